@@ -131,6 +131,41 @@ void make_buffered_strided_dim_iter(
     const memory_block_ptr& ref, intptr_t buffer_max_mem = 65536,
     const eval::eval_context *ectx = &eval::default_eval_context);
 
+/**
+ * Creates a dim_iter like make_buffered_strided_dim_iter, but which
+ * converts the upcoming chunks on a helper thread while the caller
+ * processes the current one, so that I/O such as memmap page faults,
+ * conversion, and the caller's compute overlap. Up to ``queue_depth``
+ * chunks are converted ahead, each into its own buffer of at most
+ * ``buffer_max_mem`` bytes.
+ *
+ * The chunk from one call to ``next`` stays valid until the following
+ * call to ``next`` or ``seek``. Because each buffer has its own arrmeta,
+ * ``el_arrmeta`` may change along with ``data_ptr``. An error converting
+ * a chunk is raised by the ``next`` call which would have returned it.
+ *
+ * \param out_di  An uninitialized dim_iter object. The function
+ *                populates it assuming it is filled with garbage.
+ * \param val_tp  The type of the elements the iterator should produce.
+ * \param mem_tp  The type of elements in memory.
+ * \param mem_arrmeta  The arrmeta for mem_tp.
+ * \param data_ptr  The data pointer of element 0.
+ * \param size  The dimension size.
+ * \param stride  The stride between elements.
+ * \param ref  A reference which holds the memory.
+ * \param buffer_max_mem  The maximum amount of memory to use for each temporary buffer.
+ * \param queue_depth  The number of chunks to convert ahead of the caller.
+ * \param ectx  The evaluation context.
+ */
+void make_async_buffered_strided_dim_iter(
+    dim_iter *out_di,
+    const ndt::type& val_tp,
+    const ndt::type& mem_tp, const char *mem_arrmeta,
+    const char *data_ptr, intptr_t size, intptr_t stride,
+    const memory_block_ptr& ref, intptr_t buffer_max_mem = 65536,
+    intptr_t queue_depth = 1,
+    const eval::eval_context *ectx = &eval::default_eval_context);
+
 /**
  * Makes an iterator which is empty.
  *
@@ -15,7 +15,13 @@
 #include <dynd/typed_data_assign.hpp>
 #include <dynd/types/date_util.hpp>
 
-namespace dynd { namespace eval {
+namespace dynd {
+
+namespace kernels {
+    class kernel_profiler;
+} // namespace kernels
+
+namespace eval {
 
 struct eval_context {
     // If the compiler supports atomics, use them for access
@@ -29,6 +35,8 @@ struct eval_context {
     std::atomic<date_parse_order_t> date_parse_order;
     // Century selection for 2 digit years in date strings
     std::atomic<int> century_window;
+    // If non-NULL, ckernels instantiated with this context are profiled
+    std::atomic<kernels::kernel_profiler *> profiler;
 #else
     // Default error mode for computations
     assign_error_mode errmode;
@@ -38,12 +46,15 @@ struct eval_context {
     date_parse_order_t date_parse_order;
     // Century selection for 2 digit years in date strings
     int century_window;
+    // If non-NULL, ckernels instantiated with this context are profiled
+    kernels::kernel_profiler *profiler;
 #endif
 
     DYND_CONSTEXPR eval_context()
         : errmode(assign_error_fractional),
           cuda_device_errmode(assign_error_nocheck),
-          date_parse_order(date_parse_no_ambig), century_window(70)
+          date_parse_order(date_parse_no_ambig), century_window(70),
+          profiler(NULL)
     {
     }
 
@@ -53,7 +64,8 @@ struct eval_context {
         : errmode(rhs.errmode.load()),
           cuda_device_errmode(rhs.cuda_device_errmode.load()),
           date_parse_order(rhs.date_parse_order.load()),
-          century_window(rhs.century_window.load())
+          century_window(rhs.century_window.load()),
+          profiler(rhs.profiler.load())
     {
     }
 
@@ -62,6 +74,7 @@ struct eval_context {
         cuda_device_errmode.store(rhs.cuda_device_errmode.load());
         date_parse_order.store(rhs.date_parse_order.load());
         century_window.store(rhs.century_window.load());
+        profiler.store(rhs.profiler.load());
         return *this;
     }
 #endif
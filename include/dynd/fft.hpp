@@ -64,6 +64,28 @@ void fft_cleanup();
 
 #endif // DYND_FFTW
 
+/**
+ * A built-in mixed-radix FFT engine, used by fft/ifft/rfft/irfft when
+ * libdynd is built without FFTW. Lengths whose prime factors are all
+ * 2, 3 or 5 use Cooley-Tukey butterflies directly, and any other length
+ * goes through Bluestein's algorithm on a power-of-two length. Plans are
+ * kept in a thread-safe cache keyed by length and direction, and the
+ * 1D transforms along each axis are batched and split across
+ * ``parallel::get_num_threads()`` threads.
+ *
+ * Like FFTW, the transforms are unnormalized, so ifft(fft(x)) is
+ * x scaled by the number of elements transformed.
+ */
+namespace native_fft {
+
+nd::array fft(const nd::array &x, std::vector<intptr_t> shape, std::vector<intptr_t> axes);
+nd::array ifft(const nd::array &x, std::vector<intptr_t> shape, std::vector<intptr_t> axes);
+
+nd::array rfft(const nd::array &x, std::vector<intptr_t> shape);
+nd::array irfft(const nd::array &x, std::vector<intptr_t> shape);
+
+} // namespace native_fft
+
 #define DECL_INLINES(FUNC) \
     inline nd::array FUNC(const nd::array &x) { \
         return FUNC(x, x.get_shape()); \
@@ -108,7 +130,7 @@ inline nd::array fft(const nd::array &x, std::vector<intptr_t> shape, std::vecto
 #ifdef DYND_FFTW
     return fftw::fft(x, shape, axes);
 #else
-    throw std::runtime_error("fft is not implemented");
+    return native_fft::fft(x, shape, axes);
 #endif
 }
 
@@ -140,7 +162,7 @@ inline nd::array ifft(const nd::array &x, std::vector<intptr_t> shape, std::vect
 #ifdef DYND_FFTW
     return fftw::ifft(x, shape, axes);
 #else
-    throw std::runtime_error("ifft is not implemented");
+    return native_fft::ifft(x, shape, axes);
 #endif
 }
 
@@ -173,7 +195,7 @@ inline nd::array rfft(const nd::array &x, std::vector<intptr_t> shape) {
 #ifdef DYND_FFTW
     return fftw::rfft(x, shape);
 #else
-    throw std::runtime_error("rfft is not implemented");
+    return native_fft::rfft(x, shape);
 #endif
 }
 
@@ -198,7 +220,7 @@ inline nd::array irfft(const nd::array &x, std::vector<intptr_t> shape) {
 #ifdef DYND_FFTW
     return fftw::irfft(x, shape);
 #else
-    throw std::runtime_error("irfft is not implemented");
+    return native_fft::irfft(x, shape);
 #endif
 }
 
@@ -11,6 +11,7 @@
 #include <dynd/types/arrfunc_type.hpp>
 #include <dynd/types/arrfunc_old_type.hpp>
 #include <dynd/kernels/ckernel_builder.hpp>
+#include <dynd/kernels/kernel_profiler.hpp>
 #include <dynd/types/struct_type.hpp>
 #include <dynd/types/type_pattern_match.hpp>
 #include <dynd/types/substitute_typevars.hpp>
@@ -156,6 +157,40 @@ struct arrfunc_type_data {
   }
 };
 
+namespace kernels {
+  /**
+   * Instantiates the ckernel of ``af`` inside a profiling ckernel. Use
+   * ``instantiate_ckernel``, which calls this when profiling is enabled.
+   */
+  intptr_t instantiate_profiled_ckernel(
+      const arrfunc_type_data *af, const arrfunc_type *af_tp, void *ckb,
+      intptr_t ckb_offset, const ndt::type &dst_tp, const char *dst_arrmeta,
+      const ndt::type *src_tp, const char *const *src_arrmeta,
+      kernel_request_t kernreq, const eval::eval_context *ectx,
+      const nd::array &args, const nd::array &kwds);
+
+  /**
+   * Instantiates the ckernel of ``af``, with the same parameters as
+   * ``af->instantiate``. Code instantiating an arrfunc's ckernel should
+   * call this, so that the ckernel shows up when ``ectx`` has a profiler.
+   */
+  inline intptr_t instantiate_ckernel(
+      const arrfunc_type_data *af, const arrfunc_type *af_tp, void *ckb,
+      intptr_t ckb_offset, const ndt::type &dst_tp, const char *dst_arrmeta,
+      const ndt::type *src_tp, const char *const *src_arrmeta,
+      kernel_request_t kernreq, const eval::eval_context *ectx,
+      const nd::array &args, const nd::array &kwds)
+  {
+    if (kernel_profiler::enabled(ectx, kernreq)) {
+      return instantiate_profiled_ckernel(af, af_tp, ckb, ckb_offset, dst_tp,
+                                          dst_arrmeta, src_tp, src_arrmeta,
+                                          kernreq, ectx, args, kwds);
+    }
+    return af->instantiate(af, af_tp, ckb, ckb_offset, dst_tp, dst_arrmeta,
+                           src_tp, src_arrmeta, kernreq, ectx, args, kwds);
+  }
+} // namespace kernels
+
 namespace nd {
   inline nd::array forward_as_array(const nd::array &DYND_UNUSED(names),
                                     const nd::array &DYND_UNUSED(types),
@@ -453,9 +488,10 @@ namespace nd {
 
       // Generate and evaluate the ckernel
       ckernel_builder<kernel_request_host> ckb;
-      af->instantiate(af, af_tp, &ckb, 0, dst_tp, res.get_arrmeta(), &arg_tp[0],
-                      &src_arrmeta[0], kernel_request_single, ectx, nd::array(),
-                      kwds_as_array);
+      dynd::kernels::instantiate_ckernel(af, af_tp, &ckb, 0, dst_tp,
+                                         res.get_arrmeta(), &arg_tp[0],
+                                         &src_arrmeta[0], kernel_request_single,
+                                         ectx, nd::array(), kwds_as_array);
       expr_single_t fn = ckb.get()->get_function<expr_single_t>();
       fn(res.get_readwrite_originptr(), src_data.empty() ? NULL : &src_data[0],
          ckb.get());
@@ -518,9 +554,10 @@ namespace nd {
 
       // Generate and evaluate the ckernel
       ckernel_builder<kernel_request_host> ckb;
-      af->instantiate(af, af_tp, &ckb, 0, out.get_type(), out.get_arrmeta(),
-                      &arg_tp[0], &src_arrmeta[0], kernel_request_single, ectx,
-                      array(), array());
+      dynd::kernels::instantiate_ckernel(af, af_tp, &ckb, 0, out.get_type(),
+                                         out.get_arrmeta(), &arg_tp[0],
+                                         &src_arrmeta[0], kernel_request_single,
+                                         ectx, array(), array());
       expr_single_t fn = ckb.get()->get_function<expr_single_t>();
       fn(out.get_readwrite_originptr(), src_data.empty() ? NULL : &src_data[0],
          ckb.get());
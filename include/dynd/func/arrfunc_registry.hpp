@@ -9,21 +9,68 @@
 
 namespace dynd { namespace func {
 
+namespace detail {
+struct regfunction_slot;
+} // namespace detail
+
 /**
- * Returns a reference to the map of registered arrfuncs.
+ * Returns a copy of the map of registered arrfuncs, as of the call.
  * NOTE: The internal representation will change, this
  *       function will change.
  */
-const std::map<nd::string, nd::arrfunc>& get_regfunctions();
+std::map<nd::string, nd::arrfunc> get_regfunctions();
 
 /**
-  * Looks up a named arrfunc from the registry.
+  * Looks up a named arrfunc from the registry. Lookups hash the name
+  * and never block, so they may run concurrently with each other and
+  * with set_regfunction.
   */
 nd::arrfunc get_regfunction(const nd::string &name);
 /**
-  * Sets a named arrfunc in the registry.
+  * Sets a named arrfunc in the registry. Registrations are serialized
+  * with each other. A replaced arrfunc is released once no lookup can
+  * still be reading it.
   */
 void set_regfunction(const nd::string &name, const nd::arrfunc &af);
+/**
+  * Removes a named arrfunc from the registry, raising an error if it is
+  * not registered. Handles to the name raise an error until it is
+  * registered again.
+  */
+void unregister_regfunction(const nd::string &name);
+
+/**
+ * A registry entry resolved once by name. Getting the arrfunc through
+ * the handle needs no hashing or locking, so a handle may be shared by
+ * worker threads calling it concurrently. If the name is registered
+ * again, the handle sees the new arrfunc.
+ */
+class regfunction_handle {
+  const detail::regfunction_slot *m_slot;
+
+public:
+  regfunction_handle() : m_slot(NULL) {}
+
+  /**
+   * Resolves ``name``, raising an error if it is not registered.
+   */
+  explicit regfunction_handle(const nd::string &name);
+
+  bool is_null() const { return m_slot == NULL; }
+
+  const nd::string &get_name() const;
+
+  /**
+   * The currently registered arrfunc.
+   */
+  nd::arrfunc get() const;
+
+  template <typename... A>
+  nd::array operator()(A &&... a) const
+  {
+    return get()(std::forward<A>(a)...);
+  }
+};
 
 } // namespace func
 
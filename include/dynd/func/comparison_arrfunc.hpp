@@ -0,0 +1,23 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+#include <dynd/kernels/comparison_kernels.hpp>
+
+namespace dynd {
+
+/**
+ * Returns an arrfunc with signature "(S, T) -> bool" which
+ * compares two scalars with the requested comparison. Lift it
+ * with lift_arrfunc to produce a bool mask from arrays, where
+ * the strided inner loop over builtin types is vectorizable.
+ *
+ * \param comptype  The comparison the arrfunc performs.
+ */
+nd::arrfunc make_comparison_arrfunc(comparison_type_t comptype);
+
+} // namespace dynd
@@ -0,0 +1,43 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <dynd/func/arrfunc.hpp>
+#include <dynd/types/json_type.hpp>
+
+namespace dynd {
+
+/**
+ * Returns an arrfunc ``(json) -> value_tp`` which extracts the value at
+ * ``path``, for example ``a.b[3]``, from each document. The document is
+ * indexed by its structural characters (see json_tape) to find the
+ * value, and only the value is parsed as ``value_tp``.
+ *
+ * When the document has no value at the path, an option ``value_tp``
+ * gets NA, and other types raise an error.
+ *
+ * \param path  The path of the value, as accepted by parse_json_path.
+ * \param value_tp  The type to parse the value as, which must have a
+ *                  fixed data size. The default, json, copies the text.
+ */
+nd::arrfunc make_json_get_arrfunc(const std::string &path,
+                                  const ndt::type &value_tp = ndt::make_json());
+
+/**
+ * Returns an arrfunc ``(json) -> struct_tp`` which extracts each field
+ * of ``struct_tp`` from the value at the corresponding path, indexing
+ * each document once for all of them.
+ *
+ * \param paths  One path per field of ``struct_tp``.
+ * \param struct_tp  A struct or cstruct type.
+ */
+nd::arrfunc make_json_get_arrfunc(const std::vector<std::string> &paths,
+                                  const ndt::type &struct_tp);
+
+} // namespace dynd
@@ -14,6 +14,14 @@ namespace dynd {
  * Create an arrfunc which applies a given window_op in a
  * rolling window fashion.
  *
+ * The neighborhood is given by the "shape" or "mask" keyword argument,
+ * optionally positioned by "offset". The neighborhood op is called once per
+ * row for the interior of the innermost dimension, the two innermost
+ * dimensions are visited in cache-sized tiles (overridden by the "tile_size"
+ * keyword argument), and large outputs are split across threads along the
+ * outermost dimension (overridden by the "nthreads" keyword argument). The
+ * neighborhood op must be safe to call from several threads.
+ *
  * \param neighborhood_op  An arrfunc object which transforms a neighborhood into
  *                         a single output value. Signature
  *                         '(fixed * fixed * NH, fixed * fixed * MSK) -> OUT',
@@ -21,4 +29,22 @@ namespace dynd {
 nd::arrfunc make_neighborhood_arrfunc(const nd::arrfunc &neighborhood_op,
                                       intptr_t nh_ndim);
 
+/**
+ * Create an arrfunc which applies a separable neighborhood op, one
+ * dimension at a time. The op is applied along dimension 0 of the
+ * whole array, then along dimension 1 of that result, and so on, which
+ * is equivalent to applying the outer product of the 1D neighborhoods.
+ *
+ * The neighborhood is given by the "shape" keyword argument, optionally
+ * positioned by "offset", and "tile_size" and "nthreads" work as for
+ * make_neighborhood_arrfunc.
+ *
+ * \param neighborhood_op  An arrfunc object which transforms a 1D neighborhood
+ *                         into a single output value of the same type.
+ *                         Signature '(fixed * T) -> T'.
+ * \param nh_ndim  The number of dimensions of the arrays it applies to.
+ */
+nd::arrfunc make_separable_neighborhood_arrfunc(const nd::arrfunc &neighborhood_op,
+                                                intptr_t nh_ndim);
+
 } // namespace dynd
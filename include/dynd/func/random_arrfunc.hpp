@@ -0,0 +1,55 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+
+/*
+ * These arrfuncs take no arguments and fill their whole output, of
+ * signature "() -> Dims... * R", from the Philox stream 'stream' of
+ * 'seed' (see philox_fill_words in dynd/random.hpp). Element i, in
+ * C order, always uses the same random words, so the result depends
+ * only on the seed, stream and output shape, not on how many threads
+ * fill it. Use distinct streams for independent samples with one seed.
+ */
+
+/**
+ * Returns an arrfunc which fills its output with uniform random values
+ * in [low, high). R may be float32, float64, complex[float32] or
+ * complex[float64], the real and imaginary parts being independent.
+ */
+nd::arrfunc make_uniform_arrfunc(uint64_t seed, uint64_t stream, double low,
+                                 double high);
+
+/**
+ * Returns an arrfunc which fills its output with normally distributed
+ * random values, using the Box-Muller transform. R may be float32 or
+ * float64.
+ */
+nd::arrfunc make_normal_arrfunc(uint64_t seed, uint64_t stream, double mean,
+                                double stddev);
+
+/**
+ * Returns an arrfunc which fills its output with exponentially
+ * distributed random values with the given rate. R may be float32
+ * or float64.
+ */
+nd::arrfunc make_exponential_arrfunc(uint64_t seed, uint64_t stream,
+                                     double rate);
+
+/**
+ * Returns an arrfunc which fills its output with random integers in
+ * [low, high). R may be any signed or unsigned integer type up to 64
+ * bits which can hold the range. Each value scales 64 random bits, so
+ * the bias from a range which is not a power of two is below 2^-32
+ * for any range of 32 bits or less.
+ */
+nd::arrfunc make_randint_arrfunc(uint64_t seed, uint64_t stream, int64_t low,
+                                 int64_t high);
+
+} // namespace dynd
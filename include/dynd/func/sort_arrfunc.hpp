@@ -0,0 +1,31 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+
+/**
+ * Returns an arrfunc with signature "(N * T) -> N * T", which
+ * stably sorts a one-dimensional array in the order defined by
+ * ``comparison_type_sorting_less``.
+ */
+nd::arrfunc make_sort_arrfunc();
+
+/**
+ * Returns an arrfunc with signature "(N * T) -> N * intptr", which
+ * produces the indices that stably sort a one-dimensional array.
+ */
+nd::arrfunc make_argsort_arrfunc();
+
+/**
+ * Returns an arrfunc with signature "(N * T) -> var * T", which
+ * produces the sorted distinct values of a one-dimensional array.
+ */
+nd::arrfunc make_unique_arrfunc();
+
+} // namespace dynd
@@ -0,0 +1,31 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+
+/**
+ * Returns an arrfunc with signature "(float64) -> 2 * 2 * float64",
+ * which evaluates the Airy functions, laid out as
+ * ``[[Ai, Ai'], [Bi, Bi']]`` like ``dynd::airy``.
+ */
+nd::arrfunc make_airy_arrfunc();
+
+/**
+ * Returns an arrfunc with signature "(float64) -> 2 * float64", which
+ * evaluates the Airy function Ai and its derivative.
+ */
+nd::arrfunc make_airy_ai_arrfunc();
+
+/**
+ * Returns an arrfunc with signature "(float64) -> 2 * float64", which
+ * evaluates the Airy function Bi and its derivative.
+ */
+nd::arrfunc make_airy_bi_arrfunc();
+
+} // namespace dynd
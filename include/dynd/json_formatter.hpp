@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <cstdio>
+#include <functional>
+
 #include <dynd/array.hpp>
 
 namespace dynd {
@@ -18,4 +21,46 @@ namespace dynd {
  */
 nd::array format_json(const nd::array &a, bool struct_as_list = false);
 
+/**
+ * Receives streamed JSON output, one consecutive piece at a time, always
+ * on the thread which called the formatting function.
+ */
+typedef std::function<void(const char *begin, size_t size)> json_sink_t;
+
+/**
+ * Formats the nd::array as JSON, passing the output to ``sink`` in pieces
+ * of about ``chunk_size`` bytes instead of building it in memory.
+ *
+ * When the array has a leading dimension, its elements are formatted in
+ * blocks, with up to ``parallel::get_num_threads()`` blocks formatted at
+ * once into their own buffers, which are then written in order.
+ *
+ * \param a  The array to format as JSON.
+ * \param sink  The function which receives the output.
+ * \param struct_as_list  If true, formats struct objects as lists.
+ * \param ndjson  If true, writes each element of the leading dimension
+ *                on its own line (newline-delimited JSON) instead of as
+ *                one JSON list. An array without a leading dimension is
+ *                written as one line.
+ * \param chunk_size  The approximate size of the pieces written, and of
+ *                    each thread's buffer.
+ */
+void format_json_stream(const nd::array &a, const json_sink_t &sink,
+                        bool struct_as_list = false, bool ndjson = false,
+                        intptr_t chunk_size = 1 << 20);
+
+/**
+ * Streams the nd::array as JSON to the file descriptor ``fd``, as
+ * described for ``format_json_stream``.
+ */
+void format_json_fd(const nd::array &a, int fd, bool struct_as_list = false,
+                    bool ndjson = false, intptr_t chunk_size = 1 << 20);
+
+/**
+ * Streams the nd::array as JSON to the stdio file ``f``, as described for
+ * ``format_json_stream``.
+ */
+void format_json_file(const nd::array &a, FILE *f, bool struct_as_list = false,
+                      bool ndjson = false, intptr_t chunk_size = 1 << 20);
+
 } // namespace dynd
@@ -40,19 +40,41 @@ nd::array parse_json(const ndt::type& tp, const char *json_begin, const char *js
  */
 void parse_json(nd::array& out, const char *json_begin, const char *json_end, const eval::eval_context *ectx);
 
+/**
+ * Parses the JSON, encoded as UTF-8, into existing data of type ``tp``,
+ * which is default-initialized.
+ *
+ * \param tp  The type to interpret the JSON data.
+ * \param arrmeta  The arrmeta of the output data.
+ * \param out_data  The output data.
+ * \param json_begin  The beginning of the UTF-8 buffer containing the JSON.
+ * \param json_end  One past the end of the UTF-8 buffer containing the JSON.
+ * \param ectx  An evaluation context.
+ */
+void parse_json(const ndt::type &tp, const char *arrmeta, char *out_data,
+                const char *json_begin, const char *json_end,
+                const eval::eval_context *ectx);
+
 /**
  * Parses the input json as the requested type. The input can be a string or a
  * bytes array. If the input is bytes, the parser assumes it is UTF-8 data.
+ *
+ * With ``reference_input``, UTF-8 string and json values in the result
+ * which have no escapes point into the input's memory instead of being
+ * copied, and the result holds a reference to it. This suits large
+ * immutable inputs such as an nd::memmap. The input must not be modified
+ * while the result is in use.
  */
 nd::array parse_json(const ndt::type &tp, const nd::array &json,
-                     const eval::eval_context *ectx);
+                     const eval::eval_context *ectx,
+                     bool reference_input = false);
 
 /**
  * Same as the version given a type, but parses the JSON into an uninitialized
  * dynd array.
  */
 void parse_json(nd::array &out, const nd::array &json,
-                const eval::eval_context *ectx);
+                const eval::eval_context *ectx, bool reference_input = false);
 
 inline nd::array parse_json(const ndt::type &tp, const std::string &json,
                             const eval::eval_context *ectx)
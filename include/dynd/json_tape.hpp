@@ -0,0 +1,89 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+
+/**
+ * One step of a path into a JSON document, either the field ``name`` of
+ * an object, or when ``index`` is not -1, that element of an array.
+ */
+struct json_path_step {
+    std::string name;
+    intptr_t index;
+};
+
+/**
+ * Parses a path such as ``a.b[3]`` or ``[0].name`` into its steps. Field
+ * names are separated by '.', and array indices are in brackets after
+ * them. The empty path refers to the whole document.
+ */
+void parse_json_path(const std::string &path,
+                     std::vector<json_path_step> &out_steps);
+
+/**
+ * A structural index of a JSON document, holding the offset of each
+ * '{', '}', '[', ']', ':' and ',' outside of strings, along with the
+ * index of the matching close for each open bracket. Once it is built,
+ * finding a value by path visits only the structural characters of the
+ * objects and arrays the path goes through, jumping over nested values.
+ *
+ * The index is built 64 bytes at a time, with SSE2 on x86. It checks
+ * that brackets and strings are balanced, but is not a full validation
+ * of the JSON, so values it finds still need to be parsed.
+ */
+class json_tape {
+public:
+    struct entry {
+        uint32_t offset;
+        // For '{' and '[', the index of the matching '}' or ']'
+        uint32_t match;
+    };
+
+private:
+    const char *m_begin, *m_end;
+    std::vector<entry> m_entries;
+    // The entries of the brackets still open while indexing
+    std::vector<uint32_t> m_open;
+
+public:
+    json_tape() : m_begin(NULL), m_end(NULL) {}
+
+    /**
+     * Indexes the UTF-8 JSON in the given range, reusing the memory of
+     * any previous index. Throws an exception if the brackets or strings
+     * are not balanced.
+     */
+    void index(const char *json_begin, const char *json_end);
+
+    const char *get_begin() const { return m_begin; }
+    const char *get_end() const { return m_end; }
+
+    const std::vector<entry> &get_entries() const { return m_entries; }
+
+    /**
+     * Finds the value at the path in the indexed document, returning its
+     * range of text without surrounding whitespace. Returns false if an
+     * object along the path has no such field, an array is too short, or
+     * a value along the path is not an object or array.
+     */
+    bool find(const json_path_step *path, size_t path_size,
+              const char *&out_begin, const char *&out_end) const;
+
+    bool find(const std::vector<json_path_step> &path, const char *&out_begin,
+              const char *&out_end) const
+    {
+        return find(path.empty() ? NULL : &path[0], path.size(), out_begin,
+                    out_end);
+    }
+};
+
+} // namespace dynd
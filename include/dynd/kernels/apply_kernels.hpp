@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <tuple>
+
+#include <dynd/config.hpp>
 #include <dynd/strided_vals.hpp>
 #include <dynd/kernels/cuda_kernels.hpp>
 #include <dynd/kernels/expr_kernels.hpp>
@@ -175,6 +178,302 @@ namespace kernels {
       kwds<typename from<Nsrc, typename args_of<typename funcproto_of<
                                    func_type>::type>::type>::type>;
 
+  namespace detail {
+
+    template <typename T>
+    struct is_strided_vals {
+      static const bool value = false;
+    };
+
+    template <typename T, int N>
+    struct is_strided_vals<nd::strided_vals<T, N>> {
+      static const bool value = true;
+    };
+
+    template <typename... A>
+    struct all_plain_args {
+      static const bool value = true;
+    };
+
+    template <typename A0, typename... A>
+    struct all_plain_args<A0, A...> {
+      static const bool value =
+          !is_strided_vals<typename std::remove_cv<
+              typename std::remove_reference<A0>::type>::type>::value &&
+          all_plain_args<A...>::value;
+    };
+
+    /**
+     * Detects the optional batch protocol, a member
+     * ``batch(R *dst, const A0 *src0, ..., size_t count)`` which the
+     * apply ckernels call directly for contiguous data.
+     */
+    template <typename func_type, typename R, typename A>
+    class has_batch;
+
+    template <typename func_type, typename R, typename... A>
+    class has_batch<func_type, R, type_sequence<A...>> {
+      template <typename F>
+      static auto test(int) -> decltype(
+          std::declval<F &>().batch(
+              std::declval<R *>(),
+              std::declval<const typename std::remove_cv<
+                  typename std::remove_reference<A>::type>::type *>()...,
+              std::declval<size_t>()),
+          std::true_type());
+
+      template <typename F>
+      static std::false_type test(...);
+
+    public:
+      static const bool value = decltype(test<func_type>(0))::value;
+    };
+
+    template <typename R, typename A, typename I = typename make_index_sequence<
+                                          0, A::size>::type>
+    struct apply_unit_stride;
+
+    /**
+     * Typed loops for the strided call of an apply ckernel whose
+     * arguments are all plain values. When the destination is
+     * contiguous and each source is contiguous or has stride 0, a
+     * loop specialized at compile time for that broadcast pattern is
+     * used, so the compiler can vectorize it.
+     */
+    template <typename R, typename... A, size_t... I>
+    struct apply_unit_stride<R, type_sequence<A...>, index_sequence<I...>> {
+      static const int nsrc = sizeof...(A);
+      // Broadcast patterns get their own loops for up to two sources
+      static const int nmask = nsrc <= 2 ? (1 << nsrc) : 1;
+
+      template <int Mask, typename F>
+      DYND_CUDA_HOST_DEVICE static void loop(F &func, char *dst, char *const *src, size_t count)
+      {
+        R *d = reinterpret_cast<R *>(dst);
+        for (size_t i = 0; i != count; ++i) {
+          d[i] = func(reinterpret_cast<const typename std::remove_cv<
+              typename std::remove_reference<A>::type>::type *>(
+              src[I])[((Mask >> I) & 1) ? 0 : i]...);
+        }
+      }
+
+      template <typename F>
+      DYND_CUDA_HOST_DEVICE static void batch(std::true_type, F &func, char *dst, char *const *src,
+                        size_t count)
+      {
+        func.batch(reinterpret_cast<R *>(dst),
+                   reinterpret_cast<const typename std::remove_cv<
+                       typename std::remove_reference<A>::type>::type *>(
+                       src[I])...,
+                   count);
+      }
+
+      template <typename F>
+      DYND_CUDA_HOST_DEVICE static void batch(std::false_type, F &func, char *dst, char *const *src,
+                        size_t count)
+      {
+        loop<0>(func, dst, src, count);
+      }
+
+      template <int Mask, int End>
+      struct dispatch {
+        template <typename F>
+        DYND_CUDA_HOST_DEVICE static bool run(int mask, F &func, char *dst, char *const *src,
+                        size_t count)
+        {
+          if (mask == Mask) {
+            loop<Mask>(func, dst, src, count);
+            return true;
+          }
+          return dispatch<Mask + 1, End>::run(mask, func, dst, src, count);
+        }
+      };
+
+      template <int End>
+      struct dispatch<End, End> {
+        template <typename F>
+        DYND_CUDA_HOST_DEVICE static bool run(int, F &, char *, char *const *, size_t)
+        {
+          return false;
+        }
+      };
+
+      template <typename T>
+      struct block {
+        T data[DYND_BUFFER_CHUNK_SIZE];
+      };
+
+      /**
+       * Returns the ``n`` elements of a source starting at ``offset`` as
+       * a contiguous array, copying them into ``buf`` unless the source
+       * is already contiguous. A broadcast source is copied on the first
+       * block only, which is the largest.
+       */
+      template <typename T>
+      DYND_CUDA_HOST_DEVICE static const T *block_src(T *buf, char *src, intptr_t stride,
+                                size_t offset, size_t n)
+      {
+        if (stride == static_cast<intptr_t>(sizeof(T))) {
+          return reinterpret_cast<const T *>(src) + offset;
+        } else if (stride == 0) {
+          if (offset == 0) {
+            for (size_t i = 0; i != n; ++i) {
+              buf[i] = *reinterpret_cast<const T *>(src);
+            }
+          }
+        } else {
+          src += offset * stride;
+          for (size_t i = 0; i != n; ++i, src += stride) {
+            buf[i] = *reinterpret_cast<const T *>(src);
+          }
+        }
+        return buf;
+      }
+
+      /**
+       * Calls the batch entry point on blocks of DYND_BUFFER_CHUNK_SIZE
+       * elements, gathering strided and broadcast sources and scattering
+       * a strided destination through buffers.
+       */
+      template <typename F>
+      DYND_CUDA_HOST_DEVICE static void blocked(F &func, char *dst, intptr_t dst_stride,
+                          char *const *src, const intptr_t *src_stride,
+                          size_t count)
+      {
+        std::tuple<block<typename std::remove_cv<
+            typename std::remove_reference<A>::type>::type>...> src_buf;
+        block<R> dst_buf;
+        bool dst_contiguous = dst_stride == static_cast<intptr_t>(sizeof(R));
+        for (size_t offset = 0; offset < count;
+             offset += DYND_BUFFER_CHUNK_SIZE) {
+          size_t n = count - offset < DYND_BUFFER_CHUNK_SIZE
+                         ? count - offset
+                         : DYND_BUFFER_CHUNK_SIZE;
+          R *block_dst = dst_contiguous
+                             ? reinterpret_cast<R *>(dst) + offset
+                             : dst_buf.data;
+          func.batch(block_dst,
+                     block_src(std::get<I>(src_buf).data, src[I],
+                               src_stride[I], offset, n)...,
+                     n);
+          if (!dst_contiguous) {
+            char *block_dst_ptr = dst + offset * dst_stride;
+            for (size_t i = 0; i != n; ++i, block_dst_ptr += dst_stride) {
+              *reinterpret_cast<R *>(block_dst_ptr) = dst_buf.data[i];
+            }
+          }
+        }
+      }
+
+      /**
+       * Functors with a batch entry point get every strided call, whole
+       * when it is contiguous and in blocks otherwise.
+       */
+      template <typename F>
+      DYND_CUDA_HOST_DEVICE static bool run(std::true_type, F &func, char *dst,
+                      intptr_t dst_stride, char *const *src,
+                      const intptr_t *src_stride, size_t count)
+      {
+        const intptr_t src_size[nsrc] = {
+            sizeof(typename std::remove_cv<
+                typename std::remove_reference<A>::type>::type)...};
+        bool contiguous = dst_stride == static_cast<intptr_t>(sizeof(R));
+        for (int j = 0; j < nsrc; ++j) {
+          contiguous = contiguous && src_stride[j] == src_size[j];
+        }
+        if (contiguous) {
+          batch(std::true_type(), func, dst, src, count);
+        } else {
+          blocked(func, dst, dst_stride, src, src_stride, count);
+        }
+        return true;
+      }
+
+      /**
+       * Runs the loop if the strides allow it, returning false otherwise.
+       */
+      template <typename F>
+      DYND_CUDA_HOST_DEVICE static bool run(std::false_type, F &func, char *dst,
+                      intptr_t dst_stride, char *const *src,
+                      const intptr_t *src_stride, size_t count)
+      {
+        const intptr_t src_size[nsrc] = {
+            sizeof(typename std::remove_cv<
+                typename std::remove_reference<A>::type>::type)...};
+        if (dst_stride != static_cast<intptr_t>(sizeof(R))) {
+          return false;
+        }
+        int mask = 0;
+        for (int j = 0; j < nsrc; ++j) {
+          if (src_stride[j] == 0) {
+            mask |= 1 << j;
+          } else if (src_stride[j] != src_size[j]) {
+            return false;
+          }
+        }
+        if (mask == 0) {
+          batch(std::false_type(), func, dst, src, count);
+          return true;
+        }
+        return dispatch<1, nmask>::run(mask, func, dst, src, count);
+      }
+
+      template <typename F>
+      DYND_CUDA_HOST_DEVICE static bool run(F &func, char *dst, intptr_t dst_stride,
+                      char *const *src, const intptr_t *src_stride,
+                      size_t count)
+      {
+        return run(std::integral_constant<
+                       bool, has_batch<F, R, type_sequence<A...>>::value>(),
+                   func, dst, dst_stride, src, src_stride, count);
+      }
+    };
+
+    template <typename func_type, int Nsrc,
+              typename A = typename args_of<func_type>::type,
+              typename R = typename return_of<func_type>::type,
+              bool Enable = (Nsrc > 0 && Nsrc == A::size &&
+                             !std::is_same<R, void>::value)>
+    struct apply_strided {
+      template <typename F>
+      DYND_CUDA_HOST_DEVICE static bool run(F &, char *, intptr_t, char *const *, const intptr_t *,
+                      size_t)
+      {
+        return false;
+      }
+    };
+
+    template <typename func_type, int Nsrc, typename... A, typename R>
+    struct apply_strided<func_type, Nsrc, type_sequence<A...>, R, true> {
+      template <typename F>
+      DYND_CUDA_HOST_DEVICE static bool run(F &func, char *dst, intptr_t dst_stride,
+                      char *const *src, const intptr_t *src_stride,
+                      size_t count)
+      {
+        return run(std::integral_constant<bool, all_plain_args<A...>::value>(),
+                   func, dst, dst_stride, src, src_stride, count);
+      }
+
+    private:
+      template <typename F>
+      DYND_CUDA_HOST_DEVICE static bool run(std::true_type, F &func, char *dst, intptr_t dst_stride,
+                      char *const *src, const intptr_t *src_stride,
+                      size_t count)
+      {
+        return apply_unit_stride<R, type_sequence<A...>>::run(
+            func, dst, dst_stride, src, src_stride, count);
+      }
+
+      template <typename F>
+      DYND_CUDA_HOST_DEVICE static bool run(std::false_type, F &, char *, intptr_t, char *const *,
+                      const intptr_t *, size_t)
+      {
+        return false;
+      }
+    };
+
+  } // namespace detail
+
   template <kernel_request_t kernreq, typename func_type, func_type func,
             int Nsrc>
   struct apply_function_ck;
@@ -187,6 +486,7 @@ namespace kernels {
         args_for<func_type, Nsrc>,                                             \
         kwds_for<func_type, Nsrc> {                                            \
     typedef apply_function_ck<KERNREQ, func_type, func, Nsrc> self_type;       \
+    typedef expr_ck<self_type, KERNREQ, Nsrc> parent_type;                     \
                                                                                \
     __VA_ARGS__ apply_function_ck(args_for<func_type, Nsrc> args,              \
                                   kwds_for<func_type, Nsrc> kwds)              \
@@ -199,6 +499,16 @@ namespace kernels {
       single<typename return_of<func_type>::type>(dst, src, this, this);       \
     }                                                                          \
                                                                                \
+    __VA_ARGS__ void strided(char *dst, intptr_t dst_stride, char **src,       \
+                             const intptr_t *src_stride, size_t count)         \
+    {                                                                          \
+      func_type f = func;                                                      \
+      if (!detail::apply_strided<func_type, Nsrc>::run(                        \
+              f, dst, dst_stride, src, src_stride, count)) {                   \
+        parent_type::strided(dst, dst_stride, src, src_stride, count);         \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
     static intptr_t                                                            \
     instantiate(const arrfunc_type_data *DYND_UNUSED(af_self),                 \
                 const arrfunc_type *DYND_UNUSED(af_tp), void *ckb,             \
@@ -253,6 +563,7 @@ namespace kernels {
         args_for<func_type, Nsrc>,                                             \
         kwds_for<func_type, Nsrc> {                                            \
     typedef apply_callable_ck<KERNREQ, func_type, Nsrc> self_type;             \
+    typedef expr_ck<self_type, KERNREQ, Nsrc> parent_type;                     \
                                                                                \
     func_type func;                                                            \
                                                                                \
@@ -269,6 +580,15 @@ namespace kernels {
       single<typename return_of<func_type>::type>(dst, src, this, this);       \
     }                                                                          \
                                                                                \
+    __VA_ARGS__ void strided(char *dst, intptr_t dst_stride, char **src,       \
+                             const intptr_t *src_stride, size_t count)         \
+    {                                                                          \
+      if (!detail::apply_strided<func_type, Nsrc>::run(                        \
+              func, dst, dst_stride, src, src_stride, count)) {                \
+        parent_type::strided(dst, dst_stride, src, src_stride, count);         \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
     static intptr_t                                                            \
     instantiate(const arrfunc_type_data *af_self, const arrfunc_type *af_tp,   \
                 void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,       \
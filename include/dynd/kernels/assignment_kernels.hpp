@@ -268,6 +268,11 @@ struct strided_assign_ck : public kernels::unary_ck<strided_assign_ck> {
         // Destroy the child ckernel
         get_child_ckernel()->destroy();
     }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        base.clone_child_ckernels(dst, sizeof(self_type));
+    }
 };
 
 } // namespace kernels
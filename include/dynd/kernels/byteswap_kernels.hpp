@@ -58,4 +58,35 @@ size_t make_pairwise_byteswap_assignment_function(
                 intptr_t data_size, intptr_t data_alignment,
                 kernel_request_t kernreq);
 
+/**
+ * Returns true if make_byteswap_and_convert_kernel and
+ * make_convert_and_byteswap_kernel support the pair of builtin types.
+ * The byteswapped type may be any 2, 4 or 8 byte integer or float, and the
+ * native type any integer up to 8 bytes, float32 or float64.
+ */
+bool is_fusable_byteswap_conversion(type_id_t swapped_type_id,
+                                    type_id_t native_type_id);
+
+/**
+ * Creates an assignment kernel which reads foreign-endian values of
+ * 'src_swapped_type_id', and converts them to native 'dst_type_id'
+ * values in a single pass, without buffering the swapped values.
+ */
+size_t make_byteswap_and_convert_kernel(void *ckb, intptr_t ckb_offset,
+                                        type_id_t dst_type_id,
+                                        type_id_t src_swapped_type_id,
+                                        kernel_request_t kernreq,
+                                        assign_error_mode errmode);
+
+/**
+ * Creates an assignment kernel which converts native 'src_type_id'
+ * values to 'dst_swapped_type_id', and writes them foreign-endian,
+ * in a single pass.
+ */
+size_t make_convert_and_byteswap_kernel(void *ckb, intptr_t ckb_offset,
+                                        type_id_t dst_swapped_type_id,
+                                        type_id_t src_type_id,
+                                        kernel_request_t kernreq,
+                                        assign_error_mode errmode);
+
 } // namespace dynd
@@ -7,6 +7,7 @@
 
 #include <new>
 #include <algorithm>
+#include <type_traits>
 
 #include <dynd/config.hpp>
 #include <dynd/kernels/ckernel_prefix.hpp>
@@ -210,6 +211,7 @@ public:
   self_type *init(ckernel_prefix *rawself, kernel_request_t kernreq,
                   A &&... args)
   {
+    self_type::register_clone();
     return self_type::init(rawself, kernreq, std::forward<A>(args)...);
   }
 
@@ -283,6 +285,26 @@ public:
     }
   }
 
+  /**
+   * Makes ``out`` a clone of the ckernel in this builder, which can be
+   * called at the same time as this one, for example from another
+   * thread. See ckernel_prefix::clone for what the clone shares.
+   */
+  void clone(ckernel_builder<kernel_request_host> &out) const
+  {
+    out.reset();
+    out.ensure_capacity_leaf(m_capacity);
+    out.copy(out.m_data, m_data, m_capacity);
+    try {
+      get()->clone(out.get());
+    }
+    catch (...) {
+      // Nothing in the bitwise copy is owned
+      out.set(out.m_data, 0, out.m_capacity);
+      throw;
+    }
+  }
+
   friend int ckernel_builder_ensure_capacity_leaf(void *ckb,
                                                   intptr_t requested_capacity);
 };
@@ -611,6 +633,65 @@ namespace kernels {
      */                                                                        \
     __VA_ARGS__ void destruct_children() {}                                    \
                                                                                \
+    /**                                                                        \
+     * The ckernel clone function, see ckernel_prefix::clone. This clones      \
+     * the children with clone_children, then copy constructs the ckernel      \
+     * over its bitwise copy. A child class may define its own instead.        \
+     */                                                                        \
+    static void clone(ckernel_prefix *dst, const ckernel_prefix *src)          \
+    {                                                                          \
+      const self_type *src_self = get_self(src);                               \
+      src_self->clone_children(dst);                                           \
+      try {                                                                    \
+        copy_construct(dst, src_self,                                          \
+                       std::is_copy_constructible<self_type>());               \
+      }                                                                        \
+      catch (...) {                                                            \
+        get_self(dst)->destruct_children();                                    \
+        throw;                                                                 \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    static void copy_construct(ckernel_prefix *dst, const self_type *src,      \
+                               std::true_type)                                 \
+    {                                                                          \
+      new (dst) self_type(*src);                                               \
+    }                                                                          \
+                                                                               \
+    static void copy_construct(ckernel_prefix *, const self_type *,            \
+                               std::false_type)                                \
+    {                                                                          \
+      DYND_HOST_THROW(std::runtime_error,                                      \
+                      "internal ckernel error: the ckernel is not copyable");  \
+    }                                                                          \
+                                                                               \
+    /**                                                                        \
+     * Default implementation of clone_children does nothing. A child class    \
+     * which implements destruct_children must implement this to clone the    \
+     * same children into ``dst``, or the ckernel is not clonable.             \
+     */                                                                        \
+    void clone_children(ckernel_prefix *DYND_UNUSED(dst)) const {}             \
+                                                                               \
+    /**                                                                        \
+     * Registers the clone function for this ckernel, once. Without its own    \
+     * clone, the ckernel is clonable if it is copy constructible and clones   \
+     * any children it destroys.                                               \
+     */                                                                        \
+    static void register_clone()                                               \
+    {                                                                          \
+      static const bool registered = register_ckernel_clone(                   \
+          &self_type::destruct,                                                \
+          (&self_type::clone != &general_ck::clone ||                          \
+           (std::is_copy_constructible<self_type>::value &&                    \
+            (std::is_same<decltype(&self_type::destruct_children),             \
+                          decltype(&general_ck::destruct_children)>::value ||  \
+             !std::is_same<decltype(&self_type::clone_children),               \
+                           decltype(&general_ck::clone_children)>::value)))    \
+              ? &self_type::clone                                              \
+              : NULL);                                                         \
+      (void)registered;                                                        \
+    }                                                                          \
+                                                                               \
     /**                                                                        \
      * Returns the child ckernel immediately following this one.               \
      */                                                                        \
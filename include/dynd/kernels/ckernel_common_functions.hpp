@@ -19,6 +19,13 @@ namespace kernels {
  */
 void destroy_trivial_parent_ckernel(ckernel_prefix *ckp);
 
+/**
+ * The clone function of the ckernels which use
+ * destroy_trivial_parent_ckernel, cloning the single child.
+ */
+void clone_trivial_parent_ckernel(ckernel_prefix *dst,
+                                  const ckernel_prefix *src);
+
 /**
  * An expr single ckernel function which adapts a child
  * unary single ckernel.
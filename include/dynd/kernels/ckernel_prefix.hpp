@@ -54,6 +54,7 @@ typedef uint32_t kernel_request_t;
  */
 struct ckernel_prefix {
   typedef void (*destructor_fn_t)(ckernel_prefix *);
+  typedef void (*clone_fn_t)(ckernel_prefix *dst, const ckernel_prefix *src);
 
   void *function;
   destructor_fn_t destructor;
@@ -143,6 +144,56 @@ struct ckernel_prefix {
       child->destroy();
     }
   }
+
+  /**
+   * Turns ``dst``, which holds a bitwise copy of this ckernel and
+   * its children, into an independent clone of them, using the clone
+   * function registered for this ckernel's destructor. A ckernel
+   * without a destructor owns nothing, so its bitwise copy is already
+   * a clone. If this throws, ``dst`` owns nothing and is discarded.
+   *
+   * Arrmeta the ckernels point to, whether it was passed to
+   * instantiate or belongs to a parent ckernel, is shared with the
+   * clone, so the original must outlive its clones.
+   */
+  void clone(ckernel_prefix *dst) const;
+
+  /**
+   * Clones the child ckernels at the provided offsets from `this`
+   * into the same offsets from ``dst``, skipping offsets of zero.
+   * If one of them throws, the ones already cloned are destroyed.
+   */
+  template <typename... T>
+  void clone_child_ckernels(ckernel_prefix *dst, T... offsets) const
+  {
+    const intptr_t offset_array[] = {static_cast<intptr_t>(offsets)...};
+    clone_child_ckernel_array(dst, offset_array, sizeof...(T));
+  }
+
+  void clone_child_ckernel_array(ckernel_prefix *dst, const intptr_t *offsets,
+                                 size_t count) const;
 };
 
+/**
+ * Registers the function which clones the ckernels whose destructor
+ * is ``destructor``, as used by ``ckernel_prefix::clone``. A NULL
+ * ``clone`` marks those ckernels as not clonable.
+ *
+ * \returns  true, so the registration can initialize a static.
+ */
+bool register_ckernel_clone(ckernel_prefix::destructor_fn_t destructor,
+                            ckernel_prefix::clone_fn_t clone);
+
+/**
+ * Registers ``CKT::clone`` for the ckernels with destructor
+ * ``CKT::destruct`` the first time it is called.
+ */
+template <class CKT>
+inline void register_ckernel_clone()
+{
+  static const bool registered =
+      register_ckernel_clone(&CKT::destruct, &CKT::clone);
+  (void)registered;
+}
+
 } // namespace dynd
@@ -107,4 +107,51 @@ size_t make_builtin_type_comparison_kernel(void *ckb,
                                            type_id_t src1_type_id,
                                            comparison_type_t comptype);
 
+/**
+ * Creates an expr_single_t/expr_strided_t kernel which writes the
+ * result of comparing its two sources into a bool output, so a whole
+ * strided run of comparisons produces a dense bool mask. Builtin
+ * types compared against the same type use tight loops which the
+ * compiler can vectorize, other types wrap the predicate kernel from
+ * make_comparison_kernel.
+ *
+ * \param ckb  The hierarchical assignment kernel being constructed.
+ * \param ckb_offset  The offset within 'ckb'.
+ * \param src0_dt  The first dynd type.
+ * \param src0_arrmeta  Arrmeta for the first data.
+ * \param src1_dt  The second dynd type.
+ * \param src1_arrmeta  Arrmeta for the second data
+ * \param comptype  The type of comparison to do.
+ * \param kernreq  Either kernel_request_single or kernel_request_strided.
+ * \param ectx  DyND evaluation context.
+ *
+ * \returns  The offset within 'out' immediately after the
+ *           created kernel.
+ */
+size_t make_comparison_mask_kernel(void *ckb, intptr_t ckb_offset,
+                                   const ndt::type &src0_dt,
+                                   const char *src0_arrmeta,
+                                   const ndt::type &src1_dt,
+                                   const char *src1_arrmeta,
+                                   comparison_type_t comptype,
+                                   kernel_request_t kernreq,
+                                   const eval::eval_context *ectx);
+
+/**
+ * Creates a bool mask comparison kernel for two builtin types.
+ *
+ * \param ckb  The hierarchical assignment kernel being constructed.
+ * \param ckb_offset  The offset within 'ckb'.
+ * \param src0_type_id  The first dynd type id.
+ * \param src1_type_id  The second dynd type id.
+ * \param comptype  The type of comparison to do.
+ * \param kernreq  Either kernel_request_single or kernel_request_strided.
+ */
+size_t make_builtin_type_comparison_mask_kernel(void *ckb,
+                                                intptr_t ckb_offset,
+                                                type_id_t src0_type_id,
+                                                type_id_t src1_type_id,
+                                                comparison_type_t comptype,
+                                                kernel_request_t kernreq);
+
 } // namespace dynd
@@ -0,0 +1,152 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dynd/config.hpp>
+#include <dynd/eval/eval_context.hpp>
+#include <dynd/kernels/ckernel_prefix.hpp>
+
+namespace dynd { namespace kernels {
+
+/**
+ * The statistics for one ckernel in a profiled ckernel tree. The
+ * counters are updated by the profiling ckernel wrapped around it,
+ * and include the time spent in its children.
+ */
+struct kernel_profile_node {
+    std::string name;
+    kernel_request_t kernreq;
+    std::atomic<uint64_t> calls, elements, cycles;
+    std::vector<kernel_profile_node *> children;
+
+    kernel_profile_node(const std::string &name, kernel_request_t kernreq)
+        : name(name), kernreq(kernreq), calls(0), elements(0), cycles(0)
+    {
+    }
+
+    void record(uint64_t count, uint64_t elapsed)
+    {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        elements.fetch_add(count, std::memory_order_relaxed);
+        cycles.fetch_add(elapsed, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Collects a tree of per-ckernel statistics. Set it as the ``profiler``
+ * of an eval_context, and every arrfunc ckernel and assignment ckernel
+ * instantiated with that context is wrapped in a profiling ckernel,
+ * nested as the ckernels are.
+ *
+ * Instantiating the same ckernel tree again, for example by calling
+ * an arrfunc repeatedly, adds to the same nodes. The profiler must
+ * outlive the ckernels instantiated with it.
+ *
+ * Setting the environment variable DYND_PROFILE_KERNELS to ``text`` or
+ * ``json`` profiles with eval::default_eval_context for the whole
+ * process, printing the tree to stderr at exit.
+ */
+class kernel_profiler {
+    // m_nodes[0] is the root, whose children are the instantiated trees
+    std::deque<kernel_profile_node> m_nodes;
+    // The nodes being instantiated on each thread, innermost last, with
+    // the position to look for their next child from
+    struct frame {
+        kernel_profile_node *node;
+        size_t cursor;
+    };
+    std::map<std::thread::id, std::vector<frame> > m_stacks;
+    mutable std::mutex m_mutex;
+
+    friend class profile_scope;
+
+    // Non-copyable
+    kernel_profiler(const kernel_profiler &);
+    kernel_profiler &operator=(const kernel_profiler &);
+
+public:
+    kernel_profiler();
+
+    kernel_profile_node *get_root() { return &m_nodes.front(); }
+
+    /**
+     * Returns the child of ``parent`` with the given name and request,
+     * searching from ``inout_cursor`` onwards and creating it if there
+     * is none. Updates ``inout_cursor`` to just past it.
+     */
+    kernel_profile_node *get_child(kernel_profile_node *parent,
+                                   size_t &inout_cursor,
+                                   const std::string &name,
+                                   kernel_request_t kernreq);
+
+    /** Sets all the counters back to zero, keeping the tree. */
+    void reset();
+
+    /**
+     * Prints the tree as indented text, one ckernel per line, with the
+     * share of the total cycles spent in each ckernel itself.
+     */
+    std::string to_text() const;
+
+    /**
+     * Prints the tree as a JSON list of nodes, each with "name",
+     * "request", "calls", "elements", "cycles", "self_cycles" and
+     * "children".
+     */
+    std::string to_json() const;
+
+    /**
+     * The timer used, which is the time stamp counter on x86, and
+     * nanoseconds elsewhere.
+     */
+    static uint64_t read_cycles();
+
+    /**
+     * Whether ckernels instantiated for ``kernreq`` with ``ectx`` get
+     * profiled. Only host single and strided ckernels are profiled.
+     */
+    static bool enabled(const eval::eval_context *ectx, kernel_request_t kernreq)
+    {
+        return ectx != NULL && ectx->profiler != NULL &&
+               (kernreq == kernel_request_single ||
+                kernreq == kernel_request_strided);
+    }
+};
+
+/**
+ * Wraps the ckernel about to be instantiated at ``ckb_offset`` in a
+ * profiling ckernel for the node ``name``, which becomes the parent of
+ * ckernels instantiated until the scope ends. The ckernel being profiled
+ * must be instantiated at ``get_offset()``.
+ *
+ * Construct this only when ``kernel_profiler::enabled`` is true.
+ */
+class profile_scope {
+    kernel_profiler *m_profiler;
+    intptr_t m_offset;
+
+    // Non-copyable
+    profile_scope(const profile_scope &);
+    profile_scope &operator=(const profile_scope &);
+
+public:
+    profile_scope(void *ckb, intptr_t ckb_offset, kernel_request_t kernreq,
+                  const eval::eval_context *ectx, const std::string &name);
+
+    ~profile_scope();
+
+    intptr_t get_offset() const { return m_offset; }
+};
+
+}} // namespace dynd::kernels
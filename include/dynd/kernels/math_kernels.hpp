@@ -0,0 +1,50 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/config.hpp>
+
+namespace dynd { namespace kernels { namespace vmath {
+
+/**
+ * Vectorized elementwise math functions over contiguous arrays, with
+ * ``dst`` and ``src`` either identical or non-overlapping. The loops
+ * are written to be vectorized by the compiler, and on x86 the best of
+ * the AVX-512F, AVX2+FMA and baseline builds is picked at runtime.
+ *
+ * Each function computes in double precision, using a polynomial on a
+ * reduced argument. Inputs outside the reduced range, including NaN,
+ * infinities, zeros and negatives for log, arguments to sin/cos with a
+ * magnitude above 2^20 or very close to a multiple of pi/2, and results
+ * that would be subnormal, are recomputed with the C library function
+ * of the same name, so special values follow C99 Annex F.
+ *
+ * Measured against the C library, the float64 results are within
+ * 1 ulp for exp and log, and within 2 ulp for sin, cos and tanh. The
+ * float32 versions round the float64 result, and are within 1 ulp.
+ */
+void exp(double *dst, const double *src, size_t count);
+void exp(float *dst, const float *src, size_t count);
+
+void log(double *dst, const double *src, size_t count);
+void log(float *dst, const float *src, size_t count);
+
+void sin(double *dst, const double *src, size_t count);
+void sin(float *dst, const float *src, size_t count);
+
+void cos(double *dst, const double *src, size_t count);
+void cos(float *dst, const float *src, size_t count);
+
+void tanh(double *dst, const double *src, size_t count);
+void tanh(float *dst, const float *src, size_t count);
+
+/**
+ * Returns the name of the instruction set the vectorized math functions
+ * dispatch to, one of "avx512f", "avx2", or "default".
+ */
+const char *get_isa();
+
+}}} // namespace dynd::kernels::vmath
@@ -0,0 +1,39 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/type.hpp>
+#include <dynd/eval/eval_context.hpp>
+
+namespace dynd { namespace kernels {
+
+/**
+ * Computes the stable permutation which sorts ``count`` elements
+ * of type ``el_tp``, located at ``data``, ``data + stride``, etc,
+ * in the order defined by ``comparison_type_sorting_less``.
+ *
+ * Bool, integer, floating point, date and time elements use an LSD
+ * radix sort, and ascii/utf8 strings a radix sort on an eight byte
+ * prefix followed by a comparison sort of the ties. Any other type
+ * uses a merge sort driven by its comparison kernel. The radix and
+ * merge passes are partitioned across ``parallel::get_num_threads()``
+ * threads.
+ *
+ * \param el_tp  The type of the elements being sorted.
+ * \param el_arrmeta  The arrmeta of the elements being sorted.
+ * \param data  Pointer to the first element.
+ * \param stride  The stride between elements.
+ * \param count  The number of elements.
+ * \param out_index  Filled with ``count`` indices, such that
+ *                   ``data + out_index[i] * stride`` is the i-th
+ *                   smallest element.
+ * \param ectx  DyND evaluation context.
+ */
+void strided_argsort(const ndt::type &el_tp, const char *el_arrmeta,
+                     const char *data, intptr_t stride, intptr_t count,
+                     intptr_t *out_index, const eval::eval_context *ectx);
+
+}} // namespace dynd::kernels
@@ -0,0 +1,64 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/config.hpp>
+
+namespace dynd { namespace kernels { namespace special {
+
+/**
+ * Batch versions of the special functions in dynd/special.hpp, over
+ * contiguous float64 arrays with ``dst`` and ``src`` either identical or
+ * non-overlapping. Large arrays are split across the threads given by
+ * ``parallel::get_num_threads()``.
+ *
+ * The Bessel functions of integer order 0 and 1 evaluate the same
+ * rational approximations as Cephes, but one polynomial at a time across
+ * a block of inputs, so the loops vectorize. Inputs which Cephes treats
+ * as special cases go through the scalar Cephes function.
+ */
+void bessel_j0(double *dst, const double *src, size_t count);
+void bessel_j1(double *dst, const double *src, size_t count);
+void bessel_y0(double *dst, const double *src, size_t count);
+void bessel_y1(double *dst, const double *src, size_t count);
+
+void sph_bessel_j0(double *dst, const double *src, size_t count);
+void sph_bessel_y0(double *dst, const double *src, size_t count);
+
+/**
+ * The Airy functions write several values per element, in the layout of
+ * the matching functions in dynd/special.hpp. ``airy`` writes Ai, Ai',
+ * Bi and Bi', while ``airy_ai`` and ``airy_bi`` write a value and its
+ * derivative.
+ */
+void airy(double *dst, const double *src, size_t count);
+void airy_ai(double *dst, const double *src, size_t count);
+void airy_bi(double *dst, const double *src, size_t count);
+
+/**
+ * The gamma functions have no vectorized form. They stay on the calling
+ * thread, because Cephes' gamma keeps the sign of its result in a global.
+ * That only keeps them from racing each other, they can still race with
+ * other threads calling into Cephes at the same time.
+ */
+void gamma(double *dst, const double *src, size_t count);
+void lgamma(double *dst, const double *src, size_t count);
+
+/**
+ * Functions of an order and an argument, elementwise over the two
+ * source arrays. These go through Cephes' gamma as well, and stay on
+ * the calling thread.
+ */
+void bessel_j(double *dst, const double *nu, const double *x, size_t count);
+void bessel_y(double *dst, const double *nu, const double *x, size_t count);
+void sph_bessel_j(double *dst, const double *nu, const double *x,
+                  size_t count);
+void sph_bessel_y(double *dst, const double *nu, const double *x,
+                  size_t count);
+void struve_h(double *dst, const double *nu, const double *x, size_t count);
+void legendre_p(double *dst, const int *l, const double *x, size_t count);
+
+}}} // namespace dynd::kernels::special
@@ -7,9 +7,13 @@
 
 #pragma once
 
+#include <vector>
+#include <cstring>
+
 #include <dynd/kernels/ckernel_builder.hpp>
 #include <dynd/typed_data_assign.hpp>
 #include <dynd/string_encodings.hpp>
+#include <dynd/types/base_string_type.hpp>
 
 namespace dynd { namespace kernels {
 
@@ -48,20 +52,92 @@ struct string_concatenation_kernel {
 };
 
 /**
- * String find kernel, which searches the whole string.
+ * Searches byte ranges for a fixed needle with the Two-Way algorithm of
+ * Crochemore and Perrin. The needle is factorized once in `init`, after
+ * which every search is linear in the haystack length and allocation free.
+ * Candidate alignments are located with memchr on the byte at the critical
+ * position, which the C library implements with SIMD.
+ */
+class byte_string_searcher {
+    std::vector<char> m_needle;
+    // The critical factorization position of the needle
+    intptr_t m_critical_pos;
+    // The shift to apply after a mismatch to the left of the critical position
+    intptr_t m_period;
+    // Whether the needle is periodic with m_period, which enables the
+    // memorization of the matched prefix between attempts
+    bool m_periodic;
+
+public:
+    byte_string_searcher()
+        : m_critical_pos(0), m_period(1), m_periodic(false)
+    {
+    }
+
+    /**
+     * Preprocesses the needle [needle_begin, needle_end).
+     */
+    void init(const char *needle_begin, const char *needle_end);
+
+    inline intptr_t size() const {
+        return (intptr_t)m_needle.size();
+    }
+
+    inline const char *data() const {
+        return m_needle.empty() ? NULL : &m_needle[0];
+    }
+
+    /**
+     * Returns a pointer to the first occurrence of the needle within
+     * [begin, end), or NULL if there is none.
+     */
+    const char *find(const char *begin, const char *end) const;
+
+    inline bool is_prefix_of(const char *begin, const char *end) const {
+        return end - begin >= size() && memcmp(begin, data(), size()) == 0;
+    }
+
+    inline bool is_suffix_of(const char *begin, const char *end) const {
+        return end - begin >= size() &&
+               memcmp(end - size(), data(), size()) == 0;
+    }
+};
+
+enum string_search_op_t {
+    // Codepoint index of the first occurrence, or -1
+    string_search_find,
+    string_search_contains,
+    string_search_startswith,
+    string_search_endswith
+};
+
+struct string_search_cache;
+
+/**
+ * String search kernel, which implements find, contains, startswith and
+ * endswith. The substring is transcoded into the encoding of the string
+ * being searched and preprocessed into a byte_string_searcher, which is
+ * kept for as long as consecutive elements supply the same substring. A
+ * scalar substring broadcast against a column is thus prepared once, and
+ * each element is searched bytewise, with a byte offset converted into a
+ * codepoint index only when find reports a match.
  *
- * (string, string) -> intp
+ * (string, string) -> intp   for string_search_find
+ * (string, string) -> bool   for the others
  */
-struct string_find_kernel {
-    typedef string_find_kernel extra_type;
+struct string_search_kernel {
+    typedef string_search_kernel extra_type;
 
     ckernel_prefix m_base;
+    string_search_op_t m_op;
     // The string type being searched through
     const base_string_type *m_str_type;
     const char *m_str_arrmeta;
     // The substring type being searched for
     const base_string_type *m_sub_type;
     const char *m_sub_arrmeta;
+    // The most recently prepared substring, owned by the kernel
+    string_search_cache *m_cache;
 
     ckernel_prefix& base() {
         return m_base;
@@ -70,10 +146,12 @@ struct string_find_kernel {
     /**
      * Initializes the kernel data.
      *
-     * \param src_tp        The array of two src types.
+     * \param op           Which search operation the kernel performs.
+     * \param src_tp       The array of two src types.
      * \param src_arrmeta  The array of two src arrmeta.
      */
-    void init(const ndt::type *src_tp, const char *const *src_arrmeta);
+    void init(string_search_op_t op, const ndt::type *src_tp,
+              const char *const *src_arrmeta);
 
     static void destruct(ckernel_prefix *extra);
 
@@ -21,6 +21,20 @@ size_t make_struct_comparison_kernel(
                 comparison_type_t comptype,
                 const eval::eval_context *ectx);
 
+/**
+ * Makes an expr_single_t/expr_strided_t kernel which compares two
+ * instances of the same struct/cstruct, writing a bool. Its strided
+ * call loops over the fields on the outside, making one strided mask
+ * call per field for a chunk of elements and combining the field
+ * masks, instead of visiting every field of every element.
+ */
+size_t make_struct_comparison_mask_kernel(
+                void *ckb, intptr_t ckb_offset,
+                const ndt::type& src_tp,
+                const char *src0_arrmeta, const char *src1_arrmeta,
+                comparison_type_t comptype, kernel_request_t kernreq,
+                const eval::eval_context *ectx);
+
 /**
  * Makes a kernel which lexicographically compares two
  * instances with struct_kind.
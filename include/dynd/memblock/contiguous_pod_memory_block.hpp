@@ -0,0 +1,90 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include <dynd/memblock/memory_block.hpp>
+
+namespace dynd {
+
+/**
+ * A memory block holding POD data in a single contiguous buffer which
+ * grows as data is appended. Because the buffer may move when it grows,
+ * its contents are addressed by byte offsets from the start rather than
+ * by pointers, which also lets the buffer be written out or memory
+ * mapped without any pointer fix-up.
+ */
+struct contiguous_pod_memory_block {
+    memory_block_data m_mbd;
+    /** The start of the buffer, may be NULL while empty */
+    char *m_data;
+    /** The number of bytes in use */
+    intptr_t m_size;
+    /** The number of bytes allocated */
+    intptr_t m_capacity;
+
+    contiguous_pod_memory_block()
+        : m_mbd(1, contiguous_pod_memory_block_type), m_data(NULL), m_size(0),
+          m_capacity(0)
+    {
+    }
+};
+
+/**
+ * Creates a memory block with a single contiguous, growable buffer.
+ *
+ * The initial capacity can be set if a good estimate is known.
+ */
+memory_block_ptr make_contiguous_pod_memory_block(intptr_t initial_capacity_bytes = 2048);
+
+/**
+ * Returns the start of the buffer of a contiguous_pod_memory_block. This
+ * pointer is invalidated by any allocate or resize call.
+ */
+inline char *get_contiguous_pod_memory_block_data(const memory_block_data *self)
+{
+    return reinterpret_cast<const contiguous_pod_memory_block *>(self)->m_data;
+}
+
+/**
+ * Returns the number of bytes in use in a contiguous_pod_memory_block.
+ */
+inline intptr_t get_contiguous_pod_memory_block_size(const memory_block_data *self)
+{
+    return reinterpret_cast<const contiguous_pod_memory_block *>(self)->m_size;
+}
+
+/**
+ * Appends `size_bytes` uninitialized bytes at the requested alignment to the
+ * end of the buffer, returning the offset at which they start.
+ */
+intptr_t contiguous_pod_memory_block_allocate(memory_block_data *self,
+                                              intptr_t size_bytes,
+                                              intptr_t alignment);
+
+/**
+ * Resizes the most recent allocation, which starts at `offset`. Use this to
+ * grow an allocation as needed, and to trim it once its size is known.
+ */
+void contiguous_pod_memory_block_resize(memory_block_data *self,
+                                        intptr_t offset, intptr_t size_bytes);
+
+/**
+ * Throws away all the data in the buffer, keeping its capacity.
+ */
+void contiguous_pod_memory_block_reset(memory_block_data *self);
+
+/**
+ * Shrinks the buffer to the bytes in use. Unlike with a pod memory block,
+ * moving the data here is fine since it is addressed by offsets.
+ */
+void contiguous_pod_memory_block_finalize(memory_block_data *self);
+
+void contiguous_pod_memory_block_debug_print(const memory_block_data *memblock, std::ostream& o, const std::string& indent);
+
+} // namespace dynd
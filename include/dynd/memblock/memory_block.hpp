@@ -33,7 +33,9 @@ enum memory_block_type_t {
     /** For memory used by code generation */
     executable_memory_block_type,
     /** Wraps memory mapped files */
-    memmap_memory_block_type
+    memmap_memory_block_type,
+    /** For POD data in one growable buffer, addressed by offsets */
+    contiguous_pod_memory_block_type
 };
 
 std::ostream& operator<<(std::ostream& o, memory_block_type_t mbt);
@@ -20,6 +20,14 @@ namespace dynd {
  */
 memory_block_ptr make_pod_memory_block(intptr_t initial_capacity_bytes = 2048);
 
+/**
+ * Makes the POD memory block ``self`` hold a reference to ``ref``, so that
+ * the data of blockref types using ``self`` may also point into ``ref``.
+ * Adding the same memory block again has no effect.
+ */
+void pod_memory_block_add_blockref(memory_block_data *self,
+                                   memory_block_data *ref);
+
 void pod_memory_block_debug_print(const memory_block_data *memblock, std::ostream& o, const std::string& indent);
 
 } // namespace dynd
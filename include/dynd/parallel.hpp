@@ -0,0 +1,52 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <functional>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+namespace parallel {
+
+  /**
+   * Returns the number of threads dynd uses when a ckernel
+   * splits its work across threads. This is initialized from the
+   * ``DYND_NUM_THREADS`` environment variable if it is set, and
+   * from the hardware concurrency otherwise.
+   */
+  intptr_t get_num_threads();
+
+  /**
+   * Sets the number of threads dynd uses when a ckernel splits
+   * its work across threads. A value of 1 disables threading.
+   */
+  void set_num_threads(intptr_t nthreads);
+
+  /**
+   * Returns the number of partitions ``parallel_for`` splits
+   * a range of ``size`` elements into, given at most ``nthreads``
+   * threads and at least ``grain_size`` elements per partition.
+   */
+  intptr_t get_partition_count(intptr_t size, intptr_t nthreads,
+                               intptr_t grain_size);
+
+  /**
+   * Splits the range [0, size) into contiguous partitions as
+   * described by ``get_partition_count``, and calls
+   * ``fn(partition_index, begin, end)`` for each of them. The calling
+   * thread handles partition 0, and each other partition gets its
+   * own thread. If any partition throws, the first exception is
+   * rethrown in the calling thread after all the threads are joined.
+   *
+   * \returns  The number of partitions which were used.
+   */
+  intptr_t
+  parallel_for(intptr_t size, intptr_t nthreads, intptr_t grain_size,
+               const std::function<void(intptr_t, intptr_t, intptr_t)> &fn);
+
+} // namespace parallel
+} // namespace dynd
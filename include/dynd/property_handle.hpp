@@ -0,0 +1,84 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <memory>
+
+#include <dynd/array.hpp>
+#include <dynd/func/callable.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+
+namespace dynd { namespace nd {
+
+/**
+ * A dynamic array property which has been looked up once for an
+ * array type, from ``ndt::type::resolve_property``. Applying it to
+ * arrays of that type skips the name lookup that ``nd::array::p``
+ * does on every call.
+ *
+ * Element-wise properties, like "year" of a date, are recognized the
+ * first time the handle is applied. After that the property view is
+ * made directly, and ``eval`` reuses one getter ckernel for all the
+ * arrays it is given when the types need no arrmeta.
+ *
+ * A handle caches state as it is used, so each thread should resolve
+ * its own.
+ */
+class property_handle {
+    ndt::type m_tp;
+    std::string m_name;
+    // Points into the property table owned by m_tp
+    const gfunc::callable *m_callable;
+
+    // Filled in by the first application
+    mutable bool m_probed;
+    // The property_type the callable wraps the dtype with, if it is
+    // an element-wise property, NULL otherwise
+    mutable ndt::type m_view_dtype;
+    // Cached getter for m_view_dtype, built with m_ck_errmode
+    mutable std::shared_ptr<assignment_strided_ckernel_builder> m_ck;
+    mutable assign_error_mode m_ck_errmode;
+
+    void check_type(const nd::array &n) const;
+    void getter(char *dst, const size_stride_t *dst_ss, char *src,
+                const size_stride_t *src_ss, intptr_t ndim) const;
+
+public:
+    property_handle(const ndt::type &tp, const std::string &name);
+
+    /** The array type this handle was resolved for */
+    const ndt::type &get_type() const {
+        return m_tp;
+    }
+
+    /** The name of the property */
+    const std::string &get_name() const {
+        return m_name;
+    }
+
+    /**
+     * True if this is known to be an element-wise property. This is only
+     * determined once the handle has been applied to an array.
+     */
+    bool is_elwise() const {
+        return !m_view_dtype.is_null();
+    }
+
+    /**
+     * Accesses the property of 'n', giving the same result as
+     * ``n.p(get_name())``. The type of 'n' must match the type the
+     * handle was resolved for.
+     */
+    nd::array operator()(const nd::array &n) const;
+
+    /**
+     * Accesses the property of 'n' and evaluates it into a new array.
+     */
+    nd::array eval(const nd::array &n, const eval::eval_context *ectx =
+                                           &eval::default_eval_context) const;
+};
+
+}} // namespace dynd::nd
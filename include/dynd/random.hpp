@@ -8,12 +8,40 @@
 #include <dynd/array.hpp>
 #include <dynd/types/dynd_complex.hpp>
 
-namespace dynd { namespace nd {
+namespace dynd {
+
+/**
+ * The Philox4x32-10 counter-based random number generator, from
+ * Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3". It maps
+ * a 128-bit counter and a 64-bit key to four random 32-bit words, so
+ * any position of a random stream can be computed directly without
+ * generating the ones before it.
+ *
+ * \param ctr  The four counter words.
+ * \param key  The two key words.
+ * \param out  Filled with the four random words.
+ */
+void philox4x32_10(const uint32_t *ctr, const uint32_t *key, uint32_t *out);
+
+/**
+ * Generates the words [first_word, first_word + count) of the random
+ * stream identified by 'seed' and 'stream'. Word ``w`` is word ``w % 4``
+ * of the Philox block with counter ``(w / 4, stream)`` and key 'seed'.
+ * The result only depends on the word positions, so threads filling
+ * different ranges of the same stream produce the same values as a
+ * single thread would.
+ */
+void philox_fill_words(uint64_t seed, uint64_t stream, uint64_t first_word,
+                       size_t count, uint32_t *out);
+
+namespace nd {
 
   /**
-   * Primitive function to construct an nd::array with each element initialized
-   * to a random value. This is used only for testing right now, and it should
-   * be completely redone at some point.
+   * Constructs an nd::array with each element initialized to a uniform
+   * random value in [0, 1). The dtype may be float32, float64,
+   * complex[float32] or complex[float64]. Each call uses the next stream
+   * of a fixed seed, use ``make_uniform_arrfunc`` for control over
+   * the seed.
    */
   nd::array rand(const ndt::type &tp);
 
@@ -0,0 +1,54 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/array.hpp>
+
+namespace dynd {
+
+namespace ndt {
+    /**
+     * Makes the columnar (struct of arrays) type for 'dim_size' records
+     * of the struct type 'struct_tp'. For example, with a dim_size of 10,
+     * "{x : int32, y : string}" becomes "{x : 10 * int32, y : 10 * string}".
+     * Each field is its own contiguous array, so a scan of one field
+     * only touches that field's bytes.
+     */
+    ndt::type make_struct_of_arrays(intptr_t dim_size,
+                                    const ndt::type &struct_tp);
+
+    /**
+     * Returns true if 'tp' is a struct whose fields are all fixed
+     * dimensions of the same size, as made by make_struct_of_arrays.
+     */
+    bool is_struct_of_arrays(const ndt::type &tp);
+} // namespace ndt
+
+namespace nd {
+    /**
+     * Transposes a one-dimensional array of structs (row layout) into
+     * a struct of arrays (column layout). The fields keep their names,
+     * so ``a.p("x")`` gives the same values for both layouts, but for
+     * the result it is a unit stride array.
+     *
+     * The copy is cache-blocked, a block of rows is scattered into all
+     * the columns with one strided kernel call per field before moving
+     * on to the next block.
+     */
+    array to_struct_of_arrays(const array &a,
+                              const eval::eval_context *ectx =
+                                  &eval::default_eval_context);
+
+    /**
+     * Transposes a struct of arrays (column layout) back into a
+     * one-dimensional array of structs (row layout).
+     */
+    array to_array_of_structs(const array &a,
+                              const eval::eval_context *ectx =
+                                  &eval::default_eval_context);
+} // namespace nd
+
+} // namespace dynd
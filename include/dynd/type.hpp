@@ -73,6 +73,7 @@ char *iterdata_broadcasting_terminator_reset(iterdata_common *iterdata, char *da
 // Forward declaration of nd::array and nd::strided_vals
 namespace nd {
     class array;
+    class property_handle;
 
     template <typename T, int N>
     class strided_vals;
@@ -358,6 +359,15 @@ public:
      */
     nd::array p(const std::string& property_name) const;
 
+    /**
+     * Looks up the dynamic array property of the given name for arrays
+     * of this type, returning a handle which applies it without
+     * repeating the lookup. Defined in dynd/property_handle.hpp.
+     *
+     * \param property_name  The array property to resolve.
+     */
+    nd::property_handle resolve_property(const std::string& property_name) const;
+
     /**
      * Indexes into the type, intended for recursive calls from the extended-type version. See
      * the function in base_type with the same name for more details.
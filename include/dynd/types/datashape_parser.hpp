@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include <dynd/type.hpp>
 
 namespace dynd {
@@ -37,6 +39,95 @@ inline ndt::type type_from_datashape(const char (&datashape)[N])
     return type_from_datashape(datashape, datashape + N - 1);
 }
 
+/**
+ * Like type_from_datashape, but looks up the datashape string in a
+ * process-wide cache first, and stores newly parsed types there.
+ * This is what ``ndt::type(const std::string&)`` uses. The cache is
+ * thread-safe and evicts the least recently used entries once it is
+ * full. Datashapes which fail to parse are not cached.
+ */
+ndt::type type_from_datashape_cached(const char *datashape_begin,
+                                     const char *datashape_end);
+
+/**
+ * Counters describing the datashape parse cache.
+ */
+struct datashape_cache_stats {
+    /** Lookups which found an already parsed type */
+    size_t hits;
+    /** Lookups which had to parse the datashape */
+    size_t misses;
+    /** Entries dropped to stay within the capacity */
+    size_t evictions;
+    /** The number of entries currently cached */
+    size_t size;
+    /** The maximum number of entries */
+    size_t capacity;
+};
+
+/**
+ * Returns a snapshot of the datashape parse cache counters.
+ */
+datashape_cache_stats get_datashape_cache_stats();
+
+/**
+ * Sets the maximum number of entries in the datashape parse cache,
+ * evicting entries if it currently holds more. A capacity of zero
+ * disables caching.
+ */
+void set_datashape_cache_capacity(size_t capacity);
+
+/**
+ * Removes all entries from the datashape parse cache, and resets
+ * its counters.
+ */
+void clear_datashape_cache();
+
+namespace ndt {
+    /**
+     * A type given by a datashape literal, which is parsed the first
+     * time it is used and shared from then on. Intended for namespace
+     * scope or function static declarations, as in
+     *
+     *   static const ndt::type_literal point_tp("{x: float64, y: float64}");
+     *   nd::array a = nd::empty(n, point_tp);
+     *
+     * Parsing is deferred to the first use because the datashape parser
+     * tables are only set up by libdynd_init.
+     */
+    class type_literal {
+        const char *m_datashape;
+        mutable std::once_flag m_parsed;
+        mutable ndt::type m_tp;
+
+        // Non-copyable
+        type_literal(const type_literal&);
+        type_literal& operator=(const type_literal&);
+
+        void parse() const {
+            m_tp = type_from_datashape(m_datashape);
+        }
+    public:
+        explicit type_literal(const char *datashape)
+            : m_datashape(datashape)
+        {
+        }
+
+        const char *datashape() const {
+            return m_datashape;
+        }
+
+        const ndt::type& get() const {
+            std::call_once(m_parsed, &type_literal::parse, this);
+            return m_tp;
+        }
+
+        operator const ndt::type&() const {
+            return get();
+        }
+    };
+} // namespace ndt
+
 namespace init {
 void datashape_parser_init();
 void datashape_parser_cleanup();
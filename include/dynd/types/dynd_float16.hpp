@@ -37,6 +37,22 @@ DYND_CUDA_HOST_DEVICE uint16_t double_to_halfbits(double value, assign_error_mod
 DYND_CUDA_HOST_DEVICE float halfbits_to_float(uint16_t value);
 DYND_CUDA_HOST_DEVICE double halfbits_to_double(uint16_t value);
 
+/**
+ * Bulk conversions between contiguous arrays of float16 bits and
+ * float32/float64 values. These use the F16C instructions when the CPU
+ * supports them, and a branch-free scalar loop otherwise. The results
+ * match the single-value conversions above, except that NaN payloads
+ * are quietened. Errors are only checked for the (rare) values whose
+ * result is subnormal, zero or infinite, so a checked errmode costs
+ * one extra pass over the output.
+ */
+void float_to_halfbits_array(uint16_t *dst, const float *src, size_t count,
+                             assign_error_mode errmode);
+void double_to_halfbits_array(uint16_t *dst, const double *src, size_t count,
+                              assign_error_mode errmode);
+void halfbits_to_float_array(float *dst, const uint16_t *src, size_t count);
+void halfbits_to_double_array(double *dst, const uint16_t *src, size_t count);
+
 class dynd_float16 {
     uint16_t m_bits;
 
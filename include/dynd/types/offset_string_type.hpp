@@ -0,0 +1,144 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+// The offset_string type stores each string as a pair of
+// byte offsets into one contiguous character buffer shared
+// by the whole array.
+//
+
+#pragma once
+
+#include <dynd/type.hpp>
+#include <dynd/typed_data_assign.hpp>
+#include <dynd/string_encodings.hpp>
+#include <dynd/memblock/contiguous_pod_memory_block.hpp>
+
+namespace dynd {
+
+struct offset_string_type_arrmeta {
+    /**
+     * A reference to the contiguous_pod_memory_block which holds the
+     * character data of all the strings.
+     */
+    memory_block_data *blockref;
+};
+
+/**
+ * The data of one offset_string element, the range [begin, end) of its
+ * bytes in the character buffer. The offsets are int32 or int64. A
+ * negative begin marks a missing value.
+ */
+template <typename T>
+struct offset_string_type_data {
+    T begin;
+    T end;
+};
+
+class offset_string_type : public base_string_type {
+    string_encoding_t m_encoding;
+    type_id_t m_offset_type_id;
+
+public:
+    offset_string_type(string_encoding_t encoding, type_id_t offset_type_id);
+
+    virtual ~offset_string_type();
+
+    inline string_encoding_t get_encoding() const {
+        return m_encoding;
+    }
+
+    /** The type of the offsets, int32_type_id or int64_type_id. */
+    inline type_id_t get_offset_type_id() const {
+        return m_offset_type_id;
+    }
+
+    /**
+     * Reads the offsets of a string element, widened to intptr_t.
+     */
+    inline void get_offsets(const char *data, intptr_t *out_begin,
+                            intptr_t *out_end) const
+    {
+        if (m_offset_type_id == int32_type_id) {
+            const offset_string_type_data<int32_t> *d =
+                reinterpret_cast<const offset_string_type_data<int32_t> *>(data);
+            *out_begin = d->begin;
+            *out_end = d->end;
+        } else {
+            const offset_string_type_data<int64_t> *d =
+                reinterpret_cast<const offset_string_type_data<int64_t> *>(data);
+            *out_begin = (intptr_t)d->begin;
+            *out_end = (intptr_t)d->end;
+        }
+    }
+
+    /**
+     * Writes the offsets of a string element, raising an error if they
+     * don't fit in the offset type.
+     */
+    void set_offsets(char *data, intptr_t begin, intptr_t end) const;
+
+    void get_string_range(const char **out_begin, const char **out_end,
+                          const char *arrmeta, const char *data) const;
+    void set_from_utf8_string(const char *arrmeta, char *dst,
+                              const char *utf8_begin, const char *utf8_end,
+                              const eval::eval_context *ectx) const;
+
+    void print_data(std::ostream& o, const char *arrmeta, const char *data) const;
+
+    void print_type(std::ostream& o) const;
+
+    bool is_unique_data_owner(const char *arrmeta) const;
+    ndt::type get_canonical_type() const;
+
+    void get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape, const char *arrmeta, const char *data) const;
+
+    bool is_lossless_assignment(const ndt::type& dst_tp, const ndt::type& src_tp) const;
+
+    bool operator==(const base_type& rhs) const;
+
+    void arrmeta_default_construct(char *arrmeta, bool blockref_alloc) const;
+    void arrmeta_copy_construct(char *dst_arrmeta, const char *src_arrmeta, memory_block_data *embedded_reference) const;
+    void arrmeta_reset_buffers(char *arrmeta) const;
+    void arrmeta_finalize_buffers(char *arrmeta) const;
+    void arrmeta_destruct(char *arrmeta) const;
+    void arrmeta_debug_print(const char *arrmeta, std::ostream& o, const std::string& indent) const;
+
+    size_t make_assignment_kernel(void *ckb, intptr_t ckb_offset,
+                                  const ndt::type &dst_tp,
+                                  const char *dst_arrmeta,
+                                  const ndt::type &src_tp,
+                                  const char *src_arrmeta,
+                                  kernel_request_t kernreq,
+                                  const eval::eval_context *ectx) const;
+
+    size_t make_comparison_kernel(
+                    void *ckb, intptr_t ckb_offset,
+                    const ndt::type& src0_dt, const char *src0_arrmeta,
+                    const ndt::type& src1_dt, const char *src1_arrmeta,
+                    comparison_type_t comptype,
+                    const eval::eval_context *ectx) const;
+
+    void make_string_iter(dim_iter *out_di, string_encoding_t encoding,
+            const char *arrmeta, const char *data,
+            const memory_block_ptr& ref,
+            intptr_t buffer_max_mem,
+            const eval::eval_context *ectx) const;
+
+    nd::array get_option_nafunc() const;
+};
+
+namespace ndt {
+  /**
+   * Returns type "offset_string[<encoding>, <offset type>]", where the
+   * offset type is int32_type_id or int64_type_id.
+   */
+  inline ndt::type
+  make_offset_string(string_encoding_t encoding = string_encoding_utf_8,
+                     type_id_t offset_type_id = int32_type_id)
+  {
+    return ndt::type(new offset_string_type(encoding, offset_type_id), false);
+  }
+} // namespace ndt
+
+} // namespace dynd
@@ -54,6 +54,10 @@ public:
         return m_property_name;
     }
 
+    inline size_t get_property_index() const {
+        return m_property_index;
+    }
+
     const ndt::type& get_value_type() const {
         return m_value_tp;
     }
@@ -172,6 +172,9 @@ enum type_id_t {
     // for the purpose of broadcasting together named ellipsis type vars.
     dim_fragment_type_id,
 
+    // A string stored as offsets into a contiguous character buffer
+    offset_string_type_id,
+
     // The number of built-in, atomic types (including uninitialized and void)
     builtin_type_id_count = 19
 };
@@ -155,6 +155,81 @@ namespace ndt {
      */
     void var_dim_element_resize(const type& tp,
             const char *arrmeta, char *data, intptr_t count);
+
+    /**
+     * Allocates the data of many var dim elements which share one
+     * arrmeta, carving them back to back out of large blocks of the
+     * arrmeta's memory block instead of making an allocator call per
+     * element. The type and memory block are checked once, when the
+     * builder is constructed, and the blocks grow geometrically.
+     *
+     * While the builder is active, nothing else may allocate from the
+     * same memory block. ``finish``, which the destructor also calls,
+     * gives the unused tail of the current block back to it.
+     */
+    class var_dim_builder {
+        memory_block_data *m_memblock;
+        memory_block_pod_allocator_api *m_pod_api;
+        memory_block_objectarray_allocator_api *m_objectarray_api;
+        intptr_t m_stride;
+        size_t m_alignment;
+        char *m_block_begin, *m_block_end, *m_cursor;
+        intptr_t m_block_capacity;
+        // The pending allocation from ``open`` for object arrays
+        char *m_open_begin;
+
+        void grow(intptr_t size_bytes);
+        void reserve_bytes(intptr_t size_bytes);
+
+        // Non-copyable
+        var_dim_builder(const var_dim_builder&);
+        var_dim_builder& operator=(const var_dim_builder&);
+    public:
+        /**
+         * \param tp  This must be a var_dim type.
+         * \param arrmeta  Arrmeta for `tp`, with a writable memory block.
+         */
+        var_dim_builder(const type& tp, const char *arrmeta);
+
+        ~var_dim_builder();
+
+        /**
+         * Makes sure that ``count`` more elements in total fit without
+         * another allocation, typically with the total from a counting pass.
+         */
+        void reserve(intptr_t count);
+
+        /**
+         * Initializes the var dim element at ``data``, which must be NULL,
+         * with ``count`` elements, returning the pointer to them.
+         */
+        char *append(char *data, intptr_t count);
+
+        /**
+         * Initializes ``n`` var dim elements, at ``data`` with stride
+         * ``data_stride``, with the sizes ``counts``, using one allocation.
+         */
+        void append_all(char *data, intptr_t data_stride, intptr_t n,
+                        const intptr_t *counts);
+
+        /**
+         * Returns space for up to ``max_count`` elements, for producers
+         * which only know the size after filling them in. A call to
+         * ``close`` must follow before any other builder call.
+         */
+        char *open(intptr_t max_count);
+
+        /**
+         * Initializes the var dim element at ``data``, which must be NULL,
+         * with the first ``count`` elements of the space from ``open``.
+         */
+        void close(char *data, intptr_t count);
+
+        /**
+         * Returns the unused part of the current block to the memory block.
+         */
+        void finish();
+    };
 } // namespace ndt
 
 } // namespace dynd
@@ -3,6 +3,16 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 #include <dynd/dim_iter.hpp>
 #include <dynd/array.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
@@ -96,29 +106,51 @@ static void buffered_strided_dim_iter_destructor(dim_iter *self)
 {
     // Free the reference of the element type
     base_type_xdecref(self->eltype);
+    // Free the ckernel which copies data to the buffer
+    delete reinterpret_cast<ckernel_builder<kernel_request_host> *>(self->custom[4]);
     // Free the reference owning the temporary buffer
-    memory_block_data *memblock = reinterpret_cast<memory_block_data *>(self->custom[2]);
+    memory_block_data *memblock = reinterpret_cast<memory_block_data *>(self->custom[5]);
     if (memblock != NULL) {
         memory_block_decref(memblock);
     }
     // Free the reference owning the data
-    memblock = reinterpret_cast<memory_block_data *>(self->custom[3]);
+    memblock = reinterpret_cast<memory_block_data *>(self->custom[6]);
     if (memblock != NULL) {
         memory_block_decref(memblock);
     }
 }
 
+/**
+ * Converts ``count`` elements starting at ``src`` into the buffer ``buf``
+ * with the ckernel ``ckb`` made for it.
+ */
+static void fill_dim_iter_buffer(nd::array& buf, ckernel_builder<kernel_request_host> *ckb,
+                                 const char *src, intptr_t src_stride, intptr_t count)
+{
+    const fixed_dim_type_arrmeta *md =
+        reinterpret_cast<const fixed_dim_type_arrmeta *>(buf.get_arrmeta());
+    if (!buf.get_type().is_builtin()) {
+        // For types with block references, need to reset the buffers each time
+        // we fill buf with data.
+        buf.get_type().extended()->arrmeta_reset_buffers(buf.get_arrmeta());
+    }
+    // If the type needs it, initialize the buffer data to zero
+    const ndt::type& el_tp = buf.get_type().extended<fixed_dim_type>()->get_element_type();
+    if (!el_tp.is_builtin() && (el_tp.get_flags() & type_flag_zeroinit) != 0) {
+        memset(buf.get_readwrite_originptr(), 0, count * md->stride);
+    }
+    ckernel_prefix *kdp = ckb->get();
+    expr_strided_t fn = kdp->get_function<expr_strided_t>();
+    fn(buf.get_readwrite_originptr(), md->stride, const_cast<char **>(&src),
+       &src_stride, count, kdp);
+}
+
 static int buffered_strided_dim_iter_next(dim_iter *self)
 {
     intptr_t i = static_cast<intptr_t>(self->custom[0]);
     intptr_t size = static_cast<intptr_t>(self->custom[1]);
     if (i < size) {
         nd::array buf(memory_block_ptr(reinterpret_cast<memory_block_data *>(self->custom[5]), true));
-        if (!buf.get_type().is_builtin()) {
-            // For types with block references, need to reset the buffers each time
-            // we fill buf with data.
-            buf.get_type().extended()->arrmeta_reset_buffers(buf.get_arrmeta());
-        }
         // Figure out how many elements we will buffer
         intptr_t bufsize = reinterpret_cast<const fixed_dim_type_arrmeta *>(
                                buf.get_arrmeta())->dim_size;
@@ -131,11 +163,7 @@ static int buffered_strided_dim_iter_next(dim_iter *self)
         const char *data_ptr = reinterpret_cast<const char *>(self->custom[2]);
         intptr_t stride = static_cast<intptr_t>(self->custom[3]);
         ckernel_builder<kernel_request_host> *ckb = reinterpret_cast<ckernel_builder<kernel_request_host> *>(self->custom[4]);
-        ckernel_prefix *kdp = ckb->get();
-        expr_strided_t fn = kdp->get_function<expr_strided_t>();
-        const char *child_data_ptr = data_ptr + i * stride;
-        fn(buf.get_readwrite_originptr(), self->data_stride, const_cast<char **>(&child_data_ptr),
-           &stride, bufsize, kdp);
+        fill_dim_iter_buffer(buf, ckb, data_ptr + i * stride, stride, bufsize);
         // Update the dim_iter's size
         self->data_elcount = bufsize;
         return 1;
@@ -159,35 +187,47 @@ static dim_iter_vtable buffered_strided_dim_iter_vt = {
     buffered_strided_dim_iter_seek
 };
 
-void dynd::make_buffered_strided_dim_iter(
-    dim_iter *out_di,
-    const ndt::type& val_tp,
-    const ndt::type& mem_tp, const char *mem_arrmeta,
-    const char *data_ptr, intptr_t size, intptr_t stride,
-    const memory_block_ptr& ref, intptr_t buffer_max_mem,
-    const eval::eval_context *ectx)
+/**
+ * The number of elements a dim_iter buffer of at most
+ * buffer_max_mem bytes holds.
+ */
+static intptr_t get_dim_iter_buffer_elcount(const ndt::type& mem_tp,
+                                            intptr_t size,
+                                            intptr_t buffer_max_mem)
 {
-    if (val_tp == mem_tp) {
-        // If no buffering is needed, ust the straight strided iter
-        make_strided_dim_iter(out_di, mem_tp, mem_arrmeta,
-                data_ptr, size, stride, ref);
-        return;
-    }
-    // Allocate the temporary buffer
     intptr_t buffer_elcount = buffer_max_mem;
     intptr_t buffer_data_size = mem_tp.get_data_size();
-    intptr_t buffer_ndim = mem_tp.get_ndim() + 1;
-    dimvector buffer_shape(buffer_ndim);
     if (!mem_tp.is_builtin()) {
-        // Get the shape from mem_tp/mem_meta
-        mem_tp.extended()->get_shape(buffer_ndim - 1, 0, buffer_shape.get() + 1, mem_arrmeta, NULL);
         buffer_data_size = mem_tp.extended()->get_default_data_size();
     }
     buffer_elcount /= buffer_data_size;
     if (buffer_elcount >= size) {
         buffer_elcount = size;
+    } else if (buffer_elcount < 1) {
+        buffer_elcount = 1;
+    }
+    return buffer_elcount;
+}
+
+/**
+ * Allocates a buffer of at most ``buffer_max_mem`` bytes for elements of
+ * ``val_tp``, laid out to match ``mem_tp``, and makes the ckernel in
+ * ``ckb`` which copies ``mem_tp`` elements into it.
+ */
+static nd::array make_dim_iter_buffer(
+    const ndt::type& val_tp,
+    const ndt::type& mem_tp, const char *mem_arrmeta,
+    intptr_t size, intptr_t buffer_max_mem,
+    ckernel_builder<kernel_request_host> *ckb,
+    const eval::eval_context *ectx)
+{
+    intptr_t buffer_ndim = mem_tp.get_ndim() + 1;
+    dimvector buffer_shape(buffer_ndim);
+    if (!mem_tp.is_builtin() && buffer_ndim > 1) {
+        // Get the shape from mem_tp/mem_meta
+        mem_tp.extended()->get_shape(buffer_ndim - 1, 0, buffer_shape.get() + 1, mem_arrmeta, NULL);
     }
-    buffer_shape[0] = buffer_elcount;
+    buffer_shape[0] = get_dim_iter_buffer_elcount(mem_tp, size, buffer_max_mem);
     nd::array buf = nd::dtyped_empty(buffer_ndim, buffer_shape.get(), val_tp);
     if (buffer_ndim > 2 && val_tp.get_type_id() == fixed_dim_type_id) {
         // Reorder the strides to preserve F-order if it's a strided array
@@ -195,13 +235,35 @@ void dynd::make_buffered_strided_dim_iter(
             buf.get_arrmeta() + sizeof(fixed_dim_type_arrmeta), mem_tp,
             mem_arrmeta);
     }
-    intptr_t buffer_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(
-                                 buf.get_arrmeta())->stride;
     // Make the ckernel that copies data to the buffer
-    ckernel_builder<kernel_request_host> k;
-    make_assignment_kernel(&k, 0, val_tp,
+    make_assignment_kernel(ckb, 0, val_tp,
                            buf.get_arrmeta() + sizeof(fixed_dim_type_arrmeta),
                            mem_tp, mem_arrmeta, kernel_request_strided, ectx);
+    return buf;
+}
+
+void dynd::make_buffered_strided_dim_iter(
+    dim_iter *out_di,
+    const ndt::type& val_tp,
+    const ndt::type& mem_tp, const char *mem_arrmeta,
+    const char *data_ptr, intptr_t size, intptr_t stride,
+    const memory_block_ptr& ref, intptr_t buffer_max_mem,
+    const eval::eval_context *ectx)
+{
+    if (val_tp == mem_tp) {
+        // If no buffering is needed, ust the straight strided iter
+        make_strided_dim_iter(out_di, mem_tp, mem_arrmeta,
+                data_ptr, size, stride, ref);
+        return;
+    }
+    // Allocate the temporary buffer
+    ckernel_builder<kernel_request_host> k;
+    nd::array buf = make_dim_iter_buffer(val_tp, mem_tp, mem_arrmeta, size,
+                                         buffer_max_mem, &k, ectx);
+    intptr_t buffer_elcount = reinterpret_cast<const fixed_dim_type_arrmeta *>(
+                                  buf.get_arrmeta())->dim_size;
+    intptr_t buffer_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(
+                                 buf.get_arrmeta())->stride;
 
     if (buffer_elcount == size) {
         // If the buffer is big enough for all the data, just make a copy and
@@ -243,3 +305,238 @@ void dynd::make_buffered_strided_dim_iter(
         out_di->custom[6] = 0;
     }
 }
+
+////////////////////////////////
+// Implementation of the asynchronous buffered strided dim iter.
+
+namespace {
+    struct async_buffer {
+        nd::array buf;
+        ckernel_builder<kernel_request_host> ckb;
+    };
+
+    struct async_chunk {
+        int buffer;
+        intptr_t count;
+    };
+
+    /**
+     * State shared by an asynchronous buffered dim_iter and its helper
+     * thread. Buffers move from ``free_buffers`` to the helper thread,
+     * which fills one with the next chunk and appends it to ``ready``,
+     * and then to the consumer, which holds one chunk between calls to
+     * ``next`` and returns it to ``free_buffers`` on the following call.
+     */
+    struct async_dim_iter_state {
+        const char *data_ptr;
+        intptr_t size, stride;
+        intptr_t buffer_elcount, buffer_stride;
+        memory_block_ptr ref;
+        std::unique_ptr<async_buffer[]> buffers;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        vector<int> free_buffers;
+        std::deque<async_chunk> ready;
+        // The index of the next element the helper thread converts
+        intptr_t next_index;
+        // The number of chunks the helper thread is converting
+        int in_flight;
+        // Incremented by each seek, so chunks converted for an
+        // earlier position get dropped
+        uint64_t generation;
+        // The buffer the consumer holds, or -1
+        int held_buffer;
+        // An exception from converting the chunk after the ready ones
+        std::exception_ptr error;
+        bool stop;
+        std::thread worker;
+    };
+} // anonymous namespace
+
+static void async_dim_iter_worker(async_dim_iter_state *st)
+{
+    std::unique_lock<std::mutex> lock(st->mutex);
+    for (;;) {
+        st->cv.wait(lock, [st] {
+            return st->stop || (!st->error && st->next_index < st->size &&
+                                !st->free_buffers.empty());
+        });
+        if (st->stop) {
+            return;
+        }
+        int b = st->free_buffers.back();
+        st->free_buffers.pop_back();
+        intptr_t i = st->next_index;
+        intptr_t count = std::min(st->buffer_elcount, st->size - i);
+        st->next_index = i + count;
+        uint64_t generation = st->generation;
+        ++st->in_flight;
+        lock.unlock();
+
+        // Convert the chunk without holding the lock
+        std::exception_ptr error;
+        try {
+            fill_dim_iter_buffer(st->buffers[b].buf, &st->buffers[b].ckb,
+                                 st->data_ptr + i * st->stride, st->stride, count);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        --st->in_flight;
+        if (generation != st->generation || error) {
+            st->free_buffers.push_back(b);
+            if (generation == st->generation) {
+                st->error = error;
+            }
+        } else {
+            async_chunk c = {b, count};
+            st->ready.push_back(c);
+        }
+        st->cv.notify_all();
+    }
+}
+
+static async_dim_iter_state *get_async_state(dim_iter *self)
+{
+    return reinterpret_cast<async_dim_iter_state *>(self->custom[0]);
+}
+
+static void async_buffered_strided_dim_iter_destructor(dim_iter *self)
+{
+    async_dim_iter_state *st = get_async_state(self);
+    {
+        std::lock_guard<std::mutex> lock(st->mutex);
+        st->stop = true;
+    }
+    st->cv.notify_all();
+    st->worker.join();
+    delete st;
+    // Free the reference of the element type
+    base_type_xdecref(self->eltype);
+}
+
+static int async_buffered_strided_dim_iter_next(dim_iter *self)
+{
+    async_dim_iter_state *st = get_async_state(self);
+    std::unique_lock<std::mutex> lock(st->mutex);
+    // Hand the chunk from the previous call back to the helper thread
+    if (st->held_buffer >= 0) {
+        st->free_buffers.push_back(st->held_buffer);
+        st->held_buffer = -1;
+        st->cv.notify_all();
+    }
+    st->cv.wait(lock, [st] {
+        return !st->ready.empty() || st->error ||
+               (st->next_index >= st->size && st->in_flight == 0);
+    });
+    if (!st->ready.empty()) {
+        async_chunk c = st->ready.front();
+        st->ready.pop_front();
+        st->held_buffer = c.buffer;
+        const nd::array &buf = st->buffers[c.buffer].buf;
+        self->data_ptr = buf.get_readonly_originptr();
+        self->el_arrmeta = buf.get_arrmeta() + sizeof(fixed_dim_type_arrmeta);
+        self->data_elcount = c.count;
+        return 1;
+    }
+    self->data_elcount = 0;
+    if (st->error) {
+        std::rethrow_exception(st->error);
+    }
+    return 0;
+}
+
+static void async_buffered_strided_dim_iter_seek(dim_iter *self, intptr_t i)
+{
+    async_dim_iter_state *st = get_async_state(self);
+    {
+        std::lock_guard<std::mutex> lock(st->mutex);
+        // Drop everything converted for the previous position
+        ++st->generation;
+        st->error = std::exception_ptr();
+        for (size_t j = 0; j < st->ready.size(); ++j) {
+            st->free_buffers.push_back(st->ready[j].buffer);
+        }
+        st->ready.clear();
+        if (st->held_buffer >= 0) {
+            st->free_buffers.push_back(st->held_buffer);
+            st->held_buffer = -1;
+        }
+        st->next_index = (i >= 0 && i < st->size) ? i : st->size;
+    }
+    st->cv.notify_all();
+    async_buffered_strided_dim_iter_next(self);
+}
+
+static dim_iter_vtable async_buffered_strided_dim_iter_vt = {
+    async_buffered_strided_dim_iter_destructor,
+    async_buffered_strided_dim_iter_next,
+    async_buffered_strided_dim_iter_seek
+};
+
+void dynd::make_async_buffered_strided_dim_iter(
+    dim_iter *out_di,
+    const ndt::type& val_tp,
+    const ndt::type& mem_tp, const char *mem_arrmeta,
+    const char *data_ptr, intptr_t size, intptr_t stride,
+    const memory_block_ptr& ref, intptr_t buffer_max_mem,
+    intptr_t queue_depth, const eval::eval_context *ectx)
+{
+    if (queue_depth < 1) {
+        stringstream ss;
+        ss << "make_async_buffered_strided_dim_iter: queue_depth must be at least 1, got " << queue_depth;
+        throw invalid_argument(ss.str());
+    }
+    if (val_tp == mem_tp) {
+        // If no buffering is needed, ust the straight strided iter
+        make_strided_dim_iter(out_di, mem_tp, mem_arrmeta,
+                data_ptr, size, stride, ref);
+        return;
+    }
+
+    if (get_dim_iter_buffer_elcount(mem_tp, size, buffer_max_mem) == size) {
+        // All the data fits in one buffer, so there is nothing to overlap
+        make_buffered_strided_dim_iter(out_di, val_tp, mem_tp, mem_arrmeta,
+                data_ptr, size, stride, ref, buffer_max_mem, ectx);
+        return;
+    }
+
+    std::unique_ptr<async_dim_iter_state> st(new async_dim_iter_state);
+    intptr_t buffer_count = queue_depth + 1;
+    st->buffers.reset(new async_buffer[buffer_count]);
+    for (intptr_t j = 0; j < buffer_count; ++j) {
+        st->buffers[j].buf = make_dim_iter_buffer(val_tp, mem_tp, mem_arrmeta, size,
+                                                  buffer_max_mem, &st->buffers[j].ckb, ectx);
+        st->free_buffers.push_back(static_cast<int>(buffer_count - 1 - j));
+    }
+    const nd::array &buf = st->buffers[0].buf;
+    st->buffer_elcount = reinterpret_cast<const fixed_dim_type_arrmeta *>(
+                             buf.get_arrmeta())->dim_size;
+    st->buffer_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(
+                            buf.get_arrmeta())->stride;
+    st->data_ptr = data_ptr;
+    st->size = size;
+    st->stride = stride;
+    st->ref = ref;
+    st->next_index = 0;
+    st->in_flight = 0;
+    st->generation = 0;
+    st->held_buffer = -1;
+    st->stop = false;
+    // Start converting the first chunks right away
+    st->worker = std::thread(async_dim_iter_worker, st.get());
+
+    out_di->vtable = &async_buffered_strided_dim_iter_vt;
+    out_di->data_ptr = buf.get_readonly_originptr();
+    out_di->data_elcount = 0;
+    out_di->data_stride = st->buffer_stride;
+    out_di->flags = dim_iter_restartable | dim_iter_seekable;
+    if ((intptr_t)buf.get_dtype().get_data_size() == st->buffer_stride) {
+        out_di->flags |= dim_iter_contiguous;
+    }
+    out_di->eltype = ndt::type(val_tp).release();
+    out_di->el_arrmeta = buf.get_arrmeta() + sizeof(fixed_dim_type_arrmeta);
+    out_di->custom[0] = reinterpret_cast<uintptr_t>(st.release());
+}
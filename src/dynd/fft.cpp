@@ -3,9 +3,15 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <algorithm>
+#include <complex>
 #include <map>
+#include <memory>
+#include <mutex>
 
 #include <dynd/fft.hpp>
+#include <dynd/parallel.hpp>
+#include <dynd/shortvector.hpp>
 #include <dynd/func/take_arrfunc.hpp>
 
 using namespace std;
@@ -23,6 +29,8 @@ typedef map<key_type, void *> plans_map_type;
 // that it has no state that must be initialized prior to the
 // fft_init call.
 static plans_map_type *plans;
+// FFTW planning is not thread-safe, and neither is the map
+static std::mutex plans_mutex;
 
 }} // namespace dynd::fftw
 
@@ -59,6 +67,7 @@ void init::fft_cleanup()
 #define FFTW_FFTPLAN_C2C(LIB, REAL_TYPE, SRC_ID, DST_ID) \
     LIB##_plan dynd::fftw::fftplan(vector<intptr_t> shape, vector<intptr_t> axes, LIB##_complex *src, vector<intptr_t> src_strides, \
                                    LIB##_complex *dst, vector<intptr_t> dst_strides, int sign, unsigned int flags, bool overwrite) { \
+        std::lock_guard<std::mutex> lock(plans_mutex); \
         key_type key(shape, axes, SRC_ID, src_strides, LIB##_alignment_of(reinterpret_cast<REAL_TYPE *>(src)), \
             DST_ID, dst_strides, LIB##_alignment_of(reinterpret_cast<REAL_TYPE *>(dst)), sign, flags); \
         plans_map_type::iterator it = plans->find(key); \
@@ -107,6 +116,7 @@ FFTW_FFTPLAN_C2C(fftw, double, complex_float64_type_id, complex_float64_type_id)
 #define FFTW_FFTPLAN_R2C(LIB, REAL_TYPE, SRC_ID, DST_ID) \
     LIB##_plan dynd::fftw::fftplan(vector<intptr_t> shape, REAL_TYPE *src, vector<intptr_t> src_strides, \
                                   LIB##_complex *dst, vector<intptr_t> dst_strides, unsigned int flags, bool overwrite) { \
+        std::lock_guard<std::mutex> lock(plans_mutex); \
         key_type key(shape, shape, SRC_ID, src_strides, LIB##_alignment_of(reinterpret_cast<REAL_TYPE *>(src)), \
             DST_ID, dst_strides, LIB##_alignment_of(reinterpret_cast<REAL_TYPE *>(dst)), FFTW_FORWARD, flags); \
         plans_map_type::iterator it = plans->find(key); \
@@ -142,6 +152,7 @@ FFTW_FFTPLAN_R2C(fftw, double, float64_type_id, complex_float64_type_id)
 #define FFTW_FFTPLAN_C2R(LIB, REAL_TYPE, SRC_ID, DST_ID) \
     LIB##_plan dynd::fftw::fftplan(vector<intptr_t> shape, LIB##_complex *src, vector<intptr_t> src_strides, \
                                   REAL_TYPE *dst, vector<intptr_t> dst_strides, unsigned int flags, bool overwrite) { \
+        std::lock_guard<std::mutex> lock(plans_mutex); \
         key_type key(shape, shape, SRC_ID, src_strides, LIB##_alignment_of(reinterpret_cast<REAL_TYPE *>(src)), \
             DST_ID, dst_strides, LIB##_alignment_of(reinterpret_cast<REAL_TYPE *>(dst)), FFTW_BACKWARD, flags); \
         plans_map_type::iterator it = plans->find(key); \
@@ -375,6 +386,609 @@ nd::array dynd::fftw::irfft(const nd::array &x, vector<intptr_t> shape, unsigned
 
 #endif // DYND_FFTW
 
+namespace {
+
+/**
+ * Complex multiply without the NaN/Inf recovery that std::complex's
+ * operator* does, so the butterflies stay branch free.
+ */
+template <typename T>
+inline complex<T> cmul(const complex<T> &a, const complex<T> &b)
+{
+    return complex<T>(a.real() * b.real() - a.imag() * b.imag(),
+                      a.real() * b.imag() + a.imag() * b.real());
+}
+
+template <typename T>
+inline complex<T> unit_root(intptr_t k, intptr_t n, int sign)
+{
+    // Computed in double so that float plans get correctly rounded twiddles
+    double theta = sign * 2 * 3.14159265358979323846 * (static_cast<double>(k) / n);
+    return complex<T>(static_cast<T>(cos(theta)), static_cast<T>(sin(theta)));
+}
+
+/**
+ * A plan for an unnormalized 1D complex DFT of length n, with
+ * exponent sign ``sign``. Lengths of the form 2^a 3^b 5^c are computed
+ * with recursive out-of-place Cooley-Tukey butterflies of radix
+ * 4, 2, 3 and 5, and all other lengths use Bluestein's algorithm.
+ */
+template <typename T>
+class complex_fft_plan {
+    intptr_t m_n;
+    int m_sign;
+    // Pairs of (radix, remaining length) for each stage
+    vector<intptr_t> m_factors;
+    vector<complex<T> > m_twiddles;
+
+    // Bluestein's algorithm, used when m_factors is empty and m_n > 1
+    intptr_t m_bluestein_size;
+    std::shared_ptr<const complex_fft_plan> m_bluestein_plan;
+    vector<complex<T> > m_chirp, m_chirp_fft;
+
+    void butterfly2(complex<T> *out, intptr_t fstride, intptr_t m) const
+    {
+        const complex<T> *tw = &m_twiddles[0];
+        for (intptr_t k = 0; k < m; ++k, tw += fstride) {
+            complex<T> t = cmul(out[k + m], *tw);
+            out[k + m] = out[k] - t;
+            out[k] += t;
+        }
+    }
+
+    void butterfly3(complex<T> *out, intptr_t fstride, intptr_t m) const
+    {
+        T epi3 = m_twiddles[fstride * m].imag();
+        const complex<T> *tw1 = &m_twiddles[0], *tw2 = &m_twiddles[0];
+        for (intptr_t k = 0; k < m; ++k, tw1 += fstride, tw2 += 2 * fstride) {
+            complex<T> s1 = cmul(out[k + m], *tw1);
+            complex<T> s2 = cmul(out[k + 2 * m], *tw2);
+            complex<T> s3 = s1 + s2, s0 = (s1 - s2) * epi3;
+            complex<T> a = out[k] - s3 * static_cast<T>(0.5);
+            out[k] += s3;
+            out[k + m] = complex<T>(a.real() - s0.imag(), a.imag() + s0.real());
+            out[k + 2 * m] = complex<T>(a.real() + s0.imag(), a.imag() - s0.real());
+        }
+    }
+
+    void butterfly4(complex<T> *out, intptr_t fstride, intptr_t m) const
+    {
+        const complex<T> *tw = &m_twiddles[0];
+        for (intptr_t k = 0; k < m; ++k) {
+            complex<T> s0 = cmul(out[k + m], tw[k * fstride]);
+            complex<T> s1 = cmul(out[k + 2 * m], tw[2 * k * fstride]);
+            complex<T> s2 = cmul(out[k + 3 * m], tw[3 * k * fstride]);
+            complex<T> s5 = out[k] - s1;
+            out[k] += s1;
+            complex<T> s3 = s0 + s2, s4 = s0 - s2;
+            out[k + 2 * m] = out[k] - s3;
+            out[k] += s3;
+            if (m_sign < 0) {
+                out[k + m] = complex<T>(s5.real() + s4.imag(), s5.imag() - s4.real());
+                out[k + 3 * m] = complex<T>(s5.real() - s4.imag(), s5.imag() + s4.real());
+            } else {
+                out[k + m] = complex<T>(s5.real() - s4.imag(), s5.imag() + s4.real());
+                out[k + 3 * m] = complex<T>(s5.real() + s4.imag(), s5.imag() - s4.real());
+            }
+        }
+    }
+
+    void butterfly5(complex<T> *out, intptr_t fstride, intptr_t m) const
+    {
+        const complex<T> *tw = &m_twiddles[0];
+        complex<T> ya = m_twiddles[fstride * m], yb = m_twiddles[2 * fstride * m];
+        for (intptr_t k = 0; k < m; ++k) {
+            complex<T> s0 = out[k];
+            complex<T> s1 = cmul(out[k + m], tw[k * fstride]);
+            complex<T> s2 = cmul(out[k + 2 * m], tw[2 * k * fstride]);
+            complex<T> s3 = cmul(out[k + 3 * m], tw[3 * k * fstride]);
+            complex<T> s4 = cmul(out[k + 4 * m], tw[4 * k * fstride]);
+            complex<T> s7 = s1 + s4, s10 = s1 - s4, s8 = s2 + s3, s9 = s2 - s3;
+
+            out[k] = s0 + s7 + s8;
+            complex<T> s5(s0.real() + s7.real() * ya.real() + s8.real() * yb.real(),
+                          s0.imag() + s7.imag() * ya.real() + s8.imag() * yb.real());
+            complex<T> s6(s10.imag() * ya.imag() + s9.imag() * yb.imag(),
+                          -s10.real() * ya.imag() - s9.real() * yb.imag());
+            out[k + m] = s5 - s6;
+            out[k + 4 * m] = s5 + s6;
+            complex<T> s11(s0.real() + s7.real() * yb.real() + s8.real() * ya.real(),
+                           s0.imag() + s7.imag() * yb.real() + s8.imag() * ya.real());
+            complex<T> s12(-s10.imag() * yb.imag() + s9.imag() * ya.imag(),
+                           s10.real() * yb.imag() - s9.real() * ya.imag());
+            out[k + 2 * m] = s11 + s12;
+            out[k + 3 * m] = s11 - s12;
+        }
+    }
+
+    void work(complex<T> *out, const complex<T> *in, intptr_t fstride,
+              intptr_t in_stride, const intptr_t *factors) const
+    {
+        intptr_t p = factors[0], m = factors[1];
+        if (m == 1) {
+            for (intptr_t j = 0; j < p; ++j, in += fstride * in_stride) {
+                out[j] = *in;
+            }
+        } else {
+            for (intptr_t j = 0; j < p; ++j, in += fstride * in_stride) {
+                work(out + j * m, in, fstride * p, in_stride, factors + 2);
+            }
+        }
+
+        switch (p) {
+        case 2:
+            butterfly2(out, fstride, m);
+            break;
+        case 3:
+            butterfly3(out, fstride, m);
+            break;
+        case 4:
+            butterfly4(out, fstride, m);
+            break;
+        default:
+            butterfly5(out, fstride, m);
+            break;
+        }
+    }
+
+public:
+    complex_fft_plan(intptr_t n, int sign);
+
+    intptr_t get_size() const {
+        return m_n;
+    }
+
+    /**
+     * The number of complex elements of scratch space ``execute`` needs.
+     */
+    intptr_t get_scratch_size() const {
+        return m_factors.empty() && m_n > 1 ? 2 * m_bluestein_size : 0;
+    }
+
+    /**
+     * Transforms the n elements at in[0], in[in_stride], ... into the
+     * contiguous, non-overlapping output ``out``.
+     */
+    void execute(const complex<T> *in, intptr_t in_stride, complex<T> *out,
+                 complex<T> *scratch) const;
+};
+
+template <typename T>
+complex_fft_plan<T>::complex_fft_plan(intptr_t n, int sign)
+    : m_n(n), m_sign(sign), m_bluestein_size(0)
+{
+    intptr_t remaining = n;
+    static const intptr_t radices[4] = {4, 2, 3, 5};
+    for (int i = 0; i < 4; ++i) {
+        while (remaining > 1 && remaining % radices[i] == 0) {
+            remaining /= radices[i];
+            m_factors.push_back(radices[i]);
+            m_factors.push_back(remaining);
+        }
+    }
+
+    if (remaining == 1) {
+        m_twiddles.resize(n);
+        for (intptr_t k = 0; k < n; ++k) {
+            m_twiddles[k] = unit_root<T>(k, n, sign);
+        }
+    } else {
+        m_factors.clear();
+        m_bluestein_size = 1;
+        while (m_bluestein_size < 2 * n - 1) {
+            m_bluestein_size *= 2;
+        }
+        intptr_t bn = m_bluestein_size;
+        m_bluestein_plan.reset(new complex_fft_plan(bn, -1));
+
+        // chirp[k] = exp(sign * pi * i * k^2 / n), with k^2 reduced mod 2n
+        m_chirp.resize(n);
+        for (intptr_t k = 0; k < n; ++k) {
+            intptr_t kk = static_cast<intptr_t>(
+                (static_cast<unsigned long long>(k) * k) % (2 * n));
+            m_chirp[k] = unit_root<T>(kk, 2 * n, sign);
+        }
+
+        // The transform of the conjugate chirp, wrapped around for negative
+        // offsets, and prescaled by the 1/bn of the inverse transform
+        vector<complex<T> > b(bn);
+        b[0] = conj(m_chirp[0]);
+        for (intptr_t k = 1; k < n; ++k) {
+            b[k] = b[bn - k] = conj(m_chirp[k]);
+        }
+        m_chirp_fft.resize(bn);
+        m_bluestein_plan->execute(&b[0], 1, &m_chirp_fft[0], NULL);
+        for (intptr_t k = 0; k < bn; ++k) {
+            m_chirp_fft[k] /= static_cast<T>(bn);
+        }
+    }
+}
+
+template <typename T>
+void complex_fft_plan<T>::execute(const complex<T> *in, intptr_t in_stride,
+                                  complex<T> *out, complex<T> *scratch) const
+{
+    if (m_n == 1) {
+        out[0] = in[0];
+    } else if (!m_factors.empty()) {
+        work(out, in, 1, in_stride, &m_factors[0]);
+    } else {
+        intptr_t bn = m_bluestein_size;
+        complex<T> *a = scratch, *b = scratch + bn;
+        for (intptr_t j = 0; j < m_n; ++j) {
+            a[j] = cmul(in[j * in_stride], m_chirp[j]);
+        }
+        std::fill(a + m_n, a + bn, complex<T>());
+        m_bluestein_plan->execute(a, 1, b, NULL);
+        // The inverse transform is done as conj(fft(conj(.)))
+        for (intptr_t k = 0; k < bn; ++k) {
+            b[k] = conj(cmul(b[k], m_chirp_fft[k]));
+        }
+        m_bluestein_plan->execute(b, 1, a, NULL);
+        for (intptr_t k = 0; k < m_n; ++k) {
+            out[k] = cmul(conj(a[k]), m_chirp[k]);
+        }
+    }
+}
+
+/**
+ * A plan for the real-to-complex (sign -1) or complex-to-real (sign +1)
+ * DFT of length n, with the n / 2 + 1 non-redundant complex values. Even
+ * lengths pack pairs of reals into a half-length complex transform.
+ */
+template <typename T>
+class real_fft_plan {
+    intptr_t m_n;
+    int m_sign;
+    // The half-length plan for even n, or the full-length plan for odd n
+    std::shared_ptr<const complex_fft_plan<T> > m_plan;
+    vector<complex<T> > m_twiddles;
+
+public:
+    real_fft_plan(intptr_t n, int sign);
+
+    intptr_t get_scratch_size() const {
+        return (m_n % 2 == 0 ? m_n / 2 : 2 * m_n) + m_plan->get_scratch_size();
+    }
+
+    /**
+     * Transforms the n contiguous reals ``in`` into the n / 2 + 1
+     * contiguous complex values ``out``.
+     */
+    void execute_r2c(const T *in, complex<T> *out, complex<T> *scratch) const;
+
+    /**
+     * Transforms the n / 2 + 1 contiguous complex values ``in`` into the
+     * n contiguous reals ``out``.
+     */
+    void execute_c2r(const complex<T> *in, T *out, complex<T> *scratch) const;
+};
+
+template <typename T>
+std::shared_ptr<const complex_fft_plan<T> > get_complex_plan(intptr_t n, int sign);
+
+template <typename T>
+real_fft_plan<T>::real_fft_plan(intptr_t n, int sign)
+    : m_n(n), m_sign(sign)
+{
+    if (n % 2 == 0) {
+        m_plan = get_complex_plan<T>(n / 2, sign);
+        m_twiddles.resize(n / 2 + 1);
+        for (intptr_t k = 0; k <= n / 2; ++k) {
+            m_twiddles[k] = unit_root<T>(k, n, sign);
+        }
+    } else {
+        m_plan = get_complex_plan<T>(n, sign);
+    }
+}
+
+template <typename T>
+void real_fft_plan<T>::execute_r2c(const T *in, complex<T> *out, complex<T> *scratch) const
+{
+    if (m_n % 2 == 0) {
+        intptr_t h = m_n / 2;
+        complex<T> *z = scratch;
+        m_plan->execute(reinterpret_cast<const complex<T> *>(in), 1, z, scratch + h);
+        for (intptr_t k = 0; k <= h; ++k) {
+            complex<T> zk = z[k % h], znk = conj(z[(h - k) % h]);
+            complex<T> e = (zk + znk) * static_cast<T>(0.5);
+            complex<T> d = (zk - znk) * static_cast<T>(0.5);
+            // o = d / i
+            complex<T> o(d.imag(), -d.real());
+            out[k] = e + cmul(m_twiddles[k], o);
+        }
+    } else {
+        complex<T> *a = scratch, *b = scratch + m_n;
+        for (intptr_t j = 0; j < m_n; ++j) {
+            a[j] = complex<T>(in[j], 0);
+        }
+        m_plan->execute(a, 1, b, scratch + 2 * m_n);
+        std::copy(b, b + m_n / 2 + 1, out);
+    }
+}
+
+template <typename T>
+void real_fft_plan<T>::execute_c2r(const complex<T> *in, T *out, complex<T> *scratch) const
+{
+    if (m_n % 2 == 0) {
+        intptr_t h = m_n / 2;
+        complex<T> *z = scratch;
+        for (intptr_t k = 0; k < h; ++k) {
+            complex<T> xk = in[k], xnk = conj(in[h - k]);
+            complex<T> o = cmul(m_twiddles[k], xk - xnk);
+            z[k] = (xk + xnk) + complex<T>(-o.imag(), o.real());
+        }
+        m_plan->execute(z, 1, reinterpret_cast<complex<T> *>(out), scratch + h);
+    } else {
+        complex<T> *a = scratch, *b = scratch + m_n;
+        intptr_t h = m_n / 2;
+        a[0] = complex<T>(in[0].real(), 0);
+        for (intptr_t k = 1; k <= h; ++k) {
+            a[k] = in[k];
+            a[m_n - k] = conj(in[k]);
+        }
+        m_plan->execute(a, 1, b, scratch + 2 * m_n);
+        for (intptr_t j = 0; j < m_n; ++j) {
+            out[j] = b[j].real();
+        }
+    }
+}
+
+/**
+ * A thread-safe cache of plans keyed by (length, sign). Plans are
+ * immutable once built, so they are shared between threads freely.
+ */
+template <typename PlanType>
+class plan_cache {
+    std::mutex m_mutex;
+    std::map<std::pair<intptr_t, int>, std::shared_ptr<const PlanType> > m_plans;
+
+public:
+    std::shared_ptr<const PlanType> get(intptr_t n, int sign)
+    {
+        std::pair<intptr_t, int> key(n, sign);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            typename std::map<std::pair<intptr_t, int>,
+                              std::shared_ptr<const PlanType> >::iterator it = m_plans.find(key);
+            if (it != m_plans.end()) {
+                return it->second;
+            }
+        }
+
+        // Build outside the lock, since building a plan may need other plans
+        std::shared_ptr<const PlanType> plan(new PlanType(n, sign));
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_plans.insert(std::make_pair(key, plan)).first->second;
+    }
+};
+
+template <typename T>
+std::shared_ptr<const complex_fft_plan<T> > get_complex_plan(intptr_t n, int sign)
+{
+    static plan_cache<complex_fft_plan<T> > cache;
+    return cache.get(n, sign);
+}
+
+template <typename T>
+std::shared_ptr<const real_fft_plan<T> > get_real_plan(intptr_t n, int sign)
+{
+    static plan_cache<real_fft_plan<T> > cache;
+    return cache.get(n, sign);
+}
+
+/**
+ * Picks how many 1D transforms of length n each thread should get at least.
+ */
+inline intptr_t batch_grain_size(intptr_t n)
+{
+    return std::max<intptr_t>(1, 16384 / std::max<intptr_t>(n, 1));
+}
+
+/**
+ * Transforms the C-contiguous array ``data`` with dimensions ``shape``
+ * in place along ``axis``, in parallel over the other dimensions.
+ */
+template <typename T>
+void transform_axis(complex<T> *data, const vector<intptr_t> &shape, intptr_t axis, int sign)
+{
+    intptr_t n = shape[axis];
+    if (n <= 1) {
+        return;
+    }
+    intptr_t inner = 1, outer = 1;
+    for (intptr_t i = 0; i < axis; ++i) {
+        outer *= shape[i];
+    }
+    for (intptr_t i = axis + 1; i < static_cast<intptr_t>(shape.size()); ++i) {
+        inner *= shape[i];
+    }
+
+    std::shared_ptr<const complex_fft_plan<T> > plan = get_complex_plan<T>(n, sign);
+    parallel::parallel_for(outer * inner, parallel::get_num_threads(), batch_grain_size(n),
+        [&](intptr_t, intptr_t begin, intptr_t end) {
+            vector<complex<T> > tmp(n + plan->get_scratch_size());
+            for (intptr_t b = begin; b < end; ++b) {
+                complex<T> *row = data + (b / inner) * n * inner + b % inner;
+                plan->execute(row, inner, &tmp[0], &tmp[0] + n);
+                for (intptr_t j = 0; j < n; ++j) {
+                    row[j * inner] = tmp[j];
+                }
+            }
+        });
+}
+
+/**
+ * Copies ``x`` into a new C-contiguous array of dtype ``dtp`` with the
+ * dimensions ``shape``, truncating or zero-padding each dimension.
+ */
+nd::array resized_copy(const nd::array &x, const vector<intptr_t> &shape, const ndt::type &dtp)
+{
+    intptr_t ndim = shape.size();
+    if (ndim != x.get_ndim()) {
+        stringstream ss;
+        ss << "fft shape has " << ndim << " dimensions, but the array has "
+           << x.get_ndim();
+        throw invalid_argument(ss.str());
+    }
+    nd::array y = nd::dtyped_empty(shape, dtp);
+    vector<intptr_t> x_shape = x.get_shape();
+    shortvector<irange> idx(ndim);
+    bool padded = false;
+    for (intptr_t i = 0; i < ndim; ++i) {
+        if (shape[i] < 0) {
+            throw invalid_argument("fft shape must be non-negative");
+        }
+        padded = padded || shape[i] > x_shape[i];
+        idx[i] = irange(0, std::min(shape[i], x_shape[i]));
+    }
+    if (padded) {
+        y.vals() = 0;
+    }
+    y.at_array(ndim, idx.get(), false).vals() = x.at_array(ndim, idx.get(), false);
+    return y;
+}
+
+template <typename T>
+nd::array native_c2c(const nd::array &x, const vector<intptr_t> &shape,
+                     vector<intptr_t> axes, int sign)
+{
+    nd::array y = resized_copy(x, shape, ndt::make_type<dynd_complex<T> >());
+    complex<T> *data = reinterpret_cast<complex<T> *>(y.get_readwrite_originptr());
+    sort(axes.begin(), axes.end());
+    axes.erase(unique(axes.begin(), axes.end()), axes.end());
+    for (size_t i = 0; i < axes.size(); ++i) {
+        if (axes[i] < 0 || axes[i] >= static_cast<intptr_t>(shape.size())) {
+            stringstream ss;
+            ss << "fft axis " << axes[i] << " is out of bounds for " << shape.size() << " dimensions";
+            throw invalid_argument(ss.str());
+        }
+        transform_axis<T>(data, shape, axes[i], sign);
+    }
+    return y;
+}
+
+template <typename T>
+nd::array native_r2c(const nd::array &x, const vector<intptr_t> &shape)
+{
+    intptr_t ndim = shape.size();
+    if (ndim == 0) {
+        return x.ucast(ndt::make_type<dynd_complex<T> >()).eval();
+    }
+    nd::array src = resized_copy(x, shape, ndt::make_type<T>());
+    intptr_t n = shape[ndim - 1], nc = n / 2 + 1;
+    vector<intptr_t> dst_shape = shape;
+    dst_shape[ndim - 1] = nc;
+    nd::array y = nd::dtyped_empty(dst_shape, ndt::make_type<dynd_complex<T> >());
+
+    const T *src_data = reinterpret_cast<const T *>(src.get_readonly_originptr());
+    complex<T> *dst_data = reinterpret_cast<complex<T> *>(y.get_readwrite_originptr());
+    intptr_t nrows = 1;
+    for (intptr_t i = 0; i < ndim - 1; ++i) {
+        nrows *= shape[i];
+    }
+    if (n > 0) {
+        std::shared_ptr<const real_fft_plan<T> > plan = get_real_plan<T>(n, -1);
+        parallel::parallel_for(nrows, parallel::get_num_threads(), batch_grain_size(n),
+            [&](intptr_t, intptr_t begin, intptr_t end) {
+                vector<complex<T> > scratch(plan->get_scratch_size());
+                for (intptr_t r = begin; r < end; ++r) {
+                    plan->execute_r2c(src_data + r * n, dst_data + r * nc, &scratch[0]);
+                }
+            });
+    }
+
+    for (intptr_t i = 0; i < ndim - 1; ++i) {
+        transform_axis<T>(dst_data, dst_shape, i, -1);
+    }
+    return y;
+}
+
+template <typename T>
+nd::array native_c2r(const nd::array &x, const vector<intptr_t> &shape)
+{
+    intptr_t ndim = shape.size();
+    if (ndim == 0) {
+        return x.p("real").ucast(ndt::make_type<T>()).eval();
+    }
+    intptr_t n = shape[ndim - 1], nc = n / 2 + 1;
+    vector<intptr_t> src_shape = shape;
+    src_shape[ndim - 1] = nc;
+    nd::array src = resized_copy(x, src_shape, ndt::make_type<dynd_complex<T> >());
+    complex<T> *src_data = reinterpret_cast<complex<T> *>(src.get_readwrite_originptr());
+    for (intptr_t i = 0; i < ndim - 1; ++i) {
+        transform_axis<T>(src_data, src_shape, i, 1);
+    }
+
+    nd::array y = nd::dtyped_empty(shape, ndt::make_type<T>());
+    T *dst_data = reinterpret_cast<T *>(y.get_readwrite_originptr());
+    intptr_t nrows = 1;
+    for (intptr_t i = 0; i < ndim - 1; ++i) {
+        nrows *= shape[i];
+    }
+    if (n > 0) {
+        std::shared_ptr<const real_fft_plan<T> > plan = get_real_plan<T>(n, 1);
+        parallel::parallel_for(nrows, parallel::get_num_threads(), batch_grain_size(n),
+            [&](intptr_t, intptr_t begin, intptr_t end) {
+                vector<complex<T> > scratch(plan->get_scratch_size());
+                for (intptr_t r = begin; r < end; ++r) {
+                    plan->execute_c2r(src_data + r * nc, dst_data + r * n, &scratch[0]);
+                }
+            });
+    }
+    return y;
+}
+
+} // anonymous namespace
+
+nd::array dynd::native_fft::fft(const nd::array &x, vector<intptr_t> shape, vector<intptr_t> axes)
+{
+    switch (x.get_dtype().get_type_id()) {
+    case complex_float32_type_id:
+        return native_c2c<float>(x, shape, axes, -1);
+    case complex_float64_type_id:
+        return native_c2c<double>(x, shape, axes, -1);
+    default:
+        throw runtime_error("unsupported type for fft");
+    }
+}
+
+nd::array dynd::native_fft::ifft(const nd::array &x, vector<intptr_t> shape, vector<intptr_t> axes)
+{
+    switch (x.get_dtype().get_type_id()) {
+    case complex_float32_type_id:
+        return native_c2c<float>(x, shape, axes, 1);
+    case complex_float64_type_id:
+        return native_c2c<double>(x, shape, axes, 1);
+    default:
+        throw runtime_error("unsupported type for ifft");
+    }
+}
+
+nd::array dynd::native_fft::rfft(const nd::array &x, vector<intptr_t> shape)
+{
+    switch (x.get_dtype().get_type_id()) {
+    case float32_type_id:
+        return native_r2c<float>(x, shape);
+    case float64_type_id:
+        return native_r2c<double>(x, shape);
+    default:
+        throw runtime_error("unsupported type for rfft");
+    }
+}
+
+nd::array dynd::native_fft::irfft(const nd::array &x, vector<intptr_t> shape)
+{
+    switch (x.get_dtype().get_type_id()) {
+    case complex_float32_type_id:
+        return native_c2r<float>(x, shape);
+    case complex_float64_type_id:
+        return native_c2r<double>(x, shape);
+    default:
+        throw runtime_error("unsupported type for irfft");
+    }
+}
+
 nd::array dynd::fftshift(const nd::array &x) {
     nd::arrfunc take = kernels::make_take_arrfunc();
 
@@ -3,7 +3,10 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <atomic>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <cmath>
 
 #include <dynd/func/arrfunc.hpp>
@@ -11,13 +14,167 @@
 #include <dynd/func/apply_arrfunc.hpp>
 #include <dynd/func/multidispatch_arrfunc.hpp>
 #include <dynd/func/lift_arrfunc.hpp>
+#include <dynd/func/comparison_arrfunc.hpp>
+#include <dynd/func/sort_arrfunc.hpp>
+#include <dynd/func/special_arrfunc.hpp>
+#include <dynd/kernels/math_kernels.hpp>
+#include <dynd/kernels/special_kernels.hpp>
 
 using namespace std;
 using namespace dynd;
 
-// Probably want to use a concurrent_hash_map, like
-// http://www.threadingbuildingblocks.org/docs/help/reference/containers_overview/concurrent_hash_map_cls.htm
-static map<nd::string, nd::arrfunc> *registry;
+namespace dynd { namespace func { namespace detail {
+/**
+ * One registered name. Slots live until arrfunc_registry_cleanup, and
+ * re-registering a name swaps the arrfunc pointer in place, so a slot
+ * resolved once stays valid for handles. A NULL arrfunc means the name
+ * was unregistered.
+ */
+struct regfunction_slot {
+  nd::string name;
+  size_t hash;
+  std::atomic<const nd::arrfunc *> value;
+
+  regfunction_slot(const nd::string &name, size_t hash, const nd::arrfunc *value)
+      : name(name), hash(hash), value(value)
+  {
+  }
+};
+}}} // namespace dynd::func::detail
+
+namespace {
+using func::detail::regfunction_slot;
+
+size_t hash_name(const char *begin, const char *end)
+{
+  // FNV-1a
+  size_t h = static_cast<size_t>(14695981039346656037ULL);
+  for (; begin != end; ++begin) {
+    h = (h ^ static_cast<unsigned char>(*begin)) *
+        static_cast<size_t>(1099511628211ULL);
+  }
+  return h;
+}
+
+/**
+ * Open-addressed hash table of the slots, its size is a power of two.
+ * Slots are shared by every table, and writers insert a new slot into
+ * an empty cell of the current table in place, so readers only ever do
+ * an atomic load followed by a probe. A new table is only made when the
+ * current one doubles in size.
+ */
+struct registry_table {
+  vector<std::atomic<regfunction_slot *> > cells;
+  intptr_t count;
+
+  explicit registry_table(size_t size) : cells(size), count(0)
+  {
+    for (size_t i = 0; i < size; ++i) {
+      cells[i].store(NULL, std::memory_order_relaxed);
+    }
+  }
+
+  regfunction_slot *find(size_t hash, const char *begin, const char *end) const
+  {
+    size_t mask = cells.size() - 1, size = end - begin;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      regfunction_slot *slot = cells[i].load(std::memory_order_acquire);
+      if (slot == NULL) {
+        return NULL;
+      }
+      if (slot->hash == hash &&
+          static_cast<size_t>(slot->name.end() - slot->name.begin()) == size &&
+          memcmp(slot->name.begin(), begin, size) == 0) {
+        return slot;
+      }
+    }
+  }
+
+  bool is_full() const
+  {
+    return 2 * (count + 1) > static_cast<intptr_t>(cells.size());
+  }
+
+  void insert(regfunction_slot *slot)
+  {
+    size_t mask = cells.size() - 1;
+    size_t i = slot->hash & mask;
+    while (cells[i].load(std::memory_order_relaxed) != NULL) {
+      i = (i + 1) & mask;
+    }
+    cells[i].store(slot, std::memory_order_release);
+    ++count;
+  }
+};
+
+/**
+ * Counts the readers inside a lookup, split by the parity of the epoch
+ * they entered in. A writer which has unlinked a table or an arrfunc
+ * advances the epoch, then waits for the readers of the previous
+ * epoch to leave before freeing it. Readers that enter afterwards can
+ * only see what the writer published.
+ */
+struct registry_epoch {
+  std::atomic<unsigned> epoch;
+  std::atomic<intptr_t> readers[2];
+};
+
+static registry_epoch reader_epoch;
+
+class read_guard {
+  unsigned m_parity;
+
+public:
+  read_guard()
+  {
+    for (;;) {
+      unsigned e = reader_epoch.epoch.load();
+      reader_epoch.readers[e & 1].fetch_add(1);
+      // If the epoch moved on, a writer may already be done waiting
+      // for this parity, so enter again under the new epoch
+      if (reader_epoch.epoch.load() == e) {
+        m_parity = e & 1;
+        return;
+      }
+      reader_epoch.readers[e & 1].fetch_sub(1);
+    }
+  }
+
+  ~read_guard() { reader_epoch.readers[m_parity].fetch_sub(1); }
+};
+
+/**
+ * Waits until no reader can still see anything unlinked before the
+ * call. Only called by writers holding the registry mutex.
+ */
+void wait_for_readers()
+{
+  unsigned e = reader_epoch.epoch.load();
+  reader_epoch.epoch.store(e + 1);
+  while (reader_epoch.readers[e & 1].load() != 0) {
+    std::this_thread::yield();
+  }
+}
+
+/**
+ * Everything writers need, which is only touched with the mutex held.
+ */
+struct registry_storage {
+  std::mutex mutex;
+  vector<regfunction_slot *> slots;
+};
+} // anonymous namespace
+
+static std::atomic<const registry_table *> registry;
+static registry_storage *storage;
+
+template<typename T0>
+static nd::arrfunc make_ufunc(T0 f0)
+{
+  nd::arrfunc af[1] = {nd::make_apply_arrfunc(f0)};
+  return lift_arrfunc(
+      make_multidispatch_arrfunc(sizeof(af) / sizeof(af[0]), af));
+}
 
 template<typename T0, typename T1>
 static nd::arrfunc make_ufunc(T0 f0, T1 f1)
@@ -169,11 +326,43 @@ struct logaddexp2 {
   }
 };
 #endif
+/**
+ * Wraps one of the vectorized math functions, so that contiguous loops
+ * go through its batch entry point.
+ */
+template <typename T, void (*F)(T *, const T *, size_t)>
+struct vmath_fn {
+  inline T operator()(T x) const
+  {
+    T result;
+    F(&result, &x, 1);
+    return result;
+  }
+  inline void batch(T *dst, const T *src, size_t count) const
+  {
+    F(dst, src, count);
+  }
+};
+
+template <typename T, typename U, void (*F)(T *, const U *, const T *, size_t)>
+struct vmath_binary_fn {
+  inline T operator()(U x, T y) const
+  {
+    T result;
+    F(&result, &x, &y, 1);
+    return result;
+  }
+  inline void batch(T *dst, const U *src0, const T *src1, size_t count) const
+  {
+    F(dst, src0, src1, count);
+  }
+};
 } // anonymous namespace
 
 void init::arrfunc_registry_init()
 {
-  registry = new map<nd::string, nd::arrfunc>;
+  storage = new registry_storage;
+  registry.store(new registry_table(64), std::memory_order_release);
 
   // Arithmetic
   func::set_regfunction(
@@ -217,15 +406,45 @@ void init::arrfunc_registry_init()
                         make_ufunc(logaddexp2<float>(), logaddexp2<double>()));
 #endif
 
+  // Comparisons, producing bool masks
+  func::set_regfunction(
+      "less", lift_arrfunc(make_comparison_arrfunc(comparison_type_less)));
+  func::set_regfunction(
+      "less_equal",
+      lift_arrfunc(make_comparison_arrfunc(comparison_type_less_equal)));
+  func::set_regfunction(
+      "equal", lift_arrfunc(make_comparison_arrfunc(comparison_type_equal)));
+  func::set_regfunction(
+      "not_equal",
+      lift_arrfunc(make_comparison_arrfunc(comparison_type_not_equal)));
+  func::set_regfunction(
+      "greater_equal",
+      lift_arrfunc(make_comparison_arrfunc(comparison_type_greater_equal)));
+  func::set_regfunction(
+      "greater",
+      lift_arrfunc(make_comparison_arrfunc(comparison_type_greater)));
+
+  // Sorting
+  func::set_regfunction("sort", lift_arrfunc(make_sort_arrfunc()));
+  func::set_regfunction("argsort", lift_arrfunc(make_argsort_arrfunc()));
+  // Not lifted, a var dimension inside other dimensions can't be allocated yet
+  func::set_regfunction("unique", make_unique_arrfunc());
+
   // Trig functions
   func::set_regfunction(
-      "sin", make_ufunc(&::sinf, static_cast<double (*)(double)>(&::sin)));
+      "sin", make_ufunc(vmath_fn<float, &kernels::vmath::sin>(),
+                        vmath_fn<double, &kernels::vmath::sin>()));
   func::set_regfunction(
-      "cos", make_ufunc(&::cosf, static_cast<double (*)(double)>(&::cos)));
+      "cos", make_ufunc(vmath_fn<float, &kernels::vmath::cos>(),
+                        vmath_fn<double, &kernels::vmath::cos>()));
   func::set_regfunction(
       "tan", make_ufunc(&::tanf, static_cast<double (*)(double)>(&::tan)));
   func::set_regfunction(
-      "exp", make_ufunc(&::expf, static_cast<double (*)(double)>(&::exp)));
+      "exp", make_ufunc(vmath_fn<float, &kernels::vmath::exp>(),
+                        vmath_fn<double, &kernels::vmath::exp>()));
+  func::set_regfunction(
+      "log", make_ufunc(vmath_fn<float, &kernels::vmath::log>(),
+                        vmath_fn<double, &kernels::vmath::log>()));
   func::set_regfunction(
       "arcsin", make_ufunc(&::asinf, static_cast<double (*)(double)>(&::asin)));
   func::set_regfunction(
@@ -243,7 +462,8 @@ void init::arrfunc_registry_init()
   func::set_regfunction(
       "cosh", make_ufunc(&::coshf, static_cast<double (*)(double)>(&::cosh)));
   func::set_regfunction(
-      "tanh", make_ufunc(&::tanhf, static_cast<double (*)(double)>(&::tanh)));
+      "tanh", make_ufunc(vmath_fn<float, &kernels::vmath::tanh>(),
+                         vmath_fn<double, &kernels::vmath::tanh>()));
 #if !(defined(_MSC_VER) && _MSC_VER < 1700)
   func::set_regfunction(
       "asinh",
@@ -259,34 +479,196 @@ void init::arrfunc_registry_init()
   func::set_regfunction(
       "power",
       make_ufunc(&powf, static_cast<double (*)(double, double)>(&::pow)));
+
+  // Special functions
+  func::set_regfunction(
+      "gamma", make_ufunc(vmath_fn<double, &kernels::special::gamma>()));
+  func::set_regfunction(
+      "lgamma", make_ufunc(vmath_fn<double, &kernels::special::lgamma>()));
+  func::set_regfunction(
+      "bessel_j0",
+      make_ufunc(vmath_fn<double, &kernels::special::bessel_j0>()));
+  func::set_regfunction(
+      "bessel_j1",
+      make_ufunc(vmath_fn<double, &kernels::special::bessel_j1>()));
+  func::set_regfunction(
+      "bessel_j",
+      make_ufunc(vmath_binary_fn<double, double,
+                                   &kernels::special::bessel_j>()));
+  func::set_regfunction(
+      "bessel_y0",
+      make_ufunc(vmath_fn<double, &kernels::special::bessel_y0>()));
+  func::set_regfunction(
+      "bessel_y1",
+      make_ufunc(vmath_fn<double, &kernels::special::bessel_y1>()));
+  func::set_regfunction(
+      "bessel_y",
+      make_ufunc(vmath_binary_fn<double, double,
+                                   &kernels::special::bessel_y>()));
+  func::set_regfunction(
+      "sph_bessel_j0",
+      make_ufunc(vmath_fn<double, &kernels::special::sph_bessel_j0>()));
+  func::set_regfunction(
+      "sph_bessel_j",
+      make_ufunc(vmath_binary_fn<double, double,
+                                   &kernels::special::sph_bessel_j>()));
+  func::set_regfunction(
+      "sph_bessel_y0",
+      make_ufunc(vmath_fn<double, &kernels::special::sph_bessel_y0>()));
+  func::set_regfunction(
+      "sph_bessel_y",
+      make_ufunc(vmath_binary_fn<double, double,
+                                   &kernels::special::sph_bessel_y>()));
+  func::set_regfunction(
+      "struve_h",
+      make_ufunc(vmath_binary_fn<double, double,
+                                   &kernels::special::struve_h>()));
+  func::set_regfunction(
+      "legendre_p",
+      make_ufunc(vmath_binary_fn<double, int,
+                                   &kernels::special::legendre_p>()));
+  func::set_regfunction("airy", lift_arrfunc(make_airy_arrfunc()));
+  func::set_regfunction("airy_ai", lift_arrfunc(make_airy_ai_arrfunc()));
+  func::set_regfunction("airy_bi", lift_arrfunc(make_airy_bi_arrfunc()));
 }
 
 void init::arrfunc_registry_cleanup()
 {
-  delete registry;
-  registry = NULL;
+  delete registry.exchange(NULL);
+  for (size_t i = 0; i < storage->slots.size(); ++i) {
+    delete storage->slots[i]->value.load();
+    delete storage->slots[i];
+  }
+  delete storage;
+  storage = NULL;
+}
+
+static void raise_not_registered(const nd::string &name)
+{
+  stringstream ss;
+  ss << "No dynd function ";
+  print_escaped_utf8_string(ss, name);
+  ss << " has been registered";
+  throw invalid_argument(ss.str());
+}
+
+static regfunction_slot *find_regfunction_slot(const nd::string &name)
+{
+  regfunction_slot *slot;
+  {
+    read_guard guard;
+    const registry_table *table = registry.load(std::memory_order_acquire);
+    slot = table->find(hash_name(name.begin(), name.end()), name.begin(),
+                       name.end());
+  }
+  if (slot == NULL || slot->value.load(std::memory_order_acquire) == NULL) {
+    raise_not_registered(name);
+  }
+  return slot;
 }
 
-const std::map<nd::string, nd::arrfunc> &func::get_regfunctions()
+/**
+ * Copies the arrfunc of a slot, which a concurrent registration may be
+ * replacing and freeing.
+ */
+static nd::arrfunc get_slot_value(const regfunction_slot *slot)
 {
-  return *registry;
+  read_guard guard;
+  const nd::arrfunc *value = slot->value.load(std::memory_order_acquire);
+  if (value == NULL) {
+    raise_not_registered(slot->name);
+  }
+  return *value;
+}
+
+std::map<nd::string, nd::arrfunc> func::get_regfunctions()
+{
+  std::lock_guard<std::mutex> lock(storage->mutex);
+  std::map<nd::string, nd::arrfunc> result;
+  for (size_t i = 0; i < storage->slots.size(); ++i) {
+    const nd::arrfunc *value = storage->slots[i]->value.load();
+    if (value != NULL) {
+      result[storage->slots[i]->name] = *value;
+    }
+  }
+  return result;
 }
 
 nd::arrfunc func::get_regfunction(const nd::string &name)
 {
-  map<nd::string, nd::arrfunc>::const_iterator it = registry->find(name);
-  if (it != registry->end()) {
-    return it->second;
-  } else {
-    stringstream ss;
-    ss << "No dynd function ";
-    print_escaped_utf8_string(ss, name);
-    ss << " has been registered";
-    throw invalid_argument(ss.str());
+  read_guard guard;
+  const registry_table *table = registry.load(std::memory_order_acquire);
+  const regfunction_slot *slot = table->find(
+      hash_name(name.begin(), name.end()), name.begin(), name.end());
+  const nd::arrfunc *value =
+      slot != NULL ? slot->value.load(std::memory_order_acquire) : NULL;
+  if (value == NULL) {
+    raise_not_registered(name);
   }
+  return *value;
 }
 
 void func::set_regfunction(const nd::string &name, const nd::arrfunc &af)
 {
-  (*registry)[name] = af;
+  std::lock_guard<std::mutex> lock(storage->mutex);
+  const registry_table *current = registry.load(std::memory_order_relaxed);
+  size_t hash = hash_name(name.begin(), name.end());
+  regfunction_slot *slot = current->find(hash, name.begin(), name.end());
+
+  const nd::arrfunc *value = new nd::arrfunc(af);
+  if (slot != NULL) {
+    const nd::arrfunc *old_value =
+        slot->value.exchange(value, std::memory_order_acq_rel);
+    if (old_value != NULL) {
+      wait_for_readers();
+      delete old_value;
+    }
+    return;
+  }
+
+  slot = new regfunction_slot(name, hash, value);
+  storage->slots.push_back(slot);
+  if (!current->is_full()) {
+    // No reader writes the table, so it is only const to them
+    const_cast<registry_table *>(current)->insert(slot);
+    return;
+  }
+  registry_table *next = new registry_table(current->cells.size() * 2);
+  for (size_t i = 0; i < storage->slots.size(); ++i) {
+    next->insert(storage->slots[i]);
+  }
+  registry.store(next, std::memory_order_release);
+  wait_for_readers();
+  delete current;
+}
+
+void func::unregister_regfunction(const nd::string &name)
+{
+  std::lock_guard<std::mutex> lock(storage->mutex);
+  const registry_table *current = registry.load(std::memory_order_relaxed);
+  regfunction_slot *slot = current->find(hash_name(name.begin(), name.end()),
+                                         name.begin(), name.end());
+  const nd::arrfunc *old_value =
+      slot != NULL ? slot->value.exchange(NULL, std::memory_order_acq_rel)
+                   : NULL;
+  if (old_value == NULL) {
+    raise_not_registered(name);
+  }
+  wait_for_readers();
+  delete old_value;
+}
+
+func::regfunction_handle::regfunction_handle(const nd::string &name)
+    : m_slot(find_regfunction_slot(name))
+{
+}
+
+const nd::string &func::regfunction_handle::get_name() const
+{
+  return m_slot->name;
+}
+
+nd::arrfunc func::regfunction_handle::get() const
+{
+  return get_slot_value(m_slot);
 }
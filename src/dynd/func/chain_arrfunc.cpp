@@ -3,6 +3,8 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <memory>
+
 #include <dynd/func/chain_arrfunc.hpp>
 #include <dynd/buffer_storage.hpp>
 #include <dynd/arrmeta_holder.hpp>
@@ -18,7 +20,8 @@ struct unary_heap_chain_ck : public kernels::general_ck<unary_heap_chain_ck, ker
   // The offset to the second child ckernel
   intptr_t m_second_offset;
   ndt::type m_buf_tp;
-  arrmeta_holder m_buf_arrmeta;
+  // Shared with any clones, as the children point to it
+  shared_ptr<arrmeta_holder> m_buf_arrmeta;
   vector<intptr_t> m_buf_shape;
 
   static void single(char *dst, char **src, ckernel_prefix *rawself)
@@ -79,6 +82,17 @@ struct unary_heap_chain_ck : public kernels::general_ck<unary_heap_chain_ck, ker
     // The second child ckernel
     base.destroy_child_ckernel(m_second_offset);
   }
+
+  inline void clone_children(ckernel_prefix *dst) const
+  {
+    // The buffers would allocate from the same blockrefs in the arrmeta
+    if (m_buf_tp.get_flags() & type_flag_blockref) {
+      stringstream ss;
+      ss << "cannot clone a chained ckernel with buffer type " << m_buf_tp;
+      throw runtime_error(ss.str());
+    }
+    base.clone_child_ckernels(dst, sizeof(self_type), m_second_offset);
+  }
 };
 
 struct instantiate_chain_data {
@@ -100,19 +114,21 @@ intptr_t dynd::make_chain_buf_tp_ckernel(
     unary_heap_chain_ck *self =
         unary_heap_chain_ck::create(ckb, kernreq, ckb_offset);
     self->m_buf_tp = buf_tp;
-    arrmeta_holder(buf_tp).swap(self->m_buf_arrmeta);
-    self->m_buf_arrmeta.arrmeta_default_construct(true);
+    self->m_buf_arrmeta = make_shared<arrmeta_holder>(buf_tp);
+    self->m_buf_arrmeta->arrmeta_default_construct(true);
     self->m_buf_shape.push_back(DYND_BUFFER_CHUNK_SIZE);
-    ckb_offset = first->instantiate(
-        first, first_tp, ckb, ckb_offset, buf_tp, self->m_buf_arrmeta.get(),
-        src_tp, src_arrmeta, kernreq, ectx, nd::array(), nd::array());
+    ckb_offset = kernels::instantiate_ckernel(first, first_tp, ckb, ckb_offset,
+                                              buf_tp, self->m_buf_arrmeta->get(),
+                                              src_tp, src_arrmeta, kernreq,
+                                              ectx, nd::array(), nd::array());
     reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->ensure_capacity(ckb_offset);
     self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->get_at<unary_heap_chain_ck>(root_ckb_offset);
     self->m_second_offset = ckb_offset - root_ckb_offset;
-    const char *buf_arrmeta = self->m_buf_arrmeta.get();
-    ckb_offset = second->instantiate(second, second_tp, ckb, ckb_offset, dst_tp,
-                                     dst_arrmeta, &buf_tp, &buf_arrmeta,
-                                     kernreq, ectx, nd::array(), nd::array());
+    const char *buf_arrmeta = self->m_buf_arrmeta->get();
+    ckb_offset = kernels::instantiate_ckernel(second, second_tp, ckb,
+                                              ckb_offset, dst_tp, dst_arrmeta,
+                                              &buf_tp, &buf_arrmeta, kernreq,
+                                              ectx, nd::array(), nd::array());
     return ckb_offset;
   }
   else {
@@ -0,0 +1,69 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/func/comparison_arrfunc.hpp>
+#include <dynd/kernels/comparison_kernels.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static intptr_t instantiate_comparison(
+    const arrfunc_type_data *af_self, const arrfunc_type *DYND_UNUSED(af_tp),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *DYND_UNUSED(dst_arrmeta), const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &DYND_UNUSED(args),
+    const nd::array &DYND_UNUSED(kwds))
+{
+  if (dst_tp.get_type_id() != bool_type_id) {
+    stringstream ss;
+    ss << "comparison arrfunc: expected a bool destination, got " << dst_tp;
+    throw type_error(ss.str());
+  }
+  comparison_type_t comptype = *af_self->get_data_as<comparison_type_t>();
+  return make_comparison_mask_kernel(ckb, ckb_offset, src_tp[0],
+                                     src_arrmeta[0], src_tp[1], src_arrmeta[1],
+                                     comptype, kernreq, ectx);
+}
+
+static int resolve_comparison_dst_type(
+    const arrfunc_type_data *DYND_UNUSED(self),
+    const arrfunc_type *DYND_UNUSED(af_tp), intptr_t nsrc,
+    const ndt::type *DYND_UNUSED(src_tp), int throw_on_error,
+    ndt::type &out_dst_tp, const nd::array &DYND_UNUSED(args),
+    const nd::array &DYND_UNUSED(kwds))
+{
+  if (nsrc != 2) {
+    if (throw_on_error) {
+      stringstream ss;
+      ss << "comparison arrfunc expected 2 arguments, got " << nsrc;
+      throw std::invalid_argument(ss.str());
+    }
+    else {
+      return 0;
+    }
+  }
+  out_dst_tp = ndt::make_type<dynd_bool>();
+  return 1;
+}
+
+nd::arrfunc dynd::make_comparison_arrfunc(comparison_type_t comptype)
+{
+  if (comptype < comparison_type_sorting_less ||
+      comptype > comparison_type_greater) {
+    stringstream ss;
+    ss << "invalid comparison type " << (int)comptype;
+    throw invalid_argument(ss.str());
+  }
+  nd::array af = nd::empty(ndt::type("(S, T) -> bool"));
+  arrfunc_type_data *out_af =
+      reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
+  *out_af->get_data_as<comparison_type_t>() = comptype;
+  out_af->free_func = NULL;
+  out_af->resolve_dst_type = &resolve_comparison_dst_type;
+  out_af->instantiate = &instantiate_comparison;
+  af.flag_as_immutable();
+  return af;
+}
@@ -0,0 +1,172 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/func/json_get_arrfunc.hpp>
+#include <dynd/kernels/expr_kernels.hpp>
+#include <dynd/types/base_struct_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/json_tape.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+struct json_get_arrfunc_data {
+    // The paths as given, for error messages
+    vector<string> path_text;
+    vector<vector<json_path_step> > paths;
+    // Whether each path fills a field of the destination struct, rather
+    // than a single path filling the whole destination
+    bool to_struct;
+};
+
+static void free_json_get_arrfunc_data(arrfunc_type_data *self_af) {
+    delete *self_af->get_data_as<json_get_arrfunc_data *>();
+}
+
+/**
+ * CKernel which indexes each JSON document, then parses the value at
+ * each path into its part of the destination. The tape keeps its memory
+ * from one document to the next.
+ */
+struct json_get_ck
+    : public kernels::expr_ck<json_get_ck, kernel_request_host, 1> {
+    vector<string> m_path_text;
+    vector<vector<json_path_step> > m_paths;
+    vector<ndt::type> m_tp;
+    vector<const char *> m_arrmeta;
+    vector<uintptr_t> m_offset;
+    eval::eval_context m_ectx;
+    json_tape m_tape;
+
+    inline void single(char *dst, char **src)
+    {
+        const json_type_data *d =
+            reinterpret_cast<const json_type_data *>(src[0]);
+        m_tape.index(d->begin, d->end);
+        for (size_t i = 0, i_end = m_tp.size(); i != i_end; ++i) {
+            const char *begin, *end;
+            char *field = dst + m_offset[i];
+            if (m_tape.find(m_paths[i], begin, end)) {
+                parse_json(m_tp[i], m_arrmeta[i], field, begin, end, &m_ectx);
+            } else if (m_tp[i].get_type_id() == option_type_id) {
+                m_tp[i].extended<option_type>()->assign_na(m_arrmeta[i], field,
+                                                           &m_ectx);
+            } else {
+                stringstream ss;
+                ss << "json_get: no value at path \""
+                   << m_path_text[i] << "\" in the JSON document";
+                throw invalid_argument(ss.str());
+            }
+        }
+    }
+};
+} // anonymous namespace
+
+static intptr_t instantiate_json_get(
+    const arrfunc_type_data *af_self, const arrfunc_type *DYND_UNUSED(af_tp),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, const ndt::type *src_tp,
+    const char *const *DYND_UNUSED(src_arrmeta), kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &DYND_UNUSED(args),
+    const nd::array &DYND_UNUSED(kwds))
+{
+    if (src_tp[0].get_type_id() != json_type_id) {
+        stringstream ss;
+        ss << "json_get: expected a json source, got " << src_tp[0];
+        throw type_error(ss.str());
+    }
+    const json_get_arrfunc_data *data =
+        *af_self->get_data_as<json_get_arrfunc_data *>();
+    json_get_ck *self = json_get_ck::create(ckb, kernreq, ckb_offset);
+    self->m_path_text = data->path_text;
+    self->m_paths = data->paths;
+    self->m_ectx = *ectx;
+    if (data->to_struct) {
+        const base_struct_type *sd = dst_tp.extended<base_struct_type>();
+        intptr_t field_count = sd->get_field_count();
+        const uintptr_t *data_offsets = sd->get_data_offsets(dst_arrmeta);
+        const uintptr_t *arrmeta_offsets = sd->get_arrmeta_offsets_raw();
+        for (intptr_t i = 0; i < field_count; ++i) {
+            self->m_tp.push_back(sd->get_field_type(i));
+            self->m_arrmeta.push_back(dst_arrmeta + arrmeta_offsets[i]);
+            self->m_offset.push_back(data_offsets[i]);
+        }
+    } else {
+        self->m_tp.push_back(dst_tp);
+        self->m_arrmeta.push_back(dst_arrmeta);
+        self->m_offset.push_back(0);
+    }
+    return ckb_offset;
+}
+
+static nd::arrfunc make_json_get_arrfunc_instance(json_get_arrfunc_data *data,
+                                                  const ndt::type &dst_tp)
+{
+    nd::array af = nd::empty(ndt::make_funcproto(ndt::make_json(), dst_tp));
+    arrfunc_type_data *out_af =
+        reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
+    *out_af->get_data_as<json_get_arrfunc_data *>() = data;
+    out_af->free_func = &free_json_get_arrfunc_data;
+    out_af->resolve_dst_type = NULL;
+    out_af->instantiate = &instantiate_json_get;
+    af.flag_as_immutable();
+    return af;
+}
+
+nd::arrfunc dynd::make_json_get_arrfunc(const std::string &path,
+                                        const ndt::type &value_tp)
+{
+    if (value_tp.is_symbolic()) {
+        stringstream ss;
+        ss << "make_json_get_arrfunc: the value type " << value_tp
+           << " must be concrete";
+        throw type_error(ss.str());
+    }
+    json_get_arrfunc_data *data = new json_get_arrfunc_data;
+    try {
+        data->path_text.push_back(path);
+        data->paths.resize(1);
+        parse_json_path(path, data->paths[0]);
+        data->to_struct = false;
+    } catch (...) {
+        delete data;
+        throw;
+    }
+    return make_json_get_arrfunc_instance(data, value_tp);
+}
+
+nd::arrfunc dynd::make_json_get_arrfunc(const std::vector<std::string> &paths,
+                                        const ndt::type &struct_tp)
+{
+    if (struct_tp.get_kind() != struct_kind || struct_tp.is_symbolic()) {
+        stringstream ss;
+        ss << "make_json_get_arrfunc: expected a concrete struct type, got "
+           << struct_tp;
+        throw type_error(ss.str());
+    }
+    intptr_t field_count =
+        struct_tp.extended<base_struct_type>()->get_field_count();
+    if ((intptr_t)paths.size() != field_count) {
+        stringstream ss;
+        ss << "make_json_get_arrfunc: got " << paths.size()
+           << " paths for the " << field_count << " fields of " << struct_tp;
+        throw invalid_argument(ss.str());
+    }
+    json_get_arrfunc_data *data = new json_get_arrfunc_data;
+    try {
+        data->path_text = paths;
+        data->paths.resize(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i) {
+            parse_json_path(paths[i], data->paths[i]);
+        }
+        data->to_struct = true;
+    } catch (...) {
+        delete data;
+        throw;
+    }
+    return make_json_get_arrfunc_instance(data, struct_tp);
+}
@@ -288,9 +288,10 @@ static intptr_t instantiate_multidispatch_af(
         }
       }
       if (j == nsrc) {
-        return af.get()->instantiate(af.get(), af.get_type(), ckb, ckb_offset,
-                                     dst_tp, dst_arrmeta, src_tp, src_arrmeta,
-                                     kernreq, ectx, args, kwds);
+        return kernels::instantiate_ckernel(af.get(), af.get_type(), ckb,
+                                            ckb_offset, dst_tp, dst_arrmeta,
+                                            src_tp, src_arrmeta, kernreq, ectx,
+                                            args, kwds);
       } else {
         return make_buffered_ckernel(af.get(), af.get_type(), ckb, ckb_offset,
                                      dst_tp, dst_arrmeta, nsrc, src_tp,
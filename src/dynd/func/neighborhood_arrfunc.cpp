@@ -4,6 +4,7 @@
 //
 
 #include <dynd/arrmeta_holder.hpp>
+#include <dynd/parallel.hpp>
 #include <dynd/func/call_callable.hpp>
 #include <dynd/func/neighborhood_arrfunc.hpp>
 #include <dynd/kernels/expr_kernels.hpp>
@@ -12,121 +13,486 @@
 using namespace std;
 using namespace dynd;
 
+namespace {
+
+/**
+ * The approximate number of source bytes one tile of the two innermost
+ * dimensions should touch, so that the rows of a neighborhood stay in cache
+ * while the tile is processed.
+ */
+static const intptr_t neighborhood_tile_bytes = 64 * 1024;
+
+/**
+ * The minimum number of output elements for which the outermost dimension is
+ * split across threads.
+ */
+static const intptr_t neighborhood_parallel_min_size = 64 * 1024;
+
+/**
+ * The parameters of the neighborhood along one dimension.
+ */
+struct neighborhood_dim {
+  intptr_t dst_size;
+  intptr_t dst_stride;
+  intptr_t src_stride;
+  intptr_t nh_size;
+  intptr_t nh_offset;
+  // Which entry of the start_stop array this dimension controls
+  intptr_t start_stop_index;
+};
+
+/**
+ * The ckernel for one dimension of the neighborhood. Its child is either the
+ * ckernel for the next dimension, or, for the innermost dimension, the
+ * neighborhood op requested as an expr_strided_t.
+ *
+ * The output along the dimension splits into a leading boundary, where the
+ * neighborhood is clipped at its start, an interior, where the whole
+ * neighborhood is in bounds, and a trailing boundary, where the neighborhood
+ * is clipped at its stop. The interior of the innermost dimension is handed to
+ * the neighborhood op as a single strided call.
+ */
 template <int N>
-struct neighborhood_ck : kernels::expr_ck<neighborhood_ck<N>, kernel_request_host, N> {
-    typedef neighborhood_ck<N> self_type;
+struct neighborhood_ck
+    : kernels::expr_ck<neighborhood_ck<N>, kernel_request_host, N> {
+  typedef neighborhood_ck<N> self_type;
 
-    intptr_t dst_stride;
-    intptr_t src_offset[N];
-    intptr_t src_stride[N];
-    intptr_t count[3];
-    intptr_t nh_size;
-    start_stop_t *nh_start_stop;
+  intptr_t dst_stride;
+  intptr_t src_offset[N];
+  intptr_t src_stride[N];
+  intptr_t count[3];
+  intptr_t nh_size;
+  start_stop_t *nh_start_stop;
+  // True if the child is the neighborhood op, false if it is another
+  // neighborhood_ck
+  bool innermost;
+  // If nonzero, the child is the innermost neighborhood_ck, and it is
+  // processed in column tiles of this many elements across all the rows
+  intptr_t tile_size;
 
-    // local index of first in of bounds element in the neighborhood
-    // local index of first out of bounds element in the neighborhood
+  inline intptr_t get_size() const { return count[0] + count[1] + count[2]; }
 
-    inline void single(char *dst, char **src) {
-        ckernel_prefix *child = self_type::get_child_ckernel();
-        expr_single_t child_fn = child->get_function<expr_single_t>();
+  inline void set_start_stop(intptr_t i)
+  {
+    nh_start_stop->start = (i < count[0]) ? (count[0] - i) : 0;
+    nh_start_stop->stop = (i < count[0] + count[1])
+                              ? nh_size
+                              : (nh_size - (i - count[0] - count[1] + 1));
+  }
 
-        char *src_copy[N];
-        memcpy(src_copy, src, sizeof(src_copy));
-        for (intptr_t j = 0; j < N; ++j) {
-            src_copy[j] += src_offset[j];
-        }
+  /**
+   * Computes the outputs with indices [i0, i1) along this dimension.
+   */
+  void process(char *dst, char *const *src, intptr_t i0, intptr_t i1)
+  {
+    if (tile_size != 0) {
+      process_tiled(dst, src, i0, i1);
+      return;
+    }
+
+    ckernel_prefix *child = self_type::get_child_ckernel();
+    char *src_copy[N];
+    for (intptr_t j = 0; j < N; ++j) {
+      src_copy[j] = src[j] + src_offset[j] + i0 * src_stride[j];
+    }
+    dst += i0 * dst_stride;
 
-        nh_start_stop->start = count[0];
-        nh_start_stop->stop = nh_size; // min(nh_size, dst_size)
-        for (intptr_t i = 0; i < count[0]; ++i) {
-            child_fn(dst, src_copy, child);
-            --(nh_start_stop->start);
-            dst += dst_stride;
-            for (intptr_t j = 0; j < N; ++j) {
-                src_copy[j] += src_stride[j];
-            }
+    intptr_t interior_end = count[0] + count[1];
+    for (intptr_t i = i0; i < i1;) {
+      set_start_stop(i);
+      // The interior has a constant start/stop, so it is done as one run
+      intptr_t n = (i >= count[0] && i < interior_end)
+                       ? (std::min(i1, interior_end) - i)
+                       : 1;
+      if (innermost) {
+        expr_strided_t child_fn = child->get_function<expr_strided_t>();
+        child_fn(dst, dst_stride, src_copy, src_stride, n, child);
+        dst += n * dst_stride;
+        for (intptr_t j = 0; j < N; ++j) {
+          src_copy[j] += n * src_stride[j];
         }
-      //  *nh_start = 0;
-    //    *nh_stop = nh_size;
-        for (intptr_t i = 0; i < count[1]; ++i) {
-            child_fn(dst, src_copy, child);
-            dst += dst_stride;
-            for (intptr_t j = 0; j < N; ++j) {
-                src_copy[j] += src_stride[j];
-            }
+      } else {
+        self_type *child_self = self_type::get_self(child);
+        for (intptr_t k = 0; k < n; ++k) {
+          child_self->process(dst, src_copy, 0, child_self->get_size());
+          dst += dst_stride;
+          for (intptr_t j = 0; j < N; ++j) {
+            src_copy[j] += src_stride[j];
+          }
         }
-  //      *nh_start = 0;
-//        *nh_stop = count[2]; // 0 if count[2] > 
-        for (intptr_t i = 0; i < count[2]; ++i) {
-            --(nh_start_stop->stop);
-            child_fn(dst, src_copy, child);
-            dst += dst_stride;
-            for (intptr_t j = 0; j < N; ++j) {
-                src_copy[j] += src_stride[j];
-            }
+      }
+      i += n;
+    }
+  }
+
+  /**
+   * Computes the outputs with indices [i0, i1) along this dimension, visiting
+   * the innermost dimension in tiles so the source rows of the neighborhood
+   * are reused from cache.
+   */
+  void process_tiled(char *dst, char *const *src, intptr_t i0, intptr_t i1)
+  {
+    self_type *child_self = self_type::get_self(self_type::get_child_ckernel());
+    intptr_t inner_size = child_self->get_size();
+    for (intptr_t jb = 0; jb < inner_size; jb += tile_size) {
+      intptr_t je = std::min(jb + tile_size, inner_size);
+      char *dst_row = dst + i0 * dst_stride;
+      char *src_row[N];
+      for (intptr_t j = 0; j < N; ++j) {
+        src_row[j] = src[j] + src_offset[j] + i0 * src_stride[j];
+      }
+      for (intptr_t i = i0; i < i1; ++i) {
+        set_start_stop(i);
+        child_self->process(dst_row, src_row, jb, je);
+        dst_row += dst_stride;
+        for (intptr_t j = 0; j < N; ++j) {
+          src_row[j] += src_stride[j];
         }
+      }
+    }
+  }
+
+  inline void single(char *dst, char **src) { process(dst, src, 0, get_size()); }
+
+  inline void destruct_children()
+  {
+    self_type::get_child_ckernel()->destroy();
+  }
+};
+
+/**
+ * The root ckernel of a neighborhood. It owns the start/stop bounds the
+ * neighborhood op reads, and, when the work is split across threads, holds one
+ * copy of the per-dimension ckernels and neighborhood op for each thread, laid
+ * out one after the other.
+ */
+template <int N>
+struct neighborhood_root_ck
+    : kernels::expr_ck<neighborhood_root_ck<N>, kernel_request_host, N> {
+  typedef neighborhood_root_ck<N> self_type;
+
+  start_stop_t *start_stop;
+  intptr_t nthreads;
+  // The size of one copy of the child ckernels
+  intptr_t subtree_size;
+
+  neighborhood_root_ck() : start_stop(NULL), nthreads(0), subtree_size(0) {}
+
+  ~neighborhood_root_ck() { free(start_stop); }
+
+  neighborhood_ck<N> *get_subtree(intptr_t i)
+  {
+    return neighborhood_ck<N>::get_self(self_type::get_child_ckernel(
+        sizeof(self_type) + i * subtree_size));
+  }
+
+  inline void single(char *dst, char **src)
+  {
+    neighborhood_ck<N> *first = get_subtree(0);
+    intptr_t size = first->get_size();
+    if (nthreads <= 1) {
+      first->process(dst, src, 0, size);
+    } else {
+      parallel::parallel_for(size, nthreads, 1,
+                             [this, dst, src](intptr_t i, intptr_t begin,
+                                              intptr_t end) {
+        get_subtree(i)->process(dst, src, begin, end);
+      });
+    }
+  }
+
+  inline void destruct_children()
+  {
+    for (intptr_t i = 0; i < nthreads; ++i) {
+      get_subtree(i)->base.destroy();
     }
+  }
+};
+
+/**
+ * A ckernel which applies a separable neighborhood op as one pass along
+ * each dimension, with the intermediate results held in temporary arrays.
+ */
+template <int N>
+struct separable_neighborhood_ck
+    : kernels::expr_ck<separable_neighborhood_ck<N>, kernel_request_host, N> {
+  typedef separable_neighborhood_ck<N> self_type;
+
+  vector<nd::array> tmp;
+  vector<intptr_t> pass_offsets;
+
+  inline void single(char *dst, char **src)
+  {
+    char *pass_src[N];
+    memcpy(pass_src, src, sizeof(pass_src));
+    for (size_t k = 0; k < pass_offsets.size(); ++k) {
+      char *pass_dst = (k == pass_offsets.size() - 1)
+                           ? dst
+                           : tmp[k % 2].get_readwrite_originptr();
+      ckernel_prefix *child = self_type::get_child_ckernel(pass_offsets[k]);
+      expr_single_t child_fn = child->get_function<expr_single_t>();
+      child_fn(pass_dst, pass_src, child);
+      for (intptr_t j = 0; j < N; ++j) {
+        pass_src[j] = pass_dst;
+      }
+    }
+  }
+
+  inline void destruct_children()
+  {
+    for (size_t k = 0; k < pass_offsets.size(); ++k) {
+      this->base.destroy_child_ckernel(pass_offsets[k]);
+    }
+  }
 };
 
 struct neighborhood {
-    nd::arrfunc op;
-    start_stop_t *start_stop;
+  nd::arrfunc op;
 };
 
+/**
+ * Returns the named keyword argument, or a NULL array if it was not provided.
+ */
+static nd::array get_optional_kwd(const nd::array &kwds, const char *name)
+{
+  if (kwds.is_null() ||
+      kwds.get_type().extended<base_struct_type>()->get_field_index(name) < 0) {
+    return nd::array();
+  }
+  nd::array result = kwds.p(name);
+  if (result.get_type().get_type_id() == pointer_type_id) {
+    result = result.f("dereference");
+  }
+  return result;
+}
+
+/**
+ * Chooses the tile width for the innermost dimension, so the source rows
+ * touched by one tile are about ``neighborhood_tile_bytes``. Returns 0 if the
+ * rows fit in cache without tiling.
+ */
+static intptr_t get_tile_size(intptr_t ndim, const neighborhood_dim *dims,
+                              const nd::array &kwds)
+{
+  nd::array tile_size = get_optional_kwd(kwds, "tile_size");
+  if (!tile_size.is_null()) {
+    return (ndim >= 2) ? std::max<intptr_t>(tile_size.as<intptr_t>(), 0) : 0;
+  }
+  if (ndim < 2) {
+    return 0;
+  }
+  const neighborhood_dim &rows = dims[ndim - 2], &cols = dims[ndim - 1];
+  intptr_t el_stride = std::max<intptr_t>(std::abs(cols.src_stride), 1);
+  intptr_t row_bytes = (cols.dst_size + cols.nh_size) * el_stride;
+  if (rows.nh_size * row_bytes <= neighborhood_tile_bytes) {
+    return 0;
+  }
+  return std::max(neighborhood_tile_bytes / (rows.nh_size * el_stride) -
+                      cols.nh_size,
+                  cols.nh_size);
+}
+
+/**
+ * Chooses the number of threads the outermost dimension is split across.
+ */
+static intptr_t get_thread_count(intptr_t ndim, const neighborhood_dim *dims,
+                                 const nd::array &kwds)
+{
+  nd::array nthreads = get_optional_kwd(kwds, "nthreads");
+  intptr_t total_size = 1;
+  for (intptr_t i = 0; i < ndim; ++i) {
+    total_size *= dims[i].dst_size;
+  }
+  intptr_t result;
+  if (!nthreads.is_null()) {
+    result = nthreads.as<intptr_t>();
+  } else if (total_size >= neighborhood_parallel_min_size) {
+    result = parallel::get_num_threads();
+  } else {
+    result = 1;
+  }
+  return parallel::get_partition_count(ndim > 0 ? dims[0].dst_size : 1,
+                                       result, 1);
+}
+
+/**
+ * Instantiates one copy of the per-dimension ckernels followed by the
+ * neighborhood op.
+ */
 template <int N>
-static intptr_t instantiate_neighborhood(
-    const arrfunc_type_data *af_self, const arrfunc_type *DYND_UNUSED(af_tp),
-    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
-    const char *dst_arrmeta, const ndt::type *src_tp,
-    const char *const *src_arrmeta, kernel_request_t kernreq,
+static intptr_t instantiate_neighborhood_subtree(
+    const nd::arrfunc &nh_op, void *ckb, intptr_t ckb_offset, intptr_t ndim,
+    const neighborhood_dim *dims, intptr_t tile_size, start_stop_t *start_stop,
+    const ndt::type &nh_dst_tp, const char *nh_dst_arrmeta,
+    const ndt::type *nh_src_tp, const char *const *nh_src_arrmeta,
     const eval::eval_context *ectx, const nd::array &args,
     const nd::array &kwds)
 {
-  neighborhood *nh = *af_self->get_data_as<neighborhood *>();
-  nd::arrfunc nh_op = nh->op;
+  for (intptr_t i = 0; i < ndim; ++i) {
+    typedef neighborhood_ck<N> self_type;
+    const neighborhood_dim &dim = dims[i];
+    self_type *self =
+        self_type::create(ckb, kernel_request_single, ckb_offset);
 
-  nd::array shape;
-  // TODO: Eliminate all try/catch(...)
-  try {
-    shape = kwds.p("shape").f("dereference");
+    self->dst_stride = dim.dst_stride;
+    for (intptr_t j = 0; j < N; ++j) {
+      self->src_offset[j] = dim.nh_offset * dim.src_stride;
+      self->src_stride[j] = dim.src_stride;
+    }
+
+    self->count[0] = -dim.nh_offset;
+    if (self->count[0] < 0) {
+      self->count[0] = 0;
+    } else if (self->count[0] > dim.dst_size) {
+      self->count[0] = dim.dst_size;
+    }
+    self->count[2] = dim.nh_size + dim.nh_offset - 1;
+    if (self->count[2] < 0) {
+      self->count[2] = 0;
+    } else if (self->count[2] > (dim.dst_size - self->count[0])) {
+      self->count[2] = dim.dst_size - self->count[0];
+    }
+    self->count[1] = dim.dst_size - self->count[0] - self->count[2];
+
+    self->nh_size = dim.nh_size;
+    self->nh_start_stop = start_stop + dim.start_stop_index;
+    self->innermost = (i == ndim - 1);
+    self->tile_size = (i == ndim - 2) ? tile_size : 0;
   }
-  catch (...) {
-    const nd::array &mask = kwds.p("mask").f("dereference");
-    shape = nd::array(mask.get_shape());
+
+  return kernels::instantiate_ckernel(
+      nh_op.get(), nh_op.get_type(), ckb, ckb_offset, nh_dst_tp,
+      nh_dst_arrmeta, nh_src_tp, nh_src_arrmeta, kernel_request_strided, ectx,
+      args, struct_concat(kwds, pack("start_stop",
+                                     reinterpret_cast<intptr_t>(start_stop))));
+}
+
+/**
+ * Instantiates a neighborhood_root_ck, with as many copies of the
+ * per-dimension ckernels and neighborhood op as threads it will use.
+ */
+template <int N>
+static intptr_t instantiate_neighborhood_root(
+    const nd::arrfunc &nh_op, void *ckb, intptr_t ckb_offset, intptr_t ndim,
+    const neighborhood_dim *dims, const ndt::type &nh_dst_tp,
+    const char *nh_dst_arrmeta, const ndt::type *nh_src_tp,
+    const char *const *nh_src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &args,
+    const nd::array &kwds)
+{
+  typedef neighborhood_root_ck<N> self_type;
+  intptr_t root_ckb_offset = ckb_offset;
+  self_type *self = self_type::create(ckb, kernreq, ckb_offset);
+  intptr_t nthreads = get_thread_count(ndim, dims, kwds);
+  intptr_t tile_size = get_tile_size(ndim, dims, kwds);
+  start_stop_t *start_stop =
+      reinterpret_cast<start_stop_t *>(malloc(nthreads * ndim * sizeof(start_stop_t)));
+  if (start_stop == NULL) {
+    throw bad_alloc();
   }
-  intptr_t ndim = shape.get_dim_size();
+  self->start_stop = start_stop;
 
-  nd::array offset;
-  // TODO: Eliminate all try/catch(...)
-  try {
-    offset = kwds.p("offset").f("dereference");
+  for (intptr_t i = 0; i < nthreads; ++i) {
+    intptr_t subtree_offset = ckb_offset;
+    ckb_offset = instantiate_neighborhood_subtree<N>(
+        nh_op, ckb, ckb_offset, ndim, dims, tile_size, start_stop + i * ndim,
+        nh_dst_tp, nh_dst_arrmeta, nh_src_tp, nh_src_arrmeta, ectx, args,
+        kwds);
+    reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+        ->ensure_capacity(ckb_offset);
+    self = self_type::get_self(
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+        root_ckb_offset);
+    // Count the copy only once it exists, so destruction is always safe
+    self->nthreads = i + 1;
+    // Each copy is instantiated identically, so they all have the same size
+    if (i == 0) {
+      self->subtree_size = ckb_offset - subtree_offset;
+    } else if (ckb_offset - subtree_offset != self->subtree_size) {
+      throw runtime_error("neighborhood arrfunc: the neighborhood op "
+                          "instantiated to ckernels of different sizes");
+    }
   }
-  catch (...) {
+
+  return ckb_offset;
+}
+
+/**
+ * Gets the strided shape of the dst and src[0] arrays and the neighborhood
+ * shape/offset keyword arguments.
+ */
+static void get_neighborhood_dims(
+    const char *name, const ndt::type &dst_tp, const char *dst_arrmeta,
+    const ndt::type *src_tp, const char *const *src_arrmeta,
+    const nd::array &kwds, vector<neighborhood_dim> &out_dims,
+    ndt::type &out_nh_dst_tp, const char *&out_nh_dst_arrmeta,
+    ndt::type &out_src0_el_tp)
+{
+  nd::array shape = get_optional_kwd(kwds, "shape");
+  if (shape.is_null()) {
+    nd::array mask = get_optional_kwd(kwds, "mask");
+    if (mask.is_null()) {
+      stringstream ss;
+      ss << name << " arrfunc requires a 'shape' or 'mask' keyword argument";
+      throw invalid_argument(ss.str());
+    }
+    shape = nd::array(mask.get_shape());
   }
+  intptr_t ndim = shape.get_dim_size();
+  nd::array offset = get_optional_kwd(kwds, "offset");
 
   // Process the dst array striding/types
   const size_stride_t *dst_shape;
-  ndt::type nh_dst_tp;
-  const char *nh_dst_arrmeta;
-  if (!dst_tp.get_as_strided(dst_arrmeta, ndim, &dst_shape, &nh_dst_tp,
-                             &nh_dst_arrmeta)) {
+  if (!dst_tp.get_as_strided(dst_arrmeta, ndim, &dst_shape, &out_nh_dst_tp,
+                             &out_nh_dst_arrmeta)) {
     stringstream ss;
-    ss << "neighborhood arrfunc dst must be a strided array, not " << dst_tp;
+    ss << name << " arrfunc dst must be a strided array, not " << dst_tp;
     throw invalid_argument(ss.str());
   }
 
   // Process the src[0] array striding/type
   const size_stride_t *src0_shape;
-  ndt::type src0_el_tp;
   const char *src0_el_arrmeta;
-  if (!src_tp[0].get_as_strided(src_arrmeta[0], ndim, &src0_shape, &src0_el_tp,
-                                &src0_el_arrmeta)) {
+  if (!src_tp[0].get_as_strided(src_arrmeta[0], ndim, &src0_shape,
+                                &out_src0_el_tp, &src0_el_arrmeta)) {
     stringstream ss;
-    ss << "neighborhood arrfunc argument 1 must be a 2D strided array, not "
-       << src_tp[0];
+    ss << name << " arrfunc argument 1 must be a " << ndim
+       << "D strided array, not " << src_tp[0];
     throw invalid_argument(ss.str());
   }
 
+  out_dims.resize(ndim);
+  for (intptr_t i = 0; i < ndim; ++i) {
+    neighborhood_dim &dim = out_dims[i];
+    dim.dst_size = dst_shape[i].dim_size;
+    dim.dst_stride = dst_shape[i].stride;
+    dim.src_stride = src0_shape[i].stride;
+    dim.nh_size = shape(i).as<intptr_t>();
+    dim.nh_offset = offset.is_null() ? 0 : offset(i).as<intptr_t>();
+    dim.start_stop_index = i;
+  }
+}
+
+template <int N>
+static intptr_t instantiate_neighborhood(
+    const arrfunc_type_data *af_self, const arrfunc_type *DYND_UNUSED(af_tp),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &args,
+    const nd::array &kwds)
+{
+  neighborhood *nh = *af_self->get_data_as<neighborhood *>();
+  nd::arrfunc nh_op = nh->op;
+
+  vector<neighborhood_dim> dims;
+  ndt::type nh_dst_tp, src0_el_tp;
+  const char *nh_dst_arrmeta;
+  get_neighborhood_dims("neighborhood", dst_tp, dst_arrmeta, src_tp,
+                        src_arrmeta, kwds, dims, nh_dst_tp, nh_dst_arrmeta,
+                        src0_el_tp);
+  intptr_t ndim = dims.size();
+
   // Synthesize the arrmeta for the src[0] passed to the neighborhood op
   ndt::type nh_src_tp[1];
   nh_src_tp[0] = ndt::make_fixed_dimsym(src0_el_tp, ndim);
@@ -135,50 +501,104 @@ static intptr_t instantiate_neighborhood(
   size_stride_t *nh_src0_arrmeta =
       reinterpret_cast<size_stride_t *>(nh_arrmeta.get());
   for (intptr_t i = 0; i < ndim; ++i) {
-    nh_src0_arrmeta[i].dim_size = shape(i).as<intptr_t>();
-    nh_src0_arrmeta[i].stride = src0_shape[i].stride;
+    nh_src0_arrmeta[i].dim_size = dims[i].nh_size;
+    nh_src0_arrmeta[i].stride = dims[i].src_stride;
   }
   const char *nh_src_arrmeta[1] = {nh_arrmeta.get()};
 
-  for (intptr_t i = 0; i < ndim; ++i) {
-    typedef neighborhood_ck<N> self_type;
-    self_type *self = self_type::create(ckb, kernreq, ckb_offset);
+  return instantiate_neighborhood_root<N>(
+      nh_op, ckb, ckb_offset, ndim, &dims[0], nh_dst_tp, nh_dst_arrmeta,
+      nh_src_tp, nh_src_arrmeta, kernreq, ectx, args, kwds);
+}
 
-    self->dst_stride = dst_shape[i].stride;
-    for (intptr_t j = 0; j < N; ++j) {
-      self->src_offset[j] = offset.is_null() ? 0 : (offset(i).as<intptr_t>() *
-                                                    src0_shape[i].stride);
-      self->src_stride[j] = src0_shape[i].stride;
-    }
+template <int N>
+static intptr_t instantiate_separable_neighborhood(
+    const arrfunc_type_data *af_self, const arrfunc_type *DYND_UNUSED(af_tp),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &args,
+    const nd::array &kwds)
+{
+  neighborhood *nh = *af_self->get_data_as<neighborhood *>();
+  nd::arrfunc nh_op = nh->op;
 
-    self->count[0] = offset.is_null() ? 0 : -offset(i).as<intptr_t>();
-    if (self->count[0] < 0) {
-      self->count[0] = 0;
-    }
-    else if (self->count[0] > dst_shape[i].dim_size) {
-      self->count[0] = dst_shape[i].dim_size;
-    }
-    self->count[2] = shape(i).as<intptr_t>() +
-                     (offset.is_null() ? 0 : offset(i).as<intptr_t>()) - 1;
-    if (self->count[2] < 0) {
-      self->count[2] = 0;
+  vector<neighborhood_dim> dims;
+  ndt::type nh_dst_tp, src0_el_tp;
+  const char *nh_dst_arrmeta;
+  get_neighborhood_dims("separable neighborhood", dst_tp, dst_arrmeta, src_tp,
+                        src_arrmeta, kwds, dims, nh_dst_tp, nh_dst_arrmeta,
+                        src0_el_tp);
+  intptr_t ndim = dims.size();
+
+  typedef separable_neighborhood_ck<N> self_type;
+  intptr_t root_ckb_offset = ckb_offset;
+  self_type *self = self_type::create(ckb, kernreq, ckb_offset);
+  // Two temporaries are enough, because each pass only reads the previous one
+  for (intptr_t k = 0; k < std::min<intptr_t>(ndim - 1, 2); ++k) {
+    self->tmp.push_back(nd::empty(dst_tp));
+  }
+  vector<nd::array> tmp = self->tmp;
+
+  ndt::type nh_src_tp[1] = {ndt::make_fixed_dimsym(src0_el_tp)};
+  for (intptr_t k = 0; k < ndim; ++k) {
+    const char *pass_src_arrmeta =
+        (k == 0) ? src_arrmeta[0] : tmp[(k - 1) % 2].get_arrmeta();
+    const char *pass_dst_arrmeta =
+        (k == ndim - 1) ? dst_arrmeta : tmp[k % 2].get_arrmeta();
+    const size_stride_t *pass_src_shape =
+        reinterpret_cast<const size_stride_t *>(pass_src_arrmeta);
+    const size_stride_t *pass_dst_shape =
+        reinterpret_cast<const size_stride_t *>(pass_dst_arrmeta);
+
+    // The pass along dimension k has a neighborhood of size one along all the
+    // other dimensions, and the 1D op reads start_stop[0]
+    vector<neighborhood_dim> pass_dims(dims);
+    for (intptr_t i = 0; i < ndim; ++i) {
+      pass_dims[i].dst_stride = pass_dst_shape[i].stride;
+      pass_dims[i].src_stride = pass_src_shape[i].stride;
+      if (i == k) {
+        pass_dims[i].start_stop_index = 0;
+      } else {
+        pass_dims[i].nh_size = 1;
+        pass_dims[i].nh_offset = 0;
+        pass_dims[i].start_stop_index = (i < k) ? (i + 1) : i;
+      }
     }
-    else if (self->count[2] > (dst_shape[i].dim_size - self->count[0])) {
-      self->count[2] = dst_shape[i].dim_size - self->count[0];
+
+    const size_stride_t *unused_shape;
+    if (!dst_tp.get_as_strided(pass_dst_arrmeta, ndim, &unused_shape,
+                               &nh_dst_tp, &nh_dst_arrmeta)) {
+      throw runtime_error("separable neighborhood arrfunc: internal error "
+                          "getting the strided temporary");
     }
-    self->count[1] = dst_shape[i].dim_size - self->count[0] - self->count[2];
 
-    self->nh_size = shape(i).as<intptr_t>();
-    self->nh_start_stop = nh->start_stop + i;
+    arrmeta_holder nh_arrmeta;
+    arrmeta_holder(nh_src_tp[0]).swap(nh_arrmeta);
+    size_stride_t *nh_src0_arrmeta =
+        reinterpret_cast<size_stride_t *>(nh_arrmeta.get());
+    nh_src0_arrmeta->dim_size = dims[k].nh_size;
+    nh_src0_arrmeta->stride = pass_src_shape[k].stride;
+    const char *nh_src_arrmeta[1] = {nh_arrmeta.get()};
+
+    intptr_t pass_offset = ckb_offset - root_ckb_offset;
+    ckb_offset = instantiate_neighborhood_root<N>(
+        nh_op, ckb, ckb_offset, ndim, &pass_dims[0], nh_dst_tp,
+        nh_dst_arrmeta, nh_src_tp, nh_src_arrmeta, kernel_request_single,
+        ectx, args, kwds);
+    reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+        ->ensure_capacity(ckb_offset);
+    self = self_type::get_self(
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+        root_ckb_offset);
+    self->pass_offsets.push_back(pass_offset);
   }
 
-  ckb_offset = nh_op.get()->instantiate(
-      nh_op.get(), nh_op.get_type(), ckb, ckb_offset, nh_dst_tp, nh_dst_arrmeta,
-      nh_src_tp, nh_src_arrmeta, kernel_request_single, ectx, args,
-      struct_concat(kwds, pack("start_stop", reinterpret_cast<intptr_t>(nh->start_stop))));
   return ckb_offset;
 }
 
+} // anonymous namespace
+
 static int resolve_neighborhood_dst_type(
     const arrfunc_type_data *DYND_UNUSED(self), const arrfunc_type *af_tp,
     intptr_t nsrc, const ndt::type *src_tp, int DYND_UNUSED(throw_on_error),
@@ -217,19 +637,15 @@ static int resolve_neighborhood_dst_type(
 
 static void free_neighborhood(arrfunc_type_data *self_af) {
     neighborhood *nh = *self_af->get_data_as<neighborhood *>();
-    free(nh->start_stop);
     delete nh;
 }
 
-nd::arrfunc dynd::make_neighborhood_arrfunc(const nd::arrfunc &neighborhood_op,
-                                            intptr_t nh_ndim)
+static nd::arrfunc
+make_neighborhood_arrfunc_from_pattern(const nd::arrfunc &neighborhood_op,
+                                       const ndt::type &nhop_pattern,
+                                       const ndt::type &result_pattern,
+                                       arrfunc_instantiate_t instantiate)
 {
-  std::ostringstream oss;
-  oss << "fixed**" << nh_ndim;
-  ndt::type nhop_pattern("(" + oss.str() + " * NH) -> OUT");
-  ndt::type result_pattern("(" + oss.str() + " * NH) -> " + oss.str() +
-                           " * OUT");
-
   map<nd::string, ndt::type> typevars;
   if (!ndt::pattern_match(neighborhood_op.get_array_type(), nhop_pattern,
                           typevars)) {
@@ -245,10 +661,38 @@ nd::arrfunc dynd::make_neighborhood_arrfunc(const nd::arrfunc &neighborhood_op,
   neighborhood **nh = out_af->get_data_as<neighborhood *>();
   *nh = new neighborhood;
   (*nh)->op = neighborhood_op;
-  (*nh)->start_stop = (start_stop_t *)malloc(nh_ndim * sizeof(start_stop_t));
-  out_af->instantiate = &instantiate_neighborhood<1>;
+  out_af->instantiate = instantiate;
   out_af->resolve_dst_type = &resolve_neighborhood_dst_type;
   out_af->free_func = &free_neighborhood;
   af.flag_as_immutable();
   return af;
 }
+
+nd::arrfunc dynd::make_neighborhood_arrfunc(const nd::arrfunc &neighborhood_op,
+                                            intptr_t nh_ndim)
+{
+  std::ostringstream oss;
+  oss << "fixed**" << nh_ndim;
+  ndt::type nhop_pattern("(" + oss.str() + " * NH) -> OUT");
+  ndt::type result_pattern("(" + oss.str() + " * NH) -> " + oss.str() +
+                           " * OUT");
+
+  return make_neighborhood_arrfunc_from_pattern(neighborhood_op, nhop_pattern,
+                                                result_pattern,
+                                                &instantiate_neighborhood<1>);
+}
+
+nd::arrfunc
+dynd::make_separable_neighborhood_arrfunc(const nd::arrfunc &neighborhood_op,
+                                          intptr_t nh_ndim)
+{
+  std::ostringstream oss;
+  oss << "fixed**" << nh_ndim;
+  ndt::type nhop_pattern("(fixed * T) -> T");
+  ndt::type result_pattern("(" + oss.str() + " * T) -> " + oss.str() +
+                           " * T");
+
+  return make_neighborhood_arrfunc_from_pattern(neighborhood_op, nhop_pattern,
+                                                result_pattern,
+                                                &instantiate_separable_neighborhood<1>);
+}
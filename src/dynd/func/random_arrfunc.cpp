@@ -0,0 +1,438 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <dynd/func/random_arrfunc.hpp>
+#include <dynd/random.hpp>
+#include <dynd/parallel.hpp>
+#include <dynd/kernels/expr_kernels.hpp>
+
+using namespace std;
+using namespace dynd;
+
+// Elements per thread below which the fill isn't split
+static const intptr_t random_grain_size = 65536;
+// Elements whose random words are generated together
+static const intptr_t random_chunk_size = 256;
+
+namespace {
+enum random_kind_t {
+  random_uniform,
+  random_normal,
+  random_exponential,
+  random_randint
+};
+
+const char *random_arrfunc_names[4] = {"uniform", "normal", "exponential",
+                                       "randint"};
+
+struct random_params {
+  random_kind_t kind;
+  uint64_t seed, stream;
+  // low/high, mean/stddev, or rate
+  double a, b;
+  // low/high for randint
+  int64_t ilow, ihigh;
+};
+
+const double two_pi = 6.283185307179586476925286766559;
+
+// [0, 1) from the top 24 bits of one word
+inline float unit_float(uint32_t w) { return (w >> 8) * (1.0f / 16777216.0f); }
+
+// (0, 1] from one word
+inline double unit_open_float(uint32_t w) { return (w + 1.0) / 4294967296.0; }
+
+// [0, 1) from the top 53 bits of two words
+inline double unit_double(const uint32_t *w)
+{
+  uint64_t x = ((uint64_t)w[0] << 32) | w[1];
+  return (x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// The high 64 bits of the 128 bit product a * b
+inline uint64_t mulhi64(uint64_t a, uint64_t b)
+{
+  uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+  uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+  uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+  uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+  uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+  return hi_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+/*
+ * The generators turn a fixed number of random words into one element.
+ */
+
+template <class T>
+struct uniform_gen;
+
+template <>
+struct uniform_gen<float> {
+  static const int words = 1;
+  float low, scale;
+  uniform_gen(const random_params &p)
+      : low((float)p.a), scale((float)(p.b - p.a))
+  {
+  }
+  inline void operator()(const uint32_t *w, char *dst) const
+  {
+    *reinterpret_cast<float *>(dst) = low + scale * unit_float(w[0]);
+  }
+};
+
+template <>
+struct uniform_gen<double> {
+  static const int words = 2;
+  double low, scale;
+  uniform_gen(const random_params &p) : low(p.a), scale(p.b - p.a) {}
+  inline void operator()(const uint32_t *w, char *dst) const
+  {
+    *reinterpret_cast<double *>(dst) = low + scale * unit_double(w);
+  }
+};
+
+template <class T>
+struct uniform_gen<dynd_complex<T> > {
+  static const int words = 2 * uniform_gen<T>::words;
+  uniform_gen<T> part;
+  uniform_gen(const random_params &p) : part(p) {}
+  inline void operator()(const uint32_t *w, char *dst) const
+  {
+    part(w, dst);
+    part(w + uniform_gen<T>::words, dst + sizeof(T));
+  }
+};
+
+template <class T>
+struct normal_gen;
+
+template <>
+struct normal_gen<float> {
+  static const int words = 2;
+  double mean, stddev;
+  normal_gen(const random_params &p) : mean(p.a), stddev(p.b) {}
+  inline void operator()(const uint32_t *w, char *dst) const
+  {
+    double r = sqrt(-2.0 * log(unit_open_float(w[0])));
+    *reinterpret_cast<float *>(dst) =
+        (float)(mean + stddev * r * cos(two_pi * unit_float(w[1])));
+  }
+};
+
+template <>
+struct normal_gen<double> {
+  static const int words = 4;
+  double mean, stddev;
+  normal_gen(const random_params &p) : mean(p.a), stddev(p.b) {}
+  inline void operator()(const uint32_t *w, char *dst) const
+  {
+    double r = sqrt(-2.0 * log(1.0 - unit_double(w)));
+    *reinterpret_cast<double *>(dst) =
+        mean + stddev * r * cos(two_pi * unit_double(w + 2));
+  }
+};
+
+template <class T>
+struct exponential_gen;
+
+template <>
+struct exponential_gen<float> {
+  static const int words = 1;
+  double inv_rate;
+  exponential_gen(const random_params &p) : inv_rate(1.0 / p.a) {}
+  inline void operator()(const uint32_t *w, char *dst) const
+  {
+    *reinterpret_cast<float *>(dst) =
+        (float)(-log(unit_open_float(w[0])) * inv_rate);
+  }
+};
+
+template <>
+struct exponential_gen<double> {
+  static const int words = 2;
+  double inv_rate;
+  exponential_gen(const random_params &p) : inv_rate(1.0 / p.a) {}
+  inline void operator()(const uint32_t *w, char *dst) const
+  {
+    *reinterpret_cast<double *>(dst) = -log(1.0 - unit_double(w)) * inv_rate;
+  }
+};
+
+template <class T>
+struct randint_gen {
+  static const int words = 2;
+  int64_t low;
+  uint64_t range;
+  randint_gen(const random_params &p)
+      : low(p.ilow), range((uint64_t)p.ihigh - (uint64_t)p.ilow)
+  {
+  }
+  inline void operator()(const uint32_t *w, char *dst) const
+  {
+    uint64_t x = ((uint64_t)w[0] << 32) | w[1];
+    *reinterpret_cast<T *>(dst) = (T)((uint64_t)low + mulhi64(x, range));
+  }
+};
+
+typedef void (*random_fill_t)(const random_params &p, char *dst,
+                              const vector<size_stride_t> &ss);
+
+/**
+ * Fills the strided array at 'dst' in parallel, each partition
+ * generating the random words for its own range of elements.
+ */
+template <class G>
+void random_fill(const random_params &p, char *dst,
+                 const vector<size_stride_t> &ss)
+{
+  intptr_t ndim = ss.size(), total = 1;
+  for (intptr_t d = 0; d < ndim; ++d) {
+    total *= ss[d].dim_size;
+  }
+  if (total == 0) {
+    return;
+  }
+  G gen(p);
+  parallel::parallel_for(
+      total, parallel::get_num_threads(), random_grain_size,
+      [&](intptr_t DYND_UNUSED(part), intptr_t begin, intptr_t end) {
+        uint32_t words[random_chunk_size * G::words];
+        // Find the starting element from its C order index
+        vector<intptr_t> idx(ndim);
+        char *ptr = dst;
+        intptr_t rem = begin;
+        for (intptr_t d = ndim - 1; d >= 0; --d) {
+          idx[d] = rem % ss[d].dim_size;
+          rem /= ss[d].dim_size;
+          ptr += idx[d] * ss[d].stride;
+        }
+        for (intptr_t i = begin; i < end; i += random_chunk_size) {
+          intptr_t n = min(random_chunk_size, end - i);
+          philox_fill_words(p.seed, p.stream, (uint64_t)i * G::words,
+                            n * G::words, words);
+          for (intptr_t j = 0; j < n; ++j) {
+            gen(words + j * G::words, ptr);
+            for (intptr_t d = ndim - 1; d >= 0; --d) {
+              ptr += ss[d].stride;
+              if (++idx[d] < ss[d].dim_size) {
+                break;
+              }
+              ptr -= ss[d].stride * ss[d].dim_size;
+              idx[d] = 0;
+            }
+          }
+        }
+      });
+}
+
+template <template <class> class G>
+random_fill_t get_float_fill(type_id_t tid)
+{
+  switch (tid) {
+  case float32_type_id:
+    return &random_fill<G<float> >;
+  case float64_type_id:
+    return &random_fill<G<double> >;
+  default:
+    return NULL;
+  }
+}
+
+template <class T>
+random_fill_t get_randint_fill(const random_params &p)
+{
+  if (p.ilow < (int64_t)numeric_limits<T>::min() ||
+      (p.ihigh - 1 > 0 &&
+       (uint64_t)(p.ihigh - 1) > (uint64_t)numeric_limits<T>::max())) {
+    return NULL;
+  }
+  return &random_fill<randint_gen<T> >;
+}
+
+random_fill_t get_random_fill(const random_params &p, type_id_t tid)
+{
+  switch (p.kind) {
+  case random_uniform:
+    switch (tid) {
+    case complex_float32_type_id:
+      return &random_fill<uniform_gen<dynd_complex<float> > >;
+    case complex_float64_type_id:
+      return &random_fill<uniform_gen<dynd_complex<double> > >;
+    default:
+      return get_float_fill<uniform_gen>(tid);
+    }
+  case random_normal:
+    return get_float_fill<normal_gen>(tid);
+  case random_exponential:
+    return get_float_fill<exponential_gen>(tid);
+  case random_randint:
+    switch (tid) {
+    case int8_type_id:
+      return get_randint_fill<int8_t>(p);
+    case int16_type_id:
+      return get_randint_fill<int16_t>(p);
+    case int32_type_id:
+      return get_randint_fill<int32_t>(p);
+    case int64_type_id:
+      return get_randint_fill<int64_t>(p);
+    case uint8_type_id:
+      return get_randint_fill<uint8_t>(p);
+    case uint16_type_id:
+      return get_randint_fill<uint16_t>(p);
+    case uint32_type_id:
+      return get_randint_fill<uint32_t>(p);
+    case uint64_type_id:
+      return get_randint_fill<uint64_t>(p);
+    default:
+      return NULL;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * CKernel which fills its whole destination with random values.
+ */
+struct random_ck : public kernels::expr_ck<random_ck, kernel_request_host, 0> {
+  random_params m_params;
+  random_fill_t m_fill;
+  vector<size_stride_t> m_ss;
+
+  inline void single(char *dst, char **DYND_UNUSED(src))
+  {
+    m_fill(m_params, dst, m_ss);
+  }
+};
+} // anonymous namespace
+
+static intptr_t instantiate_random(
+    const arrfunc_type_data *af_self, const arrfunc_type *DYND_UNUSED(af_tp),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, const ndt::type *DYND_UNUSED(src_tp),
+    const char *const *DYND_UNUSED(src_arrmeta), kernel_request_t kernreq,
+    const eval::eval_context *DYND_UNUSED(ectx),
+    const nd::array &DYND_UNUSED(args), const nd::array &DYND_UNUSED(kwds))
+{
+  const random_params *p = *af_self->get_data_as<random_params *>();
+  intptr_t ndim = dst_tp.get_ndim();
+  ndt::type dst_el_tp = dst_tp;
+  const size_stride_t *ss = NULL;
+  const char *dst_el_meta = dst_arrmeta;
+  if (ndim > 0 &&
+      !dst_tp.get_as_strided(dst_arrmeta, ndim, &ss, &dst_el_tp, &dst_el_meta)) {
+    stringstream ss;
+    ss << random_arrfunc_names[p->kind] << " arrfunc: could not process type "
+       << dst_tp << " as strided dimensions";
+    throw type_error(ss.str());
+  }
+  random_fill_t fill = get_random_fill(*p, dst_el_tp.get_type_id());
+  if (fill == NULL) {
+    stringstream ss;
+    ss << random_arrfunc_names[p->kind]
+       << " arrfunc: unsupported element type " << dst_el_tp;
+    if (p->kind == random_randint) {
+      ss << " for the range [" << p->ilow << ", " << p->ihigh << ")";
+    }
+    throw type_error(ss.str());
+  }
+
+  random_ck *self = random_ck::create_leaf(ckb, kernreq, ckb_offset);
+  self->m_params = *p;
+  self->m_fill = fill;
+  self->m_ss.assign(ss, ss + ndim);
+  return ckb_offset;
+}
+
+static void free_random_arrfunc_data(arrfunc_type_data *self_af)
+{
+  delete *self_af->get_data_as<random_params *>();
+}
+
+static nd::arrfunc make_random_arrfunc_instance(const random_params &p)
+{
+  nd::array af = nd::empty(ndt::type("() -> Dims... * R"));
+  arrfunc_type_data *out_af =
+      reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
+  *out_af->get_data_as<random_params *>() = new random_params(p);
+  out_af->free_func = &free_random_arrfunc_data;
+  out_af->resolve_dst_type = NULL;
+  out_af->instantiate = &instantiate_random;
+  af.flag_as_immutable();
+  return af;
+}
+
+static random_params make_random_params(random_kind_t kind, uint64_t seed,
+                                        uint64_t stream)
+{
+  random_params p;
+  p.kind = kind;
+  p.seed = seed;
+  p.stream = stream;
+  p.a = p.b = 0;
+  p.ilow = p.ihigh = 0;
+  return p;
+}
+
+nd::arrfunc dynd::make_uniform_arrfunc(uint64_t seed, uint64_t stream,
+                                       double low, double high)
+{
+  if (!(low < high)) {
+    stringstream ss;
+    ss << "uniform arrfunc: low " << low << " must be less than high "
+       << high;
+    throw invalid_argument(ss.str());
+  }
+  random_params p = make_random_params(random_uniform, seed, stream);
+  p.a = low;
+  p.b = high;
+  return make_random_arrfunc_instance(p);
+}
+
+nd::arrfunc dynd::make_normal_arrfunc(uint64_t seed, uint64_t stream,
+                                      double mean, double stddev)
+{
+  if (!(stddev >= 0)) {
+    stringstream ss;
+    ss << "normal arrfunc: stddev " << stddev << " must not be negative";
+    throw invalid_argument(ss.str());
+  }
+  random_params p = make_random_params(random_normal, seed, stream);
+  p.a = mean;
+  p.b = stddev;
+  return make_random_arrfunc_instance(p);
+}
+
+nd::arrfunc dynd::make_exponential_arrfunc(uint64_t seed, uint64_t stream,
+                                           double rate)
+{
+  if (!(rate > 0)) {
+    stringstream ss;
+    ss << "exponential arrfunc: rate " << rate << " must be positive";
+    throw invalid_argument(ss.str());
+  }
+  random_params p = make_random_params(random_exponential, seed, stream);
+  p.a = rate;
+  return make_random_arrfunc_instance(p);
+}
+
+nd::arrfunc dynd::make_randint_arrfunc(uint64_t seed, uint64_t stream,
+                                       int64_t low, int64_t high)
+{
+  if (!(low < high)) {
+    stringstream ss;
+    ss << "randint arrfunc: low " << low << " must be less than high "
+       << high;
+    throw invalid_argument(ss.str());
+  }
+  random_params p = make_random_params(random_randint, seed, stream);
+  p.ilow = low;
+  p.ihigh = high;
+  return make_random_arrfunc_instance(p);
+}
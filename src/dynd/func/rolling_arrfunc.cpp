@@ -3,6 +3,8 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <memory>
+
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/func/rolling_arrfunc.hpp>
 #include <dynd/kernels/ckernel_common_functions.hpp>
@@ -19,7 +21,8 @@ struct strided_rolling_ck : public kernels::unary_ck<strided_rolling_ck> {
     intptr_t m_window_size;
     intptr_t m_dim_size, m_dst_stride, m_src_stride;
     size_t m_window_op_offset;
-    arrmeta_holder m_src_winop_meta;
+    // Shared with any clones, as the window op points to it
+    shared_ptr<arrmeta_holder> m_src_winop_meta;
 
     inline void single(char *dst, char *src)
     {
@@ -49,6 +52,12 @@ struct strided_rolling_ck : public kernels::unary_ck<strided_rolling_ck> {
         // The window op
         base.destroy_child_ckernel(m_window_op_offset);
     }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        base.clone_child_ckernels(dst, sizeof(self_type),
+                                  m_window_op_offset);
+    }
 };
 
 struct var_rolling_ck : public kernels::unary_ck<var_rolling_ck> {
@@ -58,7 +67,10 @@ struct var_rolling_ck : public kernels::unary_ck<var_rolling_ck> {
     const char *m_dst_meta;
     size_t m_window_op_offset;
 
-    inline void single(char *dst, char *src)
+    /**
+     * Fills the allocated var dim element ``dst`` from ``src``.
+     */
+    inline void fill(char *dst, char *src)
     {
         // Get the child ckernels
         ckernel_prefix *nachild = get_child_ckernel();
@@ -75,8 +87,6 @@ struct var_rolling_ck : public kernels::unary_ck<var_rolling_ck> {
             reinterpret_cast<var_dim_type_data *>(src);
         char *src_arr_ptr = src_dat->begin + m_src_offset;
         intptr_t dim_size = src_dat->size;
-        // Allocate the output data
-        ndt::var_dim_element_initialize(m_dst_tp, m_dst_meta, dst, dim_size);
         char *dst_arr_ptr = dst_dat->begin;
 
         // Fill in NA/NaN at the beginning
@@ -92,6 +102,35 @@ struct var_rolling_ck : public kernels::unary_ck<var_rolling_ck> {
         }
     }
 
+    inline void single(char *dst, char *src)
+    {
+        // Allocate the output data
+        ndt::var_dim_element_initialize(
+            m_dst_tp, m_dst_meta, dst,
+            reinterpret_cast<var_dim_type_data *>(src)->size);
+        fill(dst, src);
+    }
+
+    inline void strided(char *dst, intptr_t dst_stride, char *src,
+                        intptr_t src_stride, size_t count)
+    {
+        // The outputs have the sizes of the inputs, so allocate them all
+        // at once, back to back in the memory block
+        ndt::var_dim_builder builder(m_dst_tp, m_dst_meta);
+        intptr_t total = 0;
+        char *src_it = src;
+        for (size_t i = 0; i != count; ++i, src_it += src_stride) {
+            total += reinterpret_cast<var_dim_type_data *>(src_it)->size;
+        }
+        builder.reserve(total);
+        for (size_t i = 0; i != count; ++i) {
+            builder.append(dst, reinterpret_cast<var_dim_type_data *>(src)->size);
+            fill(dst, src);
+            dst += dst_stride;
+            src += src_stride;
+        }
+    }
+
     inline void destruct_children()
     {
         // The window op
@@ -99,6 +138,12 @@ struct var_rolling_ck : public kernels::unary_ck<var_rolling_ck> {
         // The NA filler
         base.destroy_child_ckernel(sizeof(self_type));
     }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        base.clone_child_ckernels(dst, sizeof(self_type),
+                                  m_window_op_offset);
+    }
 };
 
 struct rolling_arrfunc_data {
@@ -214,23 +259,24 @@ instantiate_strided(const arrfunc_type_data *af_self,
     self->m_window_op_offset = ckb_offset - root_ckb_offset;
     // We construct array arrmeta for the window op ckernel to use,
     // without actually creating an nd::array to hold it.
-    arrmeta_holder(ndt::make_fixed_dim(data->window_size, src_el_tp))
-        .swap(self->m_src_winop_meta);
-    self->m_src_winop_meta.get_at<fixed_dim_type_arrmeta>(0)->dim_size =
+    self->m_src_winop_meta = make_shared<arrmeta_holder>(
+        ndt::make_fixed_dim(data->window_size, src_el_tp));
+    self->m_src_winop_meta->get_at<fixed_dim_type_arrmeta>(0)->dim_size =
         self->m_window_size;
-    self->m_src_winop_meta.get_at<fixed_dim_type_arrmeta>(0)->stride =
+    self->m_src_winop_meta->get_at<fixed_dim_type_arrmeta>(0)->stride =
         self->m_src_stride;
     if (src_el_tp.get_arrmeta_size() > 0) {
         src_el_tp.extended()->arrmeta_copy_construct(
-            self->m_src_winop_meta.get() + sizeof(fixed_dim_type_arrmeta),
+            self->m_src_winop_meta->get() + sizeof(fixed_dim_type_arrmeta),
             src_el_arrmeta, NULL);
     }
 
-    const char *src_winop_meta = self->m_src_winop_meta.get();
-    return window_af->instantiate(
-        window_af, window_af_tp, ckb, ckb_offset, dst_el_tp, dst_el_arrmeta,
-        &self->m_src_winop_meta.get_type(), &src_winop_meta,
-        kernel_request_strided, ectx, args, kwds);
+    const char *src_winop_meta = self->m_src_winop_meta->get();
+    return kernels::instantiate_ckernel(window_af, window_af_tp, ckb,
+                                        ckb_offset, dst_el_tp, dst_el_arrmeta,
+                                        &self->m_src_winop_meta->get_type(),
+                                        &src_winop_meta, kernel_request_strided,
+                                        ectx, args, kwds);
 }
 
 nd::arrfunc dynd::make_rolling_arrfunc(const nd::arrfunc &window_op,
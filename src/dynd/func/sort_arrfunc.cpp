@@ -0,0 +1,333 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <vector>
+
+#include <dynd/func/sort_arrfunc.hpp>
+#include <dynd/kernels/sort_kernels.hpp>
+#include <dynd/kernels/comparison_kernels.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/expr_kernels.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+enum sort_arrfunc_kind_t {
+  sort_arrfunc_sort,
+  sort_arrfunc_argsort,
+  sort_arrfunc_unique
+};
+
+const char *sort_arrfunc_names[3] = {"sort", "argsort", "unique"};
+
+/**
+ * CKernel which sorts a strided dimension. The child ckernel
+ * should be a single unary copy of one element.
+ */
+struct sort_ck : public kernels::expr_ck<sort_ck, kernel_request_host, 1> {
+  ndt::type m_src_el_tp;
+  const char *m_src_el_meta;
+  intptr_t m_dim_size, m_src_stride, m_dst_stride;
+  eval::eval_context m_ectx;
+
+  inline void single(char *dst, char **src)
+  {
+    if (m_dim_size == 0) {
+      return;
+    }
+    ckernel_prefix *child = get_child_ckernel();
+    expr_single_t child_fn = child->get_function<expr_single_t>();
+    vector<intptr_t> index(m_dim_size);
+    kernels::strided_argsort(m_src_el_tp, m_src_el_meta, src[0], m_src_stride,
+                             m_dim_size, &index[0],
+                             &m_ectx);
+    for (intptr_t i = 0; i < m_dim_size; ++i) {
+      char *child_src = src[0] + index[i] * m_src_stride;
+      child_fn(dst, &child_src, child);
+      dst += m_dst_stride;
+    }
+  }
+
+  inline void destruct_children()
+  {
+    // The child copy ckernel
+    get_child_ckernel()->destroy();
+  }
+
+  inline void clone_children(ckernel_prefix *dst) const
+  {
+    base.clone_child_ckernels(dst, sizeof(self_type));
+  }
+};
+
+/**
+ * CKernel which writes the indices that sort a strided dimension.
+ */
+struct argsort_ck
+    : public kernels::expr_ck<argsort_ck, kernel_request_host, 1> {
+  ndt::type m_src_el_tp;
+  const char *m_src_el_meta;
+  intptr_t m_dim_size, m_src_stride, m_dst_stride;
+  eval::eval_context m_ectx;
+
+  inline void single(char *dst, char **src)
+  {
+    if (m_dim_size == 0) {
+      return;
+    }
+    if (m_dst_stride == sizeof(intptr_t)) {
+      kernels::strided_argsort(m_src_el_tp, m_src_el_meta, src[0],
+                               m_src_stride, m_dim_size,
+                               reinterpret_cast<intptr_t *>(dst),
+                               &m_ectx);
+    }
+    else {
+      vector<intptr_t> index(m_dim_size);
+      kernels::strided_argsort(m_src_el_tp, m_src_el_meta, src[0],
+                               m_src_stride, m_dim_size, &index[0],
+                               &m_ectx);
+      for (intptr_t i = 0; i < m_dim_size; ++i) {
+        *reinterpret_cast<intptr_t *>(dst) = index[i];
+        dst += m_dst_stride;
+      }
+    }
+  }
+};
+
+/**
+ * CKernel which writes the sorted distinct values of a strided
+ * dimension into a var dimension. The child ckernel should be a
+ * single unary copy of one element.
+ */
+struct unique_ck : public kernels::expr_ck<unique_ck, kernel_request_host, 1> {
+  ndt::type m_src_el_tp, m_dst_tp;
+  const char *m_src_el_meta, *m_dst_meta;
+  intptr_t m_dim_size, m_src_stride;
+  eval::eval_context m_ectx;
+
+  inline void single(char *dst, char **src)
+  {
+    ckernel_prefix *child = get_child_ckernel();
+    expr_single_t child_fn = child->get_function<expr_single_t>();
+    vector<intptr_t> index;
+    if (m_dim_size > 0) {
+      index.resize(m_dim_size);
+      kernels::strided_argsort(m_src_el_tp, m_src_el_meta, src[0],
+                               m_src_stride, m_dim_size, &index[0],
+                               &m_ectx);
+      // In sorted order, an element is distinct from the previous one
+      // exactly when the previous one sorts before it
+      comparison_ckernel_builder k;
+      make_comparison_kernel(&k, 0, m_src_el_tp, m_src_el_meta, m_src_el_tp,
+                             m_src_el_meta, comparison_type_sorting_less,
+                             &m_ectx);
+      intptr_t unique_count = 1;
+      for (intptr_t i = 1; i < m_dim_size; ++i) {
+        if (k(src[0] + index[unique_count - 1] * m_src_stride,
+              src[0] + index[i] * m_src_stride)) {
+          index[unique_count++] = index[i];
+        }
+      }
+      index.resize(unique_count);
+    }
+    intptr_t count = index.size();
+    ndt::var_dim_element_initialize(m_dst_tp, m_dst_meta, dst, count);
+    var_dim_type_data *vdd = reinterpret_cast<var_dim_type_data *>(dst);
+    char *dst_ptr = vdd->begin;
+    intptr_t dst_stride =
+        reinterpret_cast<const var_dim_type_arrmeta *>(m_dst_meta)->stride;
+    for (intptr_t i = 0; i < count; ++i) {
+      char *child_src = src[0] + index[i] * m_src_stride;
+      child_fn(dst_ptr, &child_src, child);
+      dst_ptr += dst_stride;
+    }
+  }
+
+  inline void destruct_children()
+  {
+    // The child copy ckernel
+    get_child_ckernel()->destroy();
+  }
+
+  inline void clone_children(ckernel_prefix *dst) const
+  {
+    base.clone_child_ckernels(dst, sizeof(self_type));
+  }
+};
+} // anonymous namespace
+
+static int resolve_sort_dst_type(const arrfunc_type_data *af_self,
+                                 const arrfunc_type *af_tp, intptr_t nsrc,
+                                 const ndt::type *src_tp, int throw_on_error,
+                                 ndt::type &out_dst_tp,
+                                 const nd::array &DYND_UNUSED(args),
+                                 const nd::array &DYND_UNUSED(kwds))
+{
+  sort_arrfunc_kind_t kind = *af_self->get_data_as<sort_arrfunc_kind_t>();
+  if (nsrc != 1) {
+    if (throw_on_error) {
+      stringstream ss;
+      ss << "Wrong number of arguments to " << sort_arrfunc_names[kind]
+         << " arrfunc with prototype " << af_tp << ", got " << nsrc
+         << " arguments";
+      throw invalid_argument(ss.str());
+    }
+    else {
+      return 0;
+    }
+  }
+  type_id_t dim_id = src_tp[0].get_type_id();
+  if (dim_id != fixed_dim_type_id && dim_id != cfixed_dim_type_id) {
+    if (throw_on_error) {
+      stringstream ss;
+      ss << sort_arrfunc_names[kind]
+         << " arrfunc: could not process type " << src_tp[0];
+      ss << " as a strided dimension";
+      throw type_error(ss.str());
+    }
+    else {
+      return 0;
+    }
+  }
+  ndt::type el_tp =
+      src_tp[0].get_type_at_dimension(NULL, 1).get_canonical_type();
+  switch (kind) {
+  case sort_arrfunc_sort:
+    out_dst_tp = ndt::make_fixed_dim(src_tp[0].get_dim_size(NULL, NULL), el_tp);
+    break;
+  case sort_arrfunc_argsort:
+    out_dst_tp = ndt::make_fixed_dim(src_tp[0].get_dim_size(NULL, NULL),
+                                     ndt::make_type<intptr_t>());
+    break;
+  case sort_arrfunc_unique:
+    out_dst_tp = ndt::make_var_dim(el_tp);
+    break;
+  }
+  return 1;
+}
+
+static intptr_t instantiate_sort(
+    const arrfunc_type_data *af_self, const arrfunc_type *DYND_UNUSED(af_tp),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &DYND_UNUSED(args),
+    const nd::array &DYND_UNUSED(kwds))
+{
+  sort_arrfunc_kind_t kind = *af_self->get_data_as<sort_arrfunc_kind_t>();
+  intptr_t src_dim_size, src_stride;
+  ndt::type src_el_tp;
+  const char *src_el_meta;
+  if (!src_tp[0].get_as_strided(src_arrmeta[0], &src_dim_size, &src_stride,
+                                &src_el_tp, &src_el_meta)) {
+    stringstream ss;
+    ss << sort_arrfunc_names[kind] << " arrfunc: could not process type "
+       << src_tp[0];
+    ss << " as a strided dimension";
+    throw type_error(ss.str());
+  }
+
+  if (kind == sort_arrfunc_unique) {
+    if (dst_tp.get_type_id() != var_dim_type_id) {
+      stringstream ss;
+      ss << "unique arrfunc: could not process type " << dst_tp;
+      ss << " as a var dimension";
+      throw type_error(ss.str());
+    }
+    unique_ck *self = unique_ck::create(ckb, kernreq, ckb_offset);
+    self->m_src_el_tp = src_el_tp;
+    self->m_src_el_meta = src_el_meta;
+    self->m_dim_size = src_dim_size;
+    self->m_src_stride = src_stride;
+    self->m_dst_tp = dst_tp;
+    self->m_dst_meta = dst_arrmeta;
+    self->m_ectx = *ectx;
+    return make_assignment_kernel(
+        ckb, ckb_offset, dst_tp.extended<var_dim_type>()->get_element_type(),
+        dst_arrmeta + sizeof(var_dim_type_arrmeta), src_el_tp, src_el_meta,
+        kernel_request_single, ectx);
+  }
+
+  intptr_t dst_dim_size, dst_stride;
+  ndt::type dst_el_tp;
+  const char *dst_el_meta;
+  if (!dst_tp.get_as_strided(dst_arrmeta, &dst_dim_size, &dst_stride,
+                             &dst_el_tp, &dst_el_meta)) {
+    stringstream ss;
+    ss << sort_arrfunc_names[kind] << " arrfunc: could not process type "
+       << dst_tp;
+    ss << " as a strided dimension";
+    throw type_error(ss.str());
+  }
+  if (dst_dim_size != src_dim_size) {
+    stringstream ss;
+    ss << sort_arrfunc_names[kind]
+       << " arrfunc: source and dest have different sizes, ";
+    ss << src_dim_size << " and " << dst_dim_size;
+    throw invalid_argument(ss.str());
+  }
+
+  if (kind == sort_arrfunc_argsort) {
+    if (dst_el_tp.get_type_id() != (type_id_t)type_id_of<intptr_t>::value) {
+      stringstream ss;
+      ss << "argsort arrfunc: index type should be intptr, not ";
+      ss << dst_el_tp;
+      throw type_error(ss.str());
+    }
+    argsort_ck *self = argsort_ck::create_leaf(ckb, kernreq, ckb_offset);
+    self->m_src_el_tp = src_el_tp;
+    self->m_src_el_meta = src_el_meta;
+    self->m_dim_size = src_dim_size;
+    self->m_src_stride = src_stride;
+    self->m_dst_stride = dst_stride;
+    self->m_ectx = *ectx;
+    return ckb_offset;
+  }
+
+  sort_ck *self = sort_ck::create(ckb, kernreq, ckb_offset);
+  self->m_src_el_tp = src_el_tp;
+  self->m_src_el_meta = src_el_meta;
+  self->m_dim_size = src_dim_size;
+  self->m_src_stride = src_stride;
+  self->m_dst_stride = dst_stride;
+  self->m_ectx = *ectx;
+  // Create the child element assignment ckernel
+  return make_assignment_kernel(ckb, ckb_offset, dst_el_tp, dst_el_meta,
+                                src_el_tp, src_el_meta, kernel_request_single,
+                                ectx);
+}
+
+static nd::arrfunc make_sort_arrfunc_instance(sort_arrfunc_kind_t kind,
+                                              const char *proto)
+{
+  nd::array af = nd::empty(ndt::type(proto));
+  arrfunc_type_data *out_af =
+      reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
+  *out_af->get_data_as<sort_arrfunc_kind_t>() = kind;
+  out_af->free_func = NULL;
+  out_af->resolve_dst_type = &resolve_sort_dst_type;
+  out_af->instantiate = &instantiate_sort;
+  af.flag_as_immutable();
+  return af;
+}
+
+nd::arrfunc dynd::make_sort_arrfunc()
+{
+  return make_sort_arrfunc_instance(sort_arrfunc_sort, "(N * T) -> N * T");
+}
+
+nd::arrfunc dynd::make_argsort_arrfunc()
+{
+  return make_sort_arrfunc_instance(sort_arrfunc_argsort,
+                                    "(N * T) -> N * intptr");
+}
+
+nd::arrfunc dynd::make_unique_arrfunc()
+{
+  return make_sort_arrfunc_instance(sort_arrfunc_unique,
+                                    "(N * T) -> var * T");
+}
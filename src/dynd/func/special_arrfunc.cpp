@@ -0,0 +1,152 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/func/special_arrfunc.hpp>
+#include <dynd/kernels/expr_kernels.hpp>
+#include <dynd/kernels/special_kernels.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+enum airy_arrfunc_kind_t {
+  airy_arrfunc_airy,
+  airy_arrfunc_ai,
+  airy_arrfunc_bi
+};
+
+const char *airy_arrfunc_names[3] = {"airy", "airy_ai", "airy_bi"};
+
+void (*const airy_arrfunc_batch[3])(double *, const double *, size_t) = {
+    &kernels::special::airy, &kernels::special::airy_ai,
+    &kernels::special::airy_bi};
+
+/**
+ * CKernel which evaluates one of the Airy functions. Each element
+ * produces ``m_rows`` rows of a value and its derivative, which the
+ * batch kernel writes contiguously, so strided data goes through
+ * buffers of DYND_BUFFER_CHUNK_SIZE elements.
+ */
+struct airy_ck : public kernels::expr_ck<airy_ck, kernel_request_host, 1> {
+  void (*m_batch)(double *, const double *, size_t);
+  intptr_t m_rows, m_row_stride, m_col_stride;
+
+  inline void scatter(char *dst, const double *res) const
+  {
+    for (intptr_t i = 0; i < m_rows; ++i) {
+      *reinterpret_cast<double *>(dst + i * m_row_stride) = res[2 * i];
+      *reinterpret_cast<double *>(dst + i * m_row_stride + m_col_stride) =
+          res[2 * i + 1];
+    }
+  }
+
+  inline void single(char *dst, char **src)
+  {
+    double res[4];
+    m_batch(res, reinterpret_cast<const double *>(src[0]), 1);
+    scatter(dst, res);
+  }
+
+  inline void strided(char *dst, intptr_t dst_stride, char **src,
+                      const intptr_t *src_stride, size_t count)
+  {
+    intptr_t el_size = 2 * m_rows * sizeof(double);
+    bool dst_contiguous =
+        dst_stride == el_size && m_col_stride == sizeof(double) &&
+        (m_rows == 1 || m_row_stride == 2 * sizeof(double));
+    if (dst_contiguous && src_stride[0] == sizeof(double)) {
+      m_batch(reinterpret_cast<double *>(dst),
+              reinterpret_cast<const double *>(src[0]), count);
+      return;
+    }
+    double src_buf[DYND_BUFFER_CHUNK_SIZE];
+    double dst_buf[4 * DYND_BUFFER_CHUNK_SIZE];
+    const char *src_ptr = src[0];
+    for (size_t offset = 0; offset < count;
+         offset += DYND_BUFFER_CHUNK_SIZE) {
+      size_t n = count - offset < DYND_BUFFER_CHUNK_SIZE
+                     ? count - offset
+                     : DYND_BUFFER_CHUNK_SIZE;
+      for (size_t i = 0; i < n; ++i, src_ptr += src_stride[0]) {
+        src_buf[i] = *reinterpret_cast<const double *>(src_ptr);
+      }
+      m_batch(dst_buf, src_buf, n);
+      for (size_t i = 0; i < n; ++i, dst += dst_stride) {
+        scatter(dst, dst_buf + 2 * m_rows * i);
+      }
+    }
+  }
+};
+} // anonymous namespace
+
+static intptr_t instantiate_airy(
+    const arrfunc_type_data *af_self, const arrfunc_type *DYND_UNUSED(af_tp),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, const ndt::type *src_tp,
+    const char *const *DYND_UNUSED(src_arrmeta), kernel_request_t kernreq,
+    const eval::eval_context *DYND_UNUSED(ectx),
+    const nd::array &DYND_UNUSED(args), const nd::array &DYND_UNUSED(kwds))
+{
+  airy_arrfunc_kind_t kind = *af_self->get_data_as<airy_arrfunc_kind_t>();
+  intptr_t rows = (kind == airy_arrfunc_airy) ? 2 : 1;
+  ndt::type expected_dst_tp = ndt::make_fixed_dim(2, ndt::make_type<double>());
+  if (rows == 2) {
+    expected_dst_tp = ndt::make_fixed_dim(2, expected_dst_tp);
+  }
+  if (src_tp[0].get_type_id() != float64_type_id ||
+      dst_tp != expected_dst_tp) {
+    stringstream ss;
+    ss << airy_arrfunc_names[kind] << " arrfunc: could not evaluate "
+       << src_tp[0] << " into " << dst_tp << ", expected float64 into "
+       << expected_dst_tp;
+    throw type_error(ss.str());
+  }
+
+  airy_ck *self = airy_ck::create_leaf(ckb, kernreq, ckb_offset);
+  self->m_batch = airy_arrfunc_batch[kind];
+  self->m_rows = rows;
+  const fixed_dim_type_arrmeta *md =
+      reinterpret_cast<const fixed_dim_type_arrmeta *>(dst_arrmeta);
+  if (rows == 2) {
+    self->m_row_stride = md[0].stride;
+    self->m_col_stride = md[1].stride;
+  } else {
+    self->m_row_stride = 0;
+    self->m_col_stride = md[0].stride;
+  }
+  return ckb_offset;
+}
+
+static nd::arrfunc make_airy_arrfunc_instance(airy_arrfunc_kind_t kind,
+                                              const char *proto)
+{
+  nd::array af = nd::empty(ndt::type(proto));
+  arrfunc_type_data *out_af =
+      reinterpret_cast<arrfunc_type_data *>(af.get_readwrite_originptr());
+  *out_af->get_data_as<airy_arrfunc_kind_t>() = kind;
+  out_af->free_func = NULL;
+  out_af->instantiate = &instantiate_airy;
+  af.flag_as_immutable();
+  return af;
+}
+
+nd::arrfunc dynd::make_airy_arrfunc()
+{
+  return make_airy_arrfunc_instance(airy_arrfunc_airy,
+                                    "(float64) -> 2 * 2 * float64");
+}
+
+nd::arrfunc dynd::make_airy_ai_arrfunc()
+{
+  return make_airy_arrfunc_instance(airy_arrfunc_ai,
+                                    "(float64) -> 2 * float64");
+}
+
+nd::arrfunc dynd::make_airy_bi_arrfunc()
+{
+  return make_airy_arrfunc_instance(airy_arrfunc_bi,
+                                    "(float64) -> 2 * float64");
+}
@@ -21,20 +21,17 @@ struct masked_take_ck : public kernels::expr_ck<masked_take_ck, kernel_request_h
     const char *m_dst_meta;
     intptr_t m_dim_size, m_src0_stride, m_mask_stride;
 
-    inline void single(char *dst, char **src)
+    /**
+     * Copies the elements of ``src0`` selected by ``mask`` to ``dst_ptr``,
+     * returning how many there were.
+     */
+    inline intptr_t copy_selected(char *dst_ptr, char *src0, char *mask)
     {
         ckernel_prefix *child = get_child_ckernel();
         expr_strided_t child_fn =
                      child->get_function<expr_strided_t>();
-        char *src0 = src[0];
-        char *mask = src[1];
         intptr_t dim_size = m_dim_size, src0_stride = m_src0_stride,
                  mask_stride = m_mask_stride;
-        // Start with the dst matching the dim size. (Maybe better to
-        // do smaller? This means no resize required in the loop.)
-        ndt::var_dim_element_initialize(m_dst_tp, m_dst_meta, dst, dim_size);
-        var_dim_type_data *vdd = reinterpret_cast<var_dim_type_data *>(dst);
-        char *dst_ptr = vdd->begin;
         intptr_t dst_stride =
             reinterpret_cast<const var_dim_type_arrmeta *>(m_dst_meta)->stride;
         intptr_t dst_count = 0;
@@ -58,15 +55,48 @@ struct masked_take_ck : public kernels::expr_ck<masked_take_ck, kernel_request_h
                 dst_count += run_count;
             }
         }
+        return dst_count;
+    }
+
+    inline void single(char *dst, char **src)
+    {
+        // Start with the dst matching the dim size. (Maybe better to
+        // do smaller? This means no resize required in the loop.)
+        ndt::var_dim_element_initialize(m_dst_tp, m_dst_meta, dst, m_dim_size);
+        var_dim_type_data *vdd = reinterpret_cast<var_dim_type_data *>(dst);
+        intptr_t dst_count = copy_selected(vdd->begin, src[0], src[1]);
         // Shrink the var dim element to fit
         ndt::var_dim_element_resize(m_dst_tp, m_dst_meta, dst, dst_count);
     }
 
+    inline void strided(char *dst, intptr_t dst_stride, char **src,
+                        const intptr_t *src_stride, size_t count)
+    {
+        // All the outputs share one arrmeta, so carve them out of the
+        // memory block back to back. Each one gets room for the whole
+        // dim, and only keeps what was selected.
+        ndt::var_dim_builder builder(m_dst_tp, m_dst_meta);
+        char *src0 = src[0], *mask = src[1];
+        intptr_t src0_stride = src_stride[0], mask_stride = src_stride[1];
+        for (size_t i = 0; i != count; ++i) {
+            char *dst_ptr = builder.open(m_dim_size);
+            builder.close(dst, copy_selected(dst_ptr, src0, mask));
+            dst += dst_stride;
+            src0 += src0_stride;
+            mask += mask_stride;
+        }
+    }
+
     inline void destruct_children()
     {
         // The child copy ckernel
         get_child_ckernel()->destroy();
     }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        base.clone_child_ckernels(dst, sizeof(self_type));
+    }
 };
 
 /**
@@ -104,6 +134,11 @@ struct indexed_take_ck : public kernels::expr_ck<indexed_take_ck, kernel_request
         // The child copy ckernel
         get_child_ckernel()->destroy();
     }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        base.clone_child_ckernels(dst, sizeof(self_type));
+    }
 };
 } // anonymous namespace
 
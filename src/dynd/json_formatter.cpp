@@ -3,7 +3,19 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <errno.h>
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <vector>
+
 #include <dynd/json_formatter.hpp>
+#include <dynd/parallel.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/types/json_type.hpp>
 #include <dynd/types/date_type.hpp>
@@ -19,25 +31,59 @@ using namespace dynd;
 
 struct output_data {
   char *out_begin, *out_end, *out_capacity_end;
+  // The output grows in this pod memory block, or in ``buffer`` if it is NULL
   memory_block_pod_allocator_api *api;
   memory_block_data *blockref;
+  std::vector<char> buffer;
+  // If not NULL, full output is passed to the sink instead of growing
+  const json_sink_t *sink;
+  // The number of bytes passed to the sink so far
+  intptr_t flushed;
   bool struct_as_list;
 
+  output_data()
+      : out_begin(NULL), out_end(NULL), out_capacity_end(NULL), api(NULL),
+        blockref(NULL), sink(NULL), flushed(0), struct_as_list(false)
+  {
+  }
+
   void ensure_capacity(intptr_t added_capacity)
   {
-    // If there's not enough space, double the capacity
     if (out_capacity_end - out_end < added_capacity) {
+      if (sink != NULL) {
+        flush();
+        if (out_capacity_end - out_end >= added_capacity) {
+          return;
+        }
+      }
+      // If there's not enough space, double the capacity
       intptr_t current_size = out_end - out_begin;
       intptr_t new_capacity = 2 * (out_capacity_end - out_begin);
       // Make sure this adds the requested additional capacity
       if (new_capacity < current_size + added_capacity) {
         new_capacity = current_size + added_capacity;
       }
-      api->resize(blockref, new_capacity, &out_begin, &out_capacity_end);
+      if (api != NULL) {
+        api->resize(blockref, new_capacity, &out_begin, &out_capacity_end);
+      } else {
+        buffer.resize(new_capacity);
+        out_begin = &buffer[0];
+        out_capacity_end = out_begin + new_capacity;
+      }
       out_end = out_begin + current_size;
     }
   }
 
+  // Passes the output so far to the sink, emptying the buffer
+  void flush()
+  {
+    if (out_end != out_begin) {
+      (*sink)(out_begin, out_end - out_begin);
+      flushed += out_end - out_begin;
+      out_end = out_begin;
+    }
+  }
+
   inline void write(char c)
   {
     ensure_capacity(1);
@@ -392,3 +438,185 @@ nd::array dynd::format_json(const nd::array& n, bool struct_as_list)
 
   return result;
 }
+
+/**
+ * Gets the elements of the leading dimension of the type, returning false
+ * if it does not have one.
+ */
+static bool get_leading_dim(const ndt::type &dt, const char *arrmeta,
+                            const char *data, intptr_t &out_size,
+                            intptr_t &out_stride, ndt::type &out_element_tp,
+                            const char *&out_element_arrmeta,
+                            const char *&out_begin)
+{
+  switch (dt.get_type_id()) {
+  case cfixed_dim_type_id:
+  case fixed_dim_type_id: {
+    const fixed_dim_type_arrmeta *md =
+        reinterpret_cast<const fixed_dim_type_arrmeta *>(arrmeta);
+    out_size = md->dim_size;
+    out_stride = md->stride;
+    out_element_tp = dt.extended<base_dim_type>()->get_element_type();
+    out_element_arrmeta = arrmeta + sizeof(fixed_dim_type_arrmeta);
+    out_begin = data;
+    return true;
+  }
+  case var_dim_type_id: {
+    const var_dim_type_arrmeta *md =
+        reinterpret_cast<const var_dim_type_arrmeta *>(arrmeta);
+    const var_dim_type_data *d =
+        reinterpret_cast<const var_dim_type_data *>(data);
+    out_size = d->size;
+    out_stride = md->stride;
+    out_element_tp = dt.extended<var_dim_type>()->get_element_type();
+    out_element_arrmeta = arrmeta + sizeof(var_dim_type_arrmeta);
+    out_begin = d->begin + md->offset;
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+/**
+ * Formats the elements [begin, end) of a leading dimension, separated by
+ * commas as in a JSON list, or each followed by a newline for ndjson.
+ */
+static void format_json_elements(output_data &out, const ndt::type &element_tp,
+                                 const char *element_arrmeta,
+                                 const char *data, intptr_t stride,
+                                 intptr_t begin, intptr_t end, bool ndjson)
+{
+  for (intptr_t i = begin; i < end; ++i) {
+    if (!ndjson && i != 0) {
+      out.write(',');
+    }
+    ::format_json(out, element_tp, element_arrmeta, data + i * stride);
+    if (ndjson) {
+      out.write('\n');
+    }
+  }
+}
+
+void dynd::format_json_stream(const nd::array &n, const json_sink_t &sink,
+                              bool struct_as_list, bool ndjson,
+                              intptr_t chunk_size)
+{
+  if (chunk_size < 64) {
+    chunk_size = 64;
+  }
+  nd::array tmp = n.get_type().is_expression() ? n.eval() : n;
+
+  output_data out;
+  out.sink = &sink;
+  out.struct_as_list = struct_as_list;
+  out.ensure_capacity(chunk_size);
+
+  intptr_t size, stride;
+  ndt::type element_tp;
+  const char *element_arrmeta, *begin;
+  if (!get_leading_dim(tmp.get_type(), tmp.get_arrmeta(),
+                       tmp.get_readonly_originptr(), size, stride, element_tp,
+                       element_arrmeta, begin)) {
+    ::format_json(out, tmp.get_type(), tmp.get_arrmeta(),
+                  tmp.get_readonly_originptr());
+    if (ndjson) {
+      out.write('\n');
+    }
+    out.flush();
+    return;
+  }
+
+  if (!ndjson) {
+    out.write('[');
+  }
+  // Format the first few elements here, to estimate the size of a block
+  // which fills about a chunk
+  intptr_t done = min<intptr_t>(size, 16);
+  format_json_elements(out, element_tp, element_arrmeta, begin, stride, 0,
+                       done, ndjson);
+  intptr_t done_bytes = out.flushed + (out.out_end - out.out_begin);
+
+  intptr_t nthreads = parallel::get_num_threads();
+  vector<output_data> blocks(nthreads);
+  while (done < size) {
+    intptr_t block_size =
+        max<intptr_t>(1, chunk_size / max<intptr_t>(1, done_bytes / done));
+    intptr_t block_count =
+        min<intptr_t>(nthreads, (size - done + block_size - 1) / block_size);
+    if (block_count <= 1) {
+      // The rest streams straight through the output buffer
+      format_json_elements(out, element_tp, element_arrmeta, begin, stride,
+                           done, size, ndjson);
+      break;
+    }
+
+    // Each thread formats one block into its own buffer, which keeps its
+    // memory from one round to the next
+    parallel::parallel_for(
+        block_count, block_count, 1,
+        [&](intptr_t DYND_UNUSED(partition), intptr_t b_begin,
+            intptr_t b_end) {
+          for (intptr_t b = b_begin; b < b_end; ++b) {
+            output_data &block = blocks[b];
+            block.struct_as_list = struct_as_list;
+            block.out_end = block.out_begin;
+            intptr_t i_begin = done + b * block_size;
+            format_json_elements(block, element_tp, element_arrmeta, begin,
+                                 stride, i_begin,
+                                 min<intptr_t>(size, i_begin + block_size),
+                                 ndjson);
+          }
+        });
+
+    // Write the blocks in order
+    out.flush();
+    for (intptr_t b = 0; b < block_count; ++b) {
+      intptr_t block_bytes = blocks[b].out_end - blocks[b].out_begin;
+      sink(blocks[b].out_begin, block_bytes);
+      done_bytes += block_bytes;
+    }
+    done = min<intptr_t>(size, done + block_count * block_size);
+  }
+  if (!ndjson) {
+    out.write(']');
+  }
+  out.flush();
+}
+
+void dynd::format_json_fd(const nd::array &a, int fd, bool struct_as_list,
+                          bool ndjson, intptr_t chunk_size)
+{
+  format_json_stream(a, [fd](const char *begin, size_t size) {
+    while (size > 0) {
+#ifdef WIN32
+      int written = _write(fd, begin, (unsigned int)min<size_t>(size, 1 << 30));
+#else
+      ssize_t written = ::write(fd, begin, size);
+#endif
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        stringstream ss;
+        ss << "format_json_fd: error writing to file descriptor " << fd
+           << ": " << strerror(errno);
+        throw runtime_error(ss.str());
+      }
+      begin += written;
+      size -= written;
+    }
+  }, struct_as_list, ndjson, chunk_size);
+}
+
+void dynd::format_json_file(const nd::array &a, FILE *f, bool struct_as_list,
+                            bool ndjson, intptr_t chunk_size)
+{
+  format_json_stream(a, [f](const char *begin, size_t size) {
+    if (fwrite(begin, 1, size, f) != size) {
+      stringstream ss;
+      ss << "format_json_file: error writing to the file: " << strerror(errno);
+      throw runtime_error(ss.str());
+    }
+  }, struct_as_list, ndjson, chunk_size);
+}
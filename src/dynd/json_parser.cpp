@@ -16,8 +16,11 @@
 #include <dynd/types/time_type.hpp>
 #include <dynd/types/option_type.hpp>
 #include <dynd/kernels/string_numeric_assignment_kernels.hpp>
+#include <dynd/memblock/pod_memory_block.hpp>
 #include <dynd/parser_util.hpp>
 
+#include <utf8.h>
+
 using namespace std;
 using namespace dynd;
 
@@ -36,7 +39,9 @@ namespace {
     };
 } // anonymous namespace
 
-static void json_as_buffer(const nd::array& json, nd::array& out_tmp_ref, const char *&begin, const char *&end)
+static void json_as_buffer(const nd::array& json, nd::array& out_tmp_ref,
+                           const char *&begin, const char *&end,
+                           memory_block_data *&out_input_ref)
 {
     // Check the type of 'json', and get pointers to the begin/end of a UTF-8 buffer
     ndt::type json_type = json.get_type().value_type();
@@ -78,29 +83,58 @@ static void json_as_buffer(const nd::array& json, nd::array& out_tmp_ref, const
             break;
         }
     }
+
+    // The memory block which owns the buffer. For string and bytes this
+    // is the blockref of the arrmeta, otherwise the data is in the array
+    const string_type_arrmeta *md =
+        reinterpret_cast<const string_type_arrmeta *>(out_tmp_ref.get_arrmeta());
+    if ((out_tmp_ref.get_type().get_flags() & type_flag_blockref) != 0 &&
+            md->blockref != NULL) {
+        out_input_ref = md->blockref;
+    } else {
+        out_input_ref = out_tmp_ref.get_memblock().get();
+    }
 }
 
+static void parse_json_range(const ndt::type &tp, const char *arrmeta,
+                             char *out_data, const char *json_begin,
+                             const char *json_end,
+                             const eval::eval_context *ectx,
+                             memory_block_data *input_ref);
+
 void dynd::parse_json(nd::array &out, const nd::array &json,
-                      const eval::eval_context *ectx)
+                      const eval::eval_context *ectx, bool reference_input)
 {
     const char *json_begin = NULL, *json_end = NULL;
     nd::array tmp_ref;
-    json_as_buffer(json, tmp_ref, json_begin, json_end);
-    parse_json(out, json_begin, json_end, ectx);
+    memory_block_data *input_ref = NULL;
+    json_as_buffer(json, tmp_ref, json_begin, json_end, input_ref);
+    parse_json_range(out.get_type(), out.get_arrmeta(),
+                     out.get_readwrite_originptr(), json_begin, json_end, ectx,
+                     reference_input ? input_ref : NULL);
 }
 
 nd::array dynd::parse_json(const ndt::type &tp, const nd::array &json,
-                           const eval::eval_context *ectx)
+                           const eval::eval_context *ectx, bool reference_input)
 {
-    const char *json_begin = NULL, *json_end = NULL;
-    nd::array tmp_ref;
-    json_as_buffer(json, tmp_ref, json_begin, json_end);
-    return parse_json(tp, json_begin, json_end, ectx);
+    nd::array result;
+    result = nd::empty(tp);
+    parse_json(result, json, ectx, reference_input);
+    if (!tp.is_builtin()) {
+        tp.extended()->arrmeta_finalize_buffers(result.get_arrmeta());
+    }
+    return result;
 }
 
+/**
+ * Parses one JSON value into the data of type ``tp``. When ``input_ref``
+ * is not NULL, it is the memory block holding the JSON text, and string
+ * values without escapes point into it rather than being copied.
+ */
 static void parse_json(const ndt::type &tp, const char *arrmeta,
                        char *out_data, const char *&json_begin,
-                       const char *json_end, const eval::eval_context *ectx);
+                       const char *json_end, const eval::eval_context *ectx,
+                       memory_block_data *input_ref);
 
 static const char *skip_whitespace(const char *begin, const char *end)
 {
@@ -209,7 +243,8 @@ static void skip_json_value(const char *&begin, const char *end)
 }
 
 static void parse_strided_dim_json(const ndt::type& tp, const char *arrmeta, char *out_data,
-                const char *&begin, const char *end, const eval::eval_context *ectx)
+                const char *&begin, const char *end, const eval::eval_context *ectx,
+                memory_block_data *input_ref)
 {
     intptr_t dim_size, stride;
     ndt::type el_tp;
@@ -222,7 +257,8 @@ static void parse_strided_dim_json(const ndt::type& tp, const char *arrmeta, cha
         throw json_parse_error(begin, "expected list starting with '['", tp);
     }
     for (intptr_t i = 0; i < dim_size; ++i) {
-        parse_json(el_tp, el_arrmeta, out_data + i * stride, begin, end, ectx);
+        ::parse_json(el_tp, el_arrmeta, out_data + i * stride, begin, end, ectx,
+                     input_ref);
         if (i < dim_size-1 && !parse_token(begin, end, ",")) {
             throw json_parse_error(begin, "array is too short, expected ',' list item separator", tp);
         }
@@ -233,7 +269,8 @@ static void parse_strided_dim_json(const ndt::type& tp, const char *arrmeta, cha
 }
 
 static void parse_var_dim_json(const ndt::type& tp, const char *arrmeta, char *out_data,
-                const char *&begin, const char *end, const eval::eval_context *ectx)
+                const char *&begin, const char *end, const eval::eval_context *ectx,
+                memory_block_data *input_ref)
 {
     const var_dim_type *vad = tp.extended<var_dim_type>();
     const var_dim_type_arrmeta *md = reinterpret_cast<const var_dim_type_arrmeta *>(arrmeta);
@@ -261,8 +298,9 @@ static void parse_var_dim_json(const ndt::type& tp, const char *arrmeta, char *o
             }
             ++size;
             out->size = size;
-            parse_json(element_tp, arrmeta + sizeof(var_dim_type_arrmeta),
-                            out->begin + (size-1) * stride, begin, end, ectx);
+            ::parse_json(element_tp, arrmeta + sizeof(var_dim_type_arrmeta),
+                            out->begin + (size-1) * stride, begin, end, ectx,
+                            input_ref);
             if (!parse_token(begin, end, ",")) {
                 break;
             }
@@ -280,7 +318,8 @@ static void parse_var_dim_json(const ndt::type& tp, const char *arrmeta, char *o
 static bool parse_struct_json_from_object(const ndt::type &tp,
                                           const char *arrmeta, char *out_data,
                                           const char *&begin, const char *end,
-                                          const eval::eval_context *ectx)
+                                          const eval::eval_context *ectx,
+                                          memory_block_data *input_ref)
 {
     const char *saved_begin = begin;
     if (!parse_token(begin, end, "{")) {
@@ -322,8 +361,9 @@ static bool parse_struct_json_from_object(const ndt::type &tp,
                 //       or not. For now, just throw away fields not in the destination.
                 skip_json_value(begin, end);
             } else {
-                parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i],
-                           out_data + data_offsets[i], begin, end, ectx);
+                ::parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i],
+                           out_data + data_offsets[i], begin, end, ectx,
+                           input_ref);
                 populated_fields[i] = true;
             }
             if (!parse_token(begin, end, ",")) {
@@ -351,7 +391,8 @@ static bool parse_struct_json_from_object(const ndt::type &tp,
 static bool parse_struct_json_from_list(const ndt::type &tp,
                                         const char *arrmeta, char *out_data,
                                         const char *&begin, const char *end,
-                                        const eval::eval_context *ectx)
+                                        const eval::eval_context *ectx,
+                                        memory_block_data *input_ref)
 {
     if (!parse_token(begin, end, "[")) {
         return false;
@@ -365,8 +406,9 @@ static bool parse_struct_json_from_list(const ndt::type &tp,
     // Loop through all the fields
     for (intptr_t i = 0; i != field_count; ++i) {
         begin = skip_whitespace(begin, end);
-        parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i],
-                   out_data + data_offsets[i], begin, end, ectx);
+        ::parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i],
+                   out_data + data_offsets[i], begin, end, ectx,
+                   input_ref);
         if (i != field_count - 1 && !parse_token(begin, end, ",")) {
             throw json_parse_error(begin, "expected list item separator ','",
                                    tp);
@@ -381,10 +423,13 @@ static bool parse_struct_json_from_list(const ndt::type &tp,
 }
 
 static void parse_struct_json(const ndt::type& tp, const char *arrmeta, char *out_data,
-                const char *&begin, const char *end, const eval::eval_context *ectx)
+                const char *&begin, const char *end, const eval::eval_context *ectx,
+                memory_block_data *input_ref)
 {
-    if (parse_struct_json_from_object(tp, arrmeta, out_data, begin, end, ectx)) {
-    } else if (parse_struct_json_from_list(tp, arrmeta, out_data, begin, end, ectx)) {
+    if (parse_struct_json_from_object(tp, arrmeta, out_data, begin, end, ectx,
+                                      input_ref)) {
+    } else if (parse_struct_json_from_list(tp, arrmeta, out_data, begin, end,
+                                           ectx, input_ref)) {
     } else {
         throw json_parse_error(
             begin, "expected object dict starting with '{' or list with '['",
@@ -488,21 +533,65 @@ static void parse_number_json(const ndt::type &tp, const char *arrmeta,
     rbegin = begin;
 }
 
+/**
+ * Points the string or json value at ``out_data`` into the input JSON,
+ * for types which store the UTF-8 as is. The output's memory block
+ * takes a reference to ``input_ref``. Returns false if the value needs
+ * to be copied instead.
+ */
+static bool reference_input_string(const ndt::type &tp, const char *arrmeta,
+                                   char *out_data, const char *strbegin,
+                                   const char *strend,
+                                   const eval::eval_context *ectx,
+                                   memory_block_data *input_ref)
+{
+    if (tp.get_type_id() == string_type_id) {
+        if (tp.extended<base_string_type>()->get_encoding() !=
+                string_encoding_utf_8) {
+            return false;
+        }
+        // Invalid UTF-8 gets copied, which handles it by the error mode
+        if (ectx->errmode != assign_error_nocheck &&
+                !utf8::is_valid(strbegin, strend)) {
+            return false;
+        }
+    } else if (tp.get_type_id() != json_type_id) {
+        return false;
+    }
+    const string_type_arrmeta *md =
+        reinterpret_cast<const string_type_arrmeta *>(arrmeta);
+    if (md->blockref == NULL ||
+            md->blockref->m_type != pod_memory_block_type) {
+        return false;
+    }
+    pod_memory_block_add_blockref(md->blockref, input_ref);
+    string_type_data *d = reinterpret_cast<string_type_data *>(out_data);
+    d->begin = const_cast<char *>(strbegin);
+    d->end = const_cast<char *>(strend);
+    return true;
+}
+
 static void parse_jsonstring_json(const ndt::type &tp, const char *arrmeta,
                                   char *out_data, const char *&begin,
                                   const char *end,
-                                  const eval::eval_context *ectx)
+                                  const eval::eval_context *ectx,
+                                  memory_block_data *input_ref)
 {
     const char *saved_begin = skip_whitespace(begin, end);
     skip_json_value(begin, end);
-    const base_string_type *bsd = tp.extended<base_string_type>();
     // The skipped JSON value gets copied verbatim into the json string
-    bsd->set_from_utf8_string(arrmeta, out_data, saved_begin, begin, ectx);
+    if (input_ref == NULL ||
+            !reference_input_string(tp, arrmeta, out_data, saved_begin, begin,
+                                    ectx, input_ref)) {
+        const base_string_type *bsd = tp.extended<base_string_type>();
+        bsd->set_from_utf8_string(arrmeta, out_data, saved_begin, begin, ectx);
+    }
 }
 
 static void parse_string_json(const ndt::type &tp, const char *arrmeta,
                               char *out_data, const char *&rbegin,
-                              const char *end, const eval::eval_context *ectx)
+                              const char *end, const eval::eval_context *ectx,
+                              memory_block_data *input_ref)
 {
     const char *begin = rbegin;
     begin = skip_whitespace(begin, end);
@@ -513,8 +602,12 @@ static void parse_string_json(const ndt::type &tp, const char *arrmeta,
         const base_string_type *bsd = tp.extended<base_string_type>();
         try {
             if (!escaped) {
-                bsd->set_from_utf8_string(arrmeta, out_data, strbegin, strend,
-                                          ectx);
+                if (input_ref == NULL ||
+                        !reference_input_string(tp, arrmeta, out_data, strbegin,
+                                                strend, ectx, input_ref)) {
+                    bsd->set_from_utf8_string(arrmeta, out_data, strbegin,
+                                              strend, ectx);
+                }
             } else {
                 string val;
                 parse::unescape_string(strbegin, strend, val);
@@ -577,15 +670,17 @@ static void parse_datetime_json(const ndt::type &tp, const char *arrmeta,
 }
 
 static void parse_dim_json(const ndt::type& tp, const char *arrmeta, char *out_data,
-                const char *&begin, const char *end, const eval::eval_context *ectx)
+                const char *&begin, const char *end, const eval::eval_context *ectx,
+                memory_block_data *input_ref)
 {
     switch (tp.get_type_id()) {
         case fixed_dim_type_id:
         case cfixed_dim_type_id:
-            parse_strided_dim_json(tp, arrmeta, out_data, begin, end, ectx);
+            parse_strided_dim_json(tp, arrmeta, out_data, begin, end, ectx,
+                                   input_ref);
             break;
         case var_dim_type_id:
-            parse_var_dim_json(tp, arrmeta, out_data, begin, end, ectx);
+            parse_var_dim_json(tp, arrmeta, out_data, begin, end, ectx, input_ref);
             break;
         default: {
             stringstream ss;
@@ -672,15 +767,16 @@ static void parse_option_json(const ndt::type &tp, const char *arrmeta,
 
 static void parse_json(const ndt::type &tp, const char *arrmeta, char *out_data,
                        const char *&begin, const char *end,
-                       const eval::eval_context *ectx)
+                       const eval::eval_context *ectx,
+                       memory_block_data *input_ref)
 {
     begin = skip_whitespace(begin, end);
     switch (tp.get_kind()) {
         case dim_kind:
-            parse_dim_json(tp, arrmeta, out_data, begin, end, ectx);
+            parse_dim_json(tp, arrmeta, out_data, begin, end, ectx, input_ref);
             return;
         case struct_kind:
-            parse_struct_json(tp, arrmeta, out_data, begin, end, ectx);
+            parse_struct_json(tp, arrmeta, out_data, begin, end, ectx, input_ref);
             return;
         case bool_kind:
             parse_bool_json(tp, arrmeta, out_data, begin, end,
@@ -694,7 +790,8 @@ static void parse_json(const ndt::type &tp, const char *arrmeta, char *out_data,
                                false, ectx);
             return;
         case string_kind:
-            parse_string_json(tp, arrmeta, out_data, begin, end, ectx);
+            parse_string_json(tp, arrmeta, out_data, begin, end, ectx,
+                              input_ref);
             return;
         case datetime_kind:
             parse_datetime_json(tp, arrmeta, out_data, begin, end,
@@ -707,7 +804,8 @@ static void parse_json(const ndt::type &tp, const char *arrmeta, char *out_data,
             if (tp.get_type_id() == json_type_id) {
                 // The json type is a special string type that contains JSON directly
                 // Copy the JSON verbatim in this case.
-                parse_jsonstring_json(tp, arrmeta, out_data, begin, end, ectx);
+                parse_jsonstring_json(tp, arrmeta, out_data, begin, end, ectx,
+                                      input_ref);
                 return;
             }
             break;
@@ -809,11 +907,28 @@ void dynd::validate_json(const char *json_begin, const char *json_end)
 
 void dynd::parse_json(nd::array &out, const char *json_begin,
                       const char *json_end, const eval::eval_context *ectx)
+{
+    parse_json_range(out.get_type(), out.get_arrmeta(),
+                     out.get_readwrite_originptr(), json_begin, json_end, ectx,
+                     NULL);
+}
+
+void dynd::parse_json(const ndt::type &tp, const char *arrmeta, char *out_data,
+                      const char *json_begin, const char *json_end,
+                      const eval::eval_context *ectx)
+{
+    parse_json_range(tp, arrmeta, out_data, json_begin, json_end, ectx, NULL);
+}
+
+static void parse_json_range(const ndt::type &tp, const char *arrmeta,
+                             char *out_data, const char *json_begin,
+                             const char *json_end,
+                             const eval::eval_context *ectx,
+                             memory_block_data *input_ref)
 {
     try {
         const char *begin = json_begin, *end = json_end;
-        ndt::type tp = out.get_type();
-        ::parse_json(tp, out.get_arrmeta(), out.get_readwrite_originptr(), begin, end, ectx);
+        ::parse_json(tp, arrmeta, out_data, begin, end, ectx, input_ref);
         begin = skip_whitespace(begin, end);
         if (begin != end) {
             throw json_parse_error(begin, "unexpected trailing JSON text", tp);
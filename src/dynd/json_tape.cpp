@@ -0,0 +1,354 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DYND_JSON_TAPE_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include <dynd/json_tape.hpp>
+#include <dynd/parser_util.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+/** Index of the lowest set bit, ``x`` must be nonzero */
+inline int lowest_bit(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long result;
+    _BitScanForward64(&result, x);
+    return (int)result;
+#else
+    int result = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        ++result;
+    }
+    return result;
+#endif
+}
+
+/**
+ * Sets each bit to the xor of it and all the bits below it, which turns
+ * the bits of the quotes into the bits inside strings, counting the
+ * opening quote but not the closing one.
+ */
+inline uint64_t prefix_xor(uint64_t x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/**
+ * Finds the quotes, backslashes and structural characters in the 64
+ * bytes at ``p``, one bit per byte.
+ */
+inline void classify_block(const char *p, uint64_t &out_quote,
+                           uint64_t &out_backslash, uint64_t &out_structural)
+{
+#ifdef DYND_JSON_TAPE_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    // '[' and ']' differ from '{' and '}' only by the bit 0x20
+    const __m128i fold = _mm_set1_epi8(0x20);
+    const __m128i open_brace = _mm_set1_epi8('{');
+    const __m128i close_brace = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    out_quote = out_backslash = out_structural = 0;
+    for (int i = 0; i < 4; ++i) {
+        __m128i v =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * i));
+        __m128i folded = _mm_or_si128(v, fold);
+        __m128i s = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, open_brace),
+                         _mm_cmpeq_epi8(folded, close_brace)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+        out_quote |= uint64_t(uint16_t(_mm_movemask_epi8(
+                         _mm_cmpeq_epi8(v, quote)))) << (16 * i);
+        out_backslash |= uint64_t(uint16_t(_mm_movemask_epi8(
+                             _mm_cmpeq_epi8(v, backslash)))) << (16 * i);
+        out_structural |= uint64_t(uint16_t(_mm_movemask_epi8(s)))
+                          << (16 * i);
+    }
+#else
+    out_quote = out_backslash = out_structural = 0;
+    for (int i = 0; i < 64; ++i) {
+        switch (p[i]) {
+        case '"':
+            out_quote |= uint64_t(1) << i;
+            break;
+        case '\\':
+            out_backslash |= uint64_t(1) << i;
+            break;
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+            out_structural |= uint64_t(1) << i;
+            break;
+        default:
+            break;
+        }
+    }
+#endif
+}
+
+inline bool is_json_whitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline void trim(const char *&begin, const char *&end)
+{
+    while (begin < end && is_json_whitespace(*begin)) {
+        ++begin;
+    }
+    while (begin < end && is_json_whitespace(end[-1])) {
+        --end;
+    }
+}
+
+/** Whether the quoted JSON string in the range is ``name`` */
+bool key_equals(const char *begin, const char *end, const string &name)
+{
+    if (end - begin < 2 || *begin != '"' || end[-1] != '"') {
+        return false;
+    }
+    ++begin;
+    --end;
+    if (memchr(begin, '\\', end - begin) == NULL) {
+        return (size_t)(end - begin) == name.size() &&
+               memcmp(begin, name.data(), name.size()) == 0;
+    } else {
+        string unescaped;
+        parse::unescape_string(begin, end, unescaped);
+        return unescaped == name;
+    }
+}
+} // anonymous namespace
+
+void dynd::parse_json_path(const std::string &path,
+                           std::vector<json_path_step> &out_steps)
+{
+    out_steps.clear();
+    size_t i = 0, i_end = path.size();
+    while (i < i_end) {
+        json_path_step step;
+        if (path[i] == '[') {
+            size_t start = ++i;
+            while (i < i_end && '0' <= path[i] && path[i] <= '9') {
+                ++i;
+            }
+            if (i == start || i == i_end || path[i] != ']') {
+                stringstream ss;
+                ss << "invalid JSON path \"" << path
+                   << "\", expected an array index at position " << start;
+                throw invalid_argument(ss.str());
+            }
+            step.index = atol(path.substr(start, i - start).c_str());
+            ++i;
+        } else {
+            // Field names after the first follow a '.'
+            if (i > 0) {
+                if (path[i] != '.') {
+                    stringstream ss;
+                    ss << "invalid JSON path \"" << path
+                       << "\", expected '.' or '[' at position " << i;
+                    throw invalid_argument(ss.str());
+                }
+                ++i;
+            }
+            size_t start = i;
+            while (i < i_end && path[i] != '.' && path[i] != '[') {
+                ++i;
+            }
+            if (i == start) {
+                stringstream ss;
+                ss << "invalid JSON path \"" << path
+                   << "\", expected a field name at position " << start;
+                throw invalid_argument(ss.str());
+            }
+            step.name = path.substr(start, i - start);
+            step.index = -1;
+        }
+        out_steps.push_back(step);
+    }
+}
+
+void json_tape::index(const char *json_begin, const char *json_end)
+{
+    size_t size = json_end - json_begin;
+    if (size > 0xffffffffu) {
+        throw invalid_argument(
+            "JSON structural index: documents are limited to 4GB");
+    }
+    m_begin = json_begin;
+    m_end = json_end;
+    m_entries.clear();
+    m_open.clear();
+
+    // All ones when the previous block ended inside a string
+    uint64_t in_string = 0;
+    // 1 when the previous block ended with an unescaped backslash
+    uint64_t escape_carry = 0;
+    char padded[64];
+    for (size_t block = 0; block < size; block += 64) {
+        const char *p = json_begin + block;
+        if (size - block < 64) {
+            memcpy(padded, p, size - block);
+            memset(padded + (size - block), ' ', 64 - (size - block));
+            p = padded;
+        }
+        uint64_t quote, backslash, structural;
+        classify_block(p, quote, backslash, structural);
+
+        // Drop the quotes escaped by an odd run of backslashes
+        if ((backslash | escape_carry) != 0) {
+            uint64_t escaped = escape_carry;
+            escape_carry = 0;
+            while (backslash != 0) {
+                int pos = lowest_bit(backslash);
+                backslash &= backslash - 1;
+                if ((escaped >> pos) & 1) {
+                    continue;
+                }
+                if (pos == 63) {
+                    escape_carry = 1;
+                } else {
+                    escaped |= uint64_t(1) << (pos + 1);
+                }
+            }
+            quote &= ~escaped;
+        }
+
+        uint64_t string_mask = prefix_xor(quote) ^ in_string;
+        in_string = uint64_t(int64_t(string_mask) >> 63);
+        structural &= ~string_mask;
+
+        while (structural != 0) {
+            entry e;
+            e.offset = static_cast<uint32_t>(block + lowest_bit(structural));
+            e.match = 0;
+            structural &= structural - 1;
+            char c = json_begin[e.offset];
+            if (c == '{' || c == '[') {
+                m_open.push_back(static_cast<uint32_t>(m_entries.size()));
+            } else if (c == '}' || c == ']') {
+                if (m_open.empty() ||
+                    json_begin[m_entries[m_open.back()].offset] !=
+                        (c == '}' ? '{' : '[')) {
+                    stringstream ss;
+                    ss << "JSON structural index: unmatched '" << c
+                       << "' at offset " << e.offset;
+                    throw invalid_argument(ss.str());
+                }
+                m_entries[m_open.back()].match =
+                    static_cast<uint32_t>(m_entries.size());
+                m_open.pop_back();
+            }
+            m_entries.push_back(e);
+        }
+    }
+
+    if (in_string != 0) {
+        throw invalid_argument("JSON structural index: unterminated string");
+    }
+    if (!m_open.empty()) {
+        stringstream ss;
+        ss << "JSON structural index: unclosed '"
+           << json_begin[m_entries[m_open.back()].offset] << "' at offset "
+           << m_entries[m_open.back()].offset;
+        throw invalid_argument(ss.str());
+    }
+}
+
+bool json_tape::find(const json_path_step *path, size_t path_size,
+                     const char *&out_begin, const char *&out_end) const
+{
+    const char *value_begin = m_begin, *value_end = m_end;
+    trim(value_begin, value_end);
+    // The entry of the value's open bracket, if it is an object or array
+    size_t t = 0;
+    for (size_t s = 0; s < path_size; ++s) {
+        const json_path_step &step = path[s];
+        if (value_begin == value_end ||
+            *value_begin != (step.index == -1 ? '{' : '[')) {
+            return false;
+        }
+        size_t close = m_entries[t].match;
+        // Each member follows the entry ``prev``, which is the open
+        // bracket or a ','
+        size_t prev = t, i = t + 1, value_entry, next;
+        intptr_t k = 0;
+        for (;;) {
+            if (step.index == -1) {
+                if (i == close || m_begin[m_entries[i].offset] != ':') {
+                    return false;
+                }
+                value_entry = i + 1;
+            } else {
+                value_entry = i;
+            }
+            // Jump over a nested object or array
+            next = value_entry;
+            char c = m_begin[m_entries[next].offset];
+            if (next != close && (c == '{' || c == '[')) {
+                next = m_entries[next].match + 1;
+            }
+            const char *member_begin = m_begin + m_entries[prev].offset + 1;
+            const char *member_end = m_begin + m_entries[next].offset;
+            if (step.index == -1) {
+                const char *key_end = m_begin + m_entries[i].offset;
+                trim(member_begin, key_end);
+                if (key_equals(member_begin, key_end, step.name)) {
+                    value_begin = m_begin + m_entries[i].offset + 1;
+                    value_end = member_end;
+                    break;
+                }
+            } else if (k == step.index) {
+                value_begin = member_begin;
+                value_end = member_end;
+                break;
+            }
+            if (next == close) {
+                return false;
+            }
+            prev = next;
+            i = next + 1;
+            ++k;
+        }
+        trim(value_begin, value_end);
+        if (value_begin == value_end) {
+            return false;
+        }
+        t = value_entry;
+    }
+    out_begin = value_begin;
+    out_end = value_end;
+    return true;
+}
@@ -5,6 +5,7 @@
 
 #include <dynd/type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/kernel_profiler.hpp>
 #include <dynd/shortvector.hpp>
 #include "single_assigner_builtin.hpp"
 
@@ -114,7 +115,7 @@ static void unaligned_copy_strided(char *dst, intptr_t dst_stride,
     }
 }
 
-size_t dynd::make_assignment_kernel(
+static size_t make_unprofiled_assignment_kernel(
     void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
     const char *dst_arrmeta, const ndt::type &src_tp, const char *src_arrmeta,
     kernel_request_t kernreq, const eval::eval_context *ectx)
@@ -144,6 +145,24 @@ size_t dynd::make_assignment_kernel(
     }
 }
 
+size_t dynd::make_assignment_kernel(
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, const ndt::type &src_tp, const char *src_arrmeta,
+    kernel_request_t kernreq, const eval::eval_context *ectx)
+{
+    if (kernels::kernel_profiler::enabled(ectx, kernreq)) {
+        stringstream ss;
+        ss << "assign (" << src_tp << ") -> " << dst_tp;
+        kernels::profile_scope scope(ckb, ckb_offset, kernreq, ectx, ss.str());
+        return make_unprofiled_assignment_kernel(
+            ckb, scope.get_offset(), dst_tp, dst_arrmeta, src_tp, src_arrmeta,
+            kernreq, ectx);
+    }
+    return make_unprofiled_assignment_kernel(ckb, ckb_offset, dst_tp,
+                                             dst_arrmeta, src_tp, src_arrmeta,
+                                             kernreq, ectx);
+}
+
 size_t dynd::make_pod_typed_data_assignment_kernel(void *ckb,
                                                    intptr_t ckb_offset,
                                                    size_t data_size,
@@ -376,12 +395,79 @@ namespace {
             }
         }
     };
+
+    // Contiguous float16 <-> float32/float64 conversions go through the bulk
+    // conversion functions, which use F16C when the CPU supports it
+    inline void float16_bulk_assign(dynd_float16 *dst, const float *src,
+                                    size_t count, assign_error_mode errmode)
+    {
+        float_to_halfbits_array(reinterpret_cast<uint16_t *>(dst), src, count,
+                                errmode);
+    }
+    inline void float16_bulk_assign(dynd_float16 *dst, const double *src,
+                                    size_t count, assign_error_mode errmode)
+    {
+        double_to_halfbits_array(reinterpret_cast<uint16_t *>(dst), src, count,
+                                 errmode);
+    }
+    inline void float16_bulk_assign(float *dst, const dynd_float16 *src,
+                                    size_t count,
+                                    assign_error_mode DYND_UNUSED(errmode))
+    {
+        halfbits_to_float_array(dst, reinterpret_cast<const uint16_t *>(src),
+                                count);
+    }
+    inline void float16_bulk_assign(double *dst, const dynd_float16 *src,
+                                    size_t count,
+                                    assign_error_mode DYND_UNUSED(errmode))
+    {
+        halfbits_to_double_array(dst, reinterpret_cast<const uint16_t *>(src),
+                                 count);
+    }
+
+    template<typename dst_type, typename src_type, assign_error_mode errmode>
+    struct float16_strided_assignment {
+        static void strided_assign(
+                        char *dst, intptr_t dst_stride,
+                        char **src, const intptr_t *src_stride,
+                        size_t count, ckernel_prefix *self)
+        {
+            if (dst_stride == (intptr_t)sizeof(dst_type) &&
+                    src_stride[0] == (intptr_t)sizeof(src_type)) {
+                float16_bulk_assign(reinterpret_cast<dst_type *>(dst),
+                                    reinterpret_cast<const src_type *>(src[0]),
+                                    count, errmode);
+            } else {
+                multiple_assignment_builtin<dst_type, src_type, errmode>::
+                    strided_assign(dst, dst_stride, src, src_stride, count,
+                                   self);
+            }
+        }
+    };
+
+    // The host strided table is filled from this, so specific type pairs
+    // can provide a faster loop than the generic one
+    template<typename dst_type, typename src_type, assign_error_mode errmode>
+    struct strided_assignment_builtin
+        : public multiple_assignment_builtin<dst_type, src_type, errmode> {};
+    template<assign_error_mode errmode>
+    struct strided_assignment_builtin<dynd_float16, float, errmode>
+        : public float16_strided_assignment<dynd_float16, float, errmode> {};
+    template<assign_error_mode errmode>
+    struct strided_assignment_builtin<dynd_float16, double, errmode>
+        : public float16_strided_assignment<dynd_float16, double, errmode> {};
+    template<assign_error_mode errmode>
+    struct strided_assignment_builtin<float, dynd_float16, errmode>
+        : public float16_strided_assignment<float, dynd_float16, errmode> {};
+    template<assign_error_mode errmode>
+    struct strided_assignment_builtin<double, dynd_float16, errmode>
+        : public float16_strided_assignment<double, dynd_float16, errmode> {};
 } // anonymous namespace
 
 static expr_strided_t assign_table_strided_kernel[builtin_type_id_count-2][builtin_type_id_count-2][4] =
 {
 #define STRIDED_OPERATION_PAIR_LEVEL(dst_type, src_type, errmode) \
-            &multiple_assignment_builtin<dst_type, src_type, errmode>::strided_assign
+            &strided_assignment_builtin<dst_type, src_type, errmode>::strided_assign
         
 #define ERROR_MODE_LEVEL(dst_type, src_type) { \
         STRIDED_OPERATION_PAIR_LEVEL(dst_type, src_type, assign_error_nocheck), \
@@ -401,7 +487,7 @@ static expr_strided_t assign_table_strided_kernel[builtin_type_id_count-2][built
         ERROR_MODE_LEVEL(dst_type, uint16_t), \
         ERROR_MODE_LEVEL(dst_type, uint32_t), \
         ERROR_MODE_LEVEL(dst_type, uint64_t), \
-        ERROR_MODE_LEVEL(dst_type, dynd_int128), \
+        ERROR_MODE_LEVEL(dst_type, dynd_uint128), \
         ERROR_MODE_LEVEL(dst_type, dynd_float16), \
         ERROR_MODE_LEVEL(dst_type, float), \
         ERROR_MODE_LEVEL(dst_type, double), \
@@ -525,6 +611,12 @@ static void simple_wrapper_kernel_destruct(ckernel_prefix *self)
   self->destroy_child_ckernel(sizeof(ckernel_prefix));
 }
 
+static void simple_wrapper_kernel_clone(ckernel_prefix *dst,
+                                        const ckernel_prefix *src)
+{
+  src->clone_child_ckernels(dst, sizeof(ckernel_prefix));
+}
+
 struct wrap_single_as_strided_ck {
   typedef wrap_single_as_strided_ck self_type;
   ckernel_prefix base;
@@ -551,6 +643,11 @@ struct wrap_single_as_strided_ck {
   {
     self->destroy_child_ckernel(sizeof(self_type));
   }
+
+  static void clone(ckernel_prefix *dst, const ckernel_prefix *src)
+  {
+    src->clone_child_ckernels(dst, sizeof(self_type));
+  }
 };
 
 } // anonymous namespace
@@ -572,6 +669,9 @@ size_t dynd::make_kernreq_to_single_kernel_adapter(void *ckb,
               ->alloc_ck<ckernel_prefix>(ckb_offset);
       e->set_function<expr_strided_t>(wrap_single_as_strided_fixedcount[nsrc]);
       e->destructor = &simple_wrapper_kernel_destruct;
+      static bool clone_registered = register_ckernel_clone(
+          &simple_wrapper_kernel_destruct, &simple_wrapper_kernel_clone);
+      (void)clone_registered;
       return ckb_offset;
     } else {
       wrap_single_as_strided_ck *e =
@@ -579,6 +679,7 @@ size_t dynd::make_kernreq_to_single_kernel_adapter(void *ckb,
               ->alloc_ck<wrap_single_as_strided_ck>(ckb_offset);
       e->base.set_function<expr_strided_t>(&wrap_single_as_strided_ck::strided);
       e->base.destructor = &wrap_single_as_strided_ck::destruct;
+      register_ckernel_clone<wrap_single_as_strided_ck>();
       e->nsrc = nsrc;
       return ckb_offset;
     }
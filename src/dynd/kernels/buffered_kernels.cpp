@@ -96,6 +96,34 @@ struct buffered_ck : public kernels::general_ck<buffered_ck, kernel_request_host
   {
     base.set_expr_function<self_type>(kernreq);
   }
+
+  inline void destruct_children()
+  {
+    // The buffered arrfunc
+    get_child_ckernel()->destroy();
+    // The assignments into the buffers
+    for (size_t i = 0; i < m_src_buf_ck_offsets.size(); ++i) {
+      base.destroy_child_ckernel(m_src_buf_ck_offsets[i]);
+    }
+  }
+
+  inline void clone_children(ckernel_prefix *dst) const
+  {
+    // The clone gets its own buffers, but the children point to the
+    // arrmeta of these ones
+    for (size_t i = 0; i < m_bufs.size(); ++i) {
+      if (m_bufs[i].get_arrmeta() != NULL) {
+        stringstream ss;
+        ss << "cannot clone a buffered ckernel with buffer type "
+           << m_bufs[i].get_type();
+        throw runtime_error(ss.str());
+      }
+    }
+    vector<intptr_t> offsets(1, sizeof(self_type));
+    offsets.insert(offsets.end(), m_src_buf_ck_offsets.begin(),
+                   m_src_buf_ck_offsets.end());
+    base.clone_child_ckernel_array(dst, &offsets[0], offsets.size());
+  }
 };
 
 } // anonymous namespace
@@ -125,9 +153,10 @@ size_t dynd::make_buffered_ckernel(
     }
   }
   // Instantiate the arrfunc being buffered
-  ckb_offset = af->instantiate(af, af_tp, ckb, ckb_offset, dst_tp, dst_arrmeta,
-                               src_tp_for_af, &buffered_arrmeta[0], kernreq,
-                               ectx, nd::array(), nd::array());
+  ckb_offset = kernels::instantiate_ckernel(af, af_tp, ckb, ckb_offset, dst_tp,
+                                            dst_arrmeta, src_tp_for_af,
+                                            &buffered_arrmeta[0], kernreq, ectx,
+                                            nd::array(), nd::array());
   reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
       ->ensure_capacity(ckb_offset);
   self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
@@ -7,10 +7,78 @@
 
 #include <dynd/diagnostics.hpp>
 #include <dynd/kernels/byteswap_kernels.hpp>
+#include "single_assigner_builtin.hpp"
 
 using namespace std;
 using namespace dynd;
 
+#if !defined(__CUDACC__) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define DYND_BYTESWAP_USE_SSSE3
+
+#include <immintrin.h>
+
+static bool cpu_has_ssse3()
+{
+    static const bool result = __builtin_cpu_supports("ssse3");
+    return result;
+}
+
+/**
+ * Byteswaps 16 bytes at a time with a byte shuffle, for values of
+ * size 2, 4 or 8. Returns how many values were swapped, the caller
+ * does the remainder.
+ */
+__attribute__((target("ssse3")))
+static size_t byteswap_ssse3(char *dst, const char *src, size_t count,
+                             int data_size)
+{
+    __m128i mask;
+    switch (data_size) {
+    case 2:
+        mask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6,
+                             9, 8, 11, 10, 13, 12, 15, 14);
+        break;
+    case 4:
+        mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4,
+                             11, 10, 9, 8, 15, 14, 13, 12);
+        break;
+    default:
+        mask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0,
+                             15, 14, 13, 12, 11, 10, 9, 8);
+        break;
+    }
+    size_t per_vector = 16 / data_size;
+    size_t i = 0;
+    for (; i + per_vector <= count; i += per_vector) {
+        __m128i v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src + i * data_size));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * data_size),
+                         _mm_shuffle_epi8(v, mask));
+    }
+    return i;
+}
+#endif
+
+/**
+ * Byteswaps 'count' contiguous values of type T, which may be in place.
+ */
+template <typename T>
+static void contiguous_byteswap(char *dst, const char *src, size_t count)
+{
+    size_t i = 0;
+#ifdef DYND_BYTESWAP_USE_SSSE3
+    if (cpu_has_ssse3()) {
+        i = byteswap_ssse3(dst, src, count, sizeof(T));
+    }
+#endif
+    T *dst_T = reinterpret_cast<T *>(dst);
+    const T *src_T = reinterpret_cast<const T *>(src);
+    for (; i < count; ++i) {
+        dst_T[i] = byteswap_value(src_T[i]);
+    }
+}
+
 namespace {
 
 template<typename T>
@@ -35,6 +103,10 @@ struct aligned_fixed_size_byteswap {
                             "type: " << ndt::type(dynd::type_id_of<T>::value));
         char *src0 = src[0];
         intptr_t src0_stride = src_stride[0];
+        if (dst_stride == sizeof(T) && src0_stride == sizeof(T)) {
+            contiguous_byteswap<T>(dst, src0, count);
+            return;
+        }
         for (size_t i = 0; i != count; ++i) {
             *reinterpret_cast<T *>(dst) =
                 byteswap_value(*reinterpret_cast<T *>(src0));
@@ -68,11 +140,16 @@ struct aligned_fixed_size_pairwise_byteswap_kernel {
                             "type: " << ndt::type(dynd::type_id_of<T>::value));
         char *src0 = src[0];
         intptr_t src0_stride = src_stride[0];
+        if (dst_stride == 2 * sizeof(T) && src0_stride == 2 * sizeof(T)) {
+            // Contiguous pairs are just twice as many contiguous halves
+            contiguous_byteswap<T>(dst, src0, 2 * count);
+            return;
+        }
         for (size_t i = 0; i != count; ++i) {
             *reinterpret_cast<T *>(dst) =
-                byteswap_value(**reinterpret_cast<T **>(src0));
+                byteswap_value(*reinterpret_cast<T *>(src0));
             *(reinterpret_cast<T *>(dst) + 1) =
-                byteswap_value(*(*reinterpret_cast<T **>(src0) + 1));
+                byteswap_value(*(reinterpret_cast<T *>(src0) + 1));
             dst += dst_stride;
             src0 += src0_stride;
         }
@@ -205,3 +282,250 @@ size_t dynd::make_pairwise_byteswap_assignment_function(
     self->m_data_size = data_size;
     return ckb_offset;
 }
+
+namespace {
+    template <int N>
+    struct byteswap_uint;
+    template <>
+    struct byteswap_uint<2> {
+        typedef uint16_t type;
+    };
+    template <>
+    struct byteswap_uint<4> {
+        typedef uint32_t type;
+    };
+    template <>
+    struct byteswap_uint<8> {
+        typedef uint64_t type;
+    };
+
+    template <typename T>
+    inline T load_byteswapped(const char *src)
+    {
+        typename byteswap_uint<sizeof(T)>::type bits;
+        memcpy(&bits, src, sizeof(T));
+        bits = byteswap_value(bits);
+        T value;
+        memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    inline void store_byteswapped(char *dst, T value)
+    {
+        typename byteswap_uint<sizeof(T)>::type bits;
+        memcpy(&bits, &value, sizeof(T));
+        bits = byteswap_value(bits);
+        memcpy(dst, &bits, sizeof(T));
+    }
+
+    /**
+     * Reads a foreign-endian swapped_type, and assigns it to a native
+     * dst_type, in one pass.
+     */
+    template <typename swapped_type, typename dst_type,
+              assign_error_mode errmode>
+    struct byteswap_and_convert {
+        static void single(char *dst, char **src,
+                           ckernel_prefix *DYND_UNUSED(self))
+        {
+            swapped_type value = load_byteswapped<swapped_type>(src[0]);
+            single_assigner_builtin<dst_type, swapped_type, errmode>::assign(
+                reinterpret_cast<dst_type *>(dst), &value);
+        }
+        static void strided(char *dst, intptr_t dst_stride, char **src,
+                            const intptr_t *src_stride, size_t count,
+                            ckernel_prefix *DYND_UNUSED(self))
+        {
+            const char *src0 = src[0];
+            intptr_t src0_stride = src_stride[0];
+            for (size_t i = 0; i != count; ++i) {
+                swapped_type value = load_byteswapped<swapped_type>(src0);
+                single_assigner_builtin<dst_type, swapped_type,
+                                        errmode>::assign(
+                    reinterpret_cast<dst_type *>(dst), &value);
+                dst += dst_stride;
+                src0 += src0_stride;
+            }
+        }
+    };
+
+    /**
+     * Assigns a native src_type to a swapped_type, and writes it
+     * foreign-endian, in one pass.
+     */
+    template <typename swapped_type, typename src_type,
+              assign_error_mode errmode>
+    struct convert_and_byteswap {
+        static void single(char *dst, char **src,
+                           ckernel_prefix *DYND_UNUSED(self))
+        {
+            swapped_type value;
+            single_assigner_builtin<swapped_type, src_type, errmode>::assign(
+                &value, reinterpret_cast<const src_type *>(src[0]));
+            store_byteswapped(dst, value);
+        }
+        static void strided(char *dst, intptr_t dst_stride, char **src,
+                            const intptr_t *src_stride, size_t count,
+                            ckernel_prefix *DYND_UNUSED(self))
+        {
+            const char *src0 = src[0];
+            intptr_t src0_stride = src_stride[0];
+            for (size_t i = 0; i != count; ++i) {
+                swapped_type value;
+                single_assigner_builtin<swapped_type, src_type,
+                                        errmode>::assign(
+                    &value, reinterpret_cast<const src_type *>(src0));
+                store_byteswapped(dst, value);
+                dst += dst_stride;
+                src0 += src0_stride;
+            }
+        }
+    };
+} // anonymous namespace
+
+// The types which can be byteswapped as part of a fused kernel
+static int fused_swapped_index(type_id_t tid)
+{
+    switch (tid) {
+    case int16_type_id: return 0;
+    case int32_type_id: return 1;
+    case int64_type_id: return 2;
+    case uint16_type_id: return 3;
+    case uint32_type_id: return 4;
+    case uint64_type_id: return 5;
+    case float32_type_id: return 6;
+    case float64_type_id: return 7;
+    default: return -1;
+    }
+}
+
+// The native types which a fused kernel can convert to or from
+static int fused_native_index(type_id_t tid)
+{
+    switch (tid) {
+    case int8_type_id: return 0;
+    case int16_type_id: return 1;
+    case int32_type_id: return 2;
+    case int64_type_id: return 3;
+    case uint8_type_id: return 4;
+    case uint16_type_id: return 5;
+    case uint32_type_id: return 6;
+    case uint64_type_id: return 7;
+    case float32_type_id: return 8;
+    case float64_type_id: return 9;
+    default: return -1;
+    }
+}
+
+#define ERROR_MODE_LEVEL(kern, swapped_type, native_type) { \
+        { &kern<swapped_type, native_type, assign_error_nocheck>::single, \
+          &kern<swapped_type, native_type, assign_error_nocheck>::strided }, \
+        { &kern<swapped_type, native_type, assign_error_overflow>::single, \
+          &kern<swapped_type, native_type, assign_error_overflow>::strided }, \
+        { &kern<swapped_type, native_type, assign_error_fractional>::single, \
+          &kern<swapped_type, native_type, assign_error_fractional>::strided }, \
+        { &kern<swapped_type, native_type, assign_error_inexact>::single, \
+          &kern<swapped_type, native_type, assign_error_inexact>::strided } \
+    }
+#define NATIVE_LEVEL(kern, swapped_type) { \
+        ERROR_MODE_LEVEL(kern, swapped_type, int8_t), \
+        ERROR_MODE_LEVEL(kern, swapped_type, int16_t), \
+        ERROR_MODE_LEVEL(kern, swapped_type, int32_t), \
+        ERROR_MODE_LEVEL(kern, swapped_type, int64_t), \
+        ERROR_MODE_LEVEL(kern, swapped_type, uint8_t), \
+        ERROR_MODE_LEVEL(kern, swapped_type, uint16_t), \
+        ERROR_MODE_LEVEL(kern, swapped_type, uint32_t), \
+        ERROR_MODE_LEVEL(kern, swapped_type, uint64_t), \
+        ERROR_MODE_LEVEL(kern, swapped_type, float), \
+        ERROR_MODE_LEVEL(kern, swapped_type, double) \
+    }
+#define SWAPPED_LEVEL(kern) { \
+        NATIVE_LEVEL(kern, int16_t), \
+        NATIVE_LEVEL(kern, int32_t), \
+        NATIVE_LEVEL(kern, int64_t), \
+        NATIVE_LEVEL(kern, uint16_t), \
+        NATIVE_LEVEL(kern, uint32_t), \
+        NATIVE_LEVEL(kern, uint64_t), \
+        NATIVE_LEVEL(kern, float), \
+        NATIVE_LEVEL(kern, double) \
+    }
+
+namespace {
+    struct fused_byteswap_entry {
+        expr_single_t single;
+        expr_strided_t strided;
+    };
+} // anonymous namespace
+
+// Indexed by [swapped type][native type][errmode]
+static const fused_byteswap_entry byteswap_and_convert_table[8][10][4] =
+    SWAPPED_LEVEL(byteswap_and_convert);
+static const fused_byteswap_entry convert_and_byteswap_table[8][10][4] =
+    SWAPPED_LEVEL(convert_and_byteswap);
+
+#undef ERROR_MODE_LEVEL
+#undef NATIVE_LEVEL
+#undef SWAPPED_LEVEL
+
+bool dynd::is_fusable_byteswap_conversion(type_id_t swapped_type_id,
+                                          type_id_t native_type_id)
+{
+    return fused_swapped_index(swapped_type_id) >= 0 &&
+           fused_native_index(native_type_id) >= 0;
+}
+
+static size_t make_fused_byteswap_kernel(
+    const fused_byteswap_entry (*table)[10][4], void *ckb,
+    intptr_t ckb_offset, type_id_t swapped_type_id, type_id_t native_type_id,
+    kernel_request_t kernreq, assign_error_mode errmode)
+{
+    int swapped_i = fused_swapped_index(swapped_type_id);
+    int native_i = fused_native_index(native_type_id);
+    if (swapped_i < 0 || native_i < 0 || errmode == assign_error_default) {
+        stringstream ss;
+        ss << "cannot make a fused byteswap kernel for "
+           << ndt::type(swapped_type_id) << " and "
+           << ndt::type(native_type_id);
+        throw runtime_error(ss.str());
+    }
+    const fused_byteswap_entry &entry = table[swapped_i][native_i][errmode];
+    ckernel_prefix *result =
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+            ->alloc_ck_leaf<ckernel_prefix>(ckb_offset);
+    switch (kernreq) {
+    case kernel_request_single:
+        result->set_function<expr_single_t>(entry.single);
+        break;
+    case kernel_request_strided:
+        result->set_function<expr_strided_t>(entry.strided);
+        break;
+    default: {
+        stringstream ss;
+        ss << "make_fused_byteswap_kernel: unrecognized request "
+           << (int)kernreq;
+        throw runtime_error(ss.str());
+    }
+    }
+    return ckb_offset;
+}
+
+size_t dynd::make_byteswap_and_convert_kernel(
+    void *ckb, intptr_t ckb_offset, type_id_t dst_type_id,
+    type_id_t src_swapped_type_id, kernel_request_t kernreq,
+    assign_error_mode errmode)
+{
+    return make_fused_byteswap_kernel(byteswap_and_convert_table, ckb,
+                                      ckb_offset, src_swapped_type_id,
+                                      dst_type_id, kernreq, errmode);
+}
+
+size_t dynd::make_convert_and_byteswap_kernel(
+    void *ckb, intptr_t ckb_offset, type_id_t dst_swapped_type_id,
+    type_id_t src_type_id, kernel_request_t kernreq,
+    assign_error_mode errmode)
+{
+    return make_fused_byteswap_kernel(convert_and_byteswap_table, ckb,
+                                      ckb_offset, dst_swapped_type_id,
+                                      src_type_id, kernreq, errmode);
+}
@@ -3,6 +3,9 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <mutex>
+#include <unordered_map>
+
 #include <dynd/array.hpp>
 #include <dynd/kernels/ckernel_common_functions.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
@@ -17,6 +20,92 @@ void kernels::destroy_trivial_parent_ckernel(ckernel_prefix *self)
     self->destroy_child_ckernel(sizeof(ckernel_prefix));
 }
 
+void kernels::clone_trivial_parent_ckernel(ckernel_prefix *dst,
+                                           const ckernel_prefix *src)
+{
+    src->clone_child_ckernels(dst, sizeof(ckernel_prefix));
+}
+
+namespace {
+    /**
+     * The clone functions of the ckernels, by their destructor.
+     */
+    class ckernel_clone_registry {
+        typedef unordered_map<ckernel_prefix::destructor_fn_t,
+                              ckernel_prefix::clone_fn_t> clone_map;
+
+        mutex m_mutex;
+        clone_map m_clone;
+    public:
+        ckernel_clone_registry()
+        {
+            m_clone[&kernels::destroy_trivial_parent_ckernel] =
+                &kernels::clone_trivial_parent_ckernel;
+        }
+
+        void add(ckernel_prefix::destructor_fn_t destructor,
+                 ckernel_prefix::clone_fn_t clone)
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_clone[destructor] = clone;
+        }
+
+        ckernel_prefix::clone_fn_t find(
+            ckernel_prefix::destructor_fn_t destructor)
+        {
+            lock_guard<mutex> lock(m_mutex);
+            clone_map::const_iterator it = m_clone.find(destructor);
+            return it != m_clone.end() ? it->second : NULL;
+        }
+    };
+
+    ckernel_clone_registry &get_ckernel_clone_registry()
+    {
+        static ckernel_clone_registry registry;
+        return registry;
+    }
+} // anonymous namespace
+
+bool dynd::register_ckernel_clone(ckernel_prefix::destructor_fn_t destructor,
+                                  ckernel_prefix::clone_fn_t clone)
+{
+    get_ckernel_clone_registry().add(destructor, clone);
+    return true;
+}
+
+void ckernel_prefix::clone(ckernel_prefix *dst) const
+{
+    if (destructor == NULL) {
+        return;
+    }
+    clone_fn_t clone_fn = get_ckernel_clone_registry().find(destructor);
+    if (clone_fn == NULL) {
+        throw runtime_error(
+            "cannot clone a ckernel which does not support cloning");
+    }
+    clone_fn(dst, this);
+}
+
+void ckernel_prefix::clone_child_ckernel_array(ckernel_prefix *dst,
+                                               const intptr_t *offsets,
+                                               size_t count) const
+{
+    ckernel_prefix *self = const_cast<ckernel_prefix *>(this);
+    for (size_t i = 0; i != count; ++i) {
+        if (offsets[i] != 0) {
+            try {
+                self->get_child_ckernel(offsets[i])->clone(
+                    dst->get_child_ckernel(offsets[i]));
+            } catch (...) {
+                for (size_t j = 0; j != i; ++j) {
+                    dst->destroy_child_ckernel(offsets[j]);
+                }
+                throw;
+            }
+        }
+    }
+}
+
 namespace {
     struct constant_value_assignment_ck : public kernels::expr_ck<constant_value_assignment_ck, kernel_request_host, 0> {
         // Pointer to the array inside of `constant`
@@ -48,6 +137,11 @@ namespace {
             // Destroy the child ckernel
             get_child_ckernel()->destroy();
         }
+
+        inline void clone_children(ckernel_prefix *dst) const
+        {
+            base.clone_child_ckernels(dst, sizeof(self_type));
+        }
     };
 } // anonymous namespace
 
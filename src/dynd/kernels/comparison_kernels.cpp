@@ -5,6 +5,8 @@
 
 #include <dynd/type.hpp>
 #include <dynd/kernels/comparison_kernels.hpp>
+#include <dynd/kernels/struct_comparison_kernels.hpp>
+#include <dynd/kernels/expr_kernels.hpp>
 #include "single_comparer_builtin.hpp"
 
 using namespace std;
@@ -111,3 +113,247 @@ size_t dynd::make_builtin_type_comparison_kernel(
                                comptype);
   }
 }
+
+namespace {
+
+template <class T, comparison_type_t CompType>
+struct builtin_mask_op;
+
+#define DYND_BUILTIN_MASK_OP(comptype, op)                                     \
+  template <class T>                                                           \
+  struct builtin_mask_op<T, comptype> {                                        \
+    static inline bool f(const T &v0, const T &v1)                             \
+    {                                                                          \
+      return op<T, T, dynd_kind_of<T>::value, dynd_kind_of<T>::value, false,   \
+                false>::f(v0, v1);                                             \
+    }                                                                          \
+  };
+
+DYND_BUILTIN_MASK_OP(comparison_type_sorting_less, op_sort_lt)
+DYND_BUILTIN_MASK_OP(comparison_type_less, op_lt)
+DYND_BUILTIN_MASK_OP(comparison_type_less_equal, op_le)
+DYND_BUILTIN_MASK_OP(comparison_type_equal, op_eq)
+DYND_BUILTIN_MASK_OP(comparison_type_not_equal, op_ne)
+DYND_BUILTIN_MASK_OP(comparison_type_greater_equal, op_ge)
+DYND_BUILTIN_MASK_OP(comparison_type_greater, op_gt)
+
+#undef DYND_BUILTIN_MASK_OP
+
+/**
+ * Compares two values of the same builtin type, writing a
+ * bool. The contiguous and scalar-broadcast cases are written
+ * as plain indexed loops with no calls, so the compiler can
+ * vectorize them.
+ */
+template <class T, comparison_type_t CompType>
+struct builtin_comparison_mask_ck
+    : kernels::expr_ck<builtin_comparison_mask_ck<T, CompType>,
+                       kernel_request_host, 2> {
+  typedef builtin_mask_op<T, CompType> op;
+
+  inline void single(char *dst, char **src)
+  {
+    *dst = op::f(*reinterpret_cast<const T *>(src[0]),
+                 *reinterpret_cast<const T *>(src[1]));
+  }
+
+  inline void strided(char *dst, intptr_t dst_stride, char **src,
+                      const intptr_t *src_stride, size_t count)
+  {
+    const char *src0 = src[0], *src1 = src[1];
+    intptr_t src0_stride = src_stride[0], src1_stride = src_stride[1];
+    if (dst_stride == 1) {
+      if (src0_stride == sizeof(T) && src1_stride == sizeof(T)) {
+        const T *a = reinterpret_cast<const T *>(src0);
+        const T *b = reinterpret_cast<const T *>(src1);
+        for (size_t i = 0; i != count; ++i) {
+          dst[i] = op::f(a[i], b[i]);
+        }
+        return;
+      } else if (src0_stride == sizeof(T) && src1_stride == 0) {
+        const T *a = reinterpret_cast<const T *>(src0);
+        const T b = *reinterpret_cast<const T *>(src1);
+        for (size_t i = 0; i != count; ++i) {
+          dst[i] = op::f(a[i], b);
+        }
+        return;
+      } else if (src0_stride == 0 && src1_stride == sizeof(T)) {
+        const T a = *reinterpret_cast<const T *>(src0);
+        const T *b = reinterpret_cast<const T *>(src1);
+        for (size_t i = 0; i != count; ++i) {
+          dst[i] = op::f(a, b[i]);
+        }
+        return;
+      }
+    }
+    for (size_t i = 0; i != count; ++i) {
+      *dst = op::f(*reinterpret_cast<const T *>(src0),
+                   *reinterpret_cast<const T *>(src1));
+      dst += dst_stride;
+      src0 += src0_stride;
+      src1 += src1_stride;
+    }
+  }
+};
+
+/**
+ * Adapts a comparison predicate child ckernel into one
+ * which writes a bool for each pair of values.
+ */
+struct comparison_mask_ck
+    : kernels::expr_ck<comparison_mask_ck, kernel_request_host, 2> {
+  inline void single(char *dst, char **src)
+  {
+    ckernel_prefix *child = get_child_ckernel();
+    expr_predicate_t child_fn = child->get_function<expr_predicate_t>();
+    *dst = child_fn(src, child) != 0;
+  }
+
+  inline void strided(char *dst, intptr_t dst_stride, char **src,
+                      const intptr_t *src_stride, size_t count)
+  {
+    ckernel_prefix *child = get_child_ckernel();
+    expr_predicate_t child_fn = child->get_function<expr_predicate_t>();
+    char *src_copy[2] = {src[0], src[1]};
+    for (size_t i = 0; i != count; ++i) {
+      *dst = child_fn(src_copy, child) != 0;
+      dst += dst_stride;
+      src_copy[0] += src_stride[0];
+      src_copy[1] += src_stride[1];
+    }
+  }
+
+  inline void destruct_children() { get_child_ckernel()->destroy(); }
+
+  inline void clone_children(ckernel_prefix *dst) const
+  {
+    base.clone_child_ckernels(dst, sizeof(self_type));
+  }
+};
+
+template <class T>
+static intptr_t make_same_type_mask_kernel(void *ckb, intptr_t ckb_offset,
+                                           comparison_type_t comptype,
+                                           kernel_request_t kernreq)
+{
+  switch (comptype) {
+  case comparison_type_sorting_less:
+    builtin_comparison_mask_ck<T, comparison_type_sorting_less>::create_leaf(
+        ckb, kernreq, ckb_offset);
+    break;
+  case comparison_type_less:
+    builtin_comparison_mask_ck<T, comparison_type_less>::create_leaf(
+        ckb, kernreq, ckb_offset);
+    break;
+  case comparison_type_less_equal:
+    builtin_comparison_mask_ck<T, comparison_type_less_equal>::create_leaf(
+        ckb, kernreq, ckb_offset);
+    break;
+  case comparison_type_equal:
+    builtin_comparison_mask_ck<T, comparison_type_equal>::create_leaf(
+        ckb, kernreq, ckb_offset);
+    break;
+  case comparison_type_not_equal:
+    builtin_comparison_mask_ck<T, comparison_type_not_equal>::create_leaf(
+        ckb, kernreq, ckb_offset);
+    break;
+  case comparison_type_greater_equal:
+    builtin_comparison_mask_ck<T, comparison_type_greater_equal>::create_leaf(
+        ckb, kernreq, ckb_offset);
+    break;
+  case comparison_type_greater:
+    builtin_comparison_mask_ck<T, comparison_type_greater>::create_leaf(
+        ckb, kernreq, ckb_offset);
+    break;
+  default:
+    return -1;
+  }
+  return ckb_offset;
+}
+
+} // anonymous namespace
+
+size_t dynd::make_builtin_type_comparison_mask_kernel(
+    void *ckb, intptr_t ckb_offset, type_id_t src0_type_id,
+    type_id_t src1_type_id, comparison_type_t comptype,
+    kernel_request_t kernreq)
+{
+  if (src0_type_id == src1_type_id) {
+    intptr_t result = -1;
+    switch (src0_type_id) {
+    case bool_type_id:
+      result = make_same_type_mask_kernel<dynd_bool>(ckb, ckb_offset, comptype,
+                                                     kernreq);
+      break;
+    case int8_type_id:
+      result = make_same_type_mask_kernel<int8_t>(ckb, ckb_offset, comptype,
+                                                  kernreq);
+      break;
+    case int16_type_id:
+      result = make_same_type_mask_kernel<int16_t>(ckb, ckb_offset, comptype,
+                                                   kernreq);
+      break;
+    case int32_type_id:
+      result = make_same_type_mask_kernel<int32_t>(ckb, ckb_offset, comptype,
+                                                   kernreq);
+      break;
+    case int64_type_id:
+      result = make_same_type_mask_kernel<int64_t>(ckb, ckb_offset, comptype,
+                                                   kernreq);
+      break;
+    case uint8_type_id:
+      result = make_same_type_mask_kernel<uint8_t>(ckb, ckb_offset, comptype,
+                                                   kernreq);
+      break;
+    case uint16_type_id:
+      result = make_same_type_mask_kernel<uint16_t>(ckb, ckb_offset, comptype,
+                                                    kernreq);
+      break;
+    case uint32_type_id:
+      result = make_same_type_mask_kernel<uint32_t>(ckb, ckb_offset, comptype,
+                                                    kernreq);
+      break;
+    case uint64_type_id:
+      result = make_same_type_mask_kernel<uint64_t>(ckb, ckb_offset, comptype,
+                                                    kernreq);
+      break;
+    case float32_type_id:
+      result = make_same_type_mask_kernel<float>(ckb, ckb_offset, comptype,
+                                                 kernreq);
+      break;
+    case float64_type_id:
+      result = make_same_type_mask_kernel<double>(ckb, ckb_offset, comptype,
+                                                  kernreq);
+      break;
+    default:
+      break;
+    }
+    if (result >= 0) {
+      return result;
+    }
+  }
+  // Mixed and non-vectorized builtin types go through the predicate table
+  comparison_mask_ck::create(ckb, kernreq, ckb_offset);
+  return make_builtin_type_comparison_kernel(ckb, ckb_offset, src0_type_id,
+                                             src1_type_id, comptype);
+}
+
+size_t dynd::make_comparison_mask_kernel(
+    void *ckb, intptr_t ckb_offset, const ndt::type &src0_dt,
+    const char *src0_arrmeta, const ndt::type &src1_dt,
+    const char *src1_arrmeta, comparison_type_t comptype,
+    kernel_request_t kernreq, const eval::eval_context *ectx)
+{
+  if (src0_dt.is_builtin() && src1_dt.is_builtin()) {
+    return make_builtin_type_comparison_mask_kernel(
+        ckb, ckb_offset, src0_dt.get_type_id(), src1_dt.get_type_id(),
+        comptype, kernreq);
+  } else if (src0_dt.get_kind() == struct_kind && src0_dt == src1_dt) {
+    return make_struct_comparison_mask_kernel(ckb, ckb_offset, src0_dt,
+                                              src0_arrmeta, src1_arrmeta,
+                                              comptype, kernreq, ectx);
+  }
+  comparison_mask_ck::create(ckb, kernreq, ckb_offset);
+  return make_comparison_kernel(ckb, ckb_offset, src0_dt, src0_arrmeta,
+                                src1_dt, src1_arrmeta, comptype, ectx);
+}
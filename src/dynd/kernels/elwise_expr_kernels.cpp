@@ -62,6 +62,11 @@ struct strided_expr_kernel_extra {
     {
         self->destroy_child_ckernel(sizeof(extra_type));
     }
+
+    static void clone(ckernel_prefix *dst, const ckernel_prefix *src)
+    {
+        src->clone_child_ckernels(dst, sizeof(extra_type));
+    }
 };
 
 template <int N>
@@ -83,6 +88,7 @@ static size_t make_elwise_strided_dimension_expr_kernel_for_N(
           ->alloc_ck<strided_expr_kernel_extra<N>>(ckb_offset);
   e->base.template set_expr_function<strided_expr_kernel_extra<N> >(kernreq);
   e->base.destructor = strided_expr_kernel_extra<N>::destruct;
+  register_ckernel_clone<strided_expr_kernel_extra<N> >();
   // The dst strided parameters
   if (!dst_tp.get_as_strided(dst_arrmeta, &e->size, &e->dst_stride,
                                  &dst_child_dt, &dst_child_arrmeta)) {
@@ -236,6 +242,11 @@ struct strided_or_var_to_strided_expr_kernel_extra {
     {
         self->destroy_child_ckernel(sizeof(extra_type));
     }
+
+    static void clone(ckernel_prefix *dst, const ckernel_prefix *src)
+    {
+        src->clone_child_ckernels(dst, sizeof(extra_type));
+    }
 };
 
 template <int N>
@@ -260,6 +271,7 @@ static size_t make_elwise_strided_or_var_to_strided_dimension_expr_kernel_for_N(
       strided_or_var_to_strided_expr_kernel_extra<N> >(kernreq);
   e->base.destructor =
       &strided_or_var_to_strided_expr_kernel_extra<N>::destruct;
+  register_ckernel_clone<strided_or_var_to_strided_expr_kernel_extra<N> >();
   // The dst strided parameters
   if (!dst_tp.get_as_strided(dst_arrmeta, &e->size, &e->dst_stride,
                              &dst_child_dt, &dst_child_arrmeta)) {
@@ -484,6 +496,11 @@ struct strided_or_var_to_var_expr_kernel_extra {
     {
         self->destroy_child_ckernel(sizeof(extra_type));
     }
+
+    static void clone(ckernel_prefix *dst, const ckernel_prefix *src)
+    {
+        src->clone_child_ckernels(dst, sizeof(extra_type));
+    }
 };
 
 template<int N>
@@ -506,6 +523,7 @@ static size_t make_elwise_strided_or_var_to_var_dimension_expr_kernel_for_N(
   e->base.template set_expr_function<strided_or_var_to_var_expr_kernel_extra<N> >(
       kernreq);
   e->base.destructor = &strided_or_var_to_var_expr_kernel_extra<N>::destruct;
+  register_ckernel_clone<strided_or_var_to_var_expr_kernel_extra<N> >();
   // The dst var parameters
   const var_dim_type *dst_vdd = dst_tp.extended<var_dim_type>();
   const var_dim_type_arrmeta *dst_md =
@@ -8,6 +8,9 @@
 #include <dynd/type.hpp>
 #include <dynd/types/base_expr_type.hpp>
 #include <dynd/kernels/expression_assignment_kernels.hpp>
+#include <dynd/kernels/byteswap_kernels.hpp>
+#include <dynd/types/byteswap_type.hpp>
+#include <dynd/types/convert_type.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -155,11 +158,60 @@ namespace {
     };
 } // anonymous namespace
 
+/**
+ * If 'tp' is byteswap[T], or convert[to=V, from=byteswap[T]], with
+ * builtin V and T, and the byteswap directly over its bytes, returns
+ * the byteswap type. Otherwise returns NULL.
+ */
+static const byteswap_type *get_fusable_byteswap(const ndt::type &tp,
+                                                 const ndt::type &native_tp)
+{
+    const ndt::type *swapped_tp = &tp;
+    if (tp.get_type_id() == convert_type_id) {
+        const convert_type *ct = tp.extended<convert_type>();
+        // Fusing a different target type would skip a rounding step
+        if (ct->get_value_type() != native_tp) {
+            return NULL;
+        }
+        swapped_tp = &ct->get_operand_type();
+    }
+    if (swapped_tp->get_type_id() != byteswap_type_id) {
+        return NULL;
+    }
+    const byteswap_type *bt = swapped_tp->extended<byteswap_type>();
+    if (bt->get_operand_type().get_kind() == expr_kind ||
+            !is_fusable_byteswap_conversion(
+                bt->get_value_type().get_type_id(), native_tp.get_type_id())) {
+        return NULL;
+    }
+    return bt;
+}
+
 size_t dynd::make_expression_assignment_kernel(
     void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
     const char *dst_arrmeta, const ndt::type &src_tp, const char *src_arrmeta,
     kernel_request_t kernreq, const eval::eval_context *ectx)
 {
+    // Foreign-endian numbers with a conversion on either side get a single
+    // fused kernel instead of a buffered byteswap -> convert chain
+    if (ectx->errmode != assign_error_default) {
+        if (dst_tp.is_builtin()) {
+            const byteswap_type *bt = get_fusable_byteswap(src_tp, dst_tp);
+            if (bt != NULL) {
+                return make_byteswap_and_convert_kernel(
+                    ckb, ckb_offset, dst_tp.get_type_id(),
+                    bt->get_value_type().get_type_id(), kernreq, ectx->errmode);
+            }
+        } else if (src_tp.is_builtin()) {
+            const byteswap_type *bt = get_fusable_byteswap(dst_tp, src_tp);
+            if (bt != NULL) {
+                return make_convert_and_byteswap_kernel(
+                    ckb, ckb_offset, bt->get_value_type().get_type_id(),
+                    src_tp.get_type_id(), kernreq, ectx->errmode);
+            }
+        }
+    }
+
     intptr_t root_ckb_offset = ckb_offset;
     if (dst_tp.get_kind() == expr_kind) {
         const base_expr_type *dst_bed = dst_tp.extended<base_expr_type>();
@@ -0,0 +1,319 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#if !defined(__CUDACC__) && (defined(__GNUC__) || defined(__clang__)) &&      \
+    (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define DYND_PROFILE_USE_RDTSC
+#endif
+
+#include <dynd/kernels/kernel_profiler.hpp>
+#include <dynd/func/arrfunc.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+/**
+ * CKernel which forwards to the ckernel immediately after it,
+ * recording the call in a profile node.
+ */
+struct profile_ck
+    : public kernels::general_ck<profile_ck, kernel_request_host> {
+    kernels::kernel_profile_node *m_node;
+
+    profile_ck(kernels::kernel_profile_node *node) : m_node(node) {}
+
+    inline void init_kernfunc(kernel_request_t kernreq)
+    {
+        base.set_expr_function(kernreq, &profile_ck::single_wrapper,
+                               &profile_ck::strided_wrapper);
+    }
+
+    static void single_wrapper(char *dst, char **src, ckernel_prefix *rawself)
+    {
+        profile_ck *self = get_self(rawself);
+        ckernel_prefix *child = self->get_child_ckernel();
+        expr_single_t child_fn = child->get_function<expr_single_t>();
+        uint64_t start = kernels::kernel_profiler::read_cycles();
+        child_fn(dst, src, child);
+        self->m_node->record(1, kernels::kernel_profiler::read_cycles() - start);
+    }
+
+    static void strided_wrapper(char *dst, intptr_t dst_stride, char **src,
+                                const intptr_t *src_stride, size_t count,
+                                ckernel_prefix *rawself)
+    {
+        profile_ck *self = get_self(rawself);
+        ckernel_prefix *child = self->get_child_ckernel();
+        expr_strided_t child_fn = child->get_function<expr_strided_t>();
+        uint64_t start = kernels::kernel_profiler::read_cycles();
+        child_fn(dst, dst_stride, src, src_stride, count, child);
+        self->m_node->record(count,
+                             kernels::kernel_profiler::read_cycles() - start);
+    }
+
+    inline void destruct_children()
+    {
+        // The profiled ckernel
+        get_child_ckernel()->destroy();
+    }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        // Clones share the profile node, which records atomically
+        base.clone_child_ckernels(dst, sizeof(self_type));
+    }
+};
+
+const char *kernreq_name(kernel_request_t kernreq)
+{
+    return kernreq == kernel_request_strided ? "strided" : "single";
+}
+
+uint64_t children_cycles(const kernels::kernel_profile_node *node)
+{
+    uint64_t result = 0;
+    for (size_t i = 0, i_end = node->children.size(); i != i_end; ++i) {
+        result += node->children[i]->cycles.load(memory_order_relaxed);
+    }
+    return result;
+}
+
+uint64_t self_cycles(const kernels::kernel_profile_node *node)
+{
+    uint64_t cycles = node->cycles.load(memory_order_relaxed);
+    uint64_t in_children = children_cycles(node);
+    // Children instantiated but never called through this ckernel
+    // (e.g. only on another thread) can exceed it
+    return cycles > in_children ? cycles - in_children : 0;
+}
+
+void print_text(ostream &o, const kernels::kernel_profile_node *node,
+                uint64_t total, int indent)
+{
+    uint64_t self = self_cycles(node);
+    o << setw(12) << node->calls.load(memory_order_relaxed) << " "
+      << setw(14) << node->elements.load(memory_order_relaxed) << " "
+      << setw(16) << node->cycles.load(memory_order_relaxed) << " " << setw(6)
+      << fixed << setprecision(1)
+      << (total > 0 ? 100.0 * self / total : 0.0) << "%  "
+      << string(2 * indent, ' ') << kernreq_name(node->kernreq) << " "
+      << node->name << "\n";
+    for (size_t i = 0, i_end = node->children.size(); i != i_end; ++i) {
+        print_text(o, node->children[i], total, indent + 1);
+    }
+}
+
+void print_json_string(ostream &o, const string &s)
+{
+    o << "\"";
+    for (size_t i = 0, i_end = s.size(); i != i_end; ++i) {
+        char c = s[i];
+        if (c == '"' || c == '\\') {
+            o << '\\' << c;
+        } else if ((unsigned char)c < 0x20) {
+            o << "\\u" << hex << setw(4) << setfill('0') << (int)c << dec
+              << setfill(' ');
+        } else {
+            o << c;
+        }
+    }
+    o << "\"";
+}
+
+void print_json(ostream &o, const kernels::kernel_profile_node *node)
+{
+    o << "{\"name\": ";
+    print_json_string(o, node->name);
+    o << ", \"request\": \"" << kernreq_name(node->kernreq) << "\"";
+    o << ", \"calls\": " << node->calls.load(memory_order_relaxed);
+    o << ", \"elements\": " << node->elements.load(memory_order_relaxed);
+    o << ", \"cycles\": " << node->cycles.load(memory_order_relaxed);
+    o << ", \"self_cycles\": " << self_cycles(node);
+    o << ", \"children\": [";
+    for (size_t i = 0, i_end = node->children.size(); i != i_end; ++i) {
+        if (i != 0) {
+            o << ", ";
+        }
+        print_json(o, node->children[i]);
+    }
+    o << "]}";
+}
+
+/**
+ * Profiles eval::default_eval_context for the whole process when
+ * DYND_PROFILE_KERNELS is set, printing the result at exit.
+ */
+struct environment_profiler {
+    kernels::kernel_profiler *profiler;
+    bool json;
+
+    environment_profiler() : profiler(NULL), json(false)
+    {
+        const char *env = getenv("DYND_PROFILE_KERNELS");
+        if (env != NULL && *env != '\0' && strcmp(env, "0") != 0) {
+            profiler = new kernels::kernel_profiler();
+            json = (strcmp(env, "json") == 0);
+            eval::default_eval_context.profiler = profiler;
+        }
+    }
+
+    ~environment_profiler()
+    {
+        if (profiler != NULL) {
+            eval::default_eval_context.profiler = NULL;
+            cerr << (json ? profiler->to_json() : profiler->to_text());
+            // Not deleted, because ckernels in static objects which
+            // are destroyed later may still point at its nodes
+        }
+    }
+} environment_profiler_instance;
+} // anonymous namespace
+
+kernels::kernel_profiler::kernel_profiler()
+{
+    m_nodes.emplace_back("", kernel_request_single);
+}
+
+kernels::kernel_profile_node *
+kernels::kernel_profiler::get_child(kernel_profile_node *parent,
+                                    size_t &inout_cursor, const string &name,
+                                    kernel_request_t kernreq)
+{
+    lock_guard<mutex> lock(m_mutex);
+    vector<kernel_profile_node *> &children = parent->children;
+    for (size_t i = inout_cursor, i_end = children.size(); i < i_end; ++i) {
+        if (children[i]->kernreq == kernreq && children[i]->name == name) {
+            inout_cursor = i + 1;
+            return children[i];
+        }
+    }
+    m_nodes.emplace_back(name, kernreq);
+    children.push_back(&m_nodes.back());
+    inout_cursor = children.size();
+    return children.back();
+}
+
+void kernels::kernel_profiler::reset()
+{
+    lock_guard<mutex> lock(m_mutex);
+    for (deque<kernel_profile_node>::iterator it = m_nodes.begin();
+         it != m_nodes.end(); ++it) {
+        it->calls.store(0);
+        it->elements.store(0);
+        it->cycles.store(0);
+    }
+}
+
+string kernels::kernel_profiler::to_text() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    const kernel_profile_node *root = &m_nodes.front();
+    uint64_t total = children_cycles(root);
+    stringstream ss;
+    ss << setw(12) << "calls" << " " << setw(14) << "elements" << " "
+       << setw(16) << "cycles" << " " << setw(7) << "self" << "  ckernel\n";
+    for (size_t i = 0, i_end = root->children.size(); i != i_end; ++i) {
+        print_text(ss, root->children[i], total, 0);
+    }
+    return ss.str();
+}
+
+string kernels::kernel_profiler::to_json() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    const kernel_profile_node *root = &m_nodes.front();
+    stringstream ss;
+    ss << "[";
+    for (size_t i = 0, i_end = root->children.size(); i != i_end; ++i) {
+        if (i != 0) {
+            ss << ", ";
+        }
+        print_json(ss, root->children[i]);
+    }
+    ss << "]\n";
+    return ss.str();
+}
+
+uint64_t kernels::kernel_profiler::read_cycles()
+{
+#ifdef DYND_PROFILE_USE_RDTSC
+    return __rdtsc();
+#else
+    return chrono::duration_cast<chrono::nanoseconds>(
+               chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+kernels::profile_scope::profile_scope(void *ckb, intptr_t ckb_offset,
+                                      kernel_request_t kernreq,
+                                      const eval::eval_context *ectx,
+                                      const string &name)
+    : m_profiler(ectx->profiler), m_offset(ckb_offset)
+{
+    // Find the node under the one being instantiated on this thread
+    vector<kernel_profiler::frame> *stack;
+    kernel_profiler::frame parent;
+    {
+        lock_guard<mutex> lock(m_profiler->m_mutex);
+        stack = &m_profiler->m_stacks[this_thread::get_id()];
+        if (stack->empty()) {
+            parent.node = &m_profiler->m_nodes.front();
+            parent.cursor = 0;
+        } else {
+            parent = stack->back();
+        }
+    }
+    kernel_profiler::frame current;
+    current.node =
+        m_profiler->get_child(parent.node, parent.cursor, name, kernreq);
+    current.cursor = 0;
+
+    profile_ck::create(ckb, kernreq, m_offset, current.node);
+
+    lock_guard<mutex> lock(m_profiler->m_mutex);
+    if (!stack->empty()) {
+        stack->back().cursor = parent.cursor;
+    }
+    stack->push_back(current);
+}
+
+kernels::profile_scope::~profile_scope()
+{
+    lock_guard<mutex> lock(m_profiler->m_mutex);
+    map<thread::id, vector<kernel_profiler::frame> >::iterator it =
+        m_profiler->m_stacks.find(this_thread::get_id());
+    it->second.pop_back();
+    if (it->second.empty()) {
+        m_profiler->m_stacks.erase(it);
+    }
+}
+
+intptr_t kernels::instantiate_profiled_ckernel(
+    const arrfunc_type_data *af, const arrfunc_type *af_tp, void *ckb,
+    intptr_t ckb_offset, const ndt::type &dst_tp, const char *dst_arrmeta,
+    const ndt::type *src_tp, const char *const *src_arrmeta,
+    kernel_request_t kernreq, const eval::eval_context *ectx,
+    const nd::array &args, const nd::array &kwds)
+{
+    stringstream ss;
+    ss << "(";
+    for (intptr_t i = 0, i_end = af_tp->get_npos(); i < i_end; ++i) {
+        ss << (i == 0 ? "" : ", ") << src_tp[i];
+    }
+    ss << ") -> " << dst_tp;
+    profile_scope scope(ckb, ckb_offset, kernreq, ectx, ss.str());
+    return af->instantiate(af, af_tp, ckb, scope.get_offset(), dst_tp,
+                           dst_arrmeta, src_tp, src_arrmeta, kernreq, ectx,
+                           args, kwds);
+}
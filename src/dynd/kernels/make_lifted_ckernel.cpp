@@ -65,6 +65,11 @@ struct strided_expr_kernel_extra {
     {
         self->destroy_child_ckernel(sizeof(extra_type));
     }
+
+    static void clone(ckernel_prefix *dst, const ckernel_prefix *src)
+    {
+        src->clone_child_ckernels(dst, sizeof(extra_type));
+    }
 };
 
 } // anonymous namespace
@@ -102,6 +107,7 @@ static size_t make_elwise_strided_dimension_expr_kernel_for_N(
   }
   }
   e->base.destructor = strided_expr_kernel_extra<N>::destruct;
+  register_ckernel_clone<strided_expr_kernel_extra<N> >();
   if (!dst_tp.get_as_strided(dst_arrmeta, &e->size, &e->dst_stride,
                              &child_dst_tp, &child_dst_arrmeta)) {
     stringstream ss;
@@ -145,10 +151,11 @@ static size_t make_elwise_strided_dimension_expr_kernel_for_N(
         child_src_arrmeta, kernel_request_strided, ectx);
   }
   // Instantiate the elementwise handler
-  return elwise_handler->instantiate(
-      elwise_handler, elwise_handler_tp, ckb, ckb_offset, child_dst_tp,
-      child_dst_arrmeta, child_src_tp, child_src_arrmeta,
-      kernel_request_strided, ectx, nd::array(), nd::array());
+  return kernels::instantiate_ckernel(elwise_handler, elwise_handler_tp, ckb,
+                                      ckb_offset, child_dst_tp,
+                                      child_dst_arrmeta, child_src_tp,
+                                      child_src_arrmeta, kernel_request_strided,
+                                      ectx, nd::array(), nd::array());
 }
 
 inline static size_t make_elwise_strided_dimension_expr_kernel(
@@ -259,6 +266,11 @@ struct strided_or_var_to_strided_expr_kernel_extra {
     {
         self->destroy_child_ckernel(sizeof(extra_type));
     }
+
+    static void clone(ckernel_prefix *dst, const ckernel_prefix *src)
+    {
+        src->clone_child_ckernels(dst, sizeof(extra_type));
+    }
 };
 
 } // anonymous namespace
@@ -298,6 +310,7 @@ static size_t make_elwise_strided_or_var_to_strided_dimension_expr_kernel_for_N(
   }
   }
   e->base.destructor = strided_or_var_to_strided_expr_kernel_extra<N>::destruct;
+  register_ckernel_clone<strided_or_var_to_strided_expr_kernel_extra<N> >();
   if (!dst_tp.get_as_strided(dst_arrmeta, &e->size, &e->dst_stride,
                              &child_dst_tp, &child_dst_arrmeta)) {
     stringstream ss;
@@ -351,10 +364,11 @@ static size_t make_elwise_strided_or_var_to_strided_dimension_expr_kernel_for_N(
         kernel_request_strided, ectx);
   }
   // Instantiate the elementwise handler
-  return elwise_handler->instantiate(
-      elwise_handler, elwise_handler_tp, ckb, ckb_offset, child_dst_tp,
-      child_dst_arrmeta, child_src_tp, child_src_arrmeta,
-      kernel_request_strided, ectx, nd::array(), nd::array());
+  return kernels::instantiate_ckernel(elwise_handler, elwise_handler_tp, ckb,
+                                      ckb_offset, child_dst_tp,
+                                      child_dst_arrmeta, child_src_tp,
+                                      child_src_arrmeta, kernel_request_strided,
+                                      ectx, nd::array(), nd::array());
 }
 
 static size_t make_elwise_strided_or_var_to_strided_dimension_expr_kernel(
@@ -537,6 +551,11 @@ struct strided_or_var_to_var_expr_kernel_extra {
     {
         self->destroy_child_ckernel(sizeof(extra_type));
     }
+
+    static void clone(ckernel_prefix *dst, const ckernel_prefix *src)
+    {
+        src->clone_child_ckernels(dst, sizeof(extra_type));
+    }
 };
 
 } // anonymous namespace
@@ -575,6 +594,7 @@ static size_t make_elwise_strided_or_var_to_var_dimension_expr_kernel_for_N(
   }
   }
   e->base.destructor = strided_or_var_to_var_expr_kernel_extra<N>::destruct;
+  register_ckernel_clone<strided_or_var_to_var_expr_kernel_extra<N> >();
   // The dst var parameters
   const var_dim_type *dst_vdd = dst_tp.extended<var_dim_type>();
   const var_dim_type_arrmeta *dst_md =
@@ -627,10 +647,11 @@ static size_t make_elwise_strided_or_var_to_var_dimension_expr_kernel_for_N(
         child_src_arrmeta, kernel_request_strided, ectx);
   }
   // All the types matched, so instantiate the elementwise handler
-  return elwise_handler->instantiate(
-      elwise_handler, elwise_handler_tp, ckb, ckb_offset, child_dst_tp,
-      child_dst_arrmeta, child_src_tp, child_src_arrmeta,
-      kernel_request_strided, ectx, nd::array(), nd::array());
+  return kernels::instantiate_ckernel(elwise_handler, elwise_handler_tp, ckb,
+                                      ckb_offset, child_dst_tp,
+                                      child_dst_arrmeta, child_src_tp,
+                                      child_src_arrmeta, kernel_request_strided,
+                                      ectx, nd::array(), nd::array());
 }
 
 static size_t make_elwise_strided_or_var_to_var_dimension_expr_kernel(
@@ -693,10 +714,10 @@ size_t dynd::make_lifted_expr_ckernel(
     }
     if (i == src_count) {
       // No dimensions to lift, call the elementwise instantiate directly
-      return elwise_handler->instantiate(elwise_handler, elwise_handler_tp, ckb,
-                                         ckb_offset, dst_tp, dst_arrmeta,
-                                         src_tp, src_arrmeta, kernreq, ectx,
-                                         nd::array(), nd::array());
+      return kernels::instantiate_ckernel(elwise_handler, elwise_handler_tp,
+                                          ckb, ckb_offset, dst_tp, dst_arrmeta,
+                                          src_tp, src_arrmeta, kernreq, ectx,
+                                          nd::array(), nd::array());
     }
     else {
       stringstream ss;
@@ -165,6 +165,11 @@ struct strided_initial_reduction_kernel_extra {
     {
         self->destroy_child_ckernel(sizeof(extra_type));
     }
+
+    static void clone(ckernel_prefix *dst, const ckernel_prefix *src)
+    {
+        src->clone_child_ckernels(dst, sizeof(extra_type));
+    }
 };
 
 /**
@@ -273,6 +278,11 @@ struct strided_initial_broadcast_kernel_extra {
     {
         self->destroy_child_ckernel(sizeof(extra_type));
     }
+
+    static void clone(ckernel_prefix *dst, const ckernel_prefix *src)
+    {
+        src->clone_child_ckernels(dst, sizeof(extra_type));
+    }
 };
 
 /**
@@ -462,6 +472,16 @@ struct strided_inner_reduction_kernel_extra {
         // The destination initialization kernel
         self->destroy_child_ckernel(e->dst_init_kernel_offset);
     }
+
+    static void clone(ckernel_prefix *dst, const ckernel_prefix *src)
+    {
+        const extra_type *e = reinterpret_cast<const extra_type *>(src);
+        src->clone_child_ckernels(dst, sizeof(extra_type),
+                                  e->dst_init_kernel_offset);
+        if (e->ident_ref != NULL) {
+            memory_block_incref(e->ident_ref);
+        }
+    }
 };
 
 /**
@@ -638,6 +658,16 @@ struct strided_inner_broadcast_kernel_extra {
         // The destination initialization kernel
         self->destroy_child_ckernel(e->dst_init_kernel_offset);
     }
+
+    static void clone(ckernel_prefix *dst, const ckernel_prefix *src)
+    {
+        const extra_type *e = reinterpret_cast<const extra_type *>(src);
+        src->clone_child_ckernels(dst, sizeof(extra_type),
+                                  e->dst_init_kernel_offset);
+        if (e->ident_ref != NULL) {
+            memory_block_incref(e->ident_ref);
+        }
+    }
 };
 
 } // anonymous namespace
@@ -656,6 +686,7 @@ static size_t make_strided_initial_reduction_dimension_kernel(
       reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
           ->alloc_ck<strided_initial_reduction_kernel_extra>(ckb_offset);
   e->base().destructor = &strided_initial_reduction_kernel_extra::destruct;
+  register_ckernel_clone<strided_initial_reduction_kernel_extra>();
     // Get the function pointer for the first_call
     if (kernreq == kernel_request_single) {
         e->ckpbase.set_first_call_function(&strided_initial_reduction_kernel_extra::single_first);
@@ -688,6 +719,7 @@ static size_t make_strided_initial_broadcast_dimension_kernel(
       reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
           ->alloc_ck<strided_initial_broadcast_kernel_extra>(ckb_offset);
   e->base().destructor = &strided_initial_broadcast_kernel_extra::destruct;
+  register_ckernel_clone<strided_initial_broadcast_kernel_extra>();
     // Get the function pointer for the first_call
     if (kernreq == kernel_request_single) {
         e->ckpbase.set_first_call_function(&strided_initial_broadcast_kernel_extra::single_first);
@@ -750,6 +782,7 @@ static size_t make_strided_inner_reduction_dimension_kernel(
       reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
           ->alloc_ck<strided_inner_reduction_kernel_extra>(ckb_offset);
   e->base().destructor = &strided_inner_reduction_kernel_extra::destruct;
+  register_ckernel_clone<strided_inner_reduction_kernel_extra>();
   // Cannot have both a dst_initialization kernel and a reduction identity
   if (dst_initialization != NULL && !reduction_identity.is_null()) {
     throw invalid_argument(
@@ -833,15 +866,20 @@ static size_t make_strided_inner_reduction_dimension_kernel(
         ckb, ckb_offset, right_associative, kernel_request_strided);
     ndt::type src_tp_doubled[2] = {src_tp, src_tp};
     const char *src_arrmeta_doubled[2] = {src_arrmeta, src_arrmeta};
-    ckb_offset = elwise_reduction->instantiate(
-        elwise_reduction, elwise_reduction_tp, ckb, ckb_offset, dst_tp,
-        dst_arrmeta, src_tp_doubled, src_arrmeta_doubled,
-        kernel_request_strided, ectx, nd::array(), nd::array());
+    ckb_offset = kernels::instantiate_ckernel(elwise_reduction,
+                                              elwise_reduction_tp, ckb,
+                                              ckb_offset, dst_tp, dst_arrmeta,
+                                              src_tp_doubled,
+                                              src_arrmeta_doubled,
+                                              kernel_request_strided, ectx,
+                                              nd::array(), nd::array());
   } else {
-    ckb_offset = elwise_reduction->instantiate(
-        elwise_reduction, elwise_reduction_tp, ckb, ckb_offset, dst_tp,
-        dst_arrmeta, &src_tp, &src_arrmeta, kernel_request_strided, ectx,
-        nd::array(), nd::array());
+    ckb_offset = kernels::instantiate_ckernel(elwise_reduction,
+                                              elwise_reduction_tp, ckb,
+                                              ckb_offset, dst_tp, dst_arrmeta,
+                                              &src_tp, &src_arrmeta,
+                                              kernel_request_strided, ectx,
+                                              nd::array(), nd::array());
   }
   // Make sure there's capacity for the next ckernel
   reinterpret_cast<ckernel_builder<kernel_request_host> *>(
@@ -851,10 +889,12 @@ static size_t make_strided_inner_reduction_dimension_kernel(
                         ckb)->get_at<strided_inner_reduction_kernel_extra>(root_ckb_offset);
   e->dst_init_kernel_offset = ckb_offset - root_ckb_offset;
   if (dst_initialization != NULL) {
-    ckb_offset = dst_initialization->instantiate(
-        dst_initialization, dst_initialization_tp, ckb, ckb_offset, dst_tp,
-        dst_arrmeta, &src_tp, &src_arrmeta, kernel_request_single, ectx,
-        nd::array(), nd::array());
+    ckb_offset = kernels::instantiate_ckernel(dst_initialization,
+                                              dst_initialization_tp, ckb,
+                                              ckb_offset, dst_tp, dst_arrmeta,
+                                              &src_tp, &src_arrmeta,
+                                              kernel_request_single, ectx,
+                                              nd::array(), nd::array());
   } else if (reduction_identity.is_null()) {
     ckb_offset =
         make_assignment_kernel(ckb, ckb_offset, dst_tp, dst_arrmeta, src_tp,
@@ -889,6 +929,7 @@ static size_t make_strided_inner_broadcast_dimension_kernel(
       reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
           ->alloc_ck<strided_inner_broadcast_kernel_extra>(ckb_offset);
   e->base().destructor = &strided_inner_broadcast_kernel_extra::destruct;
+  register_ckernel_clone<strided_inner_broadcast_kernel_extra>();
   // Cannot have both a dst_initialization kernel and a reduction identity
   if (dst_initialization != NULL && !reduction_identity.is_null()) {
     throw invalid_argument(
@@ -973,15 +1014,20 @@ static size_t make_strided_inner_broadcast_dimension_kernel(
         ckb, ckb_offset, right_associative, kernel_request_strided);
     ndt::type src_tp_doubled[2] = {src_tp, src_tp};
     const char *src_arrmeta_doubled[2] = {src_arrmeta, src_arrmeta};
-    ckb_offset = elwise_reduction->instantiate(
-        elwise_reduction, elwise_reduction_tp, ckb, ckb_offset, dst_tp,
-        dst_arrmeta, src_tp_doubled, src_arrmeta_doubled,
-        kernel_request_strided, ectx, nd::array(), nd::array());
+    ckb_offset = kernels::instantiate_ckernel(elwise_reduction,
+                                              elwise_reduction_tp, ckb,
+                                              ckb_offset, dst_tp, dst_arrmeta,
+                                              src_tp_doubled,
+                                              src_arrmeta_doubled,
+                                              kernel_request_strided, ectx,
+                                              nd::array(), nd::array());
   } else {
-    ckb_offset = elwise_reduction->instantiate(
-        elwise_reduction, elwise_reduction_tp, ckb, ckb_offset, dst_tp,
-        dst_arrmeta, &src_tp, &src_arrmeta, kernel_request_strided, ectx,
-        nd::array(), nd::array());
+    ckb_offset = kernels::instantiate_ckernel(elwise_reduction,
+                                              elwise_reduction_tp, ckb,
+                                              ckb_offset, dst_tp, dst_arrmeta,
+                                              &src_tp, &src_arrmeta,
+                                              kernel_request_strided, ectx,
+                                              nd::array(), nd::array());
   }
   // Make sure there's capacity for the next ckernel
   reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
@@ -991,10 +1037,12 @@ static size_t make_strided_inner_broadcast_dimension_kernel(
                         ckb)->get_at<strided_inner_broadcast_kernel_extra>(root_ckb_offset);
   e->dst_init_kernel_offset = ckb_offset - root_ckb_offset;
   if (dst_initialization != NULL) {
-    ckb_offset = dst_initialization->instantiate(
-        dst_initialization, dst_initialization_tp, ckb, ckb_offset, dst_tp,
-        dst_arrmeta, &src_tp, &src_arrmeta, kernel_request_strided, ectx,
-        nd::array(), nd::array());
+    ckb_offset = kernels::instantiate_ckernel(dst_initialization,
+                                              dst_initialization_tp, ckb,
+                                              ckb_offset, dst_tp, dst_arrmeta,
+                                              &src_tp, &src_arrmeta,
+                                              kernel_request_strided, ectx,
+                                              nd::array(), nd::array());
   } else if (reduction_identity.is_null()) {
     ckb_offset =
         make_assignment_kernel(ckb, ckb_offset, dst_tp, dst_arrmeta, src_tp,
@@ -1030,10 +1078,11 @@ size_t dynd::make_lifted_reduction_ckernel(
       // just a dst_initialization operation, so create
       // that ckernel directly
       if (dst_initialization != NULL) {
-        return dst_initialization->instantiate(
-            dst_initialization, dst_initialization_tp, ckb, ckb_offset, dst_tp,
-            dst_arrmeta, &src_tp, &src_arrmeta, kernreq, ectx, nd::array(),
-            nd::array());
+        return kernels::instantiate_ckernel(dst_initialization,
+                                            dst_initialization_tp, ckb,
+                                            ckb_offset, dst_tp, dst_arrmeta,
+                                            &src_tp, &src_arrmeta, kernreq,
+                                            ectx, nd::array(), nd::array());
       }
       else if (reduction_identity.is_null()) {
         return make_assignment_kernel(ckb, ckb_offset, dst_tp, dst_arrmeta,
@@ -0,0 +1,354 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include <dynd/kernels/math_kernels.hpp>
+
+using namespace std;
+using namespace dynd;
+
+#if !defined(__CUDACC__) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define DYND_VMATH_X86
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DYND_VMATH_INLINE inline __attribute__((always_inline))
+#else
+#define DYND_VMATH_INLINE inline
+#endif
+
+namespace {
+
+// Adding and subtracting 1.5 * 2^52 rounds a double of magnitude below
+// 2^51 to the nearest integer, which then sits in the low mantissa bits
+const double magic_round = 6755399441055744.0;
+
+// ln(2) split so that multiples of ln2_hi by exponents are exact
+const double ln2_hi = 6.93147180369123816490e-01;
+const double ln2_lo = 1.90821492927058770002e-10;
+
+DYND_VMATH_INLINE uint64_t as_bits(double x)
+{
+  uint64_t u;
+  memcpy(&u, &x, sizeof(u));
+  return u;
+}
+
+DYND_VMATH_INLINE double from_bits(uint64_t u)
+{
+  double x;
+  memcpy(&x, &u, sizeof(x));
+  return x;
+}
+
+/**
+ * exp(x) for |x| <= 708, where neither the result nor the power of two
+ * used to scale it is subnormal or overflows.
+ */
+DYND_VMATH_INLINE double exp_core(double x)
+{
+  double k = x * 1.4426950408889634 + magic_round;
+  double kd = k - magic_round;
+  int64_t n = static_cast<int64_t>(as_bits(k) - as_bits(magic_round));
+  // |r| <= ln(2) / 2
+  double r = (x - kd * ln2_hi) - kd * ln2_lo;
+  // Taylor series to degree 13, whose truncation error is below 2^-56
+  double p = 1.0 / 6227020800.0;
+  p = p * r + 1.0 / 479001600.0;
+  p = p * r + 1.0 / 39916800.0;
+  p = p * r + 1.0 / 3628800.0;
+  p = p * r + 1.0 / 362880.0;
+  p = p * r + 1.0 / 40320.0;
+  p = p * r + 1.0 / 5040.0;
+  p = p * r + 1.0 / 720.0;
+  p = p * r + 1.0 / 120.0;
+  p = p * r + 1.0 / 24.0;
+  p = p * r + 1.0 / 6.0;
+  p = p * r + 0.5;
+  p = p * r + 1.0;
+  p = p * r + 1.0;
+  return p * from_bits(static_cast<uint64_t>(n + 1023) << 52);
+}
+
+struct exp_kernel {
+  static DYND_VMATH_INLINE bool in_range(double x)
+  {
+    return fabs(x) <= 708.0;
+  }
+
+  static DYND_VMATH_INLINE double eval(double x)
+  {
+    return exp_core(x < 708.0 ? (x > -708.0 ? x : -708.0) : 708.0);
+  }
+
+  static double fallback(double x) { return ::exp(x); }
+};
+
+struct log_kernel {
+  static DYND_VMATH_INLINE bool in_range(double x)
+  {
+    return x >= DBL_MIN && x <= DBL_MAX;
+  }
+
+  static DYND_VMATH_INLINE double eval(double x)
+  {
+    // The coefficients are from fdlibm's e_log.c
+    const double Lg1 = 6.666666666666735130e-01, Lg2 = 3.999999999940941908e-01,
+                 Lg3 = 2.857142874366239149e-01, Lg4 = 2.222219843214978396e-01,
+                 Lg5 = 1.818357216161805012e-01, Lg6 = 1.531383769920937332e-01,
+                 Lg7 = 1.479819860511658591e-01;
+
+    uint64_t u = as_bits(x);
+    // The biased exponent, converted to a double through the mantissa bits
+    double e = from_bits(0x4330000000000000ULL | (u >> 52)) -
+               4503599627370496.0 - 1023.0;
+    double m = from_bits((u & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+    // Reduce the mantissa to [sqrt(2) / 2, sqrt(2))
+    bool big = m > 1.4142135623730951;
+    m = big ? m * 0.5 : m;
+    e = big ? e + 1.0 : e;
+
+    double f = m - 1.0;
+    double s = f / (2.0 + f);
+    double z = s * s, w = z * z;
+    double t1 = w * (Lg2 + w * (Lg4 + w * Lg6));
+    double t2 = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+    double hfsq = 0.5 * f * f;
+    return e * ln2_hi - ((hfsq - (s * (hfsq + t1 + t2) + e * ln2_lo)) - f);
+  }
+
+  static double fallback(double x) { return ::log(x); }
+};
+
+/**
+ * Reduces x by the nearest multiple q of pi/2, returning the remainder
+ * and setting ``quadrant`` to q mod 4. Exact enough for |x| <= 2^20 as
+ * long as the remainder is not tiny, since pi/2 is split into three
+ * 33-bit parts.
+ */
+DYND_VMATH_INLINE double reduce_pio2(double x, double &q, uint64_t &quadrant)
+{
+  const double pio2_1 = 1.57079632673412561417e+00,
+               pio2_2 = 6.07710050630396597660e-11,
+               pio2_3 = 2.02226624871116645580e-21;
+  double k = x * 0.63661977236758134308 + magic_round;
+  q = k - magic_round;
+  quadrant = as_bits(k);
+  return ((x - q * pio2_1) - q * pio2_2) - q * pio2_3;
+}
+
+DYND_VMATH_INLINE bool pio2_in_range(double x)
+{
+  double q;
+  uint64_t quadrant;
+  double r = reduce_pio2(x, q, quadrant);
+  return fabs(x) <= 1048576.0 && (q == 0.0 || fabs(r) >= 1e-6);
+}
+
+/**
+ * sin or cos of x, picked by quadrant + offset, using the polynomials
+ * from Cephes sin.c on [-pi/4, pi/4].
+ */
+DYND_VMATH_INLINE double sincos_eval(double x, uint64_t offset)
+{
+  double q;
+  uint64_t quadrant;
+  double r = reduce_pio2(x, q, quadrant);
+  double z = r * r;
+
+  double ps = 1.58962301576546568060E-10;
+  ps = ps * z - 2.50507477628578072866E-8;
+  ps = ps * z + 2.75573136213857245213E-6;
+  ps = ps * z - 1.98412698295895385996E-4;
+  ps = ps * z + 8.33333333332211858878E-3;
+  ps = ps * z - 1.66666666666666307295E-1;
+  double s = r + r * z * ps;
+
+  double pc = -1.13585365213876817300E-11;
+  pc = pc * z + 2.08757008419747316778E-9;
+  pc = pc * z - 2.75573141792967388112E-7;
+  pc = pc * z + 2.48015872888517045348E-5;
+  pc = pc * z - 1.38888888888730564116E-3;
+  pc = pc * z + 4.16666666666665929218E-2;
+  double c = 1.0 - 0.5 * z + z * z * pc;
+
+  quadrant += offset;
+  double v = (quadrant & 1) ? c : s;
+  return (quadrant & 2) ? -v : v;
+}
+
+struct sin_kernel {
+  static DYND_VMATH_INLINE bool in_range(double x)
+  {
+    // Zero goes to the fallback to keep its sign
+    return pio2_in_range(x) && x != 0.0;
+  }
+
+  static DYND_VMATH_INLINE double eval(double x) { return sincos_eval(x, 0); }
+
+  static double fallback(double x) { return ::sin(x); }
+};
+
+struct cos_kernel {
+  static DYND_VMATH_INLINE bool in_range(double x) { return pio2_in_range(x); }
+
+  static DYND_VMATH_INLINE double eval(double x) { return sincos_eval(x, 1); }
+
+  static double fallback(double x) { return ::cos(x); }
+};
+
+struct tanh_kernel {
+  static DYND_VMATH_INLINE bool in_range(double x)
+  {
+    // Zero goes to the fallback to keep its sign, and NaN fails both
+    return x == x && x != 0.0;
+  }
+
+  static DYND_VMATH_INLINE double eval(double x)
+  {
+    double a = fabs(x);
+
+    // The rational approximation from Cephes tanh.c for |x| < 0.625
+    double z = x * x;
+    double p = (-9.64399179425052238628E-1 * z - 9.92877231001918586564E1) * z -
+               1.61468768441708447952E3;
+    double q = ((z + 1.12811678491632931402E2) * z + 2.23548839060100448583E3) *
+                   z +
+               4.84406305325125486048E3;
+    double small = x + x * z * (p / q);
+
+    // 1 - 2 / (exp(2|x|) + 1) otherwise, which rounds to 1 above 22
+    double e = exp_core(2.0 * (a < 22.0 ? a : 22.0));
+    double large = a < 22.0 ? 1.0 - 2.0 / (e + 1.0) : 1.0;
+    large = x < 0.0 ? -large : large;
+
+    return a < 0.625 ? small : large;
+  }
+
+  static double fallback(double x) { return ::tanh(x); }
+};
+
+/**
+ * Applies kernel K to blocks of the input. Each block is copied first,
+ * so that ``dst`` may alias ``src``, then evaluated with a branch-free
+ * loop, and finally any out of range inputs are redone by the fallback.
+ */
+template <typename K, typename T>
+DYND_VMATH_INLINE void apply_kernel(T *dst, const T *src, size_t count)
+{
+  const size_t block_size = 256;
+  T x[block_size];
+  unsigned char ok[block_size];
+  for (size_t b = 0; b < count; b += block_size) {
+    size_t n = std::min(block_size, count - b);
+    memcpy(x, src + b, n * sizeof(T));
+    T *d = dst + b;
+    unsigned char all_ok = 1;
+    for (size_t i = 0; i < n; ++i) {
+      double xi = x[i];
+      ok[i] = K::in_range(xi);
+      all_ok &= ok[i];
+      d[i] = static_cast<T>(K::eval(xi));
+    }
+    if (!all_ok) {
+      for (size_t i = 0; i < n; ++i) {
+        if (!ok[i]) {
+          d[i] = static_cast<T>(K::fallback(x[i]));
+        }
+      }
+    }
+  }
+}
+
+enum isa_level_t { isa_default, isa_avx2, isa_avx512f };
+
+isa_level_t get_isa_level()
+{
+#ifdef DYND_VMATH_X86
+  static const isa_level_t result =
+      __builtin_cpu_supports("avx512f")
+          ? isa_avx512f
+          : ((__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                 ? isa_avx2
+                 : isa_default);
+  return result;
+#else
+  return isa_default;
+#endif
+}
+
+} // anonymous namespace
+
+#ifdef DYND_VMATH_X86
+
+#define DYND_VMATH_FUNCTION(NAME, T)                                           \
+  static void NAME##_default(T *dst, const T *src, size_t count)               \
+  {                                                                            \
+    apply_kernel<NAME##_kernel>(dst, src, count);                              \
+  }                                                                            \
+  __attribute__((target("avx2,fma"))) static void NAME##_avx2(                 \
+      T *dst, const T *src, size_t count)                                      \
+  {                                                                            \
+    apply_kernel<NAME##_kernel>(dst, src, count);                              \
+  }                                                                            \
+  __attribute__((target("avx512f"))) static void NAME##_avx512f(               \
+      T *dst, const T *src, size_t count)                                      \
+  {                                                                            \
+    apply_kernel<NAME##_kernel>(dst, src, count);                              \
+  }                                                                            \
+  void kernels::vmath::NAME(T *dst, const T *src, size_t count)                \
+  {                                                                            \
+    switch (get_isa_level()) {                                                 \
+    case isa_avx512f:                                                          \
+      NAME##_avx512f(dst, src, count);                                         \
+      break;                                                                   \
+    case isa_avx2:                                                             \
+      NAME##_avx2(dst, src, count);                                            \
+      break;                                                                   \
+    default:                                                                   \
+      NAME##_default(dst, src, count);                                         \
+      break;                                                                   \
+    }                                                                          \
+  }
+
+#else
+
+#define DYND_VMATH_FUNCTION(NAME, T)                                           \
+  void kernels::vmath::NAME(T *dst, const T *src, size_t count)                \
+  {                                                                            \
+    apply_kernel<NAME##_kernel>(dst, src, count);                              \
+  }
+
+#endif
+
+DYND_VMATH_FUNCTION(exp, double)
+DYND_VMATH_FUNCTION(exp, float)
+DYND_VMATH_FUNCTION(log, double)
+DYND_VMATH_FUNCTION(log, float)
+DYND_VMATH_FUNCTION(sin, double)
+DYND_VMATH_FUNCTION(sin, float)
+DYND_VMATH_FUNCTION(cos, double)
+DYND_VMATH_FUNCTION(cos, float)
+DYND_VMATH_FUNCTION(tanh, double)
+DYND_VMATH_FUNCTION(tanh, float)
+
+#undef DYND_VMATH_FUNCTION
+
+const char *kernels::vmath::get_isa()
+{
+  switch (get_isa_level()) {
+  case isa_avx512f:
+    return "avx512f";
+  case isa_avx2:
+    return "avx2";
+  default:
+    return "default";
+  }
+}
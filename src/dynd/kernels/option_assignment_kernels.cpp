@@ -123,6 +123,13 @@ struct option_to_option_ck
         // value_assign
         base.destroy_child_ckernel(m_value_assign_offset);
     }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        base.clone_child_ckernels(dst, sizeof(self_type),
+                                  m_dst_assign_na_offset,
+                                  m_value_assign_offset);
+    }
 };
 
 /**
@@ -189,6 +196,12 @@ struct option_to_value_ck
         // value_assign
         base.destroy_child_ckernel(m_value_assign_offset);
     }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        base.clone_child_ckernels(dst, sizeof(self_type),
+                                  m_value_assign_offset);
+    }
 };
 
 } // anonymous namespace
@@ -220,16 +233,18 @@ static intptr_t instantiate_option_to_option_assignment_kernel(
   const arrfunc_type *af_tp =
       src_tp[0].extended<option_type>()->get_is_avail_arrfunc_type();
   ckb_offset =
-      af->instantiate(af, af_tp, ckb, ckb_offset, ndt::make_type<dynd_bool>(),
-                      NULL, src_tp, src_arrmeta, kernreq, ectx, args, kwds);
+      kernels::instantiate_ckernel(af, af_tp, ckb, ckb_offset,
+                                   ndt::make_type<dynd_bool>(), NULL, src_tp,
+                                   src_arrmeta, kernreq, ectx, args, kwds);
   // instantiate dst_assign_na
   reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->ensure_capacity_leaf(ckb_offset);
   self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->get_at<self_type>(root_ckb_offset);
   self->m_dst_assign_na_offset = ckb_offset - root_ckb_offset;
   af = dst_tp.extended<option_type>()->get_assign_na_arrfunc();
   af_tp = dst_tp.extended<option_type>()->get_assign_na_arrfunc_type();
-  ckb_offset = af->instantiate(af, af_tp, ckb, ckb_offset, dst_tp, dst_arrmeta,
-                               NULL, NULL, kernreq, ectx, args, kwds);
+  ckb_offset = kernels::instantiate_ckernel(af, af_tp, ckb, ckb_offset, dst_tp,
+                                            dst_arrmeta, NULL, NULL, kernreq,
+                                            ectx, args, kwds);
   // instantiate value_assign
   reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->ensure_capacity(ckb_offset);
   self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->get_at<self_type>(root_ckb_offset);
@@ -266,8 +281,9 @@ static intptr_t instantiate_option_to_value_assignment_kernel(
   const arrfunc_type *af_tp =
       src_tp[0].extended<option_type>()->get_is_avail_arrfunc_type();
   ckb_offset =
-      af->instantiate(af, af_tp, ckb, ckb_offset, ndt::make_type<dynd_bool>(),
-                      NULL, src_tp, src_arrmeta, kernreq, ectx, args, kwds);
+      kernels::instantiate_ckernel(af, af_tp, ckb, ckb_offset,
+                                   ndt::make_type<dynd_bool>(), NULL, src_tp,
+                                   src_arrmeta, kernreq, ectx, args, kwds);
   // instantiate value_assign
   reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->ensure_capacity_leaf(ckb_offset);
   self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->get_at<self_type>(root_ckb_offset);
@@ -332,6 +348,12 @@ struct string_to_option_tp_ck : public kernels::unary_ck<string_to_option_tp_ck>
         // dst_assign_na
         base.destroy_child_ckernel(m_dst_assign_na_offset);
     }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        base.clone_child_ckernels(dst, sizeof(self_type),
+                                  m_dst_assign_na_offset);
+    }
 };
 }
 
@@ -405,8 +427,9 @@ static intptr_t instantiate_string_to_option_assignment_kernel(
       dst_tp.extended<option_type>()->get_assign_na_arrfunc();
   const arrfunc_type *af_tp =
       dst_tp.extended<option_type>()->get_assign_na_arrfunc_type();
-  ckb_offset = af->instantiate(af, af_tp, ckb, ckb_offset, dst_tp, dst_arrmeta,
-                               NULL, NULL, kernreq, ectx, args, kwds);
+  ckb_offset = kernels::instantiate_ckernel(af, af_tp, ckb, ckb_offset, dst_tp,
+                                            dst_arrmeta, NULL, NULL, kernreq,
+                                            ectx, args, kwds);
   return ckb_offset;
 }
 
@@ -507,9 +530,10 @@ size_t kernels::make_option_assignment_kernel(
     typevars.clear();
     if (ndt::pattern_match(src_tp, (*af_tp)->get_arg_type(0), typevars) &&
         ndt::pattern_match(dst_tp, (*af_tp)->get_return_type(), typevars)) {
-      return af->instantiate(af, *af_tp, ckb, ckb_offset, dst_tp, dst_arrmeta,
-                             &src_tp, &src_arrmeta, kernreq, ectx, nd::array(),
-                             nd::array());
+      return kernels::instantiate_ckernel(af, *af_tp, ckb, ckb_offset, dst_tp,
+                                          dst_arrmeta, &src_tp, &src_arrmeta,
+                                          kernreq, ectx, nd::array(),
+                                          nd::array());
     }
   }
 
@@ -41,7 +41,7 @@ struct is_avail<dynd_bool> {
         char *src0 = src[0];
         intptr_t src0_stride = src_stride[0];
         for (size_t i = 0; i != count; ++i) {
-            *dst = *reinterpret_cast<unsigned char *>(src) <= 1;
+            *dst = *reinterpret_cast<unsigned char *>(src0) <= 1;
             dst += dst_stride;
             src0 += src0_stride;
         }
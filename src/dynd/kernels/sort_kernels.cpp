@@ -0,0 +1,353 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
+#include <dynd/kernels/sort_kernels.hpp>
+#include <dynd/kernels/comparison_kernels.hpp>
+#include <dynd/types/base_string_type.hpp>
+#include <dynd/parallel.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+// Ranges shorter than this are not split across threads
+const intptr_t sort_grain_size = 16384;
+
+/**
+ * Each radix key struct maps an element to an unsigned integer
+ * whose order matches comparison_type_sorting_less.
+ */
+struct bool_radix_key {
+  static inline uint64_t get(const char *p)
+  {
+    return *reinterpret_cast<const uint8_t *>(p) != 0;
+  }
+};
+
+template <class U>
+struct unsigned_radix_key {
+  static inline uint64_t get(const char *p)
+  {
+    U u;
+    memcpy(&u, p, sizeof(U));
+    return u;
+  }
+};
+
+template <class U>
+struct signed_radix_key {
+  static inline uint64_t get(const char *p)
+  {
+    U u;
+    memcpy(&u, p, sizeof(U));
+    // Flipping the sign bit puts negative values first
+    return static_cast<U>(u ^ (U(1) << (sizeof(U) * 8 - 1)));
+  }
+};
+
+template <class F, class U>
+struct float_radix_key {
+  static inline uint64_t get(const char *p)
+  {
+    F f;
+    memcpy(&f, p, sizeof(F));
+    if (f != f) {
+      // NaNs go at the end, like op_sort_lt
+      return static_cast<U>(~U(0));
+    } else if (f == 0) {
+      // -0.0 and 0.0 compare equal
+      f = 0;
+    }
+    U u;
+    memcpy(&u, &f, sizeof(U));
+    const U sign = U(1) << (sizeof(U) * 8 - 1);
+    return (u & sign) ? static_cast<U>(~u) : static_cast<U>(u | sign);
+  }
+};
+
+/**
+ * Stable LSD radix sort of ``index`` by ``keys``, one byte
+ * at a time over the low ``key_bytes`` bytes of the keys. Each
+ * pass histograms and scatters the partitions in parallel, and
+ * passes where every key has the same byte are skipped. On exit
+ * ``keys`` is sorted and ``index`` permuted to match.
+ */
+void radix_argsort(uint64_t *keys, intptr_t *index, intptr_t count,
+                   int key_bytes, intptr_t nthreads)
+{
+  vector<uint64_t> keys_tmp(count);
+  vector<intptr_t> index_tmp(count);
+  uint64_t *ksrc = keys, *kdst = &keys_tmp[0];
+  intptr_t *isrc = index, *idst = &index_tmp[0];
+  intptr_t nparts =
+      parallel::get_partition_count(count, nthreads, sort_grain_size);
+  vector<intptr_t> hist(nparts * 256);
+
+  for (int digit = 0; digit < key_bytes; ++digit) {
+    int shift = digit * 8;
+    std::fill(hist.begin(), hist.end(), 0);
+    parallel::parallel_for(
+        count, nthreads, sort_grain_size,
+        [&](intptr_t part, intptr_t begin, intptr_t end) {
+          intptr_t *h = &hist[part * 256];
+          for (intptr_t i = begin; i != end; ++i) {
+            ++h[(ksrc[i] >> shift) & 0xff];
+          }
+        });
+    // Exclusive prefix sum in (bucket, partition) order, so each
+    // partition scatters after the earlier ones and the sort is stable
+    intptr_t total = 0;
+    bool trivial = false;
+    for (int b = 0; b < 256; ++b) {
+      intptr_t bucket_begin = total;
+      for (intptr_t p = 0; p != nparts; ++p) {
+        intptr_t c = hist[p * 256 + b];
+        hist[p * 256 + b] = total;
+        total += c;
+      }
+      if (total - bucket_begin == count) {
+        trivial = true;
+        break;
+      }
+    }
+    if (trivial) {
+      continue;
+    }
+    parallel::parallel_for(
+        count, nthreads, sort_grain_size,
+        [&](intptr_t part, intptr_t begin, intptr_t end) {
+          intptr_t *h = &hist[part * 256];
+          for (intptr_t i = begin; i != end; ++i) {
+            intptr_t pos = h[(ksrc[i] >> shift) & 0xff]++;
+            kdst[pos] = ksrc[i];
+            idst[pos] = isrc[i];
+          }
+        });
+    swap(ksrc, kdst);
+    swap(isrc, idst);
+  }
+
+  if (ksrc != keys) {
+    memcpy(keys, ksrc, count * sizeof(uint64_t));
+    memcpy(index, isrc, count * sizeof(intptr_t));
+  }
+}
+
+template <class K>
+void radix_key_argsort(const char *data, intptr_t stride, intptr_t count,
+                       int key_bytes, intptr_t *out_index, intptr_t nthreads)
+{
+  vector<uint64_t> keys(count);
+  parallel::parallel_for(count, nthreads, sort_grain_size,
+                         [&](intptr_t, intptr_t begin, intptr_t end) {
+    const char *p = data + begin * stride;
+    for (intptr_t i = begin; i != end; ++i, p += stride) {
+      keys[i] = K::get(p);
+    }
+  });
+  radix_argsort(&keys[0], out_index, count, key_bytes, nthreads);
+}
+
+/** Orders element indices with a sorting_less comparison ckernel */
+struct element_index_less {
+  comparison_ckernel_builder *m_less;
+  const char *m_data;
+  intptr_t m_stride;
+
+  inline bool operator()(intptr_t a, intptr_t b) const
+  {
+    return (*m_less)(m_data + a * m_stride, m_data + b * m_stride);
+  }
+};
+
+/**
+ * Sorts ascii/utf8 strings by radix sorting on their first eight
+ * bytes, then comparison sorting the runs which share a prefix.
+ * Byte order matches the comparison kernels of these encodings.
+ */
+void string_prefix_argsort(const ndt::type &el_tp, const char *el_arrmeta,
+                           const char *data, intptr_t stride, intptr_t count,
+                           intptr_t *out_index, intptr_t nthreads,
+                           const eval::eval_context *ectx)
+{
+  const base_string_type *bst = el_tp.extended<base_string_type>();
+  vector<uint64_t> keys(count);
+  parallel::parallel_for(count, nthreads, sort_grain_size,
+                         [&](intptr_t, intptr_t begin, intptr_t end) {
+    for (intptr_t i = begin; i != end; ++i) {
+      const char *str_begin, *str_end;
+      bst->get_string_range(&str_begin, &str_end, el_arrmeta,
+                            data + i * stride);
+      intptr_t n = min<intptr_t>(str_end - str_begin, 8);
+      uint64_t key = 0;
+      for (intptr_t j = 0; j < 8; ++j) {
+        key = (key << 8) |
+              (j < n ? reinterpret_cast<const uint8_t *>(str_begin)[j] : 0u);
+      }
+      keys[i] = key;
+    }
+  });
+  radix_argsort(&keys[0], out_index, count, 8, nthreads);
+
+  comparison_ckernel_builder k;
+  make_comparison_kernel(&k, 0, el_tp, el_arrmeta, el_tp, el_arrmeta,
+                         comparison_type_sorting_less, ectx);
+  element_index_less less = {&k, data, stride};
+  for (intptr_t i = 0; i < count;) {
+    intptr_t j = i + 1;
+    while (j < count && keys[j] == keys[i]) {
+      ++j;
+    }
+    if (j - i > 1) {
+      std::stable_sort(out_index + i, out_index + j, less);
+    }
+    i = j;
+  }
+}
+
+/**
+ * Stable merge sort driven by the type's comparison kernel. Each
+ * partition is sorted on its own thread, then neighbouring runs are
+ * merged pairwise in parallel until one run is left.
+ */
+void merge_argsort(const ndt::type &el_tp, const char *el_arrmeta,
+                   const char *data, intptr_t stride, intptr_t count,
+                   intptr_t *out_index, intptr_t nthreads,
+                   const eval::eval_context *ectx)
+{
+  intptr_t nparts =
+      parallel::get_partition_count(count, nthreads, sort_grain_size);
+  // Each thread calls its own copy of the comparison ckernel
+  vector<comparison_ckernel_builder> k(nparts);
+  for (intptr_t p = 0; p != nparts; ++p) {
+    make_comparison_kernel(&k[p], 0, el_tp, el_arrmeta, el_tp, el_arrmeta,
+                           comparison_type_sorting_less, ectx);
+  }
+
+  // The partitions are contiguous, so each thread only writes the end
+  // of its own run, and parallel_for joins them before runs is read
+  vector<intptr_t> runs(nparts + 1);
+  runs[0] = 0;
+  parallel::parallel_for(count, nthreads, sort_grain_size,
+                         [&](intptr_t part, intptr_t begin, intptr_t end) {
+    element_index_less less = {&k[part], data, stride};
+    std::stable_sort(out_index + begin, out_index + end, less);
+    runs[part + 1] = end;
+  });
+
+  vector<intptr_t> index_tmp(count);
+  intptr_t *src = out_index, *dst = &index_tmp[0];
+  while (runs.size() > 2) {
+    intptr_t nruns = runs.size() - 1;
+    parallel::parallel_for((nruns + 1) / 2, nparts, 1,
+                           [&](intptr_t part, intptr_t begin, intptr_t end) {
+      element_index_less less = {&k[part], data, stride};
+      for (intptr_t pair = begin; pair != end; ++pair) {
+        intptr_t r0 = runs[2 * pair];
+        intptr_t r1 = runs[min(2 * pair + 1, nruns)];
+        intptr_t r2 = runs[min(2 * pair + 2, nruns)];
+        std::merge(src + r0, src + r1, src + r1, src + r2, dst + r0, less);
+      }
+    });
+    vector<intptr_t> merged_runs;
+    for (intptr_t i = 0; i < nruns; i += 2) {
+      merged_runs.push_back(runs[i]);
+    }
+    merged_runs.push_back(runs[nruns]);
+    runs.swap(merged_runs);
+    swap(src, dst);
+  }
+
+  if (src != out_index) {
+    memcpy(out_index, src, count * sizeof(intptr_t));
+  }
+}
+
+} // anonymous namespace
+
+void kernels::strided_argsort(const ndt::type &el_tp, const char *el_arrmeta,
+                              const char *data, intptr_t stride,
+                              intptr_t count, intptr_t *out_index,
+                              const eval::eval_context *ectx)
+{
+  for (intptr_t i = 0; i < count; ++i) {
+    out_index[i] = i;
+  }
+  if (count <= 1) {
+    return;
+  }
+
+  intptr_t nthreads = parallel::get_num_threads();
+  switch (el_tp.get_type_id()) {
+  case bool_type_id:
+    radix_key_argsort<bool_radix_key>(data, stride, count, 1, out_index,
+                                      nthreads);
+    return;
+  case int8_type_id:
+    radix_key_argsort<signed_radix_key<uint8_t> >(data, stride, count, 1,
+                                                   out_index, nthreads);
+    return;
+  case int16_type_id:
+    radix_key_argsort<signed_radix_key<uint16_t> >(data, stride, count, 2,
+                                                    out_index, nthreads);
+    return;
+  case int32_type_id:
+  case date_type_id:
+    radix_key_argsort<signed_radix_key<uint32_t> >(data, stride, count, 4,
+                                                    out_index, nthreads);
+    return;
+  case int64_type_id:
+  case time_type_id:
+    radix_key_argsort<signed_radix_key<uint64_t> >(data, stride, count, 8,
+                                                    out_index, nthreads);
+    return;
+  case uint8_type_id:
+    radix_key_argsort<unsigned_radix_key<uint8_t> >(data, stride, count, 1,
+                                                     out_index, nthreads);
+    return;
+  case uint16_type_id:
+    radix_key_argsort<unsigned_radix_key<uint16_t> >(data, stride, count, 2,
+                                                      out_index, nthreads);
+    return;
+  case uint32_type_id:
+    radix_key_argsort<unsigned_radix_key<uint32_t> >(data, stride, count, 4,
+                                                      out_index, nthreads);
+    return;
+  case uint64_type_id:
+    radix_key_argsort<unsigned_radix_key<uint64_t> >(data, stride, count, 8,
+                                                      out_index, nthreads);
+    return;
+  case float32_type_id:
+    radix_key_argsort<float_radix_key<float, uint32_t> >(
+        data, stride, count, 4, out_index, nthreads);
+    return;
+  case float64_type_id:
+    radix_key_argsort<float_radix_key<double, uint64_t> >(
+        data, stride, count, 8, out_index, nthreads);
+    return;
+  case string_type_id:
+  case offset_string_type_id: {
+    string_encoding_t encoding =
+        el_tp.extended<base_string_type>()->get_encoding();
+    if (encoding == string_encoding_ascii ||
+        encoding == string_encoding_utf_8) {
+      string_prefix_argsort(el_tp, el_arrmeta, data, stride, count, out_index,
+                            nthreads, ectx);
+      return;
+    }
+    break;
+  }
+  default:
+    break;
+  }
+
+  merge_argsort(el_tp, el_arrmeta, data, stride, count, out_index, nthreads,
+                ectx);
+}
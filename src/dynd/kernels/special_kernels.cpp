@@ -0,0 +1,543 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include <dynd/cephes.hpp>
+#include <dynd/parallel.hpp>
+#include <dynd/special.hpp>
+#include <dynd/kernels/math_kernels.hpp>
+// Cephes renames airy to cephes_airy, which would rename the batch kernel too
+#undef airy
+#include <dynd/kernels/special_kernels.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+const size_t block_size = 256;
+
+// Number of elements below which the batch functions stay on one thread
+const intptr_t parallel_grain_size = 16384;
+
+const double SQ2OPI = 7.9788456080286535587989E-1;
+const double TWOOPI = 6.36619772367581343075535E-1;
+const double PIO4 = 7.85398163397448309616E-1;
+const double THPIO4 = 2.35619449019234492885E0;
+
+/**
+ * Evaluates Cephes' ``polevl(z[i], coef, N)`` for each of the n lanes,
+ * applying one step of Horner's rule to all the lanes at a time.
+ */
+inline void polevl_lanes(double *y, const double *z, size_t n,
+                         const double *coef, int N)
+{
+  for (size_t i = 0; i < n; ++i) {
+    y[i] = coef[0];
+  }
+  for (int k = 1; k <= N; ++k) {
+    double c = coef[k];
+    for (size_t i = 0; i < n; ++i) {
+      y[i] = y[i] * z[i] + c;
+    }
+  }
+}
+
+/**
+ * Evaluates Cephes' ``p1evl(z[i], coef, N)``, where the leading
+ * coefficient is an implicit 1, for each of the n lanes.
+ */
+inline void p1evl_lanes(double *y, const double *z, size_t n,
+                        const double *coef, int N)
+{
+  for (size_t i = 0; i < n; ++i) {
+    y[i] = z[i] + coef[0];
+  }
+  for (int k = 1; k < N; ++k) {
+    double c = coef[k];
+    for (size_t i = 0; i < n; ++i) {
+      y[i] = y[i] * z[i] + c;
+    }
+  }
+}
+
+// The coefficients below are from Cephes j0.c and j1.c
+
+const double j0_PP[7] = {
+    7.96936729297347051624E-4, 8.28352392107440799803E-2,
+    1.23953371646414299388E0,  5.44725003058768775090E0,
+    8.74716500199817011941E0,  5.30324038235394892183E0,
+    9.99999999999999997821E-1};
+const double j0_PQ[7] = {
+    9.24408810558863637013E-4, 8.56288474354474431428E-2,
+    1.25352743901058953537E0,  5.47097740330417105182E0,
+    8.76190883237069594232E0,  5.30605288235394617618E0,
+    1.00000000000000000218E0};
+const double j0_QP[8] = {
+    -1.13663838898469149931E-2, -1.28252718670509318512E0,
+    -1.95539544257735972385E1,  -9.32060152123768231369E1,
+    -1.77681167980488050595E2,  -1.47077505154951170175E2,
+    -5.14105326766599330220E1,  -6.05014350600728481186E0};
+const double j0_QQ[7] = {
+    6.43178256118178023184E1, 8.56430025976980587198E2,
+    3.88240183605401609683E3, 7.24046774195652478189E3,
+    5.93072701187316984827E3, 2.06209331660327847417E3,
+    2.42005740240291393179E2};
+const double j0_YP[8] = {
+    1.55924367855235737965E4,   -1.46639295903971606143E7,
+    5.43526477051876500413E9,   -9.82136065717911466409E11,
+    8.75906394395366999549E13,  -3.46628303384729719441E15,
+    4.42733268572569800351E16,  -1.84950800436986690637E16};
+const double j0_YQ[7] = {
+    1.04128353664259848412E3,  6.26107330137134956842E5,
+    2.68919633393814121987E8,  8.64002487103935000337E10,
+    2.02979612750105546709E13, 3.17157752842975028269E15,
+    2.50596256172653059228E17};
+const double j0_RP[4] = {
+    -4.79443220978201773821E9, 1.95617491946556577543E12,
+    -2.49248344360967716204E14, 9.70862251047306323952E15};
+const double j0_RQ[8] = {
+    4.99563147152651017219E2,  1.73785401676374683123E5,
+    4.84409658339962045305E7,  1.11855537045356834862E10,
+    2.11277520115489217587E12, 3.10518229857422583814E14,
+    3.18121955943204943306E16, 1.71086294081043136091E18};
+const double j0_DR1 = 5.78318596294678452118E0;
+const double j0_DR2 = 3.04712623436620863991E1;
+
+const double j1_RP[4] = {
+    -8.99971225705559398224E8, 4.52228297998194034323E11,
+    -7.27494245221818276015E13, 3.68295732863852883286E15};
+const double j1_RQ[8] = {
+    6.20836478118054335476E2,  2.56987256757748830383E5,
+    8.35146791431949253037E7,  2.21511595479792499675E10,
+    4.74914122079991414898E12, 7.84369607876235854894E14,
+    8.95222336184627338078E16, 5.32278620332680085395E18};
+const double j1_PP[7] = {
+    7.62125616208173112003E-4, 7.31397056940917570436E-2,
+    1.12719608129684925192E0,  5.11207951146807644818E0,
+    8.42404590141772420927E0,  5.21451598682361504063E0,
+    1.00000000000000000254E0};
+const double j1_PQ[7] = {
+    5.71323128072548699714E-4, 6.88455908754495404082E-2,
+    1.10514232634061696926E0,  5.07386386128601488557E0,
+    8.39985554327604159757E0,  5.20982848682361821619E0,
+    9.99999999999999997461E-1};
+const double j1_QP[8] = {
+    5.10862594750176621635E-2, 4.98213872951233449420E0,
+    7.58238284132545283818E1,  3.66779609360150777800E2,
+    7.10856304998926107277E2,  5.97489612400613639965E2,
+    2.11688757100572135698E2,  2.52070205858023719784E1};
+const double j1_QQ[7] = {
+    7.42373277035675149943E1, 1.05644886038262816351E3,
+    4.98641058337653607651E3, 9.56231892404756170795E3,
+    7.99704160447350683650E3, 2.82619278517639096600E3,
+    3.36093607810698293419E2};
+const double j1_YP[6] = {
+    1.26320474790178026440E9,  -6.47355876379160291031E11,
+    1.14509511541823727583E14, -8.12770255501325109621E15,
+    2.02439475713594898196E17, -7.78877196265950026825E17};
+const double j1_YQ[8] = {
+    5.94301592346128195359E2,  2.35564092943068577943E5,
+    7.34811944459721705660E7,  1.87601316108706159478E10,
+    3.88231277496238566008E12, 6.20557727146953693363E14,
+    6.87141087355300489866E16, 3.97270608116560655612E18};
+const double j1_Z1 = 1.46819706421238932572E1;
+const double j1_Z2 = 4.92184563216946036703E1;
+
+/**
+ * The asymptotic form shared by the Bessel functions of order 0 and 1
+ * for x > 5, where ``phase`` is pi/4 or 3pi/4 by order.
+ */
+void bessel_far(double *y, const double *x, size_t n, const double *PP,
+                const double *PQ, const double *QP, const double *QQ,
+                double phase, bool second_kind)
+{
+  double w[block_size], z[block_size], p[block_size], q[block_size],
+      t[block_size], s[block_size], c[block_size];
+  for (size_t i = 0; i < n; ++i) {
+    w[i] = 5.0 / x[i];
+    z[i] = w[i] * w[i];
+    t[i] = x[i] - phase;
+  }
+  polevl_lanes(p, z, n, PP, 6);
+  polevl_lanes(s, z, n, PQ, 6);
+  for (size_t i = 0; i < n; ++i) {
+    p[i] /= s[i];
+  }
+  polevl_lanes(q, z, n, QP, 7);
+  p1evl_lanes(s, z, n, QQ, 7);
+  for (size_t i = 0; i < n; ++i) {
+    q[i] /= s[i];
+  }
+  kernels::vmath::sin(s, t, n);
+  kernels::vmath::cos(c, t, n);
+  if (second_kind) {
+    for (size_t i = 0; i < n; ++i) {
+      y[i] = (p[i] * s[i] + w[i] * q[i] * c[i]) * SQ2OPI / sqrt(x[i]);
+    }
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      y[i] = (p[i] * c[i] - w[i] * q[i] * s[i]) * SQ2OPI / sqrt(x[i]);
+    }
+  }
+}
+
+void j0_near(double *y, const double *x, size_t n)
+{
+  double z[block_size], r[block_size];
+  for (size_t i = 0; i < n; ++i) {
+    z[i] = x[i] * x[i];
+  }
+  polevl_lanes(y, z, n, j0_RP, 3);
+  p1evl_lanes(r, z, n, j0_RQ, 8);
+  for (size_t i = 0; i < n; ++i) {
+    double p = (z[i] - j0_DR1) * (z[i] - j0_DR2) * y[i] / r[i];
+    y[i] = fabs(x[i]) < 1.0e-5 ? 1.0 - z[i] / 4.0 : p;
+  }
+}
+
+void j1_near(double *y, const double *x, size_t n)
+{
+  double z[block_size], r[block_size];
+  for (size_t i = 0; i < n; ++i) {
+    z[i] = x[i] * x[i];
+  }
+  polevl_lanes(y, z, n, j1_RP, 3);
+  p1evl_lanes(r, z, n, j1_RQ, 8);
+  for (size_t i = 0; i < n; ++i) {
+    y[i] = y[i] / r[i] * x[i] * (z[i] - j1_Z1) * (z[i] - j1_Z2);
+  }
+}
+
+struct bessel_j0_kernel {
+  static bool is_near(double x) { return fabs(x) <= 5.0; }
+  static bool is_far(double x) { return fabs(x) > 5.0 && fabs(x) <= DBL_MAX; }
+
+  static void near(double *y, const double *x, size_t n) { j0_near(y, x, n); }
+
+  static void far(double *y, const double *x, size_t n)
+  {
+    double a[block_size];
+    for (size_t i = 0; i < n; ++i) {
+      a[i] = fabs(x[i]);
+    }
+    bessel_far(y, a, n, j0_PP, j0_PQ, j0_QP, j0_QQ, PIO4, false);
+  }
+
+  static double scalar(double x) { return cephes_j0(x); }
+};
+
+struct bessel_j1_kernel {
+  static bool is_near(double x) { return fabs(x) <= 5.0; }
+  static bool is_far(double x) { return fabs(x) > 5.0 && fabs(x) <= DBL_MAX; }
+
+  static void near(double *y, const double *x, size_t n) { j1_near(y, x, n); }
+
+  static void far(double *y, const double *x, size_t n)
+  {
+    double a[block_size];
+    for (size_t i = 0; i < n; ++i) {
+      a[i] = fabs(x[i]);
+    }
+    bessel_far(y, a, n, j1_PP, j1_PQ, j1_QP, j1_QQ, THPIO4, false);
+    for (size_t i = 0; i < n; ++i) {
+      y[i] = x[i] < 0.0 ? -y[i] : y[i];
+    }
+  }
+
+  static double scalar(double x) { return cephes_j1(x); }
+};
+
+struct bessel_y0_kernel {
+  static bool is_near(double x) { return x > 0.0 && x <= 5.0; }
+  static bool is_far(double x) { return x > 5.0 && x <= DBL_MAX; }
+
+  static void near(double *y, const double *x, size_t n)
+  {
+    double z[block_size], r[block_size], j[block_size], l[block_size];
+    for (size_t i = 0; i < n; ++i) {
+      z[i] = x[i] * x[i];
+    }
+    polevl_lanes(y, z, n, j0_YP, 7);
+    p1evl_lanes(r, z, n, j0_YQ, 7);
+    j0_near(j, x, n);
+    kernels::vmath::log(l, x, n);
+    for (size_t i = 0; i < n; ++i) {
+      y[i] = y[i] / r[i] + TWOOPI * l[i] * j[i];
+    }
+  }
+
+  static void far(double *y, const double *x, size_t n)
+  {
+    bessel_far(y, x, n, j0_PP, j0_PQ, j0_QP, j0_QQ, PIO4, true);
+  }
+
+  static double scalar(double x) { return cephes_y0(x); }
+};
+
+struct bessel_y1_kernel {
+  static bool is_near(double x) { return x > 0.0 && x <= 5.0; }
+  static bool is_far(double x) { return x > 5.0 && x <= DBL_MAX; }
+
+  static void near(double *y, const double *x, size_t n)
+  {
+    double z[block_size], r[block_size], j[block_size], l[block_size];
+    for (size_t i = 0; i < n; ++i) {
+      z[i] = x[i] * x[i];
+    }
+    polevl_lanes(y, z, n, j1_YP, 5);
+    p1evl_lanes(r, z, n, j1_YQ, 8);
+    j1_near(j, x, n);
+    kernels::vmath::log(l, x, n);
+    for (size_t i = 0; i < n; ++i) {
+      y[i] = x[i] * (y[i] / r[i]) + TWOOPI * (j[i] * l[i] - 1.0 / x[i]);
+    }
+  }
+
+  static void far(double *y, const double *x, size_t n)
+  {
+    bessel_far(y, x, n, j1_PP, j1_PQ, j1_QP, j1_QQ, THPIO4, true);
+  }
+
+  static double scalar(double x) { return cephes_y1(x); }
+};
+
+/**
+ * Evaluates kernel K over a range, one block at a time. The inputs of
+ * each block are gathered by which approximation applies to them, so
+ * that the near and far evaluations each run over contiguous lanes, and
+ * any remaining inputs go to the scalar function.
+ */
+template <typename K>
+void eval_blocks(double *dst, const double *src, size_t count)
+{
+  double x[block_size], xnear[block_size], xfar[block_size],
+      ynear[block_size], yfar[block_size];
+  size_t inear[block_size], ifar[block_size];
+  for (size_t b = 0; b < count; b += block_size) {
+    size_t n = std::min(block_size, count - b);
+    // Copy first, since dst may alias src
+    memcpy(x, src + b, n * sizeof(double));
+    double *d = dst + b;
+    size_t nnear = 0, nfar = 0;
+    for (size_t i = 0; i < n; ++i) {
+      if (K::is_near(x[i])) {
+        inear[nnear] = i;
+        xnear[nnear++] = x[i];
+      } else if (K::is_far(x[i])) {
+        ifar[nfar] = i;
+        xfar[nfar++] = x[i];
+      } else {
+        d[i] = K::scalar(x[i]);
+      }
+    }
+    K::near(ynear, xnear, nnear);
+    K::far(yfar, xfar, nfar);
+    for (size_t i = 0; i < nnear; ++i) {
+      d[inear[i]] = ynear[i];
+    }
+    for (size_t i = 0; i < nfar; ++i) {
+      d[ifar[i]] = yfar[i];
+    }
+  }
+}
+
+/**
+ * sin(x) / x or -cos(x) / x, the spherical Bessel functions of order 0.
+ */
+template <bool SecondKind>
+void sph_bessel_0_blocks(double *dst, const double *src, size_t count)
+{
+  double x[block_size], t[block_size];
+  for (size_t b = 0; b < count; b += block_size) {
+    size_t n = std::min(block_size, count - b);
+    memcpy(x, src + b, n * sizeof(double));
+    double *d = dst + b;
+    if (SecondKind) {
+      kernels::vmath::cos(t, x, n);
+      for (size_t i = 0; i < n; ++i) {
+        d[i] = -t[i] / x[i];
+      }
+    } else {
+      kernels::vmath::sin(t, x, n);
+      for (size_t i = 0; i < n; ++i) {
+        d[i] = x[i] == 0.0 ? 1.0 : t[i] / x[i];
+      }
+    }
+  }
+}
+
+template <double (*F)(double)>
+void eval_scalar(double *dst, const double *src, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = F(src[i]);
+  }
+}
+
+/**
+ * Splits a batch across threads once it is large enough, calling
+ * ``fn(begin, end)`` for disjoint ranges of the elements.
+ */
+template <typename F>
+void eval_parallel(size_t count, const F &fn)
+{
+  intptr_t nthreads = parallel::get_num_threads();
+  if (nthreads <= 1 ||
+      count < static_cast<size_t>(2 * parallel_grain_size)) {
+    fn(0, count);
+    return;
+  }
+  parallel::parallel_for(static_cast<intptr_t>(count), nthreads,
+                         parallel_grain_size,
+                         [&fn](intptr_t, intptr_t begin, intptr_t end) {
+    fn(static_cast<size_t>(begin), static_cast<size_t>(end));
+  });
+}
+
+void eval_parallel(void (*fn)(double *, const double *, size_t), double *dst,
+                   const double *src, size_t count)
+{
+  eval_parallel(count, [fn, dst, src](size_t begin, size_t end) {
+    fn(dst + begin, src + begin, end - begin);
+  });
+}
+
+/**
+ * Evaluates one of the Airy functions of dynd/special.hpp, which write
+ * ``N`` doubles per element.
+ */
+template <int N, void (*F)(double (&)[N], double)>
+void eval_airy(double *dst, const double *src, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    F(*reinterpret_cast<double (*)[N]>(dst + N * i), src[i]);
+  }
+}
+
+void airy_scalar(double (&res)[4], double x)
+{
+  cephes_airy(x, &res[0], &res[1], &res[2], &res[3]);
+}
+
+// Cephes' gamma, which the functions of an order also use for some
+// arguments, returns its sign through the global ``sgngam``, so these
+// are evaluated on the calling thread only
+template <typename T, double (*F)(T, double)>
+void eval_binary(double *dst, const T *nu, const double *x, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = F(nu[i], x[i]);
+  }
+}
+
+double gamma_scalar(double x) { return cephes_Gamma(x); }
+
+double lgamma_scalar(double x) { return cephes_lgam(x); }
+
+} // anonymous namespace
+
+void kernels::special::bessel_j0(double *dst, const double *src, size_t count)
+{
+  eval_parallel(&eval_blocks<bessel_j0_kernel>, dst, src, count);
+}
+
+void kernels::special::bessel_j1(double *dst, const double *src, size_t count)
+{
+  eval_parallel(&eval_blocks<bessel_j1_kernel>, dst, src, count);
+}
+
+void kernels::special::bessel_y0(double *dst, const double *src, size_t count)
+{
+  eval_parallel(&eval_blocks<bessel_y0_kernel>, dst, src, count);
+}
+
+void kernels::special::bessel_y1(double *dst, const double *src, size_t count)
+{
+  eval_parallel(&eval_blocks<bessel_y1_kernel>, dst, src, count);
+}
+
+void kernels::special::sph_bessel_j0(double *dst, const double *src,
+                                     size_t count)
+{
+  eval_parallel(&sph_bessel_0_blocks<false>, dst, src, count);
+}
+
+void kernels::special::sph_bessel_y0(double *dst, const double *src,
+                                     size_t count)
+{
+  eval_parallel(&sph_bessel_0_blocks<true>, dst, src, count);
+}
+
+void kernels::special::airy(double *dst, const double *src, size_t count)
+{
+  eval_parallel(count, [dst, src](size_t begin, size_t end) {
+    eval_airy<4, &airy_scalar>(dst + 4 * begin, src + begin, end - begin);
+  });
+}
+
+void kernels::special::airy_ai(double *dst, const double *src, size_t count)
+{
+  eval_parallel(count, [dst, src](size_t begin, size_t end) {
+    eval_airy<2, &dynd::airy_ai>(dst + 2 * begin, src + begin, end - begin);
+  });
+}
+
+void kernels::special::airy_bi(double *dst, const double *src, size_t count)
+{
+  eval_parallel(count, [dst, src](size_t begin, size_t end) {
+    eval_airy<2, &dynd::airy_bi>(dst + 2 * begin, src + begin, end - begin);
+  });
+}
+
+void kernels::special::gamma(double *dst, const double *src, size_t count)
+{
+  eval_scalar<&gamma_scalar>(dst, src, count);
+}
+
+void kernels::special::lgamma(double *dst, const double *src, size_t count)
+{
+  eval_scalar<&lgamma_scalar>(dst, src, count);
+}
+
+void kernels::special::bessel_j(double *dst, const double *nu,
+                                const double *x, size_t count)
+{
+  eval_binary<double, &dynd::bessel_j>(dst, nu, x, count);
+}
+
+void kernels::special::bessel_y(double *dst, const double *nu,
+                                const double *x, size_t count)
+{
+  eval_binary<double, &dynd::bessel_y>(dst, nu, x, count);
+}
+
+void kernels::special::sph_bessel_j(double *dst, const double *nu,
+                                    const double *x, size_t count)
+{
+  eval_binary<double, &dynd::sph_bessel_j>(dst, nu, x, count);
+}
+
+void kernels::special::sph_bessel_y(double *dst, const double *nu,
+                                    const double *x, size_t count)
+{
+  eval_binary<double, &dynd::sph_bessel_y>(dst, nu, x, count);
+}
+
+void kernels::special::struve_h(double *dst, const double *nu,
+                                const double *x, size_t count)
+{
+  eval_binary<double, &dynd::struve_h>(dst, nu, x, count);
+}
+
+void kernels::special::legendre_p(double *dst, const int *l, const double *x,
+                                  size_t count)
+{
+  eval_binary<int, &dynd::legendre_p>(dst, l, x, count);
+}
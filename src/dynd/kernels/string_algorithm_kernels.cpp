@@ -5,12 +5,14 @@
 
 #include <stdexcept>
 #include <sstream>
+#include <algorithm>
 
 #include <dynd/shortvector.hpp>
 #include <dynd/type.hpp>
 #include <dynd/diagnostics.hpp>
 #include <dynd/kernels/string_algorithm_kernels.hpp>
 #include <dynd/types/string_type.hpp>
+#include <dynd/exceptions.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -88,121 +90,335 @@ void kernels::string_concatenation_kernel::strided(
 }
 
 /////////////////////////////////////////////
-// String find kernel
+// Two-Way byte string search
 
-void kernels::string_find_kernel::init(const ndt::type* src_tp, const char *const*src_arrmeta)
+/**
+ * Computes the maximal suffix of x[0, m) under the byte ordering, or
+ * under its reverse if `reversed` is true. Returns the index just before
+ * the suffix starts, and its period in `out_period`.
+ */
+static intptr_t two_way_maximal_suffix(const unsigned char *x, intptr_t m,
+                                       bool reversed, intptr_t *out_period)
+{
+    intptr_t ms = -1, j = 0, k = 1, p = 1;
+    while (j + k < m) {
+        unsigned char a = x[j + k], b = x[ms + k];
+        if (reversed ? (a > b) : (a < b)) {
+            // The suffix at j + k is smaller, extend the period
+            j += k;
+            k = 1;
+            p = j - ms;
+        } else if (a == b) {
+            if (k != p) {
+                ++k;
+            } else {
+                j += p;
+                k = 1;
+            }
+        } else {
+            // A new maximal suffix candidate starts at j
+            ms = j;
+            j = ms + 1;
+            k = p = 1;
+        }
+    }
+    *out_period = p;
+    return ms;
+}
+
+void kernels::byte_string_searcher::init(const char *needle_begin,
+                                         const char *needle_end)
+{
+    m_needle.assign(needle_begin, needle_end);
+    intptr_t m = size();
+    if (m < 2) {
+        m_critical_pos = -1;
+        m_period = 1;
+        m_periodic = false;
+        return;
+    }
+
+    // The critical factorization is the later of the two maximal suffixes
+    const unsigned char *x = reinterpret_cast<const unsigned char *>(data());
+    intptr_t p, q;
+    intptr_t i = two_way_maximal_suffix(x, m, false, &p);
+    intptr_t j = two_way_maximal_suffix(x, m, true, &q);
+    if (i > j) {
+        m_critical_pos = i;
+        m_period = p;
+    } else {
+        m_critical_pos = j;
+        m_period = q;
+    }
+
+    if (m_period + m_critical_pos + 1 <= m &&
+            memcmp(x, x + m_period, m_critical_pos + 1) == 0) {
+        m_periodic = true;
+    } else {
+        m_periodic = false;
+        m_period = max(m_critical_pos + 1, m - m_critical_pos - 1) + 1;
+    }
+}
+
+const char *kernels::byte_string_searcher::find(const char *begin,
+                                                const char *end) const
+{
+    intptr_t m = size(), n = end - begin;
+    if (m == 0) {
+        return begin;
+    } else if (m > n) {
+        return NULL;
+    } else if (m == 1) {
+        return reinterpret_cast<const char *>(memchr(begin, m_needle[0], n));
+    }
+
+    const unsigned char *x = reinterpret_cast<const unsigned char *>(data());
+    const unsigned char *y = reinterpret_cast<const unsigned char *>(begin);
+    intptr_t ell = m_critical_pos, per = m_period;
+    // The right half of the needle is matched first, so its first byte is
+    // the one used to skip ahead to candidate alignments
+    unsigned char skip_byte = x[ell + 1];
+    intptr_t j = 0, memory = -1;
+    while (j <= n - m) {
+        if (memory < 0 && y[j + ell + 1] != skip_byte) {
+            const void *next =
+                memchr(y + j + ell + 1, skip_byte, n - m - j + 1);
+            if (next == NULL) {
+                return NULL;
+            }
+            j = reinterpret_cast<const unsigned char *>(next) - y - ell - 1;
+        }
+        // Match the right half of the needle
+        intptr_t i = max(ell, memory) + 1;
+        while (i < m && x[i] == y[i + j]) {
+            ++i;
+        }
+        if (i < m) {
+            j += i - ell;
+            memory = -1;
+            continue;
+        }
+        // Match the left half of the needle
+        i = ell;
+        while (i > memory && x[i] == y[i + j]) {
+            --i;
+        }
+        if (i <= memory) {
+            return begin + j;
+        }
+        j += per;
+        if (m_periodic) {
+            // The prefix of the needle shifted by its period is already known
+            // to match, so it needn't be compared again
+            memory = m - per - 1;
+        }
+    }
+    return NULL;
+}
+
+/////////////////////////////////////////////
+// String search kernel
+
+namespace dynd { namespace kernels {
+struct string_search_cache {
+    // The substring exactly as it was last supplied
+    vector<char> source;
+    // The substring in the encoding of the searched string
+    byte_string_searcher searcher;
+    // False if the substring has characters which the encoding of the
+    // searched string can't represent, in which case nothing matches
+    bool matchable;
+};
+}} // namespace dynd::kernels
+
+void kernels::string_search_kernel::init(string_search_op_t op,
+                                         const ndt::type *src_tp,
+                                         const char *const *src_arrmeta)
 {
     if (src_tp[0].get_kind() != string_kind) {
         stringstream ss;
-        ss << "Expected a string type for the string find kernel, not " << src_tp[0];
+        ss << "Expected a string type for the string search kernel, not " << src_tp[0];
         throw runtime_error(ss.str());
     }
     if (src_tp[1].get_kind() != string_kind) {
         stringstream ss;
-        ss << "Expected a string type for the string find kernel, not " << src_tp[1];
+        ss << "Expected a string type for the string search kernel, not " << src_tp[1];
         throw runtime_error(ss.str());
     }
-    m_base.destructor = &kernels::string_find_kernel::destruct;
+    m_base.destructor = &kernels::string_search_kernel::destruct;
+    m_op = op;
     m_str_type = static_cast<const base_string_type *>(ndt::type(src_tp[0]).release());
     m_str_arrmeta = src_arrmeta[0];
     m_sub_type = static_cast<const base_string_type *>(ndt::type(src_tp[1]).release());
     m_sub_arrmeta = src_arrmeta[1];
-
+    m_cache = NULL;
 }
 
-void kernels::string_find_kernel::destruct(ckernel_prefix *extra)
+void kernels::string_search_kernel::destruct(ckernel_prefix *extra)
 {
     extra_type *e = reinterpret_cast<extra_type *>(extra);
     base_type_xdecref(e->m_str_type);
     base_type_xdecref(e->m_sub_type);
+    delete e->m_cache;
 }
 
-inline void find_one_string(
-                intptr_t *d,
-                const char *str_begin, const char *str_end,
-                const char *sub_begin, const char *sub_end,
-                next_unicode_codepoint_t str_next_fn,
-                next_unicode_codepoint_t sub_next_fn)
+/**
+ * Returns the preprocessed form of the substring [sub_begin, sub_end),
+ * reusing the kernel's cached one when the substring hasn't changed.
+ */
+static const kernels::string_search_cache *
+get_search_cache(kernels::string_search_kernel *e, const char *sub_begin,
+                 const char *sub_end)
 {
-    int32_t sub_first = sub_next_fn(sub_begin, sub_end);
-    // TODO: This algorithm is slow and naive, should use fast algorithms...
-    intptr_t pos = 0;
-    while (str_begin < str_end) {
-        int32_t str_cp = str_next_fn(str_begin, str_end);
-        if (str_cp == sub_first) {
-            // If the first character matched, try the rest
-            const char *sub_match_begin = sub_begin, *str_match_begin = str_begin;
-            bool matched = true;
-            while (sub_match_begin < sub_end) {
-                if (str_match_begin == str_end) {
-                    // End of the string
-                    matched = false;
-                    break;
-                }
-                int32_t sub_cp = str_next_fn(sub_match_begin, sub_end);
-                str_cp = str_next_fn(str_match_begin, str_end);
-                if (sub_cp != str_cp) {
-                    // Mismatched character
-                    matched = false;
-                    break;
-                }
-            }
-            if (matched) {
-                *d = pos;
-                return;
+    kernels::string_search_cache *c = e->m_cache;
+    size_t size = sub_end - sub_begin;
+    if (c != NULL && c->source.size() == size &&
+            (size == 0 || memcmp(&c->source[0], sub_begin, size) == 0)) {
+        return c;
+    }
+    if (c == NULL) {
+        c = e->m_cache = new kernels::string_search_cache;
+    }
+    c->source.assign(sub_begin, sub_end);
+    c->matchable = true;
+
+    string_encoding_t str_encoding = e->m_str_type->get_encoding();
+    string_encoding_t sub_encoding = e->m_sub_type->get_encoding();
+    if (str_encoding == sub_encoding ||
+            (sub_encoding == string_encoding_ascii &&
+             (str_encoding == string_encoding_utf_8 ||
+              str_encoding == string_encoding_latin1))) {
+        // The bytes can be searched for as is
+        c->searcher.init(sub_begin, sub_end);
+    } else {
+        // Transcode the substring into the encoding of the searched string,
+        // every codepoint needs at most four bytes in any encoding
+        // TODO: Get the error mode from the evaluation context
+        next_unicode_codepoint_t next_fn =
+            get_next_unicode_codepoint_function(sub_encoding, assign_error_nocheck);
+        append_unicode_codepoint_t append_fn =
+            get_append_unicode_codepoint_function(str_encoding, assign_error_inexact);
+        size_t max_size =
+            4 * (size / string_encoding_char_size_table[sub_encoding]);
+        vector<char> buf(max_size + 1);
+        char *out = &buf[0], *out_end = &buf[0] + max_size;
+        try {
+            while (sub_begin < sub_end) {
+                append_fn(next_fn(sub_begin, sub_end), out, out_end);
             }
+        } catch (const string_encode_error &) {
+            c->matchable = false;
         }
-        ++pos;
+        c->searcher.init(&buf[0], out);
     }
+    return c;
+}
 
-    *d = -1;
+/**
+ * Returns the number of codepoints in the string [begin, end).
+ */
+static intptr_t count_codepoints(string_encoding_t encoding, const char *begin,
+                                 const char *end)
+{
+    intptr_t count = 0;
+    switch (encoding) {
+        case string_encoding_utf_8:
+            // Count every byte which isn't a continuation byte
+            for (; begin < end; ++begin) {
+                count += ((*begin & 0xc0) != 0x80);
+            }
+            return count;
+        case string_encoding_utf_16: {
+            // Count every code unit which isn't a trailing surrogate
+            const uint16_t *it = reinterpret_cast<const uint16_t *>(begin);
+            const uint16_t *it_end = reinterpret_cast<const uint16_t *>(end);
+            for (; it < it_end; ++it) {
+                count += (*it < 0xdc00 || *it > 0xdfff);
+            }
+            return count;
+        }
+        default:
+            return (end - begin) / string_encoding_char_size_table[encoding];
+    }
 }
 
-void kernels::string_find_kernel::single(
-                char *dst, char **src,
-                ckernel_prefix *extra)
+/**
+ * Finds the first match of the searcher's needle at a character boundary
+ * of a fixed-width encoding whose code units are `char_size` bytes.
+ */
+static const char *find_aligned(const kernels::byte_string_searcher &searcher,
+                                const char *begin, const char *end,
+                                intptr_t char_size)
 {
-    const extra_type *e = reinterpret_cast<const extra_type *>(extra);
-    string_encoding_t str_encoding = e->m_str_type->get_encoding();
-    string_encoding_t sub_encoding = e->m_sub_type->get_encoding();
-    // TODO: Get the error mode from the evaluation context
-    next_unicode_codepoint_t str_next_fn = get_next_unicode_codepoint_function(str_encoding, assign_error_nocheck);
-    next_unicode_codepoint_t sub_next_fn = get_next_unicode_codepoint_function(sub_encoding, assign_error_nocheck);
+    const char *it = begin;
+    for (;;) {
+        const char *match = searcher.find(it, end);
+        if (match == NULL || char_size == 1 || (match - begin) % char_size == 0) {
+            return match;
+        }
+        it = match + 1;
+    }
+}
 
-    intptr_t *d = reinterpret_cast<intptr_t *>(dst);
+static inline void search_one_string(char *dst,
+                                     kernels::string_search_kernel *e,
+                                     const char *str, const char *sub)
+{
     // Get the extents of the string and substring
     const char *str_begin, *str_end;
-    e->m_str_type->get_string_range(&str_begin, &str_end, e->m_str_arrmeta, src[0]);
+    e->m_str_type->get_string_range(&str_begin, &str_end, e->m_str_arrmeta, str);
     const char *sub_begin, *sub_end;
-    e->m_sub_type->get_string_range(&sub_begin, &sub_end, e->m_sub_arrmeta, src[1]);
-    find_one_string(d, str_begin, str_end, sub_begin, sub_end, str_next_fn, sub_next_fn);
+    e->m_sub_type->get_string_range(&sub_begin, &sub_end, e->m_sub_arrmeta, sub);
+    const kernels::string_search_cache *c = get_search_cache(e, sub_begin, sub_end);
+
+    string_encoding_t str_encoding = e->m_str_type->get_encoding();
+    const char *match = NULL;
+    bool result = false;
+    if (c->matchable) {
+        switch (e->m_op) {
+            case kernels::string_search_find:
+            case kernels::string_search_contains:
+                match = find_aligned(c->searcher, str_begin, str_end,
+                            string_encoding_char_size_table[str_encoding]);
+                result = (match != NULL);
+                break;
+            case kernels::string_search_startswith:
+                result = c->searcher.is_prefix_of(str_begin, str_end);
+                break;
+            case kernels::string_search_endswith:
+                result = c->searcher.is_suffix_of(str_begin, str_end);
+                break;
+        }
+    }
+
+    if (e->m_op == kernels::string_search_find) {
+        *reinterpret_cast<intptr_t *>(dst) =
+            result ? count_codepoints(str_encoding, str_begin, match) : -1;
+    } else {
+        *reinterpret_cast<dynd_bool *>(dst) = result;
+    }
 }
 
+void kernels::string_search_kernel::single(
+                char *dst, char **src,
+                ckernel_prefix *extra)
+{
+    extra_type *e = reinterpret_cast<extra_type *>(extra);
+    search_one_string(dst, e, src[0], src[1]);
+}
 
-void kernels::string_find_kernel::strided(
+void kernels::string_search_kernel::strided(
                 char *dst, intptr_t dst_stride,
                 char **src, const intptr_t *src_stride,
                 size_t count, ckernel_prefix *extra)
 {
-    const extra_type *e = reinterpret_cast<const extra_type *>(extra);
-    string_encoding_t str_encoding = e->m_str_type->get_encoding();
-    string_encoding_t sub_encoding = e->m_sub_type->get_encoding();
-    // TODO: Get the error mode from the evaluation context
-    next_unicode_codepoint_t str_next_fn = get_next_unicode_codepoint_function(str_encoding, assign_error_nocheck);
-    next_unicode_codepoint_t sub_next_fn = get_next_unicode_codepoint_function(sub_encoding, assign_error_nocheck);
-
+    extra_type *e = reinterpret_cast<extra_type *>(extra);
     const char *src_str = src[0], *src_sub = src[1];
+    intptr_t src_str_stride = src_stride[0], src_sub_stride = src_stride[1];
     for (size_t i = 0; i != count; ++i) {
-        intptr_t *d = reinterpret_cast<intptr_t *>(dst);
-        // Get the extents of the string and substring
-        const char *str_begin, *str_end;
-        e->m_str_type->get_string_range(&str_begin, &str_end, e->m_str_arrmeta, src_str);
-        const char *sub_begin, *sub_end;
-        e->m_sub_type->get_string_range(&sub_begin, &sub_end, e->m_sub_arrmeta, src_sub);
-        find_one_string(d, str_begin, str_end, sub_begin, sub_end, str_next_fn, sub_next_fn);
-
+        search_one_string(dst, e, src_str, src_sub);
         dst += dst_stride;
-        src_str += src_stride[0];
-        src_sub += src_stride[1];
+        src_str += src_str_stride;
+        src_sub += src_sub_stride;
     }
 }
@@ -101,6 +101,15 @@ namespace {
                 base_type_decref(e->src_string_tp);
             }
         }
+
+        static void clone(ckernel_prefix *DYND_UNUSED(dst),
+                          const ckernel_prefix *src)
+        {
+            const extra_type *e = reinterpret_cast<const extra_type *>(src);
+            if (e->src_string_tp) {
+                base_type_incref(e->src_string_tp);
+            }
+        }
     };
 } // anonymous namespace
 
@@ -443,6 +452,7 @@ size_t dynd::make_string_to_builtin_assignment_kernel(
         e->base.set_function<expr_single_t>(
             static_string_to_builtin_kernels[dst_type_id - bool_type_id]);
         e->base.destructor = &string_to_builtin_kernel_extra::destruct;
+        register_ckernel_clone<string_to_builtin_kernel_extra>();
         // The kernel data owns this reference
         e->src_string_tp = static_cast<const base_string_type *>(
             ndt::type(src_string_tp).release());
@@ -492,6 +502,15 @@ namespace {
                 base_type_decref(e->dst_string_tp);
             }
         }
+
+        static void clone(ckernel_prefix *DYND_UNUSED(dst),
+                          const ckernel_prefix *src)
+        {
+            const extra_type *e = reinterpret_cast<const extra_type *>(src);
+            if (e->dst_string_tp) {
+                base_type_incref(e->dst_string_tp);
+            }
+        }
     };
 } // anonymous namespace
 
@@ -512,6 +531,7 @@ size_t dynd::make_builtin_to_string_assignment_kernel(
             reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->alloc_ck_leaf<builtin_to_string_kernel_extra>(ckb_offset);
         e->base.set_function<expr_single_t>(builtin_to_string_kernel_extra::single);
         e->base.destructor = builtin_to_string_kernel_extra::destruct;
+        register_ckernel_clone<builtin_to_string_kernel_extra>();
         // The kernel data owns this reference
         e->dst_string_tp = static_cast<const base_string_type *>(ndt::type(dst_string_tp).release());
         e->src_type_id = src_type_id;
@@ -22,6 +22,9 @@ struct tuple_unary_op_item {
   size_t child_kernel_offset;
   size_t dst_data_offset;
   size_t src_data_offset;
+  // If nonzero, this item is a run of adjacent POD fields copied
+  // with a memcpy, and there is no child kernel
+  size_t copy_size;
 };
 
 struct tuple_unary_op_ck : public kernels::unary_ck<tuple_unary_op_ck> {
@@ -36,6 +39,11 @@ struct tuple_unary_op_ck : public kernels::unary_ck<tuple_unary_op_ck> {
 
     for (intptr_t i = 0; i < field_count; ++i) {
       const tuple_unary_op_item &item = fi[i];
+      if (item.copy_size != 0) {
+        memcpy(dst + item.dst_data_offset, src + item.src_data_offset,
+               item.copy_size);
+        continue;
+      }
       child = get_child_ckernel(item.child_kernel_offset);
       child_fn = child->get_function<expr_single_t>();
       char *child_src = src + item.src_data_offset;
@@ -43,13 +51,91 @@ struct tuple_unary_op_ck : public kernels::unary_ck<tuple_unary_op_ck> {
     }
   }
 
+  /**
+   * Loops over the fields on the outside, so each field's child
+   * kernel gets one strided call covering the whole batch.
+   */
+  inline void strided(char *dst, intptr_t dst_stride, char *src,
+                      intptr_t src_stride, size_t count)
+  {
+    const tuple_unary_op_item *fi = &m_fields[0];
+    intptr_t field_count = m_fields.size();
+    ckernel_prefix *child;
+    expr_strided_t child_fn;
+
+    for (intptr_t i = 0; i < field_count; ++i) {
+      const tuple_unary_op_item &item = fi[i];
+      char *child_dst = dst + item.dst_data_offset;
+      char *child_src = src + item.src_data_offset;
+      if (item.copy_size != 0) {
+        size_t copy_size = item.copy_size;
+        for (size_t j = 0; j != count; ++j) {
+          memcpy(child_dst, child_src, copy_size);
+          child_dst += dst_stride;
+          child_src += src_stride;
+        }
+        continue;
+      }
+      child = get_child_ckernel(item.child_kernel_offset);
+      child_fn = child->get_function<expr_strided_t>();
+      child_fn(child_dst, dst_stride, &child_src, &src_stride, count, child);
+    }
+  }
+
   inline void destruct_children()
   {
     for (size_t i = 0; i < m_fields.size(); ++i) {
-      base.destroy_child_ckernel(m_fields[i].child_kernel_offset);
+      if (m_fields[i].copy_size == 0) {
+        base.destroy_child_ckernel(m_fields[i].child_kernel_offset);
+      }
+    }
+  }
+
+  inline void clone_children(ckernel_prefix *dst) const
+  {
+    vector<intptr_t> offsets;
+    for (size_t i = 0; i < m_fields.size(); ++i) {
+      if (m_fields[i].copy_size == 0) {
+        offsets.push_back(m_fields[i].child_kernel_offset);
+      }
+    }
+    if (!offsets.empty()) {
+      base.clone_child_ckernel_array(dst, &offsets[0], offsets.size());
     }
   }
 };
+
+/**
+ * Tries to handle field i of a copy with a memcpy, either by
+ * extending the previous memcpy run or by starting a new one.
+ */
+static bool add_pod_copy_field(vector<tuple_unary_op_item> &fields,
+                               const uintptr_t *dst_offsets,
+                               const ndt::type *dst_tp,
+                               const uintptr_t *src_offsets,
+                               const ndt::type *src_tp, intptr_t i)
+{
+  if (dst_tp[i] != src_tp[i] || !dst_tp[i].is_pod()) {
+    return false;
+  }
+  size_t data_size = dst_tp[i].get_data_size();
+  if (!fields.empty()) {
+    tuple_unary_op_item &prev = fields.back();
+    if (prev.copy_size != 0 &&
+        prev.dst_data_offset + prev.copy_size == dst_offsets[i] &&
+        prev.src_data_offset + prev.copy_size == src_offsets[i]) {
+      prev.copy_size += data_size;
+      return true;
+    }
+  }
+  tuple_unary_op_item item;
+  item.child_kernel_offset = 0;
+  item.dst_data_offset = dst_offsets[i];
+  item.src_data_offset = src_offsets[i];
+  item.copy_size = data_size;
+  fields.push_back(item);
+  return true;
+}
 } // anonymous namespace
 
 intptr_t dynd::make_tuple_unary_op_ckernel(
@@ -60,19 +146,29 @@ intptr_t dynd::make_tuple_unary_op_ckernel(
     const ndt::type *src_tp, const char *const *src_arrmeta,
     kernel_request_t kernreq, const eval::eval_context *ectx)
 {
+  // Only a plain copy can turn POD fields into memcpy runs
+  bool is_copy = (af == make_copy_arrfunc().get());
   intptr_t root_ckb_offset = ckb_offset;
   tuple_unary_op_ck *self = tuple_unary_op_ck::create(ckb, kernreq, ckb_offset);
-  self->m_fields.resize(field_count);
+  self->m_fields.reserve(field_count);
   for (intptr_t i = 0; i < field_count; ++i) {
     reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->ensure_capacity(ckb_offset);
     self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->get_at<tuple_unary_op_ck>(root_ckb_offset);
-    tuple_unary_op_item &field = self->m_fields[i];
+    if (is_copy && add_pod_copy_field(self->m_fields, dst_offsets, dst_tp,
+                                      src_offsets, src_tp, i)) {
+      continue;
+    }
+    tuple_unary_op_item field;
     field.child_kernel_offset = ckb_offset - root_ckb_offset;
     field.dst_data_offset = dst_offsets[i];
     field.src_data_offset = src_offsets[i];
-    ckb_offset = af->instantiate(
-        af, af_tp, ckb, ckb_offset, dst_tp[i], dst_arrmeta[i], &src_tp[i],
-        &src_arrmeta[i], kernel_request_single, ectx, nd::array(), nd::array());
+    field.copy_size = 0;
+    self->m_fields.push_back(field);
+    ckb_offset = kernels::instantiate_ckernel(af, af_tp, ckb, ckb_offset,
+                                              dst_tp[i], dst_arrmeta[i],
+                                              &src_tp[i], &src_arrmeta[i],
+                                              kernreq, ectx, nd::array(),
+                                              nd::array());
   }
   return ckb_offset;
 }
@@ -95,9 +191,12 @@ intptr_t dynd::make_tuple_unary_op_ckernel(
     field.child_kernel_offset = ckb_offset - root_ckb_offset;
     field.dst_data_offset = dst_offsets[i];
     field.src_data_offset = src_offsets[i];
-    ckb_offset = af[i]->instantiate(
-        af[i], af_tp[i], ckb, ckb_offset, dst_tp[i], dst_arrmeta[i], &src_tp[i],
-        &src_arrmeta[i], kernel_request_single, ectx, nd::array(), nd::array());
+    field.copy_size = 0;
+    ckb_offset = kernels::instantiate_ckernel(af[i], af_tp[i], ckb, ckb_offset,
+                                              dst_tp[i], dst_arrmeta[i],
+                                              &src_tp[i], &src_arrmeta[i],
+                                              kernreq, ectx, nd::array(),
+                                              nd::array());
   }
   return ckb_offset;
 }
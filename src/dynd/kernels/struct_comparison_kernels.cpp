@@ -5,10 +5,12 @@
 
 #include <stdexcept>
 #include <sstream>
+#include <vector>
 
 #include <dynd/type.hpp>
 #include <dynd/diagnostics.hpp>
 #include <dynd/kernels/struct_comparison_kernels.hpp>
+#include <dynd/kernels/expr_kernels.hpp>
 #include <dynd/types/base_struct_type.hpp>
 
 using namespace std;
@@ -188,6 +190,130 @@ namespace {
             }
         }
     };
+
+    struct struct_compare_mask_item {
+        size_t src0_data_offset, src1_data_offset;
+        // Mask kernel for src0.field_i <op> src1.field_i
+        size_t child_kernel_offset;
+        // For sorting_less, mask kernel for src1.field_i < src0.field_i
+        size_t reverse_child_kernel_offset;
+    };
+
+    // Bool mask comparison, working one field at a time over a chunk
+    struct struct_compare_mask_ck
+        : public kernels::expr_ck<struct_compare_mask_ck, kernel_request_host, 2> {
+        comparison_type_t m_comptype;
+        vector<struct_compare_mask_item> m_fields;
+
+        inline void single(char *dst, char **src)
+        {
+            intptr_t src_stride[2] = {0, 0};
+            strided(dst, 0, src, src_stride, 1);
+        }
+
+        inline void strided(char *dst, intptr_t dst_stride, char **src,
+                            const intptr_t *src_stride, size_t count)
+        {
+            char result[DYND_BUFFER_CHUNK_SIZE];
+            char *src_chunk[2] = {src[0], src[1]};
+            while (count > 0) {
+                size_t chunk_size = min(count, (size_t)DYND_BUFFER_CHUNK_SIZE);
+                compare_chunk(result, src_chunk, src_stride, chunk_size);
+                for (size_t i = 0; i != chunk_size; ++i) {
+                    *dst = result[i];
+                    dst += dst_stride;
+                }
+                src_chunk[0] += chunk_size * src_stride[0];
+                src_chunk[1] += chunk_size * src_stride[1];
+                count -= chunk_size;
+            }
+        }
+
+        void compare_chunk(char *result, char *const *src,
+                           const intptr_t *src_stride, size_t count)
+        {
+            char field_result[DYND_BUFFER_CHUNK_SIZE];
+            char reverse_result[DYND_BUFFER_CHUNK_SIZE];
+            char undecided[DYND_BUFFER_CHUNK_SIZE];
+            intptr_t reverse_stride[2] = {src_stride[1], src_stride[0]};
+            size_t field_count = m_fields.size();
+            if (m_comptype == comparison_type_sorting_less) {
+                // Lexicographic: the first field which differs decides
+                memset(result, 0, count);
+                memset(undecided, 1, count);
+                for (size_t i = 0; i != field_count; ++i) {
+                    const struct_compare_mask_item &item = m_fields[i];
+                    char *child_src[2] = {src[0] + item.src0_data_offset,
+                                          src[1] + item.src1_data_offset};
+                    call_child(item.child_kernel_offset, field_result,
+                               child_src, src_stride, count);
+                    swap(child_src[0], child_src[1]);
+                    call_child(item.reverse_child_kernel_offset,
+                               reverse_result, child_src, reverse_stride,
+                               count);
+                    char any_undecided = 0;
+                    for (size_t j = 0; j != count; ++j) {
+                        result[j] |= undecided[j] & field_result[j];
+                        undecided[j] &= !(field_result[j] | reverse_result[j]);
+                        any_undecided |= undecided[j];
+                    }
+                    if (!any_undecided) {
+                        break;
+                    }
+                }
+            } else {
+                // equal is the AND of the fields, not_equal the OR
+                char identity = (m_comptype == comparison_type_equal);
+                memset(result, identity, count);
+                for (size_t i = 0; i != field_count; ++i) {
+                    const struct_compare_mask_item &item = m_fields[i];
+                    char *child_src[2] = {src[0] + item.src0_data_offset,
+                                          src[1] + item.src1_data_offset};
+                    call_child(item.child_kernel_offset, field_result,
+                               child_src, src_stride, count);
+                    char any_undecided = 0;
+                    for (size_t j = 0; j != count; ++j) {
+                        result[j] = identity ? (result[j] & field_result[j])
+                                             : (result[j] | field_result[j]);
+                        any_undecided |= (result[j] == identity);
+                    }
+                    if (!any_undecided) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        inline void call_child(size_t child_offset, char *dst, char **src,
+                               const intptr_t *src_stride, size_t count)
+        {
+            ckernel_prefix *child = get_child_ckernel(child_offset);
+            expr_strided_t child_fn = child->get_function<expr_strided_t>();
+            child_fn(dst, 1, src, src_stride, count, child);
+        }
+
+        inline void destruct_children()
+        {
+            for (size_t i = 0; i < m_fields.size(); ++i) {
+                base.destroy_child_ckernel(m_fields[i].child_kernel_offset);
+                base.destroy_child_ckernel(
+                    m_fields[i].reverse_child_kernel_offset);
+            }
+        }
+
+        inline void clone_children(ckernel_prefix *dst) const
+        {
+            vector<intptr_t> offsets;
+            for (size_t i = 0; i < m_fields.size(); ++i) {
+                offsets.push_back(m_fields[i].child_kernel_offset);
+                offsets.push_back(m_fields[i].reverse_child_kernel_offset);
+            }
+            if (!offsets.empty()) {
+                base.clone_child_ckernel_array(dst, &offsets[0],
+                                               offsets.size());
+            }
+        }
+    };
 } // anonymous namespace
 
 size_t dynd::make_struct_comparison_kernel(
@@ -334,3 +460,53 @@ size_t dynd::make_general_struct_comparison_kernel(
 {
     throw runtime_error("TODO: make_general_struct_comparison_kernel is not implemented");
 }
+
+size_t dynd::make_struct_comparison_mask_kernel(
+                void *ckb, intptr_t ckb_offset,
+                const ndt::type& src_tp,
+                const char *src0_arrmeta, const char *src1_arrmeta,
+                comparison_type_t comptype, kernel_request_t kernreq,
+                const eval::eval_context *ectx)
+{
+  if (comptype != comparison_type_sorting_less &&
+      comptype != comparison_type_equal &&
+      comptype != comparison_type_not_equal) {
+    throw not_comparable_error(src_tp, src_tp, comptype);
+  }
+  intptr_t root_ckb_offset = ckb_offset;
+  const base_struct_type *bsd = src_tp.extended<base_struct_type>();
+  size_t field_count = bsd->get_field_count();
+  const uintptr_t *src0_data_offsets = bsd->get_data_offsets(src0_arrmeta);
+  const uintptr_t *src1_data_offsets = bsd->get_data_offsets(src1_arrmeta);
+  const uintptr_t *arrmeta_offsets = bsd->get_arrmeta_offsets_raw();
+  struct_compare_mask_ck *self =
+      struct_compare_mask_ck::create(ckb, kernreq, ckb_offset);
+  self->m_comptype = comptype;
+  self->m_fields.resize(field_count);
+  for (size_t i = 0; i != field_count; ++i) {
+    const ndt::type &ft = bsd->get_field_type(i);
+    const char *field0_arrmeta = src0_arrmeta + arrmeta_offsets[i];
+    const char *field1_arrmeta = src1_arrmeta + arrmeta_offsets[i];
+    // Have to re-get the pointer because creating the field
+    // comparison kernels may move the memory
+    reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->ensure_capacity(ckb_offset);
+    self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->get_at<struct_compare_mask_ck>(root_ckb_offset);
+    struct_compare_mask_item *item = &self->m_fields[i];
+    item->src0_data_offset = src0_data_offsets[i];
+    item->src1_data_offset = src1_data_offsets[i];
+    item->child_kernel_offset = ckb_offset - root_ckb_offset;
+    ckb_offset = make_comparison_mask_kernel(
+        ckb, ckb_offset, ft, field0_arrmeta, ft, field1_arrmeta, comptype,
+        kernel_request_strided, ectx);
+    if (comptype == comparison_type_sorting_less) {
+      reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->ensure_capacity(ckb_offset);
+      self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->get_at<struct_compare_mask_ck>(root_ckb_offset);
+      item = &self->m_fields[i];
+      item->reverse_child_kernel_offset = ckb_offset - root_ckb_offset;
+      ckb_offset = make_comparison_mask_kernel(
+          ckb, ckb_offset, ft, field1_arrmeta, ft, field0_arrmeta,
+          comparison_type_sorting_less, kernel_request_strided, ectx);
+    }
+  }
+  return ckb_offset;
+}
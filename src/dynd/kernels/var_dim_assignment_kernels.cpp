@@ -67,6 +67,11 @@ namespace {
         {
             get_child_ckernel()->destroy();
         }
+
+        inline void clone_children(ckernel_prefix *dst) const
+        {
+            base.clone_child_ckernels(dst, sizeof(self_type));
+        }
     };
 } // anonymous namespace
 
@@ -166,6 +171,11 @@ namespace {
         {
             get_child_ckernel()->destroy();
         }
+
+        inline void clone_children(ckernel_prefix *dst) const
+        {
+            base.clone_child_ckernels(dst, sizeof(self_type));
+        }
     };
 } // anonymous namespace
 
@@ -267,6 +277,11 @@ namespace {
         {
             base.destroy_child_ckernel(sizeof(self_type));
         }
+
+        inline void clone_children(ckernel_prefix *dst) const
+        {
+            base.clone_child_ckernels(dst, sizeof(self_type));
+        }
     };
 } // anonymous namespace
 
@@ -336,6 +351,11 @@ namespace {
         {
             get_child_ckernel()->destroy();
         }
+
+        inline void clone_children(ckernel_prefix *dst) const
+        {
+            base.clone_child_ckernels(dst, sizeof(self_type));
+        }
     };
 } // anonymous namespace
 
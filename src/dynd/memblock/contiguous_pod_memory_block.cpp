@@ -0,0 +1,99 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstdlib>
+#include <stdexcept>
+
+#include <dynd/memblock/contiguous_pod_memory_block.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace dynd { namespace detail {
+
+void free_contiguous_pod_memory_block(memory_block_data *memblock)
+{
+    contiguous_pod_memory_block *emb = reinterpret_cast<contiguous_pod_memory_block *>(memblock);
+    free(emb->m_data);
+    delete emb;
+}
+
+}} // namespace dynd::detail
+
+static void reserve(contiguous_pod_memory_block *emb, intptr_t capacity_bytes)
+{
+    if (capacity_bytes > emb->m_capacity) {
+        // Grow geometrically so appending is amortized constant time
+        intptr_t new_capacity = max(capacity_bytes, 2 * emb->m_capacity);
+        char *data = reinterpret_cast<char *>(realloc(emb->m_data, new_capacity));
+        if (data == NULL) {
+            throw bad_alloc();
+        }
+        emb->m_data = data;
+        emb->m_capacity = new_capacity;
+    }
+}
+
+memory_block_ptr dynd::make_contiguous_pod_memory_block(intptr_t initial_capacity_bytes)
+{
+    contiguous_pod_memory_block *emb = new contiguous_pod_memory_block();
+    memory_block_ptr result(reinterpret_cast<memory_block_data *>(emb), false);
+    if (initial_capacity_bytes > 0) {
+        reserve(emb, initial_capacity_bytes);
+    }
+    return result;
+}
+
+intptr_t dynd::contiguous_pod_memory_block_allocate(memory_block_data *self,
+                                                    intptr_t size_bytes,
+                                                    intptr_t alignment)
+{
+    contiguous_pod_memory_block *emb = reinterpret_cast<contiguous_pod_memory_block *>(self);
+    intptr_t offset = (emb->m_size + alignment - 1) & ~(alignment - 1);
+    reserve(emb, offset + size_bytes);
+    emb->m_size = offset + size_bytes;
+    return offset;
+}
+
+void dynd::contiguous_pod_memory_block_resize(memory_block_data *self,
+                                              intptr_t offset, intptr_t size_bytes)
+{
+    contiguous_pod_memory_block *emb = reinterpret_cast<contiguous_pod_memory_block *>(self);
+    if (offset > emb->m_size) {
+        throw runtime_error("contiguous_pod_memory_block_resize: offset is past the end of the buffer");
+    }
+    reserve(emb, offset + size_bytes);
+    emb->m_size = offset + size_bytes;
+}
+
+void dynd::contiguous_pod_memory_block_reset(memory_block_data *self)
+{
+    reinterpret_cast<contiguous_pod_memory_block *>(self)->m_size = 0;
+}
+
+void dynd::contiguous_pod_memory_block_finalize(memory_block_data *self)
+{
+    contiguous_pod_memory_block *emb = reinterpret_cast<contiguous_pod_memory_block *>(self);
+    if (emb->m_size == 0) {
+        free(emb->m_data);
+        emb->m_data = NULL;
+        emb->m_capacity = 0;
+    } else if (emb->m_size < emb->m_capacity) {
+        char *data = reinterpret_cast<char *>(realloc(emb->m_data, emb->m_size));
+        if (data != NULL) {
+            emb->m_data = data;
+            emb->m_capacity = emb->m_size;
+        }
+    }
+}
+
+void dynd::contiguous_pod_memory_block_debug_print(const memory_block_data *memblock,
+                std::ostream& o, const std::string& indent)
+{
+    const contiguous_pod_memory_block *emb = reinterpret_cast<const contiguous_pod_memory_block *>(memblock);
+    o << indent << " data: " << (const void *)emb->m_data << "\n";
+    o << indent << " size: " << emb->m_size << "\n";
+    o << indent << " capacity: " << emb->m_capacity << "\n";
+}
@@ -11,6 +11,7 @@
 #include <dynd/memblock/array_memory_block.hpp>
 #include <dynd/memblock/external_memory_block.hpp>
 #include <dynd/memblock/memmap_memory_block.hpp>
+#include <dynd/memblock/contiguous_pod_memory_block.hpp>
 
 #include <dynd/array.hpp>
 
@@ -59,6 +60,11 @@ void free_objectarray_memory_block(memory_block_data *memblock);
  * This should only be called by the memory_block decref code.
  */
 void free_memmap_memory_block(memory_block_data *memblock);
+/**
+ * INTERNAL: Frees a memory_block created by make_contiguous_pod_memory_block.
+ * This should only be called by the memory_block decref code.
+ */
+void free_contiguous_pod_memory_block(memory_block_data *memblock);
 
 
 /**
@@ -110,6 +116,9 @@ void dynd::detail::memory_block_free(memory_block_data *memblock)
         case memmap_memory_block_type:
             free_memmap_memory_block(memblock);
             return;
+        case contiguous_pod_memory_block_type:
+            free_contiguous_pod_memory_block(memblock);
+            return;
     }
 
     stringstream ss;
@@ -144,6 +153,9 @@ std::ostream& dynd::operator<<(std::ostream& o, memory_block_type_t mbt)
         case memmap_memory_block_type:
             o << "memmap";
             break;
+        case contiguous_pod_memory_block_type:
+            o << "contiguous_pod";
+            break;
         default:
             o << "unknown memory_block_type(" << (int)mbt << ")";
     }
@@ -181,6 +193,9 @@ void dynd::memory_block_debug_print(const memory_block_data *memblock, std::ostr
             case memmap_memory_block_type:
                 memmap_memory_block_debug_print(memblock, o, indent);
                 break;
+            case contiguous_pod_memory_block_type:
+                contiguous_pod_memory_block_debug_print(memblock, o, indent);
+                break;
         }
         o << indent << "------" << endl;
     } else {
@@ -205,6 +220,8 @@ memory_block_pod_allocator_api *dynd::get_memory_block_pod_allocator_api(memory_
             throw runtime_error("Cannot get a POD allocator API from an executable_memory_block");
         case memmap_memory_block_type:
             throw runtime_error("Cannot get a POD allocator API from a memmap_memory_block");
+        case contiguous_pod_memory_block_type:
+            throw runtime_error("Cannot get a POD allocator API from a contiguous_pod_memory_block");
         default:
             throw runtime_error("unknown memory block type");
     }
@@ -228,6 +245,8 @@ memory_block_objectarray_allocator_api *dynd::get_memory_block_objectarray_alloc
             throw runtime_error("Cannot get an objectarray allocator API from an executable_memory_block");
         case memmap_memory_block_type:
             throw runtime_error("Cannot get an objectarray allocator API from a memmap_memory_block");
+        case contiguous_pod_memory_block_type:
+            throw runtime_error("Cannot get an objectarray allocator API from a contiguous_pod_memory_block");
         default:
             throw runtime_error("unknown memory block type");
     }
@@ -3,6 +3,7 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <sstream>
 #include <stdexcept>
 #include <vector>
 #include <cstdlib>
@@ -22,6 +23,8 @@ namespace {
         vector<char *> m_memory_handles;
         /** The current malloc'd memory being doled out */
         char *m_memory_begin, *m_memory_current, *m_memory_end;
+        /** Other memory blocks the data may point into */
+        vector<memory_block_data *> m_blockrefs;
 
         /**
          * Allocates some new memory from which to dole out
@@ -53,6 +56,9 @@ namespace {
             for (size_t i = 0, i_end = m_memory_handles.size(); i != i_end; ++i) {
                 free(m_memory_handles[i]);
             }
+            for (size_t i = 0, i_end = m_blockrefs.size(); i != i_end; ++i) {
+                memory_block_decref(m_blockrefs[i]);
+            }
         }
     };
 } // anonymous namespace
@@ -63,6 +69,24 @@ memory_block_ptr dynd::make_pod_memory_block(intptr_t initial_capacity_bytes)
     return memory_block_ptr(reinterpret_cast<memory_block_data *>(pmb), false);
 }
 
+void dynd::pod_memory_block_add_blockref(memory_block_data *self,
+                                         memory_block_data *ref)
+{
+    if (self->m_type != pod_memory_block_type) {
+        stringstream ss;
+        ss << "cannot add a blockref to a " << (memory_block_type_t)self->m_type
+           << " memory block, it must be a pod memory block";
+        throw runtime_error(ss.str());
+    }
+    pod_memory_block *emb = reinterpret_cast<pod_memory_block *>(self);
+    if (ref == self || find(emb->m_blockrefs.begin(), emb->m_blockrefs.end(),
+                            ref) != emb->m_blockrefs.end()) {
+        return;
+    }
+    emb->m_blockrefs.push_back(ref);
+    memory_block_incref(ref);
+}
+
 namespace dynd { namespace detail {
 
 void free_pod_memory_block(memory_block_data *memblock)
@@ -177,5 +201,8 @@ void dynd::pod_memory_block_debug_print(const memory_block_data *memblock, std::
         o << indent << " allocated: " << emb->m_total_allocated_capacity << "\n";
     } else {
         o << indent << " finalized: " << emb->m_total_allocated_capacity << "\n";
-    } 
+    }
+    for (size_t i = 0, i_end = emb->m_blockrefs.size(); i != i_end; ++i) {
+        memory_block_debug_print(emb->m_blockrefs[i], o, indent + " ");
+    }
 }
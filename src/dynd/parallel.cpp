@@ -0,0 +1,97 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstdlib>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <dynd/parallel.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static intptr_t default_num_threads()
+{
+  const char *env = getenv("DYND_NUM_THREADS");
+  if (env != NULL) {
+    intptr_t nthreads = atoi(env);
+    return nthreads > 0 ? nthreads : 1;
+  }
+  intptr_t nthreads = thread::hardware_concurrency();
+  return nthreads > 0 ? nthreads : 1;
+}
+
+static intptr_t num_threads = default_num_threads();
+
+intptr_t parallel::get_num_threads() { return num_threads; }
+
+void parallel::set_num_threads(intptr_t nthreads)
+{
+  num_threads = nthreads > 0 ? nthreads : 1;
+}
+
+intptr_t parallel::get_partition_count(intptr_t size, intptr_t nthreads,
+                                       intptr_t grain_size)
+{
+  if (grain_size < 1) {
+    grain_size = 1;
+  }
+  intptr_t npartitions = size / grain_size;
+  if (npartitions > nthreads) {
+    npartitions = nthreads;
+  }
+  return npartitions > 1 ? npartitions : 1;
+}
+
+intptr_t parallel::parallel_for(
+    intptr_t size, intptr_t nthreads, intptr_t grain_size,
+    const std::function<void(intptr_t, intptr_t, intptr_t)> &fn)
+{
+  intptr_t npartitions = get_partition_count(size, nthreads, grain_size);
+  if (npartitions == 1) {
+    fn(0, 0, size);
+    return 1;
+  }
+
+  vector<exception_ptr> errors(npartitions);
+  vector<thread> threads;
+  threads.reserve(npartitions - 1);
+  for (intptr_t i = 1; i < npartitions; ++i) {
+    intptr_t begin = size * i / npartitions, end = size * (i + 1) / npartitions;
+    auto run = [&fn, &errors, i, begin, end]() {
+      try {
+        fn(i, begin, end);
+      }
+      catch (...) {
+        errors[i] = current_exception();
+      }
+    };
+    try {
+      threads.push_back(thread(run));
+    }
+    catch (const system_error &) {
+      // If no more threads can be started, do the work here
+      run();
+    }
+  }
+  try {
+    fn(0, 0, size / npartitions);
+  }
+  catch (...) {
+    errors[0] = current_exception();
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+  for (intptr_t i = 0; i < npartitions; ++i) {
+    if (errors[i]) {
+      rethrow_exception(errors[i]);
+    }
+  }
+
+  return npartitions;
+}
@@ -0,0 +1,149 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <stdexcept>
+#include <sstream>
+
+#include <dynd/property_handle.hpp>
+#include <dynd/types/property_type.hpp>
+#include <dynd/types/builtin_type_properties.hpp>
+
+using namespace std;
+using namespace dynd;
+
+nd::property_handle ndt::type::resolve_property(
+    const std::string &property_name) const
+{
+    return nd::property_handle(*this, property_name);
+}
+
+nd::property_handle::property_handle(const ndt::type &tp,
+                                     const std::string &name)
+    : m_tp(tp), m_name(name), m_callable(NULL), m_probed(false),
+      m_ck_errmode(assign_error_default)
+{
+    const std::pair<std::string, gfunc::callable> *properties = NULL;
+    size_t count = 0;
+    if (!tp.is_null()) {
+        if (!tp.is_builtin()) {
+            tp.extended()->get_dynamic_array_properties(&properties, &count);
+        } else {
+            get_builtin_type_dynamic_array_properties(tp.get_type_id(),
+                                                      &properties, &count);
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (properties[i].first == name) {
+            m_callable = &properties[i].second;
+            return;
+        }
+    }
+
+    stringstream ss;
+    ss << "dynd type " << tp << " does not have array property " << name;
+    throw runtime_error(ss.str());
+}
+
+void nd::property_handle::check_type(const nd::array &n) const
+{
+    if (n.is_null() || n.get_type() != m_tp) {
+        stringstream ss;
+        ss << "property handle for " << m_name << " was resolved for type "
+           << m_tp << ", it cannot be applied to an array of type "
+           << (n.is_null() ? ndt::type() : n.get_type());
+        throw runtime_error(ss.str());
+    }
+}
+
+nd::array nd::property_handle::operator()(const nd::array &n) const
+{
+    check_type(n);
+    if (!m_view_dtype.is_null()) {
+        return n.replace_dtype(m_view_dtype, 0);
+    }
+    nd::array result = m_callable->call(n);
+    if (!m_probed) {
+        // Element-wise properties view the data through a property_type
+        // of the dtype, which can then be applied directly
+        m_probed = true;
+        ndt::type result_dtype = result.get_dtype();
+        if (result_dtype.get_type_id() == property_type_id &&
+                result.get_ndim() == n.get_ndim() &&
+                result.get_readonly_originptr() ==
+                    n.get_readonly_originptr()) {
+            const property_type *pd = result_dtype.extended<property_type>();
+            if (!pd->is_reversed_property() &&
+                    pd->get_operand_type() == n.get_dtype()) {
+                m_view_dtype = result_dtype;
+            }
+        }
+    }
+    return result;
+}
+
+void nd::property_handle::getter(char *dst, const size_stride_t *dst_ss,
+                                 char *src, const size_stride_t *src_ss,
+                                 intptr_t ndim) const
+{
+    if (ndim == 0) {
+        (*m_ck)(dst, 0, src, 0, 1);
+    } else if (ndim == 1) {
+        (*m_ck)(dst, dst_ss[0].stride, src, src_ss[0].stride,
+                dst_ss[0].dim_size);
+    } else {
+        for (intptr_t i = 0; i < dst_ss[0].dim_size; ++i) {
+            getter(dst + i * dst_ss[0].stride, dst_ss + 1,
+                   src + i * src_ss[0].stride, src_ss + 1, ndim - 1);
+        }
+    }
+}
+
+nd::array nd::property_handle::eval(const nd::array &n,
+                                    const eval::eval_context *ectx) const
+{
+    nd::array view = (*this)(n);
+    if (m_view_dtype.is_null()) {
+        return view.eval(ectx);
+    }
+
+    // The getter ckernel can only be reused when it doesn't depend on
+    // the arrmeta of a particular array
+    const property_type *pd = m_view_dtype.extended<property_type>();
+    const ndt::type &src_dt = pd->get_operand_type();
+    const ndt::type &dst_dt = pd->get_value_type();
+    if (src_dt.is_builtin() || src_dt.get_kind() == expr_kind ||
+            src_dt.get_arrmeta_size() != 0 ||
+            dst_dt.get_arrmeta_size() != 0) {
+        return view.eval(ectx);
+    }
+    intptr_t ndim = n.get_ndim();
+    const size_stride_t *src_ss = NULL, *dst_ss = NULL;
+    ndt::type el_tp;
+    const char *el_arrmeta = NULL;
+    if (ndim > 0 && !n.get_type().get_as_strided(n.get_arrmeta(), ndim,
+                                                 &src_ss, &el_tp,
+                                                 &el_arrmeta)) {
+        return view.eval(ectx);
+    }
+    nd::array result = nd::empty_like(n, dst_dt);
+    if (ndim > 0 && !result.get_type().get_as_strided(result.get_arrmeta(),
+                                                      ndim, &dst_ss, &el_tp,
+                                                      &el_arrmeta)) {
+        return view.eval(ectx);
+    }
+
+    if (!m_ck || m_ck_errmode != ectx->errmode) {
+        std::shared_ptr<assignment_strided_ckernel_builder> ck(
+            new assignment_strided_ckernel_builder);
+        src_dt.extended()->make_elwise_property_getter_kernel(
+            ck.get(), 0, NULL, NULL, pd->get_property_index(),
+            kernel_request_strided, ectx);
+        m_ck = ck;
+        m_ck_errmode = ectx->errmode;
+    }
+    getter(result.get_readwrite_originptr(), dst_ss,
+           const_cast<char *>(n.get_readonly_originptr()), src_ss, ndim);
+    return result;
+}
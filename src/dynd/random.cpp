@@ -3,72 +3,108 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <atomic>
+
 #include <dynd/random.hpp>
+#include <dynd/func/random_arrfunc.hpp>
 
 using namespace std;
 using namespace dynd;
 
-// Currently using c stdlib rand(), which is known to
-// be a terrible thing to do, this function needs to
-// be replaced before it's reasonable for serious
-// applications
-inline void bad_quality_random(float *out)
-{
-  *out = ::rand() / ((float)RAND_MAX);
-}
+static const uint32_t philox_m0 = 0xD2511F53u, philox_m1 = 0xCD9E8D57u;
+static const uint32_t philox_w0 = 0x9E3779B9u, philox_w1 = 0xBB67AE85u;
 
-inline void bad_quality_random(double *out)
+/**
+ * The ten Philox rounds on one block, written on scalars so a loop
+ * over independent blocks can be vectorized.
+ */
+static inline void philox_rounds(uint32_t &c0, uint32_t &c1, uint32_t &c2,
+                                 uint32_t &c3, uint32_t k0, uint32_t k1)
 {
-  *out = ::rand() / ((double)RAND_MAX);
+  for (int round = 0; round < 10; ++round) {
+    if (round > 0) {
+      k0 += philox_w0;
+      k1 += philox_w1;
+    }
+    uint64_t p0 = (uint64_t)philox_m0 * c0;
+    uint64_t p1 = (uint64_t)philox_m1 * c2;
+    uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+    uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+    c1 = (uint32_t)p1;
+    c3 = (uint32_t)p0;
+    c0 = n0;
+    c2 = n2;
+  }
 }
 
-inline void bad_quality_random(dynd_complex<float> *out)
+void dynd::philox4x32_10(const uint32_t *ctr, const uint32_t *key,
+                         uint32_t *out)
 {
-  *out = dynd_complex<float>(::rand() / ((float)RAND_MAX),
-                             ::rand() / ((float)RAND_MAX));
+  uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+  philox_rounds(c0, c1, c2, c3, key[0], key[1]);
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
 }
 
-inline void bad_quality_random(dynd_complex<double> *out)
+void dynd::philox_fill_words(uint64_t seed, uint64_t stream,
+                             uint64_t first_word, size_t count, uint32_t *out)
 {
-  *out = dynd_complex<double>(::rand() / ((double)RAND_MAX),
-                              ::rand() / ((double)RAND_MAX));
-}
+  uint32_t key[2] = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+  uint32_t ctr[4] = {0, 0, (uint32_t)stream, (uint32_t)(stream >> 32)};
+  uint64_t block = first_word / 4;
+  uint32_t words[4];
 
-template<class T>
-static void fill_random(const nd::array &a, intptr_t count)
-{
-  T *v = reinterpret_cast<T *>(a.get_readwrite_originptr());
-  for (intptr_t i = 0; i < count; ++i) {
-    bad_quality_random(&v[i]);
+  // Leading partial block
+  size_t lane = (size_t)(first_word % 4);
+  if (lane != 0 && count > 0) {
+    ctr[0] = (uint32_t)block;
+    ctr[1] = (uint32_t)(block >> 32);
+    philox4x32_10(ctr, key, words);
+    for (; lane < 4 && count > 0; ++lane, --count) {
+      *out++ = words[lane];
+    }
+    ++block;
   }
-}
-
-nd::array nd::rand(const ndt::type &tp) {
-  intptr_t strided_ndim = tp.get_strided_ndim();
-  ndt::type dtp = tp.get_type_at_dimension(NULL, strided_ndim);
 
-  nd::array res = nd::empty(tp);
+  // Full blocks, each independent of the others
+  size_t nblocks = count / 4;
+  for (size_t i = 0; i < nblocks; ++i) {
+    uint64_t b = block + i;
+    uint32_t c0 = (uint32_t)b, c1 = (uint32_t)(b >> 32);
+    uint32_t c2 = ctr[2], c3 = ctr[3];
+    philox_rounds(c0, c1, c2, c3, key[0], key[1]);
+    out[4 * i] = c0;
+    out[4 * i + 1] = c1;
+    out[4 * i + 2] = c2;
+    out[4 * i + 3] = c3;
+  }
+  out += 4 * nblocks;
+  block += nblocks;
+  count -= 4 * nblocks;
 
-  // Get the total number of elements to fill in randomly
-  intptr_t total_size = 1;
-  const size_stride_t *arrmeta =
-      reinterpret_cast<const size_stride_t *>(res.get_arrmeta());
-  for (intptr_t i = 0; i < strided_ndim; ++i) {
-    total_size *= arrmeta[i].dim_size;
+  // Trailing partial block
+  if (count > 0) {
+    ctr[0] = (uint32_t)block;
+    ctr[1] = (uint32_t)(block >> 32);
+    philox4x32_10(ctr, key, words);
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = words[i];
+    }
   }
+}
 
+nd::array nd::rand(const ndt::type &tp)
+{
+  // Each call draws from the next stream, so repeated calls differ
+  static atomic<uint64_t> next_stream(0);
+  ndt::type dtp = tp.get_dtype();
   switch (dtp.get_type_id()) {
   case float32_type_id:
-    fill_random<float>(res, total_size);
-    break;
   case float64_type_id:
-    fill_random<double>(res, total_size);
-    break;
   case complex_float32_type_id:
-    fill_random<dynd_complex<float> >(res, total_size);
-    break;
   case complex_float64_type_id:
-    fill_random<dynd_complex<double> >(res, total_size);
     break;
   default: {
     stringstream ss;
@@ -77,5 +113,7 @@ nd::array nd::rand(const ndt::type &tp) {
   }
   }
 
+  nd::array res = nd::empty(tp);
+  make_uniform_arrfunc(0x64796e64u, next_stream++, 0.0, 1.0).call_out(res);
   return res;
 }
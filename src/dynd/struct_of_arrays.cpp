@@ -0,0 +1,213 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
+#include <vector>
+
+#include <dynd/struct_of_arrays.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/types/base_struct_type.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+// How many bytes of records to transpose at a time, chosen so a block
+// of rows and its slices of the columns stay in cache together
+static const intptr_t transpose_block_bytes = 32768;
+
+ndt::type ndt::make_struct_of_arrays(intptr_t dim_size,
+                                     const ndt::type &struct_tp)
+{
+  if (struct_tp.get_kind() != struct_kind) {
+    stringstream ss;
+    ss << "make_struct_of_arrays: provided type " << struct_tp
+       << " is not of struct kind";
+    throw type_error(ss.str());
+  }
+  const base_struct_type *bsd = struct_tp.extended<base_struct_type>();
+  intptr_t field_count = bsd->get_field_count();
+  nd::array field_types = nd::empty(field_count, ndt::make_type());
+  for (intptr_t i = 0; i != field_count; ++i) {
+    unchecked_fixed_dim_get_rw<ndt::type>(field_types, i) =
+        ndt::make_fixed_dim(dim_size, bsd->get_field_type(i));
+  }
+  return ndt::make_struct(bsd->get_field_names(), field_types);
+}
+
+bool ndt::is_struct_of_arrays(const ndt::type &tp)
+{
+  if (tp.get_kind() != struct_kind) {
+    return false;
+  }
+  const base_struct_type *bsd = tp.extended<base_struct_type>();
+  intptr_t field_count = bsd->get_field_count();
+  if (field_count == 0) {
+    return false;
+  }
+  intptr_t dim_size = -1;
+  for (intptr_t i = 0; i != field_count; ++i) {
+    const ndt::type &ft = bsd->get_field_type(i);
+    if (ft.get_type_id() != fixed_dim_type_id) {
+      return false;
+    }
+    intptr_t field_dim_size = ft.extended<fixed_dim_type>()->get_fixed_dim_size();
+    if (i == 0) {
+      dim_size = field_dim_size;
+    } else if (field_dim_size != dim_size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace {
+/**
+ * The per-field data of one side of a transposition: where the
+ * field's first value is, the stride between values, and the
+ * arrmeta of the field's element type.
+ */
+struct transpose_field {
+  char *data;
+  intptr_t stride;
+  const char *arrmeta;
+};
+} // anonymous namespace
+
+/**
+ * Copies 'dim_size' values of each field from 'src' to 'dst', in blocks
+ * of 'block_size' rows. Within a block each field gets one strided call,
+ * so the row side of the copy is read or written once per block while it
+ * is still in cache.
+ */
+static void blocked_field_transpose(intptr_t dim_size, intptr_t block_size,
+                                    const base_struct_type *bsd,
+                                    const vector<transpose_field> &dst,
+                                    const vector<transpose_field> &src,
+                                    const eval::eval_context *ectx)
+{
+  intptr_t field_count = bsd->get_field_count();
+  vector<assignment_strided_ckernel_builder> k(field_count);
+  for (intptr_t i = 0; i != field_count; ++i) {
+    const ndt::type &ft = bsd->get_field_type(i);
+    make_assignment_kernel(&k[i], 0, ft, dst[i].arrmeta, ft, src[i].arrmeta,
+                           kernel_request_strided, ectx);
+  }
+
+  for (intptr_t begin = 0; begin < dim_size; begin += block_size) {
+    intptr_t count = min(block_size, dim_size - begin);
+    for (intptr_t i = 0; i != field_count; ++i) {
+      k[i](dst[i].data + begin * dst[i].stride, dst[i].stride,
+           src[i].data + begin * src[i].stride, src[i].stride, count);
+    }
+  }
+}
+
+nd::array nd::to_struct_of_arrays(const nd::array &a,
+                                  const eval::eval_context *ectx)
+{
+  intptr_t dim_size, stride;
+  ndt::type el_tp;
+  const char *el_arrmeta;
+  if (!a.get_type().get_as_strided(a.get_arrmeta(), &dim_size, &stride,
+                                   &el_tp, &el_arrmeta) ||
+      el_tp.get_kind() != struct_kind) {
+    stringstream ss;
+    ss << "to_struct_of_arrays: expected a one-dimensional array of "
+          "structs, not " << a.get_type();
+    throw type_error(ss.str());
+  }
+
+  nd::array result = nd::empty(ndt::make_struct_of_arrays(dim_size, el_tp));
+  const base_struct_type *src_bsd = el_tp.extended<base_struct_type>();
+  const base_struct_type *dst_bsd =
+      result.get_type().extended<base_struct_type>();
+  intptr_t field_count = src_bsd->get_field_count();
+  const uintptr_t *src_offsets = src_bsd->get_data_offsets(el_arrmeta);
+  const uintptr_t *src_arrmeta_offsets = src_bsd->get_arrmeta_offsets_raw();
+  const uintptr_t *dst_offsets =
+      dst_bsd->get_data_offsets(result.get_arrmeta());
+  const uintptr_t *dst_arrmeta_offsets = dst_bsd->get_arrmeta_offsets_raw();
+
+  vector<transpose_field> dst(field_count), src(field_count);
+  for (intptr_t i = 0; i != field_count; ++i) {
+    src[i].data =
+        const_cast<char *>(a.get_readonly_originptr()) + src_offsets[i];
+    src[i].stride = stride;
+    src[i].arrmeta = el_arrmeta + src_arrmeta_offsets[i];
+    const fixed_dim_type_arrmeta *md =
+        reinterpret_cast<const fixed_dim_type_arrmeta *>(
+            result.get_arrmeta() + dst_arrmeta_offsets[i]);
+    dst[i].data = result.get_readwrite_originptr() + dst_offsets[i];
+    dst[i].stride = md->stride;
+    dst[i].arrmeta = reinterpret_cast<const char *>(md + 1);
+  }
+
+  intptr_t row_size = max<intptr_t>(stride < 0 ? -stride : stride, 1);
+  blocked_field_transpose(dim_size,
+                          max<intptr_t>(transpose_block_bytes / row_size, 16),
+                          src_bsd, dst, src, ectx);
+  return result;
+}
+
+nd::array nd::to_array_of_structs(const nd::array &a,
+                                  const eval::eval_context *ectx)
+{
+  if (!ndt::is_struct_of_arrays(a.get_type())) {
+    stringstream ss;
+    ss << "to_array_of_structs: expected a struct whose fields are all "
+          "arrays of the same size, not " << a.get_type();
+    throw type_error(ss.str());
+  }
+
+  const base_struct_type *src_bsd = a.get_type().extended<base_struct_type>();
+  intptr_t field_count = src_bsd->get_field_count();
+  intptr_t dim_size = src_bsd->get_field_type(0)
+                          .extended<fixed_dim_type>()
+                          ->get_fixed_dim_size();
+  nd::array field_types = nd::empty(field_count, ndt::make_type());
+  for (intptr_t i = 0; i != field_count; ++i) {
+    unchecked_fixed_dim_get_rw<ndt::type>(field_types, i) =
+        src_bsd->get_field_type(i)
+            .extended<fixed_dim_type>()
+            ->get_element_type();
+  }
+  ndt::type el_tp = ndt::make_struct(src_bsd->get_field_names(), field_types);
+
+  nd::array result = nd::empty(dim_size, el_tp);
+  intptr_t stride;
+  ndt::type result_el_tp;
+  const char *el_arrmeta;
+  result.get_type().get_as_strided(result.get_arrmeta(), &dim_size, &stride,
+                                   &result_el_tp, &el_arrmeta);
+  const base_struct_type *dst_bsd = el_tp.extended<base_struct_type>();
+  const uintptr_t *dst_offsets = dst_bsd->get_data_offsets(el_arrmeta);
+  const uintptr_t *dst_arrmeta_offsets = dst_bsd->get_arrmeta_offsets_raw();
+  const uintptr_t *src_offsets = src_bsd->get_data_offsets(a.get_arrmeta());
+  const uintptr_t *src_arrmeta_offsets = src_bsd->get_arrmeta_offsets_raw();
+
+  vector<transpose_field> dst(field_count), src(field_count);
+  for (intptr_t i = 0; i != field_count; ++i) {
+    const fixed_dim_type_arrmeta *md =
+        reinterpret_cast<const fixed_dim_type_arrmeta *>(
+            a.get_arrmeta() + src_arrmeta_offsets[i]);
+    src[i].data =
+        const_cast<char *>(a.get_readonly_originptr()) + src_offsets[i];
+    src[i].stride = md->stride;
+    src[i].arrmeta = reinterpret_cast<const char *>(md + 1);
+    dst[i].data = result.get_readwrite_originptr() + dst_offsets[i];
+    dst[i].stride = stride;
+    dst[i].arrmeta = el_arrmeta + dst_arrmeta_offsets[i];
+  }
+
+  blocked_field_transpose(dim_size,
+                          max<intptr_t>(transpose_block_bytes /
+                                            max<intptr_t>(stride, 1), 16),
+                          dst_bsd, dst, src, ectx);
+  return result;
+}
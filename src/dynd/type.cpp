@@ -75,13 +75,14 @@ const ndt::type ndt::static_builtin_types[builtin_type_id_count] = {
 ndt::type::type(const std::string& rep)
     : m_extended(NULL)
 {
-    type_from_datashape(rep).swap(*this);
+    type_from_datashape_cached(rep.data(), rep.data() + rep.size())
+        .swap(*this);
 }
 
 ndt::type::type(const char *rep_begin, const char *rep_end)
     : m_extended(NULL)
 {
-    type_from_datashape(rep_begin, rep_end).swap(*this);
+    type_from_datashape_cached(rep_begin, rep_end).swap(*this);
 }
 
 
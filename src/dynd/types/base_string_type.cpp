@@ -50,21 +50,21 @@ void base_string_type::get_dynamic_type_properties(const std::pair<std::string,
 namespace {
     // TODO: The representation of deferred operations needs work,
     //       this way is too verbose and boilerplatey
-    class string_find_kernel_generator : public expr_kernel_generator {
+    class string_search_kernel_generator : public expr_kernel_generator {
         ndt::type m_rdt, m_op1dt, m_op2dt;
-        expr_operation_pair m_op_pair;
+        kernels::string_search_op_t m_search_op;
         const char *m_name;
 
-        typedef kernels::string_find_kernel extra_type;
+        typedef kernels::string_search_kernel extra_type;
     public:
-        string_find_kernel_generator(const ndt::type& rdt, const ndt::type& op1dt, const ndt::type& op2dt,
-                        const expr_operation_pair& op_pair, const char *name)
+        string_search_kernel_generator(const ndt::type& rdt, const ndt::type& op1dt, const ndt::type& op2dt,
+                        kernels::string_search_op_t search_op, const char *name)
             : expr_kernel_generator(true), m_rdt(rdt), m_op1dt(op1dt), m_op2dt(op2dt),
-                            m_op_pair(op_pair), m_name(name)
+                            m_search_op(search_op), m_name(name)
         {
         }
 
-        virtual ~string_find_kernel_generator() {
+        virtual ~string_search_kernel_generator() {
         }
 
         size_t make_expr_kernel(
@@ -97,10 +97,10 @@ namespace {
                     ->alloc_ck_leaf<extra_type>(ckb_offset);
             switch (kernreq) {
                 case kernel_request_single:
-                    e->base().set_function(m_op_pair.single);
+                    e->base().set_function(&extra_type::single);
                     break;
                 case kernel_request_strided:
-                    e->base().set_function(m_op_pair.strided);
+                    e->base().set_function(&extra_type::strided);
                     break;
                 default: {
                     stringstream ss;
@@ -108,7 +108,7 @@ namespace {
                     throw runtime_error(ss.str());
                 }
             }
-            e->init(src_tp, src_arrmeta);
+            e->init(m_search_op, src_tp, src_arrmeta);
             return ckb_offset;
         }
 
@@ -120,7 +120,9 @@ namespace {
     };
 } // anonymous namespace
 
-static nd::array array_function_find(const nd::array& self, const nd::array& sub)
+static nd::array make_string_search(const nd::array& self, const nd::array& sub,
+                                    kernels::string_search_op_t search_op,
+                                    const char *name)
 {
     nd::array ops[2] = {self, sub};
 
@@ -139,24 +141,43 @@ static nd::array array_function_find(const nd::array& self, const nd::array& sub
     }
 
     // Assemble the destination value type
-    ndt::type rdt = ndt::make_type<intptr_t>();
+    ndt::type rdt = (search_op == kernels::string_search_find)
+                        ? ndt::make_type<intptr_t>()
+                        : ndt::make_type<dynd_bool>();
     ndt::type result_vdt = ndt::make_type(ndim, result_shape.get(), rdt);
 
     // Create the result
     nd::array result = combine_into_tuple(2, ops);
-    expr_operation_pair expr_ops;
-    expr_ops.single = &kernels::string_find_kernel::single;
-    expr_ops.strided = &kernels::string_find_kernel::strided;
     // Because the expr type's operand is the result's type,
     // we can swap it in as the type
     ndt::type edt = ndt::make_expr(result_vdt,
                     result.get_type(),
-                    new string_find_kernel_generator(rdt, ops[0].get_dtype().value_type(),
-                                    ops[1].get_dtype().value_type(), expr_ops, "string.find"));
+                    new string_search_kernel_generator(rdt, ops[0].get_dtype().value_type(),
+                                    ops[1].get_dtype().value_type(), search_op, name));
     edt.swap(result.get_ndo()->m_type);
     return result;
 }
 
+static nd::array array_function_find(const nd::array& self, const nd::array& sub)
+{
+    return make_string_search(self, sub, kernels::string_search_find, "string.find");
+}
+
+static nd::array array_function_contains(const nd::array& self, const nd::array& sub)
+{
+    return make_string_search(self, sub, kernels::string_search_contains, "string.contains");
+}
+
+static nd::array array_function_startswith(const nd::array& self, const nd::array& prefix)
+{
+    return make_string_search(self, prefix, kernels::string_search_startswith, "string.startswith");
+}
+
+static nd::array array_function_endswith(const nd::array& self, const nd::array& suffix)
+{
+    return make_string_search(self, suffix, kernels::string_search_endswith, "string.endswith");
+}
+
 static size_t base_string_array_functions_size;
 static pair<string, gfunc::callable> *base_string_array_functions;
 void base_string_type::get_dynamic_array_functions(
@@ -175,11 +196,19 @@ void init::base_string_type_init()
   base_string_type_properties[0] = pair<string, gfunc::callable>(
       "encoding", gfunc::make_callable(&get_extended_string_encoding, "self"));
 
-  base_string_array_functions_size = 1;
+  base_string_array_functions_size = 4;
   base_string_array_functions =
       new pair<string, gfunc::callable>[base_string_array_functions_size];
   base_string_array_functions[0] = pair<string, gfunc::callable>(
       "find", gfunc::make_callable(&array_function_find, "self", "sub"));
+  base_string_array_functions[1] = pair<string, gfunc::callable>(
+      "contains", gfunc::make_callable(&array_function_contains, "self", "sub"));
+  base_string_array_functions[2] = pair<string, gfunc::callable>(
+      "startswith",
+      gfunc::make_callable(&array_function_startswith, "self", "prefix"));
+  base_string_array_functions[3] = pair<string, gfunc::callable>(
+      "endswith",
+      gfunc::make_callable(&array_function_endswith, "self", "suffix"));
 }
 
 void init::base_string_type_cleanup()
@@ -261,6 +261,11 @@ struct struct_property_getter_ck
     {
         get_child_ckernel()->destroy();
     }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        base.clone_child_ckernels(dst, sizeof(self_type));
+    }
 };
 } // anonymous namespace
 
@@ -129,6 +129,7 @@ static void format_string_datashape(std::ostream &o, const ndt::type &tp)
   switch (tp.get_type_id()) {
   case string_type_id:
   case fixedstring_type_id:
+  case offset_string_type_id:
     // data shape only has one kind of string
     o << "string";
     break;
@@ -5,6 +5,9 @@
 
 #include <map>
 #include <set>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 #include <dynd/types/datashape_parser.hpp>
 #include <dynd/parser_util.hpp>
@@ -18,6 +21,7 @@
 #include <dynd/types/tuple_type.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/types/fixedstring_type.hpp>
+#include <dynd/types/offset_string_type.hpp>
 #include <dynd/types/json_type.hpp>
 #include <dynd/types/date_type.hpp>
 #include <dynd/types/time_type.hpp>
@@ -71,6 +75,86 @@ static ndt::type parse_datashape(const char *&begin, const char *end, map<string
 
 static const map<string, ndt::type> *builtin_types;
 
+namespace {
+    /**
+     * An LRU cache from datashape strings to their parsed types.
+     */
+    class datashape_cache {
+        typedef list<pair<string, ndt::type> > lru_list;
+
+        mutex m_mutex;
+        // Most recently used entries are at the front
+        lru_list m_lru;
+        unordered_map<string, lru_list::iterator> m_index;
+        size_t m_capacity, m_hits, m_misses, m_evictions;
+
+        // Must be called with m_mutex held
+        void shrink_to(size_t size) {
+            while (m_lru.size() > size) {
+                m_index.erase(m_lru.back().first);
+                m_lru.pop_back();
+                ++m_evictions;
+            }
+        }
+    public:
+        explicit datashape_cache(size_t capacity)
+            : m_capacity(capacity), m_hits(0), m_misses(0), m_evictions(0)
+        {
+        }
+
+        ndt::type lookup(const char *begin, const char *end) {
+            string key(begin, end);
+            {
+                lock_guard<mutex> lock(m_mutex);
+                unordered_map<string, lru_list::iterator>::iterator it =
+                    m_index.find(key);
+                if (it != m_index.end()) {
+                    ++m_hits;
+                    m_lru.splice(m_lru.begin(), m_lru, it->second);
+                    return it->second->second;
+                }
+                ++m_misses;
+            }
+            // Parse without holding the lock, another thread may race
+            // to insert the same key, in which case its entry is kept
+            ndt::type tp = type_from_datashape(begin, end);
+            lock_guard<mutex> lock(m_mutex);
+            if (m_capacity > 0 && m_index.find(key) == m_index.end()) {
+                m_lru.push_front(make_pair(key, tp));
+                m_index[key] = m_lru.begin();
+                shrink_to(m_capacity);
+            }
+            return tp;
+        }
+
+        datashape_cache_stats get_stats() {
+            lock_guard<mutex> lock(m_mutex);
+            datashape_cache_stats result;
+            result.hits = m_hits;
+            result.misses = m_misses;
+            result.evictions = m_evictions;
+            result.size = m_lru.size();
+            result.capacity = m_capacity;
+            return result;
+        }
+
+        void set_capacity(size_t capacity) {
+            lock_guard<mutex> lock(m_mutex);
+            m_capacity = capacity;
+            shrink_to(m_capacity);
+        }
+
+        void clear() {
+            lock_guard<mutex> lock(m_mutex);
+            m_lru.clear();
+            m_index.clear();
+            m_hits = m_misses = m_evictions = 0;
+        }
+    };
+} // anonymous namespace
+
+static datashape_cache *parse_cache;
+
 void init::datashape_parser_init()
 {
   // Fill in the types in a stack-allocated map
@@ -110,10 +194,13 @@ void init::datashape_parser_init()
   map<string, ndt::type> *bit_ptr = new map<string, ndt::type>();
   bit_ptr->swap(bit);
   builtin_types = bit_ptr;
+  parse_cache = new datashape_cache(256);
 }
 
 void init::datashape_parser_cleanup()
 {
+  delete parse_cache;
+  parse_cache = NULL;
   delete builtin_types;
   builtin_types=NULL;
 }
@@ -462,6 +549,43 @@ static ndt::type parse_string_parameters(const char *&rbegin, const char *end)
     }
 }
 
+// offset_string_type : offset_string |
+//                      offset_string['encoding'] |
+//                      offset_string[OFFSET_TYPE] |
+//                      offset_string['encoding', OFFSET_TYPE]
+// This is called after 'offset_string' is already matched
+static ndt::type parse_offset_string_parameters(const char *&rbegin, const char *end,
+                                                map<string, ndt::type> &symtable)
+{
+    const char *begin = rbegin;
+    if (parse_token_ds(begin, end, '[')) {
+        const char *saved_begin = begin;
+        string encoding_str;
+        string_encoding_t encoding = string_encoding_utf_8;
+        ndt::type offset_tp = ndt::make_type<int32_t>();
+        bool has_offset_tp = true;
+        if (parse_quoted_string(begin, end, encoding_str)) {
+            encoding = string_to_encoding(saved_begin, encoding_str);
+            has_offset_tp = parse_token_ds(begin, end, ',');
+        }
+        if (has_offset_tp) {
+            saved_begin = begin;
+            offset_tp = parse_datashape(begin, end, symtable);
+            if (offset_tp.get_type_id() != int32_type_id &&
+                    offset_tp.get_type_id() != int64_type_id) {
+                throw datashape_parse_error(saved_begin, "expected int32 or int64 offsets");
+            }
+        }
+        if (!parse_token_ds(begin, end, ']')) {
+            throw datashape_parse_error(begin, "expected closing ']'");
+        }
+        rbegin = begin;
+        return ndt::make_offset_string(encoding, offset_tp.get_type_id());
+    } else {
+        return ndt::make_offset_string();
+    }
+}
+
 // char_type : char | char[encoding]
 // This is called after 'char' is already matched
 static ndt::type parse_char_parameters(const char *&rbegin, const char *end)
@@ -1060,6 +1184,8 @@ static ndt::type parse_datashape_nooption(const char *&rbegin, const char *end,
             }
         } else if (parse::compare_range_to_literal(nbegin, nend, "string")) {
             result = parse_string_parameters(begin, end);
+        } else if (parse::compare_range_to_literal(nbegin, nend, "offset_string")) {
+            result = parse_offset_string_parameters(begin, end, symtable);
         } else if (parse::compare_range_to_literal(nbegin, nend, "complex")) {
             result = parse_complex_parameters(begin, end, symtable);
         } else if (parse::compare_range_to_literal(nbegin, nend, "datetime")) {
@@ -1299,3 +1425,34 @@ ndt::type dynd::type_from_datashape(const char *datashape_begin, const char *dat
     }
 }
 
+ndt::type dynd::type_from_datashape_cached(const char *datashape_begin,
+                                           const char *datashape_end)
+{
+    if (parse_cache == NULL) {
+        return type_from_datashape(datashape_begin, datashape_end);
+    }
+    return parse_cache->lookup(datashape_begin, datashape_end);
+}
+
+datashape_cache_stats dynd::get_datashape_cache_stats()
+{
+    if (parse_cache == NULL) {
+        datashape_cache_stats result = {0, 0, 0, 0, 0};
+        return result;
+    }
+    return parse_cache->get_stats();
+}
+
+void dynd::set_datashape_cache_capacity(size_t capacity)
+{
+    if (parse_cache != NULL) {
+        parse_cache->set_capacity(capacity);
+    }
+}
+
+void dynd::clear_datashape_cache()
+{
+    if (parse_cache != NULL) {
+        parse_cache->clear();
+    }
+}
@@ -85,7 +85,10 @@ uint16_t dynd::float_to_halfbits(float value, assign_error_mode errmode)
             throw runtime_error(ss.str());
 #endif
         }
-        f_sig >>= (113 - f_exp);
+        // Shift into place, keeping any bits shifted out as a sticky bit so
+        // the rounding below doesn't mistake them for an exact tie
+        f_sig = (f_sig >> (113 - f_exp)) |
+                ((f_sig&(((uint32_t)1 << (113 - f_exp)) - 1)) != 0);
         // Handle rounding by adding 1 to the bit beyond dynd_float16 precision
 #if DYND_FLOAT16_ROUND_TIES_TO_EVEN
         // If the last bit in the float16 significand is 0 (already even), and
@@ -202,7 +205,10 @@ uint16_t dynd::double_to_halfbits(double value, assign_error_mode errmode)
             throw runtime_error(ss.str());
 #endif
         }
-        d_sig >>= (1009 - d_exp);
+        // Shift into place, keeping any bits shifted out as a sticky bit so
+        // the rounding below doesn't mistake them for an exact tie
+        d_sig = (d_sig >> (1009 - d_exp)) |
+                ((d_sig&(((uint64_t)1 << (1009 - d_exp)) - 1)) != 0);
         // Handle rounding by adding 1 to the bit beyond dynd_float16 precision
 #if DYND_FLOAT16_ROUND_TIES_TO_EVEN
         // If the last bit in the dynd_float16 significand is 0 (already even), and
@@ -327,6 +333,213 @@ double dynd::halfbits_to_double(uint16_t h)
     }
 }
 
+// Branch-free scalar conversions used by the bulk conversion functions.
+// The float16 subnormal cases are rounded by the FPU, by adding (or
+// subtracting) a magic number whose ulp is the float16 subnormal ulp, and
+// the three result classes are computed unconditionally and then selected.
+
+static inline uint16_t float_to_halfbits_fast(float value)
+{
+    union { float f; uint32_t u; } conv, denorm;
+    conv.f = value;
+    uint32_t sign = conv.u&0x80000000u;
+    uint32_t u = conv.u ^ sign;
+
+    // Subnormal or zero result, 0.5f has an ulp of 2^-24
+    denorm.u = u;
+    denorm.f += 0.5f;
+    uint32_t h_denorm = denorm.u - 0x3f000000u;
+    // Normal result, rebias the exponent and round to nearest even
+    uint32_t h_norm = (u + 0xc8000fffu + ((u >> 13)&1u)) >> 13;
+    // Inf or quiet NaN
+    uint32_t h_inf = (u > 0x7f800000u) ? (0x7e00u | ((u >> 13)&0x03ffu))
+                                        : 0x7c00u;
+
+    uint32_t h = (u < 0x38800000u) ? h_denorm
+                    : ((u < 0x47800000u) ? h_norm : h_inf);
+    return (uint16_t)(h | (sign >> 16));
+}
+
+static inline uint16_t double_to_halfbits_fast(double value)
+{
+    union { double d; uint64_t u; } conv, denorm;
+    conv.d = value;
+    uint64_t sign = conv.u&0x8000000000000000ULL;
+    uint64_t u = conv.u ^ sign;
+
+    // Subnormal or zero result, 2^28 has an ulp of 2^-24
+    denorm.u = u;
+    denorm.d += 268435456.0;
+    uint64_t h_denorm = denorm.u - 0x41b0000000000000ULL;
+    // Normal result, rebias the exponent and round to nearest even
+    uint64_t h_norm = (u + 0xc10001ffffffffffULL + ((u >> 42)&1u)) >> 42;
+    // Inf or quiet NaN
+    uint64_t h_inf = (u > 0x7ff0000000000000ULL)
+                        ? (0x7e00u | ((u >> 42)&0x03ffu)) : 0x7c00u;
+
+    uint64_t h = (u < 0x3f10000000000000ULL) ? h_denorm
+                    : ((u < 0x40f0000000000000ULL) ? h_norm : h_inf);
+    return (uint16_t)(h | (sign >> 48));
+}
+
+static inline float halfbits_to_float_fast(uint16_t h)
+{
+    union { float f; uint32_t u; } conv, denorm;
+    uint32_t h_exp = h&0x7c00u;
+    uint32_t mag = ((uint32_t)(h&0x7fffu)) << 13;
+
+    // Subnormal or zero input, 2^-14 has an ulp of 2^-24
+    denorm.u = mag + 0x38800000u;
+    denorm.f -= 6.103515625e-05f;
+    // Normal input, just rebias the exponent
+    uint32_t f_norm = mag + 0x38000000u;
+    // Inf or NaN, all-ones exponent and a quietened copy of the significand
+    uint32_t f_inf = (mag + 0x70000000u) |
+                     ((uint32_t)((mag&0x007fffffu) != 0) << 22);
+
+    conv.u = (h_exp == 0) ? denorm.u
+                : ((h_exp == 0x7c00u) ? f_inf : f_norm);
+    conv.u |= ((uint32_t)(h&0x8000u)) << 16;
+    return conv.f;
+}
+
+#if !defined(__CUDACC__) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define DYND_FLOAT16_USE_F16C
+
+#include <immintrin.h>
+
+static bool cpu_has_f16c()
+{
+    static const bool result = __builtin_cpu_supports("avx") &&
+                               __builtin_cpu_supports("f16c");
+    return result;
+}
+
+__attribute__((target("avx,f16c")))
+static void float_to_halfbits_f16c(uint16_t *dst, const float *src,
+                                   size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 f = _mm256_loadu_ps(src + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                         _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+    }
+    for (; i < count; ++i) {
+        dst[i] = float_to_halfbits_fast(src[i]);
+    }
+}
+
+__attribute__((target("avx,f16c")))
+static void halfbits_to_float_f16c(float *dst, const uint16_t *src,
+                                   size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+    for (; i < count; ++i) {
+        dst[i] = halfbits_to_float_fast(src[i]);
+    }
+}
+
+__attribute__((target("avx,f16c")))
+static void halfbits_to_double_f16c(double *dst, const uint16_t *src,
+                                    size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m256 f = _mm256_cvtph_ps(h);
+        _mm256_storeu_pd(dst + i, _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+        _mm256_storeu_pd(dst + i + 4,
+                         _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+    }
+    for (; i < count; ++i) {
+        dst[i] = halfbits_to_float_fast(src[i]);
+    }
+}
+#endif
+
+// Only results which are zero, subnormal, the smallest normal (reached by
+// rounding up a subnormal), or inf/NaN can have raised an error, so those
+// get redone with the checked conversion to throw the usual exception.
+template <class T, uint16_t (*checked)(T, assign_error_mode)>
+static void check_halfbits_array(const uint16_t *dst, const T *src,
+                                 size_t count, assign_error_mode errmode)
+{
+    for (size_t i = 0; i != count; ++i) {
+        uint16_t h = dst[i]&0x7fffu;
+        if (h <= 0x0400u || h >= 0x7c00u) {
+            checked(src[i], errmode);
+        }
+    }
+}
+
+void dynd::float_to_halfbits_array(uint16_t *dst, const float *src,
+                                   size_t count, assign_error_mode errmode)
+{
+#ifdef DYND_FLOAT16_USE_F16C
+    if (cpu_has_f16c()) {
+        float_to_halfbits_f16c(dst, src, count);
+    } else
+#endif
+    {
+        for (size_t i = 0; i != count; ++i) {
+            dst[i] = float_to_halfbits_fast(src[i]);
+        }
+    }
+    if (errmode != assign_error_nocheck) {
+        check_halfbits_array<float, &float_to_halfbits>(dst, src, count,
+                                                        errmode);
+    }
+}
+
+void dynd::double_to_halfbits_array(uint16_t *dst, const double *src,
+                                    size_t count, assign_error_mode errmode)
+{
+    // F16C only converts from float32, and going through float32 would round
+    // twice, so this always uses the scalar loop
+    for (size_t i = 0; i != count; ++i) {
+        dst[i] = double_to_halfbits_fast(src[i]);
+    }
+    if (errmode != assign_error_nocheck) {
+        check_halfbits_array<double, &double_to_halfbits>(dst, src, count,
+                                                          errmode);
+    }
+}
+
+void dynd::halfbits_to_float_array(float *dst, const uint16_t *src,
+                                   size_t count)
+{
+#ifdef DYND_FLOAT16_USE_F16C
+    if (cpu_has_f16c()) {
+        halfbits_to_float_f16c(dst, src, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i != count; ++i) {
+        dst[i] = halfbits_to_float_fast(src[i]);
+    }
+}
+
+void dynd::halfbits_to_double_array(double *dst, const uint16_t *src,
+                                    size_t count)
+{
+#ifdef DYND_FLOAT16_USE_F16C
+    if (cpu_has_f16c()) {
+        halfbits_to_double_f16c(dst, src, count);
+        return;
+    }
+#endif
+    // float32 holds every float16 value exactly
+    for (size_t i = 0; i != count; ++i) {
+        dst[i] = halfbits_to_float_fast(src[i]);
+    }
+}
+
 dynd::dynd_float16::dynd_float16(const dynd_int128& value)
 {
     m_bits = double_to_halfbits((double)value, assign_error_nocheck);
@@ -236,6 +236,11 @@ struct string_to_json_ck
         // Destroy the child ckernel
         get_child_ckernel()->destroy();
     }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        base.clone_child_ckernels(dst, sizeof(self_type));
+    }
 };
 } // anonymous namespace
 
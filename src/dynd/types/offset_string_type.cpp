@@ -0,0 +1,776 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+
+#include <dynd/types/offset_string_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/string_assignment_kernels.hpp>
+#include <dynd/kernels/string_comparison_kernels.hpp>
+#include <dynd/kernels/string_numeric_assignment_kernels.hpp>
+#include <dynd/iter/string_iter.hpp>
+#include <dynd/exceptions.hpp>
+
+using namespace std;
+using namespace dynd;
+
+offset_string_type::offset_string_type(string_encoding_t encoding,
+                                       type_id_t offset_type_id)
+    : base_string_type(offset_string_type_id,
+                    offset_type_id == int64_type_id ? 2 * sizeof(int64_t) : 2 * sizeof(int32_t),
+                    offset_type_id == int64_type_id ? sizeof(int64_t) : sizeof(int32_t),
+                    type_flag_scalar|type_flag_zeroinit|type_flag_blockref,
+                    sizeof(offset_string_type_arrmeta)),
+            m_encoding(encoding), m_offset_type_id(offset_type_id)
+{
+    switch (encoding) {
+        case string_encoding_ascii:
+        case string_encoding_ucs_2:
+        case string_encoding_utf_8:
+        case string_encoding_utf_16:
+        case string_encoding_utf_32:
+            break;
+        default:
+            throw runtime_error("Unrecognized string encoding in offset_string type constructor");
+    }
+    if (offset_type_id != int32_type_id && offset_type_id != int64_type_id) {
+        stringstream ss;
+        ss << "The offsets of an offset_string must be int32 or int64, not "
+           << ndt::type(offset_type_id);
+        throw type_error(ss.str());
+    }
+}
+
+offset_string_type::~offset_string_type()
+{
+}
+
+void offset_string_type::set_offsets(char *data, intptr_t begin, intptr_t end) const
+{
+    if (m_offset_type_id == int32_type_id) {
+        if (end > numeric_limits<int32_t>::max()) {
+            stringstream ss;
+            ss << "The character buffer of " << ndt::type(this, true)
+               << " has outgrown its int32 offsets, use int64 offsets instead";
+            throw overflow_error(ss.str());
+        }
+        offset_string_type_data<int32_t> *d =
+            reinterpret_cast<offset_string_type_data<int32_t> *>(data);
+        d->begin = static_cast<int32_t>(begin);
+        d->end = static_cast<int32_t>(end);
+    } else {
+        offset_string_type_data<int64_t> *d =
+            reinterpret_cast<offset_string_type_data<int64_t> *>(data);
+        d->begin = begin;
+        d->end = end;
+    }
+}
+
+void offset_string_type::get_string_range(const char **out_begin, const char**out_end,
+                const char *arrmeta, const char *data) const
+{
+    const offset_string_type_arrmeta *md =
+        reinterpret_cast<const offset_string_type_arrmeta *>(arrmeta);
+    intptr_t begin, end;
+    get_offsets(data, &begin, &end);
+    if (begin < 0 || md->blockref == NULL) {
+        // A missing value, or a default value with no buffer
+        *out_begin = NULL;
+        *out_end = NULL;
+    } else {
+        const char *base = get_contiguous_pod_memory_block_data(md->blockref);
+        *out_begin = base + begin;
+        *out_end = base + end;
+    }
+}
+
+/**
+ * Appends the string [src_begin, src_end) in `src_encoding` to the character
+ * buffer in `dst_encoding`, returning its offsets.
+ */
+static void append_string(memory_block_data *blockref,
+                          string_encoding_t dst_encoding,
+                          string_encoding_t src_encoding,
+                          const char *src_begin, const char *src_end,
+                          assign_error_mode errmode, intptr_t *out_begin,
+                          intptr_t *out_end)
+{
+    intptr_t src_charsize = string_encoding_char_size_table[src_encoding];
+    intptr_t dst_charsize = string_encoding_char_size_table[dst_encoding];
+    intptr_t src_size = src_end - src_begin;
+
+    // The source may be a string from this same buffer, which moves as
+    // it grows, so hold on to it as an offset in that case
+    const char *base = get_contiguous_pod_memory_block_data(blockref);
+    intptr_t buffer_size = get_contiguous_pod_memory_block_size(blockref);
+    bool src_in_buffer = base != NULL && src_begin >= base &&
+                         src_begin < base + buffer_size;
+    intptr_t src_offset = src_in_buffer ? (src_begin - base) : 0;
+
+    if (dst_encoding == src_encoding) {
+        // Same encoding, a straight copy
+        intptr_t offset = contiguous_pod_memory_block_allocate(blockref, src_size,
+                                                               dst_charsize);
+        char *data = get_contiguous_pod_memory_block_data(blockref);
+        if (src_in_buffer) {
+            src_begin = data + src_offset;
+        }
+        if (src_size > 0) {
+            memcpy(data + offset, src_begin, src_size);
+        }
+        *out_begin = offset;
+        *out_end = offset + src_size;
+        return;
+    }
+
+    next_unicode_codepoint_t next_fn =
+        get_next_unicode_codepoint_function(src_encoding, errmode);
+    append_unicode_codepoint_t append_fn =
+        get_append_unicode_codepoint_function(dst_encoding, errmode);
+
+    // Allocate the initial output as the src number of characters + some padding
+    intptr_t capacity = (src_size / src_charsize + 16) * dst_charsize * 1124 / 1024;
+    intptr_t offset = contiguous_pod_memory_block_allocate(blockref, capacity,
+                                                           dst_charsize);
+    intptr_t used = 0;
+    const char *src_it = src_begin;
+    while (src_it < src_end) {
+        if (capacity - used < 8) {
+            // Grow the allocation, keeping the source valid if it moves
+            intptr_t src_pos = src_it - src_begin;
+            capacity *= 2;
+            contiguous_pod_memory_block_resize(blockref, offset, capacity);
+            if (src_in_buffer) {
+                src_begin = get_contiguous_pod_memory_block_data(blockref) + src_offset;
+                src_end = src_begin + src_size;
+                src_it = src_begin + src_pos;
+            }
+        }
+        char *data = get_contiguous_pod_memory_block_data(blockref);
+        char *dst_it = data + offset + used;
+        append_fn(next_fn(src_it, src_end), dst_it, data + offset + capacity);
+        used = dst_it - (data + offset);
+    }
+
+    // Shrink-wrap the allocation to just fit the string
+    contiguous_pod_memory_block_resize(blockref, offset, used);
+    *out_begin = offset;
+    *out_end = offset + used;
+}
+
+void offset_string_type::set_from_utf8_string(const char *arrmeta, char *dst,
+                                              const char *utf8_begin,
+                                              const char *utf8_end,
+                                              const eval::eval_context *ectx) const
+{
+    const offset_string_type_arrmeta *md =
+        reinterpret_cast<const offset_string_type_arrmeta *>(arrmeta);
+    intptr_t begin, end;
+    append_string(md->blockref, m_encoding, string_encoding_utf_8, utf8_begin,
+                  utf8_end, ectx->errmode, &begin, &end);
+    set_offsets(dst, begin, end);
+}
+
+void offset_string_type::print_data(std::ostream& o, const char *arrmeta, const char *data) const
+{
+    uint32_t cp;
+    next_unicode_codepoint_t next_fn;
+    next_fn = get_next_unicode_codepoint_function(m_encoding, assign_error_nocheck);
+    const char *begin, *end;
+    get_string_range(&begin, &end, arrmeta, data);
+
+    // Print as an escaped string
+    o << "\"";
+    while (begin < end) {
+        cp = next_fn(begin, end);
+        print_escaped_unicode_codepoint(o, cp, false);
+    }
+    o << "\"";
+}
+
+void offset_string_type::print_type(std::ostream& o) const
+{
+    o << "offset_string";
+    if (m_encoding != string_encoding_utf_8) {
+        o << "['" << m_encoding << "'";
+        if (m_offset_type_id != int32_type_id) {
+            o << ", " << ndt::type(m_offset_type_id);
+        }
+        o << "]";
+    } else if (m_offset_type_id != int32_type_id) {
+        o << "[" << ndt::type(m_offset_type_id) << "]";
+    }
+}
+
+bool offset_string_type::is_unique_data_owner(const char *arrmeta) const
+{
+    const offset_string_type_arrmeta *md =
+        reinterpret_cast<const offset_string_type_arrmeta *>(arrmeta);
+    if (md->blockref != NULL &&
+            (md->blockref->m_use_count != 1 ||
+             md->blockref->m_type != contiguous_pod_memory_block_type)) {
+        return false;
+    }
+    return true;
+}
+
+ndt::type offset_string_type::get_canonical_type() const
+{
+    return ndt::type(this, true);
+}
+
+void offset_string_type::get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape,
+                const char *DYND_UNUSED(arrmeta), const char *DYND_UNUSED(data)) const
+{
+    out_shape[i] = -1;
+    if (i+1 < ndim) {
+        stringstream ss;
+        ss << "requested too many dimensions from type " << ndt::type(this, true);
+        throw runtime_error(ss.str());
+    }
+}
+
+bool offset_string_type::is_lossless_assignment(
+                const ndt::type& DYND_UNUSED(dst_tp),
+                const ndt::type& DYND_UNUSED(src_tp)) const
+{
+    // Don't shortcut anything to 'nocheck' error checking, so that
+    // decoding errors get caught appropriately.
+    return false;
+}
+
+bool offset_string_type::operator==(const base_type& rhs) const
+{
+    if (this == &rhs) {
+        return true;
+    } else if (rhs.get_type_id() != offset_string_type_id) {
+        return false;
+    } else {
+        const offset_string_type *dt = static_cast<const offset_string_type*>(&rhs);
+        return m_encoding == dt->m_encoding &&
+               m_offset_type_id == dt->m_offset_type_id;
+    }
+}
+
+void offset_string_type::arrmeta_default_construct(char *arrmeta,
+                                                   bool blockref_alloc) const
+{
+  // Allocate a contiguous buffer for the characters of all the strings
+  if (blockref_alloc) {
+    offset_string_type_arrmeta *md =
+        reinterpret_cast<offset_string_type_arrmeta *>(arrmeta);
+    md->blockref = make_contiguous_pod_memory_block().release();
+  }
+}
+
+void offset_string_type::arrmeta_copy_construct(
+    char *dst_arrmeta, const char *src_arrmeta,
+    memory_block_data *DYND_UNUSED(embedded_reference)) const
+{
+    // The offsets are only meaningful relative to the source's buffer, so
+    // unlike string the embedded reference can't stand in for it
+    const offset_string_type_arrmeta *src_md =
+        reinterpret_cast<const offset_string_type_arrmeta *>(src_arrmeta);
+    offset_string_type_arrmeta *dst_md =
+        reinterpret_cast<offset_string_type_arrmeta *>(dst_arrmeta);
+    dst_md->blockref = src_md->blockref;
+    if (dst_md->blockref) {
+        memory_block_incref(dst_md->blockref);
+    }
+}
+
+void offset_string_type::arrmeta_reset_buffers(char *arrmeta) const
+{
+    const offset_string_type_arrmeta *md =
+        reinterpret_cast<const offset_string_type_arrmeta *>(arrmeta);
+    if (md->blockref != NULL &&
+            md->blockref->m_type == contiguous_pod_memory_block_type) {
+        contiguous_pod_memory_block_reset(md->blockref);
+    } else {
+        throw runtime_error("can only reset the buffers of a dynd offset_string "
+                        "type if the memory block reference was constructed by default");
+    }
+}
+
+void offset_string_type::arrmeta_finalize_buffers(char *arrmeta) const
+{
+    offset_string_type_arrmeta *md =
+        reinterpret_cast<offset_string_type_arrmeta *>(arrmeta);
+    if (md->blockref != NULL &&
+            md->blockref->m_type == contiguous_pod_memory_block_type) {
+        contiguous_pod_memory_block_finalize(md->blockref);
+    }
+}
+
+void offset_string_type::arrmeta_destruct(char *arrmeta) const
+{
+    offset_string_type_arrmeta *md =
+        reinterpret_cast<offset_string_type_arrmeta *>(arrmeta);
+    if (md->blockref) {
+        memory_block_decref(md->blockref);
+    }
+}
+
+void offset_string_type::arrmeta_debug_print(const char *arrmeta, std::ostream& o, const std::string& indent) const
+{
+    const offset_string_type_arrmeta *md =
+        reinterpret_cast<const offset_string_type_arrmeta *>(arrmeta);
+    o << indent << "offset_string arrmeta\n";
+    memory_block_debug_print(md->blockref, o, indent + " ");
+}
+
+namespace {
+/**
+ * Assigns any string type to an offset_string, appending the characters
+ * to the destination's buffer.
+ */
+struct string_to_offset_string_ck
+    : public kernels::unary_ck<string_to_offset_string_ck> {
+    const offset_string_type *m_dst_tp;
+    const offset_string_type_arrmeta *m_dst_arrmeta;
+    const base_string_type *m_src_tp;
+    const char *m_src_arrmeta;
+    assign_error_mode m_errmode;
+
+    inline void single(char *dst, char *src)
+    {
+        if (m_src_tp->get_type_id() == offset_string_type_id) {
+            const offset_string_type *src_tp =
+                static_cast<const offset_string_type *>(m_src_tp);
+            intptr_t begin, end;
+            src_tp->get_offsets(src, &begin, &end);
+            const offset_string_type_arrmeta *src_md =
+                reinterpret_cast<const offset_string_type_arrmeta *>(m_src_arrmeta);
+            if (begin < 0 ||
+                    (src_md->blockref == m_dst_arrmeta->blockref &&
+                     src_tp->get_encoding() == m_dst_tp->get_encoding())) {
+                // Missing values, and strings already in the destination
+                // buffer, only need their offsets copied
+                m_dst_tp->set_offsets(dst, begin, end);
+                return;
+            }
+        }
+
+        const char *src_begin, *src_end;
+        m_src_tp->get_string_range(&src_begin, &src_end, m_src_arrmeta, src);
+        intptr_t begin, end;
+        append_string(m_dst_arrmeta->blockref, m_dst_tp->get_encoding(),
+                      m_src_tp->get_encoding(), src_begin, src_end, m_errmode,
+                      &begin, &end);
+        m_dst_tp->set_offsets(dst, begin, end);
+    }
+
+    inline void destruct_children()
+    {
+        base_type_xdecref(m_dst_tp);
+        base_type_xdecref(m_src_tp);
+    }
+
+    inline void clone_children(ckernel_prefix *DYND_UNUSED(dst)) const
+    {
+        // The clone holds its own references to the types
+        base_type_xincref(m_dst_tp);
+        base_type_xincref(m_src_tp);
+    }
+};
+
+// Empty string_type arrmeta, for presenting an offset_string to a
+// string kernel as a "string" with no blockref
+static const string_type_arrmeta empty_string_arrmeta = {NULL};
+
+/**
+ * Assigns an offset_string to another type by presenting each element as
+ * a "string" of the same encoding to the child assignment kernel.
+ */
+struct offset_string_to_any_ck
+    : public kernels::unary_ck<offset_string_to_any_ck> {
+    const offset_string_type *m_src_tp;
+    const char *m_src_arrmeta;
+
+    inline void single(char *dst, char *src)
+    {
+        static char empty = 0;
+        string_type_data tmp;
+        const char *begin, *end;
+        m_src_tp->get_string_range(&begin, &end, m_src_arrmeta, src);
+        intptr_t begin_offset, end_offset;
+        m_src_tp->get_offsets(src, &begin_offset, &end_offset);
+        if (begin_offset < 0) {
+            // A missing value is an uninitialized string
+            tmp.begin = NULL;
+            tmp.end = NULL;
+        } else if (begin == NULL) {
+            tmp.begin = &empty;
+            tmp.end = &empty;
+        } else {
+            tmp.begin = const_cast<char *>(begin);
+            tmp.end = const_cast<char *>(end);
+        }
+        char *child_src = reinterpret_cast<char *>(&tmp);
+        ckernel_prefix *child = get_child_ckernel();
+        expr_single_t child_fn = child->get_function<expr_single_t>();
+        child_fn(dst, &child_src, child);
+    }
+
+    inline void destruct_children()
+    {
+        base_type_xdecref(m_src_tp);
+        get_child_ckernel()->destroy();
+    }
+
+    inline void clone_children(ckernel_prefix *dst) const
+    {
+        base.clone_child_ckernels(dst, sizeof(self_type));
+        base_type_xincref(m_src_tp);
+    }
+};
+} // anonymous namespace
+
+size_t offset_string_type::make_assignment_kernel(
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, const ndt::type &src_tp, const char *src_arrmeta,
+    kernel_request_t kernreq, const eval::eval_context *ectx) const
+{
+    if (this == dst_tp.extended()) {
+        if (src_tp.get_kind() == string_kind) {
+            string_to_offset_string_ck *self =
+                string_to_offset_string_ck::create_leaf(ckb, kernreq, ckb_offset);
+            self->m_dst_tp = static_cast<const offset_string_type *>(ndt::type(dst_tp).release());
+            self->m_dst_arrmeta = reinterpret_cast<const offset_string_type_arrmeta *>(dst_arrmeta);
+            self->m_src_tp = static_cast<const base_string_type *>(ndt::type(src_tp).release());
+            self->m_src_arrmeta = src_arrmeta;
+            self->m_errmode = ectx->errmode;
+            return ckb_offset;
+        } else if (!src_tp.is_builtin()) {
+            return src_tp.extended()->make_assignment_kernel(
+                ckb, ckb_offset, dst_tp, dst_arrmeta, src_tp,
+                src_arrmeta, kernreq, ectx);
+        } else {
+            return make_builtin_to_string_assignment_kernel(
+                ckb, ckb_offset, dst_tp, dst_arrmeta,
+                src_tp.get_type_id(), kernreq, ectx);
+        }
+    } else {
+        if (dst_tp.is_builtin()) {
+            return make_string_to_builtin_assignment_kernel(
+                ckb, ckb_offset, dst_tp.get_type_id(), src_tp, src_arrmeta,
+                kernreq, ectx);
+        } else {
+            offset_string_to_any_ck *self =
+                offset_string_to_any_ck::create(ckb, kernreq, ckb_offset);
+            self->m_src_tp = static_cast<const offset_string_type *>(ndt::type(src_tp).release());
+            self->m_src_arrmeta = src_arrmeta;
+            return dynd::make_assignment_kernel(
+                ckb, ckb_offset, dst_tp, dst_arrmeta, ndt::make_string(m_encoding),
+                reinterpret_cast<const char *>(&empty_string_arrmeta),
+                kernel_request_single, ectx);
+        }
+    }
+}
+
+namespace {
+struct offset_string_compare_kernel_extra {
+    ckernel_prefix base;
+    const offset_string_type *src_tp[2];
+    const char *src_arrmeta[2];
+
+    inline void get_range(int i, const char *src, const char **out_begin,
+                          const char **out_end) const
+    {
+        src_tp[i]->get_string_range(out_begin, out_end, src_arrmeta[i], src);
+    }
+
+    static void destruct(ckernel_prefix *self)
+    {
+        offset_string_compare_kernel_extra *e =
+            reinterpret_cast<offset_string_compare_kernel_extra *>(self);
+        base_type_xdecref(e->src_tp[0]);
+        base_type_xdecref(e->src_tp[1]);
+    }
+};
+
+/**
+ * Orders code units so that comparing them one by one is codepoint order.
+ * For UTF-8 and UTF-32 that is the order of the code units themselves.
+ */
+template <typename T>
+struct codepoint_order_less {
+    inline bool operator()(T lhs, T rhs) const { return lhs < rhs; }
+};
+
+/**
+ * In UTF-16, the surrogates 0xD800-0xDFFF encode codepoints above
+ * 0xFFFF, so they are moved above the other code units 0xE000-0xFFFF.
+ */
+template <>
+struct codepoint_order_less<uint16_t> {
+    static inline uint32_t fixup(uint16_t u)
+    {
+        if (u >= 0xD800) {
+            return u >= 0xE000 ? u - 0x800u : u + 0x2000u;
+        }
+        return u;
+    }
+
+    inline bool operator()(uint16_t lhs, uint16_t rhs) const
+    {
+        return fixup(lhs) < fixup(rhs);
+    }
+};
+
+/**
+ * Compares two offset_strings of the same encoding code unit by code
+ * unit, in codepoint order.
+ */
+template <typename T>
+struct offset_string_compare_kernel {
+    typedef offset_string_compare_kernel_extra extra_type;
+
+    static inline bool lt(const extra_type *e, const char *const *src,
+                          int a, int b)
+    {
+        const char *a_begin, *a_end, *b_begin, *b_end;
+        e->get_range(a, src[a], &a_begin, &a_end);
+        e->get_range(b, src[b], &b_begin, &b_end);
+        return lexicographical_compare(reinterpret_cast<const T *>(a_begin),
+                                       reinterpret_cast<const T *>(a_end),
+                                       reinterpret_cast<const T *>(b_begin),
+                                       reinterpret_cast<const T *>(b_end),
+                                       codepoint_order_less<T>());
+    }
+
+    static inline bool eq(const extra_type *e, const char *const *src)
+    {
+        const char *a_begin, *a_end, *b_begin, *b_end;
+        e->get_range(0, src[0], &a_begin, &a_end);
+        e->get_range(1, src[1], &b_begin, &b_end);
+        return (a_end - a_begin == b_end - b_begin) &&
+               (a_end == a_begin || memcmp(a_begin, b_begin, a_end - a_begin) == 0);
+    }
+
+    static int less(const char *const *src, ckernel_prefix *self)
+    {
+        return lt(reinterpret_cast<const extra_type *>(self), src, 0, 1);
+    }
+
+    static int less_equal(const char *const *src, ckernel_prefix *self)
+    {
+        return !lt(reinterpret_cast<const extra_type *>(self), src, 1, 0);
+    }
+
+    static int equal(const char *const *src, ckernel_prefix *self)
+    {
+        return eq(reinterpret_cast<const extra_type *>(self), src);
+    }
+
+    static int not_equal(const char *const *src, ckernel_prefix *self)
+    {
+        return !eq(reinterpret_cast<const extra_type *>(self), src);
+    }
+
+    static int greater_equal(const char *const *src, ckernel_prefix *self)
+    {
+        return !lt(reinterpret_cast<const extra_type *>(self), src, 0, 1);
+    }
+
+    static int greater(const char *const *src, ckernel_prefix *self)
+    {
+        return lt(reinterpret_cast<const extra_type *>(self), src, 1, 0);
+    }
+};
+} // anonymous namespace
+
+#define DYND_OFFSET_STRING_COMPARISON_TABLE_TYPE_LEVEL(type) { \
+    offset_string_compare_kernel<type>::less, \
+    offset_string_compare_kernel<type>::less, \
+    offset_string_compare_kernel<type>::less_equal, \
+    offset_string_compare_kernel<type>::equal, \
+    offset_string_compare_kernel<type>::not_equal, \
+    offset_string_compare_kernel<type>::greater_equal, \
+    offset_string_compare_kernel<type>::greater \
+    }
+
+size_t offset_string_type::make_comparison_kernel(
+    void *ckb, intptr_t ckb_offset, const ndt::type &src0_dt,
+    const char *src0_arrmeta, const ndt::type &src1_dt,
+    const char *src1_arrmeta, comparison_type_t comptype,
+    const eval::eval_context *ectx) const
+{
+    if (this == src0_dt.extended()) {
+        if (src1_dt.get_type_id() == offset_string_type_id &&
+                src1_dt.extended<base_string_type>()->get_encoding() == m_encoding &&
+                0 <= comptype && comptype < 7) {
+            static int lookup[5] = {0, 1, 0, 1, 2};
+            static expr_predicate_t offset_string_comparisons_table[3][7] = {
+                DYND_OFFSET_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint8_t),
+                DYND_OFFSET_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint16_t),
+                DYND_OFFSET_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint32_t)};
+            offset_string_compare_kernel_extra *e =
+                reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+                    ->alloc_ck_leaf<offset_string_compare_kernel_extra>(ckb_offset);
+            e->base.set_function<expr_predicate_t>(
+                offset_string_comparisons_table[lookup[m_encoding]][comptype]);
+            e->base.destructor = &offset_string_compare_kernel_extra::destruct;
+            e->src_tp[0] = static_cast<const offset_string_type *>(ndt::type(src0_dt).release());
+            e->src_tp[1] = static_cast<const offset_string_type *>(ndt::type(src1_dt).release());
+            e->src_arrmeta[0] = src0_arrmeta;
+            e->src_arrmeta[1] = src1_arrmeta;
+            return ckb_offset;
+        } else if (src1_dt.get_kind() == string_kind) {
+            return make_general_string_comparison_kernel(ckb, ckb_offset,
+                            src0_dt, src0_arrmeta,
+                            src1_dt, src1_arrmeta,
+                            comptype, ectx);
+        } else if (!src1_dt.is_builtin()) {
+            return src1_dt.extended()->make_comparison_kernel(ckb, ckb_offset,
+                            src0_dt, src0_arrmeta,
+                            src1_dt, src1_arrmeta,
+                            comptype, ectx);
+        }
+    }
+
+    throw not_comparable_error(src0_dt, src1_dt, comptype);
+}
+
+#undef DYND_OFFSET_STRING_COMPARISON_TABLE_TYPE_LEVEL
+
+void offset_string_type::make_string_iter(dim_iter *out_di, string_encoding_t encoding,
+            const char *arrmeta, const char *data,
+            const memory_block_ptr& ref,
+            intptr_t buffer_max_mem,
+            const eval::eval_context *ectx) const
+{
+    const char *begin, *end;
+    get_string_range(&begin, &end, arrmeta, data);
+    memory_block_ptr dataref = ref;
+    const offset_string_type_arrmeta *md =
+        reinterpret_cast<const offset_string_type_arrmeta *>(arrmeta);
+    if (md->blockref != NULL) {
+        dataref = memory_block_ptr(md->blockref);
+    }
+    iter::make_string_iter(out_di, encoding,
+            m_encoding, begin, end, dataref, buffer_max_mem, ectx);
+}
+
+namespace {
+template <typename T>
+struct offset_string_is_avail_ck {
+    static void single(char *dst, char **src,
+                       ckernel_prefix *DYND_UNUSED(self))
+    {
+        *dst = reinterpret_cast<const offset_string_type_data<T> *>(src[0])->begin >= 0;
+    }
+
+    static void strided(char *dst, intptr_t dst_stride, char **src,
+                        const intptr_t *src_stride, size_t count,
+                        ckernel_prefix *DYND_UNUSED(self))
+    {
+        const char *src0 = src[0];
+        intptr_t src0_stride = src_stride[0];
+        for (size_t i = 0; i != count; ++i) {
+            *dst = reinterpret_cast<const offset_string_type_data<T> *>(src0)->begin >= 0;
+            dst += dst_stride;
+            src0 += src0_stride;
+        }
+    }
+};
+
+template <typename T>
+struct offset_string_assign_na_ck {
+    static void single(char *dst, char **DYND_UNUSED(src),
+                       ckernel_prefix *DYND_UNUSED(self))
+    {
+        offset_string_type_data<T> *d =
+            reinterpret_cast<offset_string_type_data<T> *>(dst);
+        d->begin = -1;
+        d->end = -1;
+    }
+
+    static void strided(char *dst, intptr_t dst_stride,
+                        char **DYND_UNUSED(src),
+                        const intptr_t *DYND_UNUSED(src_stride), size_t count,
+                        ckernel_prefix *DYND_UNUSED(self))
+    {
+        for (size_t i = 0; i != count; ++i, dst += dst_stride) {
+            offset_string_type_data<T> *d =
+                reinterpret_cast<offset_string_type_data<T> *>(dst);
+            d->begin = -1;
+            d->end = -1;
+        }
+    }
+};
+
+static const offset_string_type *
+get_option_value_offset_string(const ndt::type &tp, const char *which)
+{
+    if (tp.get_type_id() != option_type_id ||
+            tp.extended<option_type>()->get_value_type().get_type_id() !=
+                offset_string_type_id) {
+        stringstream ss;
+        ss << "Expected " << which << " type ?offset_string, got " << tp;
+        throw type_error(ss.str());
+    }
+    return tp.extended<option_type>()->get_value_type().extended<offset_string_type>();
+}
+
+static intptr_t instantiate_offset_string_is_avail(
+    const arrfunc_type_data *DYND_UNUSED(self),
+    const arrfunc_type *DYND_UNUSED(af_tp), void *ckb,
+    intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *DYND_UNUSED(dst_arrmeta), const ndt::type *src_tp,
+    const char *const *DYND_UNUSED(src_arrmeta), kernel_request_t kernreq,
+    const eval::eval_context *DYND_UNUSED(ectx),
+    const nd::array &DYND_UNUSED(args), const nd::array &DYND_UNUSED(kwds))
+{
+    const offset_string_type *ost = get_option_value_offset_string(src_tp[0], "source");
+    if (dst_tp.get_type_id() != bool_type_id) {
+        stringstream ss;
+        ss << "Expected destination type bool, got " << dst_tp;
+        throw type_error(ss.str());
+    }
+    ckernel_prefix *ckp = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->alloc_ck_leaf<ckernel_prefix>(ckb_offset);
+    if (ost->get_offset_type_id() == int32_type_id) {
+        ckp->set_expr_function<offset_string_is_avail_ck<int32_t> >(kernreq);
+    } else {
+        ckp->set_expr_function<offset_string_is_avail_ck<int64_t> >(kernreq);
+    }
+    return ckb_offset;
+}
+
+static intptr_t instantiate_offset_string_assign_na(
+    const arrfunc_type_data *DYND_UNUSED(self),
+    const arrfunc_type *DYND_UNUSED(af_tp), void *ckb,
+    intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *DYND_UNUSED(dst_arrmeta),
+    const ndt::type *DYND_UNUSED(src_tp),
+    const char *const *DYND_UNUSED(src_arrmeta), kernel_request_t kernreq,
+    const eval::eval_context *DYND_UNUSED(ectx),
+    const nd::array &DYND_UNUSED(args), const nd::array &DYND_UNUSED(kwds))
+{
+    const offset_string_type *ost = get_option_value_offset_string(dst_tp, "destination");
+    ckernel_prefix *ckp = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)->alloc_ck_leaf<ckernel_prefix>(ckb_offset);
+    if (ost->get_offset_type_id() == int32_type_id) {
+        ckp->set_expr_function<offset_string_assign_na_ck<int32_t> >(kernreq);
+    } else {
+        ckp->set_expr_function<offset_string_assign_na_ck<int64_t> >(kernreq);
+    }
+    return ckb_offset;
+}
+} // anonymous namespace
+
+nd::array offset_string_type::get_option_nafunc() const
+{
+    nd::array naf = nd::empty(option_type::make_nafunc_type());
+    arrfunc_type_data *is_avail =
+        reinterpret_cast<arrfunc_type_data *>(naf.get_ndo()->m_data_pointer);
+    arrfunc_type_data *assign_na = is_avail + 1;
+
+    is_avail->instantiate = &instantiate_offset_string_is_avail;
+    assign_na->instantiate = &instantiate_offset_string_assign_na;
+    naf.flag_as_immutable();
+    return naf;
+}
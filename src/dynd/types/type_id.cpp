@@ -107,6 +107,8 @@ std::ostream &dynd::operator<<(std::ostream &o, type_id_t tid)
     return (o << "string");
   case fixedstring_type_id:
     return (o << "fixedstring");
+  case offset_string_type_id:
+    return (o << "offset_string");
   case categorical_type_id:
     return (o << "categorical");
   case date_type_id:
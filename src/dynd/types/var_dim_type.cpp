@@ -754,6 +754,162 @@ void ndt::var_dim_element_resize(const type& tp,
     }
 }
 
+namespace {
+    // The size of the first block a var_dim_builder allocates, when
+    // nothing was reserved
+    const intptr_t var_dim_builder_initial_bytes = 4096;
+
+    inline char *align_up(char *ptr, size_t alignment)
+    {
+        return reinterpret_cast<char *>(
+            (reinterpret_cast<uintptr_t>(ptr) + alignment - 1) &
+            ~(uintptr_t)(alignment - 1));
+    }
+} // anonymous namespace
+
+ndt::var_dim_builder::var_dim_builder(const type& tp, const char *arrmeta)
+    : m_memblock(NULL), m_pod_api(NULL), m_objectarray_api(NULL),
+      m_stride(0), m_alignment(1), m_block_begin(NULL), m_block_end(NULL),
+      m_cursor(NULL), m_block_capacity(0), m_open_begin(NULL)
+{
+    if (tp.get_type_id() != var_dim_type_id) {
+        stringstream ss;
+        ss << "internal error: expected a var_dim type, not " << tp;
+        throw dynd::type_error(ss.str());
+    }
+    const var_dim_type_arrmeta *md = reinterpret_cast<const var_dim_type_arrmeta *>(arrmeta);
+    if (md->offset != 0) {
+        throw runtime_error("internal error: var_dim arrmeta offset must be "
+                            "zero to initialize");
+    }
+    m_memblock = md->blockref;
+    m_stride = md->stride;
+    m_alignment = tp.extended<var_dim_type>()->get_target_alignment();
+    if (m_memblock == NULL) {
+        throw runtime_error("internal error: var_dim arrmeta has no memblock");
+    } else if (m_memblock->m_type == objectarray_memory_block_type) {
+        m_objectarray_api = get_memory_block_objectarray_allocator_api(m_memblock);
+    } else if (m_memblock->m_type == pod_memory_block_type ||
+                m_memblock->m_type == zeroinit_memory_block_type) {
+        m_pod_api = get_memory_block_pod_allocator_api(m_memblock);
+    } else {
+        stringstream ss;
+        ss << "var_dim_builder internal error: ";
+        ss << "var_dim arrmeta has memblock type " << (memory_block_type_t)m_memblock->m_type;
+        ss << " that is not writable";
+        throw runtime_error(ss.str());
+    }
+}
+
+ndt::var_dim_builder::~var_dim_builder()
+{
+    try {
+        finish();
+    } catch (...) {
+    }
+}
+
+void ndt::var_dim_builder::grow(intptr_t size_bytes)
+{
+    // Give back the unused tail of the current block, so that the
+    // next block can continue in the same memory if it fits
+    finish();
+    intptr_t capacity = max(size_bytes, max(2 * m_block_capacity,
+                                            var_dim_builder_initial_bytes));
+    m_pod_api->allocate(m_memblock, capacity, m_alignment, &m_block_begin,
+                        &m_block_end);
+    m_cursor = m_block_begin;
+    m_block_capacity = capacity;
+}
+
+void ndt::var_dim_builder::reserve_bytes(intptr_t size_bytes)
+{
+    if (m_block_begin == NULL || m_block_end - m_cursor < size_bytes) {
+        grow(size_bytes);
+    }
+}
+
+void ndt::var_dim_builder::reserve(intptr_t count)
+{
+    if (m_pod_api != NULL) {
+        reserve_bytes(count * m_stride + (intptr_t)m_alignment - 1);
+    }
+}
+
+char *ndt::var_dim_builder::append(char *data, intptr_t count)
+{
+    var_dim_type_data *d = reinterpret_cast<var_dim_type_data *>(data);
+    if (d->begin != NULL) {
+        throw runtime_error(
+            "internal error: var_dim element data must be NULL to initialize");
+    }
+    if (m_objectarray_api != NULL) {
+        d->begin = m_objectarray_api->allocate(m_memblock, count);
+    } else {
+        reserve(count);
+        d->begin = align_up(m_cursor, m_alignment);
+        m_cursor = d->begin + count * m_stride;
+    }
+    d->size = count;
+    return d->begin;
+}
+
+void ndt::var_dim_builder::append_all(char *data, intptr_t data_stride,
+                                      intptr_t n, const intptr_t *counts)
+{
+    if (m_pod_api != NULL) {
+        // One allocation covering all the elements, with room for
+        // any alignment padding between them
+        intptr_t total = 0;
+        for (intptr_t i = 0; i < n; ++i) {
+            total += counts[i];
+        }
+        reserve_bytes(total * m_stride + n * ((intptr_t)m_alignment - 1));
+    }
+    for (intptr_t i = 0; i < n; ++i, data += data_stride) {
+        append(data, counts[i]);
+    }
+}
+
+char *ndt::var_dim_builder::open(intptr_t max_count)
+{
+    if (m_objectarray_api != NULL) {
+        m_open_begin = m_objectarray_api->allocate(m_memblock, max_count);
+    } else {
+        reserve(max_count);
+        m_open_begin = align_up(m_cursor, m_alignment);
+    }
+    return m_open_begin;
+}
+
+void ndt::var_dim_builder::close(char *data, intptr_t count)
+{
+    var_dim_type_data *d = reinterpret_cast<var_dim_type_data *>(data);
+    if (d->begin != NULL) {
+        throw runtime_error(
+            "internal error: var_dim element data must be NULL to initialize");
+    }
+    if (m_objectarray_api != NULL) {
+        d->begin = m_objectarray_api->resize(m_memblock, m_open_begin, count);
+    } else {
+        d->begin = m_open_begin;
+        m_cursor = d->begin + count * m_stride;
+    }
+    d->size = count;
+    m_open_begin = NULL;
+}
+
+void ndt::var_dim_builder::finish()
+{
+    if (m_pod_api != NULL && m_block_begin != NULL) {
+        m_pod_api->resize(m_memblock, m_cursor - m_block_begin,
+                          &m_block_begin, &m_block_end);
+        m_block_begin = NULL;
+        m_block_end = NULL;
+        m_cursor = NULL;
+    }
+}
+
 ndt::type ndt::make_var_dim(const ndt::type &element_tp)
 {
   return ndt::type(new var_dim_type(element_tp), false);
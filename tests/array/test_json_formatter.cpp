@@ -4,14 +4,24 @@
 //
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
 
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include <fcntl.h>
+
 #include "inc_gtest.hpp"
 
 #include <dynd/json_formatter.hpp>
 #include <dynd/json_parser.hpp>
+#include <dynd/parallel.hpp>
 #include <dynd/types/var_dim_type.hpp>
 #include <dynd/types/cfixed_dim_type.hpp>
 #include <dynd/types/cstruct_type.hpp>
@@ -115,3 +125,142 @@ TEST(JSONFormatter, UniformDim) {
     EXPECT_EQ("[1.5,null,3.125,9.25,null,null]", format_json(a).as<string>());
 }
 
+
+namespace {
+struct collect_output {
+  string *out;
+  intptr_t *max_piece;
+  void operator()(const char *begin, size_t size) const
+  {
+    out->append(begin, size);
+    *max_piece = max(*max_piece, (intptr_t)size);
+  }
+};
+
+string format_json_streamed(const nd::array &a, bool ndjson,
+                            intptr_t chunk_size, intptr_t *max_piece = NULL)
+{
+  string result;
+  intptr_t piece = 0;
+  collect_output c = {&result, &piece};
+  format_json_stream(a, c, false, ndjson, chunk_size);
+  if (max_piece != NULL) {
+    *max_piece = piece;
+  }
+  return result;
+}
+
+string read_file(const char *fn)
+{
+  ifstream fin(fn, ios::binary);
+  stringstream ss;
+  ss << fin.rdbuf();
+  return ss.str();
+}
+
+void remove_file(const char *fn)
+{
+#ifdef WIN32
+  _unlink(fn);
+#else
+  unlink(fn);
+#endif
+}
+} // anonymous namespace
+
+TEST(JSONFormatter, Stream) {
+  intptr_t nthreads = parallel::get_num_threads();
+  stringstream ss;
+  ss << "[";
+  for (int i = 0; i < 3000; ++i) {
+    ss << (i == 0 ? "" : ", ") << "{\"id\": " << i << ", \"name\": \""
+       << string(i % 50, 'a' + i % 26) << "\", \"vals\": [";
+    for (int j = 0; j < i % 5; ++j) {
+      ss << (j == 0 ? "" : ", ") << i * j;
+    }
+    ss << "]}";
+  }
+  ss << "]";
+  nd::array a =
+      parse_json(ndt::type("var * {id: int32, name: string, vals: var * int64}"),
+                 ss.str(), &eval::default_eval_context);
+  string expected = format_json(a).as<string>();
+  for (intptr_t t = 1; t <= 4; t += 3) {
+    parallel::set_num_threads(t);
+    intptr_t max_piece;
+    EXPECT_EQ(expected, format_json_streamed(a, false, 1 << 20));
+    EXPECT_EQ(expected, format_json_streamed(a, false, 1000, &max_piece));
+    // The blocks are sized from the average element so far, so the pieces
+    // stay within a small multiple of the chunk size
+    EXPECT_LT(max_piece, 3000);
+  }
+  parallel::set_num_threads(nthreads);
+
+  // A fixed dimension, and arrays without enough elements for the
+  // threads or no leading dimension
+  int vals[1000];
+  for (int i = 0; i < 1000; ++i) {
+    vals[i] = i * 7 - 100;
+  }
+  a = vals;
+  EXPECT_EQ(format_json(a).as<string>(), format_json_streamed(a, false, 64));
+  a = parse_json("{x: 3 * int8}", "{\"x\": [1, 2, 3]}");
+  EXPECT_EQ("{\"x\":[1,2,3]}", format_json_streamed(a, false, 64));
+  a = parse_json("0 * int32", "[]");
+  EXPECT_EQ("[]", format_json_streamed(a, false, 64));
+}
+
+TEST(JSONFormatter, StreamNDJSON) {
+  intptr_t nthreads = parallel::get_num_threads();
+  parallel::set_num_threads(4);
+  int vals[500];
+  string expected;
+  for (int i = 0; i < 500; ++i) {
+    vals[i] = 3 * i;
+    stringstream ss;
+    ss << 3 * i << "\n";
+    expected += ss.str();
+  }
+  nd::array a = vals;
+  EXPECT_EQ(expected, format_json_streamed(a, true, 64));
+  parallel::set_num_threads(nthreads);
+
+  a = parse_json("var * {a: int32}", "[{\"a\": 1}, {\"a\": 2}]");
+  EXPECT_EQ("{\"a\":1}\n{\"a\":2}\n", format_json_streamed(a, true, 64));
+  a = 5;
+  EXPECT_EQ("5\n", format_json_streamed(a, true, 64));
+}
+
+TEST(JSONFormatter, StreamToFile) {
+  int vals[2000];
+  for (int i = 0; i < 2000; ++i) {
+    vals[i] = i;
+  }
+  nd::array a = vals;
+  string expected = format_json(a).as<string>();
+
+  FILE *f = fopen("test_stream.json", "wb");
+  ASSERT_TRUE(f != NULL);
+  format_json_file(a, f, false, false, 256);
+  fclose(f);
+  EXPECT_EQ(expected, read_file("test_stream.json"));
+
+#ifdef WIN32
+  int fd = _open("test_stream.json", _O_WRONLY | _O_TRUNC | _O_BINARY);
+#else
+  int fd = open("test_stream.json", O_WRONLY | O_TRUNC);
+#endif
+  ASSERT_GE(fd, 0);
+  format_json_fd(a, fd, false, true, 256);
+#ifdef WIN32
+  _close(fd);
+#else
+  close(fd);
+#endif
+  string lines = read_file("test_stream.json");
+  EXPECT_EQ(2000, count(lines.begin(), lines.end(), '\n'));
+  EXPECT_EQ("1999\n", lines.substr(lines.size() - 5));
+  remove_file("test_stream.json");
+
+  EXPECT_THROW(format_json_fd(a, -1), runtime_error);
+}
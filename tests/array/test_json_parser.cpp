@@ -479,3 +479,72 @@ TEST(JSONParser, JSONDType) {
     EXPECT_EQ(12, n(1).as<int>());
     EXPECT_EQ("testing string", n(2).as<string>());
 }
+
+TEST(JSONParser, ReferenceInput) {
+    string text = "[{\"name\": \"alpha\", \"note\": \"a\\tb\", \"raw\": [1, 2]},"
+                  " {\"name\": \"beta\", \"note\": \"c\", \"raw\": {\"x\": 0}}]";
+    nd::array json = nd::array(text).eval_immutable();
+    const string_type_data *src =
+        reinterpret_cast<const string_type_data *>(
+            json.get_readonly_originptr());
+    nd::array n = parse_json(ndt::type("2 * {name: string, note: string,"
+                                       " raw: json}"),
+                             json, &eval::default_eval_context, true);
+    EXPECT_EQ("alpha", n(0, 0).as<string>());
+    EXPECT_EQ("a\tb", n(0, 1).as<string>());
+    EXPECT_EQ("[1, 2]", n(0, 2).as<string>());
+    EXPECT_EQ("beta", n(1, 0).as<string>());
+    EXPECT_EQ("{\"x\": 0}", n(1, 2).as<string>());
+
+    // Strings without escapes and json values point into the input,
+    // while the escaped string is a copy
+    const string_type_data *name =
+        reinterpret_cast<const string_type_data *>(
+            n(0, 0).get_readonly_originptr());
+    const string_type_data *note =
+        reinterpret_cast<const string_type_data *>(
+            n(0, 1).get_readonly_originptr());
+    const string_type_data *raw =
+        reinterpret_cast<const string_type_data *>(
+            n(1, 2).get_readonly_originptr());
+    EXPECT_TRUE(src->begin <= name->begin && name->end <= src->end);
+    EXPECT_TRUE(src->begin <= raw->begin && raw->end <= src->end);
+    EXPECT_FALSE(src->begin <= note->begin && note->end <= src->end);
+
+    // The result keeps the input alive
+    json = nd::array();
+    EXPECT_EQ("alpha", n(0, 0).as<string>());
+    EXPECT_EQ("{\"x\": 0}", n(1, 2).as<string>());
+
+    // Without the option everything is copied
+    json = nd::array(text).eval_immutable();
+    src = reinterpret_cast<const string_type_data *>(
+        json.get_readonly_originptr());
+    n = parse_json(ndt::type("2 * {name: string, note: string, raw: json}"),
+                   json, &eval::default_eval_context);
+    name = reinterpret_cast<const string_type_data *>(
+        n(0, 0).get_readonly_originptr());
+    EXPECT_FALSE(src->begin <= name->begin && name->end <= src->end);
+    EXPECT_EQ("alpha", n(0, 0).as<string>());
+}
+
+TEST(JSONParser, ReferenceInputVarDim) {
+    // Many strings in a var dim share the reference to the input, and
+    // other string encodings are still copied
+    stringstream ss;
+    ss << "[";
+    for (int i = 0; i < 1000; ++i) {
+        ss << (i == 0 ? "" : ", ") << "\"s" << i << "\"";
+    }
+    ss << "]";
+    nd::array json = nd::array(ss.str()).eval_immutable();
+    nd::array n = parse_json(ndt::type("var * string"), json,
+                             &eval::default_eval_context, true);
+    ASSERT_EQ(1000, n.get_dim_size());
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ("s" + to_string(i), n(i).as<string>());
+    }
+    n = parse_json(ndt::type("var * string['utf16']"), json,
+                   &eval::default_eval_context, true);
+    EXPECT_EQ("s999", n(999).as<string>());
+}
@@ -0,0 +1,163 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "inc_gtest.hpp"
+
+#include <dynd/json_tape.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+// The offsets of the structural characters, one character at a time
+vector<uint32_t> reference_offsets(const string &json)
+{
+    vector<uint32_t> result;
+    bool in_string = false, escaped = false;
+    for (size_t i = 0; i < json.size(); ++i) {
+        char c = json[i];
+        if (in_string) {
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (strchr("{}[]:,", c) != NULL) {
+            result.push_back((uint32_t)i);
+        }
+    }
+    return result;
+}
+
+vector<uint32_t> tape_offsets(const json_tape &tape)
+{
+    vector<uint32_t> result;
+    for (size_t i = 0; i < tape.get_entries().size(); ++i) {
+        result.push_back(tape.get_entries()[i].offset);
+    }
+    return result;
+}
+
+string find_path(const json_tape &tape, const string &path)
+{
+    vector<json_path_step> steps;
+    parse_json_path(path, steps);
+    const char *begin, *end;
+    if (!tape.find(steps, begin, end)) {
+        return "<none>";
+    }
+    return string(begin, end);
+}
+} // anonymous namespace
+
+TEST(JSONTape, Structure) {
+    string json = "{\"a\": [1, {\"b\": \"x,}\"}], \"c\\\"]\": 2}";
+    json_tape tape;
+    tape.index(json.data(), json.data() + json.size());
+    EXPECT_EQ(reference_offsets(json), tape_offsets(tape));
+    const vector<json_tape::entry> &e = tape.get_entries();
+    ASSERT_EQ(11u, e.size());
+    // The outer object and the array match their closes
+    EXPECT_EQ(10u, e[0].match);
+    EXPECT_EQ('[', json[e[2].offset]);
+    EXPECT_EQ(']', json[e[e[2].match].offset]);
+}
+
+TEST(JSONTape, BlockBoundaries) {
+    // Runs of backslashes and quotes placed across the 64 byte blocks
+    const char *pieces[] = {"\\\\", "\\\"", "\\\\\\\"", "x", "\\\\\\\\"};
+    for (int shift = 0; shift < 140; ++shift) {
+        for (int p = 0; p < 5; ++p) {
+            string json = "[" + string(shift, ' ') + "\"";
+            for (int k = 0; k < 40; ++k) {
+                json += pieces[(p + k) % 5];
+                json += (k % 3 == 0) ? "{," : ":";
+            }
+            json += "\", {\"k\": [" + string(shift % 7, ' ') + "1]}]";
+            json_tape tape;
+            tape.index(json.data(), json.data() + json.size());
+            ASSERT_EQ(reference_offsets(json), tape_offsets(tape))
+                << "shift " << shift << ", piece " << p;
+            EXPECT_EQ("1", find_path(tape, "[1].k[0]"));
+        }
+    }
+}
+
+TEST(JSONTape, Errors) {
+    json_tape tape;
+    string json = "{\"a\": [1, 2}";
+    EXPECT_THROW(tape.index(json.data(), json.data() + json.size()),
+                 invalid_argument);
+    json = "[1, 2";
+    EXPECT_THROW(tape.index(json.data(), json.data() + json.size()),
+                 invalid_argument);
+    json = "[\"abc]";
+    EXPECT_THROW(tape.index(json.data(), json.data() + json.size()),
+                 invalid_argument);
+    // The tape is reusable after an error
+    json = "[\"abc\"]";
+    tape.index(json.data(), json.data() + json.size());
+    EXPECT_EQ("\"abc\"", find_path(tape, "[0]"));
+}
+
+TEST(JSONTape, Find) {
+    string json = " {\"id\": 7, \"user\": {\"name\": \"Al, \\\"B\\\"\","
+                  " \"tags\": [[], [1, [2, 3]], {\"x\": null}]},"
+                  " \"t\\u0061b\": true, \"empty\": {}} ";
+    json_tape tape;
+    tape.index(json.data(), json.data() + json.size());
+    EXPECT_EQ(json.substr(1, json.size() - 2), find_path(tape, ""));
+    EXPECT_EQ("7", find_path(tape, "id"));
+    EXPECT_EQ("\"Al, \\\"B\\\"\"", find_path(tape, "user.name"));
+    EXPECT_EQ("[]", find_path(tape, "user.tags[0]"));
+    EXPECT_EQ("[2, 3]", find_path(tape, "user.tags[1][1]"));
+    EXPECT_EQ("3", find_path(tape, "user.tags[1][1][1]"));
+    EXPECT_EQ("null", find_path(tape, "user.tags[2].x"));
+    // Escaped field names are compared unescaped
+    EXPECT_EQ("true", find_path(tape, "tab"));
+    EXPECT_EQ("{}", find_path(tape, "empty"));
+
+    EXPECT_EQ("<none>", find_path(tape, "missing"));
+    EXPECT_EQ("<none>", find_path(tape, "empty.a"));
+    EXPECT_EQ("<none>", find_path(tape, "user.tags[0][0]"));
+    EXPECT_EQ("<none>", find_path(tape, "user.tags[3]"));
+    EXPECT_EQ("<none>", find_path(tape, "id.x"));
+    EXPECT_EQ("<none>", find_path(tape, "user[0]"));
+    EXPECT_EQ("<none>", find_path(tape, "[0]"));
+}
+
+TEST(JSONTape, ParsePath) {
+    vector<json_path_step> steps;
+    parse_json_path("a.bc[3][10].d", steps);
+    ASSERT_EQ(5u, steps.size());
+    EXPECT_EQ("a", steps[0].name);
+    EXPECT_EQ(-1, steps[0].index);
+    EXPECT_EQ("bc", steps[1].name);
+    EXPECT_EQ(3, steps[2].index);
+    EXPECT_EQ(10, steps[3].index);
+    EXPECT_EQ("d", steps[4].name);
+    parse_json_path("[0].x", steps);
+    ASSERT_EQ(2u, steps.size());
+    EXPECT_EQ(0, steps[0].index);
+    EXPECT_EQ("x", steps[1].name);
+    parse_json_path("", steps);
+    EXPECT_TRUE(steps.empty());
+
+    EXPECT_THROW(parse_json_path(".a", steps), invalid_argument);
+    EXPECT_THROW(parse_json_path("a.", steps), invalid_argument);
+    EXPECT_THROW(parse_json_path("a..b", steps), invalid_argument);
+    EXPECT_THROW(parse_json_path("a[", steps), invalid_argument);
+    EXPECT_THROW(parse_json_path("a[-1]", steps), invalid_argument);
+    EXPECT_THROW(parse_json_path("a[1]b", steps), invalid_argument);
+}
@@ -12,6 +12,7 @@
 #include "inc_gtest.hpp"
 
 #include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
 #include <dynd/types/bytes_type.hpp>
 #include <dynd/types/string_type.hpp>
 
@@ -57,3 +58,28 @@ TEST(ArrayMemMap, SimpleString) {
     unlink("test.txt");
 #endif
 }
+
+TEST(ArrayMemMap, ParseJSONReference) {
+    const char *str = "{\"id\": 3, \"name\": \"mapped\"}";
+    write_string_file("test.json", str, strlen(str));
+    nd::array a = nd::memmap("test.json");
+    const bytes_type_data *src =
+        reinterpret_cast<const bytes_type_data *>(a.get_readonly_originptr());
+    nd::array n = parse_json(ndt::type("{id: int32, name: string}"), a,
+                             &eval::default_eval_context, true);
+    const string_type_data *name =
+        reinterpret_cast<const string_type_data *>(
+            n(1).get_readonly_originptr());
+    // The string points into the mapped file, which stays mapped
+    EXPECT_TRUE(src->begin <= name->begin && name->end <= src->end);
+    a = nd::array();
+    EXPECT_EQ(3, n(0).as<int>());
+    EXPECT_EQ("mapped", n(1).as<string>());
+    n = nd::array();
+
+#ifdef WIN32
+    _unlink("test.json");
+#else
+    unlink("test.json");
+#endif
+}
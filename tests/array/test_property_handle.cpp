@@ -0,0 +1,82 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/property_handle.hpp>
+#include <dynd/types/date_type.hpp>
+#include <dynd/types/property_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(PropertyHandle, Elwise) {
+    const char *strs0[] = {"1931-12-12", "2013-05-14", "2012-12-25"};
+    const char *strs1[] = {"1999-01-02", "2000-02-29", "1970-01-01"};
+    nd::array a = nd::array(strs0).ucast(ndt::make_date()).eval();
+    nd::array b = nd::array(strs1).ucast(ndt::make_date()).eval();
+
+    nd::property_handle year = a.get_type().resolve_property("year");
+    EXPECT_EQ("year", year.get_name());
+    EXPECT_EQ(a.get_type(), year.get_type());
+    EXPECT_FALSE(year.is_elwise());
+
+    // The first application finds out it's an element-wise property
+    nd::array y = year(a);
+    EXPECT_TRUE(year.is_elwise());
+    EXPECT_EQ(a.p("year").get_type(), y.get_type());
+    EXPECT_EQ(1931, y(0).as<int32_t>());
+    y = year(b);
+    EXPECT_EQ(a.p("year").get_type(), y.get_type());
+    EXPECT_EQ(2000, y(1).as<int32_t>());
+
+    // Evaluating reuses the getter for every array
+    nd::property_handle day = a.get_type().resolve_property("day");
+    for (int i = 0; i < 3; ++i) {
+        nd::array d = day.eval(i % 2 ? a : b);
+        EXPECT_EQ(ndt::type("3 * int32"), d.get_type());
+        if (i % 2) {
+            EXPECT_EQ(12, d(0).as<int32_t>());
+            EXPECT_EQ(14, d(1).as<int32_t>());
+            EXPECT_EQ(25, d(2).as<int32_t>());
+        } else {
+            EXPECT_EQ(2, d(0).as<int32_t>());
+            EXPECT_EQ(29, d(1).as<int32_t>());
+            EXPECT_EQ(1, d(2).as<int32_t>());
+        }
+    }
+
+    // Strided and multidimensional arrays
+    nd::array m = nd::empty(2, 3, ndt::make_date());
+    m(0).vals() = a;
+    m(1).vals() = b;
+    nd::property_handle month = m.get_type().resolve_property("month");
+    nd::array mo = month.eval(m);
+    EXPECT_EQ(ndt::type("2 * 3 * int32"), mo.get_type());
+    EXPECT_EQ(5, mo(0, 1).as<int32_t>());
+    EXPECT_EQ(1, mo(1, 2).as<int32_t>());
+    mo = month.eval(m);
+    EXPECT_EQ(12, mo(0, 2).as<int32_t>());
+    EXPECT_EQ(2, mo(1, 1).as<int32_t>());
+    nd::property_handle col_month = m(irange(), 1).get_type().resolve_property("month");
+    nd::array c = col_month.eval(m(irange(), 1));
+    EXPECT_EQ(5, c(0).as<int32_t>());
+    EXPECT_EQ(2, c(1).as<int32_t>());
+}
+
+TEST(PropertyHandle, Errors) {
+    nd::array a = nd::array("2001-02-03").ucast(ndt::make_date()).eval();
+    EXPECT_THROW(a.get_type().resolve_property("century"), runtime_error);
+    nd::property_handle year = a.get_type().resolve_property("year");
+    EXPECT_EQ(2001, year(a).as<int32_t>());
+    EXPECT_EQ(2001, year.eval(a).as<int32_t>());
+    // A handle only applies to the type it was resolved for
+    EXPECT_THROW(year(nd::array(1)), runtime_error);
+    EXPECT_THROW(year(nd::array()), runtime_error);
+}
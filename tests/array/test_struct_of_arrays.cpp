@@ -0,0 +1,78 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "inc_gtest.hpp"
+#include "../dynd_assertions.hpp"
+
+#include <dynd/struct_of_arrays.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(StructOfArrays, Type) {
+    ndt::type tp = ndt::make_struct_of_arrays(
+        10, ndt::type("{x : int32, y : string}"));
+    EXPECT_EQ(ndt::type("{x : 10 * int32, y : 10 * string}"), tp);
+    EXPECT_TRUE(ndt::is_struct_of_arrays(tp));
+    EXPECT_FALSE(ndt::is_struct_of_arrays(ndt::type("{x : int32, y : string}")));
+    EXPECT_FALSE(ndt::is_struct_of_arrays(
+        ndt::type("{x : 10 * int32, y : 9 * string}")));
+    EXPECT_FALSE(ndt::is_struct_of_arrays(ndt::type("10 * int32")));
+    EXPECT_THROW(ndt::make_struct_of_arrays(10, ndt::type("int32")),
+                 type_error);
+}
+
+TEST(StructOfArrays, RoundTrip) {
+    nd::array a = parse_json("4 * {x : int32, y : float64, s : string}",
+                             "[[1, 1.5, \"a\"], [2, 2.5, \"bc\"], "
+                             "[3, 3.5, \"\"], [4, 4.5, \"def\"]]");
+    nd::array b = nd::to_struct_of_arrays(a);
+    EXPECT_EQ(ndt::type("{x : 4 * int32, y : 4 * float64, s : 4 * string}"),
+              b.get_type());
+    // The same field access gives the same values, at unit stride
+    EXPECT_JSON_EQ_ARR("[1, 2, 3, 4]", b.p("x"));
+    EXPECT_JSON_EQ_ARR("[1.5, 2.5, 3.5, 4.5]", b.p("y"));
+    EXPECT_JSON_EQ_ARR("[\"a\", \"bc\", \"\", \"def\"]", b.p("s"));
+    EXPECT_JSON_EQ_ARR("[1, 2, 3, 4]", a.p("x"));
+    EXPECT_EQ(4, reinterpret_cast<const fixed_dim_type_arrmeta *>(
+                     b.p("x").get_arrmeta())->stride);
+    EXPECT_EQ(8, reinterpret_cast<const fixed_dim_type_arrmeta *>(
+                     b.p("y").get_arrmeta())->stride);
+
+    nd::array c = nd::to_array_of_structs(b);
+    EXPECT_EQ(a.get_type(), c.get_type());
+    EXPECT_JSON_EQ_ARR("[[1, 1.5, \"a\"], [2, 2.5, \"bc\"], [3, 3.5, \"\"], "
+                       "[4, 4.5, \"def\"]]", c);
+
+    EXPECT_THROW(nd::to_struct_of_arrays(b.p("x")), type_error);
+    EXPECT_THROW(nd::to_array_of_structs(a), type_error);
+}
+
+TEST(StructOfArrays, Blocked) {
+    // Enough rows to take several blocks, from a strided view
+    intptr_t n = 5000;
+    nd::array a = nd::empty(2 * n, ndt::type("{a : int64, b : int16, c : float32}"));
+    for (intptr_t i = 0; i < 2 * n; ++i) {
+        a(i, 0).vals() = i;
+        a(i, 1).vals() = (int16_t)(i % 1000);
+        a(i, 2).vals() = i * 0.5f;
+    }
+    nd::array b = nd::to_struct_of_arrays(a(irange().by(2)));
+    nd::array c = nd::to_array_of_structs(b);
+    for (intptr_t i = 0; i < n; ++i) {
+        ASSERT_EQ(2 * i, b.p("a")(i).as<int64_t>());
+        ASSERT_EQ((2 * i) % 1000, b.p("b")(i).as<int16_t>());
+        ASSERT_EQ(i * 1.0f, b.p("c")(i).as<float>());
+        ASSERT_EQ(2 * i, c(i, 0).as<int64_t>());
+        ASSERT_EQ((2 * i) % 1000, c(i, 1).as<int16_t>());
+        ASSERT_EQ(i * 1.0f, c(i, 2).as<float>());
+    }
+}
@@ -14,6 +14,7 @@
 #include <dynd/array.hpp>
 #include <dynd/func/apply_arrfunc.hpp>
 #include <dynd/func/call_callable.hpp>
+#include <dynd/func/lift_arrfunc.hpp>
 #include <dynd/types/cfixed_dim_type.hpp>
 
 #ifdef __CUDACC__
@@ -482,6 +483,96 @@ TYPED_TEST_P(Apply, CallableWithKeywords)
                     .template as<int>());
 }
 
+#ifndef __CUDACC__
+
+struct axpy_batch {
+  static int batch_calls;
+
+  double operator()(double x, double y) const { return 2.0 * x + y; }
+
+  void batch(double *dst, const double *x, const double *y, size_t count) const
+  {
+    ++batch_calls;
+    for (size_t i = 0; i != count; ++i) {
+      dst[i] = 2.0 * x[i] + y[i];
+    }
+  }
+};
+
+int axpy_batch::batch_calls = 0;
+
+TEST(Apply, UnitStride)
+{
+  double a_vals[6] = {1.5, -2.0, 3.25, 0.0, 7.0, -1.0};
+  double b_vals[6] = {0.5, 4.0, -1.0, 2.0, 3.5, 6.0};
+  nd::array a = a_vals, b = b_vals, c;
+
+  // Contiguous inputs go through the functor's batch overload
+  nd::arrfunc af = lift_arrfunc(nd::make_apply_arrfunc(axpy_batch()));
+  axpy_batch::batch_calls = 0;
+  c = af(a, b);
+  EXPECT_EQ(1, axpy_batch::batch_calls);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(2.0 * a_vals[i] + b_vals[i], c(i).as<double>());
+  }
+
+  // A broadcast scalar is gathered into a block for the batch overload
+  c = af(a, 10.0);
+  EXPECT_EQ(2, axpy_batch::batch_calls);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(2.0 * a_vals[i] + 10.0, c(i).as<double>());
+  }
+  c = af(10.0, b);
+  EXPECT_EQ(3, axpy_batch::batch_calls);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(20.0 + b_vals[i], c(i).as<double>());
+  }
+
+  // So are non-unit strides
+  c = af(a(irange().by(2)), b(irange().by(2)));
+  EXPECT_EQ(4, axpy_batch::batch_calls);
+  EXPECT_EQ(3, c.get_dim_size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(2.0 * a_vals[2 * i] + b_vals[2 * i], c(i).as<double>());
+  }
+
+  // Long strided runs are split into blocks of DYND_BUFFER_CHUNK_SIZE
+  intptr_t n = 2 * DYND_BUFFER_CHUNK_SIZE + 5;
+  nd::array x = nd::empty(2 * n, "float64"), y = nd::empty(n, "float64");
+  for (intptr_t i = 0; i < 2 * n; ++i) {
+    x(i).vals() = 0.25 * i;
+  }
+  for (intptr_t i = 0; i < n; ++i) {
+    y(i).vals() = -1.0 * i;
+  }
+  axpy_batch::batch_calls = 0;
+  c = af(x(irange().by(2)), y);
+  EXPECT_EQ(3, axpy_batch::batch_calls);
+  for (intptr_t i = 0; i < n; ++i) {
+    EXPECT_EQ(i - 1.0 * i, c(i).as<double>());
+  }
+  axpy_batch::batch_calls = 0;
+  c = nd::empty(2 * n, "float64");
+  af.call_out(y, 1.5, c(irange().by(2)));
+  EXPECT_EQ(3, axpy_batch::batch_calls);
+  for (intptr_t i = 0; i < n; ++i) {
+    EXPECT_EQ(-2.0 * i + 1.5, c(2 * i).as<double>());
+  }
+
+  // Functions without a batch overload use the contiguous loops
+  af = lift_arrfunc(nd::make_apply_arrfunc<decltype(&func0), &func0>());
+  int x_vals[4] = {5, 1, -3, 8}, y_vals[4] = {3, 4, 2, 8};
+  x = x_vals;
+  y = y_vals;
+  EXPECT_JSON_EQ_ARR("[4, -6, -10, 0]", af(x, y));
+  EXPECT_JSON_EQ_ARR("[8, 0, -8, 14]", af(x, 1));
+  af = lift_arrfunc(nd::make_apply_arrfunc(&func0));
+  EXPECT_JSON_EQ_ARR("[4, -6, -10, 0]", af(x, y));
+  EXPECT_JSON_EQ_ARR("[-4, 4, 12, -10]", af(3, x));
+}
+
+#endif
+
 typedef integral_constant<kernel_request_t, kernel_request_host>
     kernel_request_host_type;
 typedef integral_constant<kernel_request_t, kernel_request_cuda_device>
@@ -0,0 +1,186 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <sstream>
+#include <vector>
+#include <cmath>
+
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/parallel.hpp>
+#include <dynd/func/arrfunc.hpp>
+#include <dynd/func/lift_arrfunc.hpp>
+#include <dynd/func/rolling_arrfunc.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+/** A leaf ckernel which remembers the values it has seen */
+struct remember_ck : public kernels::unary_ck<remember_ck> {
+  vector<int> m_seen;
+
+  inline void single(char *dst, char *src)
+  {
+    m_seen.push_back(*reinterpret_cast<int *>(src));
+    *reinterpret_cast<int *>(dst) = (int)m_seen.size();
+  }
+};
+
+/** A ckernel which destroys its child, but does not know how to clone it */
+struct no_clone_ck : public kernels::unary_ck<no_clone_ck> {
+  inline void single(char *dst, char *src)
+  {
+    ckernel_prefix *child = get_child_ckernel();
+    expr_single_t child_fn = child->get_function<expr_single_t>();
+    child_fn(dst, &src, child);
+  }
+
+  inline void destruct_children() { get_child_ckernel()->destroy(); }
+};
+
+void noop_destruct(ckernel_prefix *DYND_UNUSED(self)) {}
+
+void instantiate_single(const nd::arrfunc &af,
+                        ckernel_builder<kernel_request_host> &ckb,
+                        const nd::array &dst, const nd::array &src)
+{
+  const char *src_arrmeta = src.get_arrmeta();
+  af.get()->instantiate(af.get(), af.get_type(), &ckb, 0, dst.get_type(),
+                        dst.get_arrmeta(), &src.get_type(), &src_arrmeta,
+                        kernel_request_single, &eval::default_eval_context,
+                        nd::array(), nd::array());
+}
+
+void call(ckernel_builder<kernel_request_host> &ckb, const nd::array &dst,
+          const nd::array &src)
+{
+  char *src_data = const_cast<char *>(src.get_readonly_originptr());
+  ckb.get()->get_function<expr_single_t>()(dst.get_readwrite_originptr(),
+                                           &src_data, ckb.get());
+}
+} // anonymous namespace
+
+TEST(CKernelClone, State) {
+  ckernel_builder<kernel_request_host> ckb, clone;
+  intptr_t ckb_offset = 0;
+  remember_ck::create_leaf(&ckb, kernel_request_single, ckb_offset);
+  int src = 5, dst = 0;
+  char *src_ptr = reinterpret_cast<char *>(&src);
+  expr_single_t fn = ckb.get()->get_function<expr_single_t>();
+  fn(reinterpret_cast<char *>(&dst), &src_ptr, ckb.get());
+  EXPECT_EQ(1, dst);
+
+  // The clone starts with a copy of the state, then goes its own way
+  ckb.clone(clone);
+  fn(reinterpret_cast<char *>(&dst), &src_ptr, clone.get());
+  EXPECT_EQ(2, dst);
+  fn(reinterpret_cast<char *>(&dst), &src_ptr, clone.get());
+  EXPECT_EQ(3, dst);
+  EXPECT_EQ(1u, remember_ck::get_self(ckb.get())->m_seen.size());
+  EXPECT_EQ(3u, remember_ck::get_self(clone.get())->m_seen.size());
+}
+
+TEST(CKernelClone, NotClonable) {
+  ckernel_builder<kernel_request_host> ckb, clone;
+  intptr_t ckb_offset = 0;
+  no_clone_ck::create(&ckb, kernel_request_single, ckb_offset);
+  remember_ck::create_leaf(&ckb, kernel_request_single, ckb_offset);
+  EXPECT_THROW(ckb.clone(clone), runtime_error);
+  EXPECT_TRUE(clone.get()->function == NULL);
+  EXPECT_TRUE(clone.get()->destructor == NULL);
+
+  // A ckernel whose destructor has no clone function registered
+  ckernel_builder<kernel_request_host> ckb2;
+  ckb_offset = 0;
+  ckb2.alloc_ck_leaf<ckernel_prefix>(ckb_offset)->destructor = &noop_destruct;
+  EXPECT_THROW(ckb2.clone(clone), runtime_error);
+
+  // A ckernel without a destructor owns nothing, and its copy is a clone
+  ckernel_builder<kernel_request_host> empty;
+  empty.clone(clone);
+  EXPECT_TRUE(clone.get()->function == NULL);
+}
+
+TEST(CKernelClone, Lifted) {
+  nd::arrfunc af = lift_arrfunc(make_arrfunc_from_assignment(
+      ndt::make_type<int>(), ndt::type("string[16]"), assign_error_default));
+  nd::array src = nd::empty("3 * string[16]");
+  src(0).vals() = "172";
+  src(1).vals() = "-139";
+  src(2).vals() = "12345";
+  nd::array dst = nd::empty("3 * int32");
+
+  ckernel_builder<kernel_request_host> ckb, clone;
+  instantiate_single(af, ckb, dst, src);
+  ckb.clone(clone);
+  // The clone doesn't need the original
+  ckb.reset();
+  call(clone, dst, src);
+  EXPECT_EQ(172, dst(0).as<int>());
+  EXPECT_EQ(-139, dst(1).as<int>());
+  EXPECT_EQ(12345, dst(2).as<int>());
+}
+
+TEST(CKernelClone, Threads) {
+  nd::arrfunc af = lift_arrfunc(make_arrfunc_from_assignment(
+      ndt::make_type<int>(), ndt::type("string[16]"), assign_error_default));
+  const intptr_t rows = 64, nthreads = 4;
+  nd::array src = nd::empty(rows, 8, "string[16]");
+  for (intptr_t i = 0; i < rows; ++i) {
+    for (intptr_t j = 0; j < 8; ++j) {
+      stringstream ss;
+      ss << i * 100 + j;
+      src(i, j).vals() = ss.str();
+    }
+  }
+  nd::array dst = nd::empty(rows, 8, "int32");
+
+  // One ckernel per thread, for rows of 8 values
+  ckernel_builder<kernel_request_host> ckb;
+  instantiate_single(af, ckb, dst(0), src(0));
+  vector<ckernel_builder<kernel_request_host> > clones(nthreads);
+  for (intptr_t t = 0; t < nthreads; ++t) {
+    ckb.clone(clones[t]);
+  }
+  parallel::parallel_for(rows, nthreads, 1,
+                         [&](intptr_t t, intptr_t begin, intptr_t end) {
+    for (intptr_t i = begin; i < end; ++i) {
+      call(clones[t], dst(i), src(i));
+    }
+  });
+  for (intptr_t i = 0; i < rows; ++i) {
+    for (intptr_t j = 0; j < 8; ++j) {
+      ASSERT_EQ(i * 100 + j, dst(i, j).as<int>());
+    }
+  }
+}
+
+TEST(CKernelClone, Rolling) {
+  nd::arrfunc rolling_sum = make_rolling_arrfunc(
+      kernels::make_builtin_sum1d_arrfunc(float64_type_id), 4);
+  double adata[] = {1, 3, 7, 2, 9, 4, -5, 100, 2, -20, 3, 9, 18};
+  nd::array src = adata;
+  nd::array expected = rolling_sum(src);
+  nd::array dst = nd::empty(src.get_type());
+
+  ckernel_builder<kernel_request_host> ckb, clone;
+  instantiate_single(rolling_sum, ckb, dst, src);
+  ckb.clone(clone);
+  // The clone shares the window op arrmeta the original made
+  ckb.reset();
+  call(clone, dst, src);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(DYND_ISNAN(dst(i).as<double>()));
+  }
+  for (int i = 3; i < 13; ++i) {
+    EXPECT_EQ(expected(i).as<double>(), dst(i).as<double>());
+  }
+}
@@ -0,0 +1,112 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <sstream>
+
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/func/json_get_arrfunc.hpp>
+#include <dynd/func/lift_arrfunc.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+nd::array make_documents(int n)
+{
+    stringstream ss;
+    ss << "[";
+    for (int i = 0; i < n; ++i) {
+        ss << (i == 0 ? "" : ", ") << "{\"id\": " << i
+           << ", \"pad\": \"" << string(i % 70, 'x') << "\", \"user\": "
+           << "{\"name\": \"u" << i << "\", \"scores\": [" << i << ", "
+           << 2 * i << "]}";
+        if (i % 3 == 0) {
+            ss << ", \"extra\": " << i;
+        }
+        ss << "}";
+    }
+    ss << "]";
+    stringstream tp;
+    tp << n << " * json";
+    return parse_json(ndt::type(tp.str()), ss.str(),
+                      &eval::default_eval_context);
+}
+} // anonymous namespace
+
+TEST(JSONGet, Value) {
+    nd::array docs = make_documents(200);
+    nd::arrfunc get_score =
+        lift_arrfunc(make_json_get_arrfunc("user.scores[1]",
+                                           ndt::make_type<int64_t>()));
+    nd::array a = get_score(docs);
+    EXPECT_EQ(ndt::type("200 * int64"), a.get_type());
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_EQ(2 * i, a(i).as<int64_t>());
+    }
+
+    nd::arrfunc get_name = lift_arrfunc(
+        make_json_get_arrfunc("user.name", ndt::make_string()));
+    a = get_name(docs);
+    EXPECT_EQ("u17", a(17).as<string>());
+
+    // By default, the JSON text of the value
+    nd::arrfunc get_user = make_json_get_arrfunc("user");
+    a = get_user(docs(5));
+    EXPECT_EQ(ndt::make_json(), a.get_type());
+    EXPECT_EQ("{\"name\": \"u5\", \"scores\": [5, 10]}", a.as<string>());
+}
+
+TEST(JSONGet, Missing) {
+    nd::array docs = make_documents(10);
+    nd::arrfunc get_extra = lift_arrfunc(
+        make_json_get_arrfunc("extra", ndt::make_option<int32_t>()));
+    nd::array a = get_extra(docs);
+    for (int i = 0; i < 10; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_EQ(i, a(i).as<int32_t>());
+        } else {
+            EXPECT_TRUE(a(i).is_missing());
+        }
+    }
+
+    get_extra = lift_arrfunc(
+        make_json_get_arrfunc("extra", ndt::make_type<int32_t>()));
+    EXPECT_THROW(get_extra(docs), invalid_argument);
+    // A value of the wrong kind is a parse error
+    nd::arrfunc get_name = lift_arrfunc(
+        make_json_get_arrfunc("user.name", ndt::make_type<int32_t>()));
+    EXPECT_THROW(get_name(docs), invalid_argument);
+    EXPECT_THROW(make_json_get_arrfunc("a..b"), invalid_argument);
+}
+
+TEST(JSONGet, Struct) {
+    nd::array docs = make_documents(100);
+    vector<string> paths;
+    paths.push_back("id");
+    paths.push_back("user.scores[0]");
+    paths.push_back("extra");
+    nd::arrfunc get = lift_arrfunc(make_json_get_arrfunc(
+        paths, ndt::type("{id: int32, score: float64, extra: ?int32}")));
+    nd::array a = get(docs);
+    EXPECT_EQ(ndt::type("100 * {id: int32, score: float64, extra: ?int32}"),
+              a.get_type());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(i, a(i, 0).as<int32_t>());
+        ASSERT_EQ(i, a(i, 1).as<double>());
+        ASSERT_EQ(i % 3 != 0, a(i, 2).is_missing());
+    }
+
+    EXPECT_THROW(make_json_get_arrfunc(paths, ndt::type("{id: int32}")),
+                 invalid_argument);
+    EXPECT_THROW(make_json_get_arrfunc(paths, ndt::type("3 * int32")),
+                 type_error);
+}
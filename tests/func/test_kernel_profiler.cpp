@@ -0,0 +1,94 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/func/arrfunc.hpp>
+#include <dynd/func/lift_arrfunc.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/kernel_profiler.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(KernelProfiler, ArrFuncTree) {
+    kernels::kernel_profiler prof;
+    eval::eval_context ectx;
+    ectx.profiler = &prof;
+
+    nd::arrfunc af = lift_arrfunc(make_arrfunc_from_assignment(
+        ndt::make_type<int>(), ndt::make_string(), assign_error_default));
+    const char *in[3] = {"172", "-139", "12345"};
+    nd::array a = nd::empty("3 * string");
+    a.vals() = in;
+    nd::array b;
+    // Calling twice adds to the same tree
+    for (int i = 0; i < 2; ++i) {
+        b = af.call(1, &a, &ectx);
+        EXPECT_EQ(ndt::type("3 * int32"), b.get_type());
+        EXPECT_EQ(-139, b(1).as<int>());
+    }
+
+    kernels::kernel_profile_node *root = prof.get_root();
+    ASSERT_EQ(1u, root->children.size());
+    kernels::kernel_profile_node *lifted = root->children[0];
+    EXPECT_EQ("(3 * string) -> 3 * int32", lifted->name);
+    EXPECT_EQ(kernel_request_single, lifted->kernreq);
+    EXPECT_EQ(2u, lifted->calls.load());
+    EXPECT_EQ(2u, lifted->elements.load());
+    ASSERT_EQ(1u, lifted->children.size());
+    kernels::kernel_profile_node *el = lifted->children[0];
+    EXPECT_EQ("(string) -> int32", el->name);
+    EXPECT_EQ(kernel_request_strided, el->kernreq);
+    EXPECT_EQ(2u, el->calls.load());
+    EXPECT_EQ(6u, el->elements.load());
+    EXPECT_LE(el->cycles.load(), lifted->cycles.load());
+
+    string text = prof.to_text();
+    EXPECT_NE(string::npos, text.find("single (3 * string) -> 3 * int32"));
+    EXPECT_NE(string::npos, text.find("  strided (string) -> int32"));
+    string json = prof.to_json();
+    EXPECT_EQ(0u, json.find("[{\"name\": \"(3 * string) -> 3 * int32\", "
+                            "\"request\": \"single\", \"calls\": 2, "
+                            "\"elements\": 2, \"cycles\": "));
+
+    prof.reset();
+    EXPECT_EQ(0u, lifted->calls.load());
+    EXPECT_EQ(0u, el->elements.load());
+    EXPECT_EQ(1u, root->children.size());
+}
+
+TEST(KernelProfiler, Assignment) {
+    kernels::kernel_profiler prof;
+    eval::eval_context ectx;
+    ectx.profiler = &prof;
+
+    int vals[4] = {1, 2, 3, 4};
+    nd::array a = vals;
+    nd::array b = nd::empty(4, ndt::make_type<double>());
+    b.val_assign(a, &ectx);
+    EXPECT_EQ(3.0, b(2).as<double>());
+
+    kernels::kernel_profile_node *root = prof.get_root();
+    ASSERT_EQ(1u, root->children.size());
+    kernels::kernel_profile_node *node = root->children[0];
+    EXPECT_EQ("assign (4 * int32) -> 4 * float64", node->name);
+    EXPECT_EQ(1u, node->calls.load());
+    ASSERT_EQ(1u, node->children.size());
+    EXPECT_EQ("assign (int32) -> float64", node->children[0]->name);
+    EXPECT_EQ(kernel_request_strided, node->children[0]->kernreq);
+    EXPECT_EQ(4u, node->children[0]->elements.load());
+
+    // Without a profiler in the context, nothing is recorded
+    eval::eval_context plain_ectx;
+    b.val_assign(a, &plain_ectx);
+    EXPECT_EQ(1u, node->calls.load());
+}
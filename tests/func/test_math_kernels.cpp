@@ -0,0 +1,220 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "inc_gtest.hpp"
+#include "../dynd_assertions.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/func/arrfunc_registry.hpp>
+#include <dynd/kernels/math_kernels.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+// The distance between a and b in units in the last place
+template <typename T>
+double ulp_diff(T a, T b)
+{
+  if (a == b || (a != a && b != b)) {
+    return 0;
+  }
+  if (a != a || b != b) {
+    return numeric_limits<double>::infinity();
+  }
+  T scale = std::abs(b) < numeric_limits<T>::min() ? numeric_limits<T>::min()
+                                                   : std::abs(b);
+  int e;
+  frexp(scale, &e);
+  return std::abs((double)a - (double)b) /
+         ldexp(1.0, e - numeric_limits<T>::digits);
+}
+
+// The largest ulp error of the vectorized function over the inputs
+template <typename T>
+double max_ulp(void (*vf)(T *, const T *, size_t), double (*ref)(double),
+               const vector<T> &x)
+{
+  vector<T> y(x.size());
+  vf(&y[0], &x[0], x.size());
+  double result = 0;
+  for (size_t i = 0; i < x.size(); ++i) {
+    T expected = static_cast<T>(ref(x[i]));
+    result = std::max(result, ulp_diff(y[i], expected));
+  }
+  return result;
+}
+
+template <typename T>
+vector<T> uniform_inputs(double lo, double hi, size_t count)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<double> dist(lo, hi);
+  vector<T> result(count);
+  for (size_t i = 0; i < count; ++i) {
+    result[i] = static_cast<T>(dist(gen));
+  }
+  return result;
+}
+
+// Inputs spread over the whole positive range of exponents
+template <typename T>
+vector<T> log_inputs(size_t count)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<double> mant(1.0, 2.0);
+  std::uniform_int_distribution<int> expo(numeric_limits<T>::min_exponent - 1,
+                                          numeric_limits<T>::max_exponent - 1);
+  vector<T> result(count);
+  for (size_t i = 0; i < count; ++i) {
+    result[i] = static_cast<T>(ldexp(mant(gen), expo(gen)));
+  }
+  return result;
+}
+
+template <typename T>
+vector<T> special_inputs()
+{
+  vector<T> result;
+  result.push_back(0);
+  result.push_back(-T(0));
+  result.push_back(1);
+  result.push_back(-1);
+  result.push_back(numeric_limits<T>::infinity());
+  result.push_back(-numeric_limits<T>::infinity());
+  result.push_back(numeric_limits<T>::quiet_NaN());
+  result.push_back(numeric_limits<T>::min());
+  result.push_back(numeric_limits<T>::denorm_min());
+  result.push_back(-numeric_limits<T>::denorm_min());
+  result.push_back(numeric_limits<T>::max());
+  result.push_back(-numeric_limits<T>::max());
+  result.push_back(T(708.5));
+  result.push_back(T(-745.5));
+  result.push_back(T(1e22));
+  result.push_back(T(3.14159265358979323846));
+  result.push_back(T(1.57079632679489661923));
+  return result;
+}
+
+// Special values must match the C library exactly, including zero signs
+template <typename T>
+void check_special(void (*vf)(T *, const T *, size_t), double (*ref)(double),
+                   const char *name)
+{
+  vector<T> x = special_inputs<T>();
+  vector<T> y(x.size());
+  vf(&y[0], &x[0], x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    T expected = static_cast<T>(ref(x[i]));
+    if (expected != expected) {
+      EXPECT_NE(y[i], y[i]) << name << "(" << x[i] << ")";
+    } else if (expected == 0 || std::abs(expected) == numeric_limits<T>::infinity()) {
+      EXPECT_EQ(expected, y[i]) << name << "(" << x[i] << ")";
+      EXPECT_EQ(signbit(expected), signbit(y[i])) << name << "(" << x[i] << ")";
+    } else {
+      EXPECT_GE(1.0, ulp_diff(y[i], expected)) << name << "(" << x[i] << ")";
+    }
+  }
+}
+
+} // anonymous namespace
+
+TEST(MathKernels, ISA) {
+  string isa = kernels::vmath::get_isa();
+  EXPECT_TRUE(isa == "avx512f" || isa == "avx2" || isa == "default");
+}
+
+TEST(MathKernels, Float64Accuracy) {
+  EXPECT_GE(1.0, max_ulp<double>(&kernels::vmath::exp, &::exp,
+                                 uniform_inputs<double>(-745, 710, 20000)));
+  EXPECT_GE(1.0, max_ulp<double>(&kernels::vmath::log, &::log,
+                                 log_inputs<double>(20000)));
+  EXPECT_GE(1.0, max_ulp<double>(&kernels::vmath::log, &::log,
+                                 uniform_inputs<double>(0.5, 2, 20000)));
+  EXPECT_GE(2.0, max_ulp<double>(&kernels::vmath::sin, &::sin,
+                                 uniform_inputs<double>(-100, 100, 20000)));
+  EXPECT_GE(2.0, max_ulp<double>(&kernels::vmath::cos, &::cos,
+                                 uniform_inputs<double>(-100, 100, 20000)));
+  EXPECT_GE(2.0, max_ulp<double>(&kernels::vmath::sin, &::sin,
+                                 uniform_inputs<double>(-1e7, 1e7, 20000)));
+  EXPECT_GE(2.0, max_ulp<double>(&kernels::vmath::tanh, &::tanh,
+                                 uniform_inputs<double>(-1, 1, 20000)));
+  EXPECT_GE(2.0, max_ulp<double>(&kernels::vmath::tanh, &::tanh,
+                                 uniform_inputs<double>(-30, 30, 20000)));
+}
+
+TEST(MathKernels, Float32Accuracy) {
+  EXPECT_GE(1.0, max_ulp<float>(&kernels::vmath::exp, &::exp,
+                                uniform_inputs<float>(-104, 89, 20000)));
+  EXPECT_GE(1.0, max_ulp<float>(&kernels::vmath::log, &::log,
+                                log_inputs<float>(20000)));
+  EXPECT_GE(1.0, max_ulp<float>(&kernels::vmath::sin, &::sin,
+                                uniform_inputs<float>(-100, 100, 20000)));
+  EXPECT_GE(1.0, max_ulp<float>(&kernels::vmath::cos, &::cos,
+                                uniform_inputs<float>(-100, 100, 20000)));
+  EXPECT_GE(1.0, max_ulp<float>(&kernels::vmath::tanh, &::tanh,
+                                uniform_inputs<float>(-10, 10, 20000)));
+}
+
+TEST(MathKernels, SpecialValues) {
+  check_special<double>(&kernels::vmath::exp, &::exp, "exp");
+  check_special<double>(&kernels::vmath::log, &::log, "log");
+  check_special<double>(&kernels::vmath::sin, &::sin, "sin");
+  check_special<double>(&kernels::vmath::cos, &::cos, "cos");
+  check_special<double>(&kernels::vmath::tanh, &::tanh, "tanh");
+  check_special<float>(&kernels::vmath::exp, &::exp, "exp");
+  check_special<float>(&kernels::vmath::log, &::log, "log");
+  check_special<float>(&kernels::vmath::sin, &::sin, "sin");
+  check_special<float>(&kernels::vmath::cos, &::cos, "cos");
+  check_special<float>(&kernels::vmath::tanh, &::tanh, "tanh");
+}
+
+TEST(MathKernels, InPlace) {
+  // Longer than one internal block, with out of range values mixed in
+  vector<double> x = uniform_inputs<double>(-800, 800, 1000);
+  vector<double> expected(x.size()), y(x);
+  kernels::vmath::exp(&expected[0], &x[0], x.size());
+  kernels::vmath::exp(&y[0], &y[0], y.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    EXPECT_EQ(expected[i], y[i]);
+  }
+}
+
+TEST(MathKernels, Registry) {
+  vector<double> x = uniform_inputs<double>(-5, 5, 300);
+  nd::array a = nd::empty(x.size(), ndt::make_type<double>());
+  memcpy(a.get_readwrite_originptr(), &x[0], x.size() * sizeof(double));
+
+  const char *names[] = {"exp", "sin", "cos", "tanh"};
+  void (*fns[])(double *, const double *, size_t) = {
+      &kernels::vmath::exp, &kernels::vmath::sin, &kernels::vmath::cos,
+      &kernels::vmath::tanh};
+  for (int j = 0; j < 4; ++j) {
+    nd::array b = func::get_regfunction(names[j])(a);
+    vector<double> expected(x.size());
+    fns[j](&expected[0], &x[0], x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+      EXPECT_EQ(expected[i], b(i).as<double>()) << names[j];
+    }
+    // A strided view goes through the scalar path with the same results
+    nd::array c = func::get_regfunction(names[j])(a(irange().by(3)));
+    for (size_t i = 0; i < x.size(); i += 3) {
+      EXPECT_EQ(expected[i], c(i / 3).as<double>()) << names[j];
+    }
+  }
+
+  nd::array b = func::get_regfunction("log")(nd::array(1.0f));
+  EXPECT_EQ(0.0f, b.as<float>());
+  EXPECT_DOUBLE_EQ(1.0, func::get_regfunction("log")(exp(1.0)).as<double>());
+}
@@ -171,6 +171,87 @@ TEST(Neighborhood, Sum3D) {
         "[[true, false, true], [false, true, false], [true, false, true]]]"), "offset", parse_json("3 * int", "[-1, -1, -1]"))));
 }
 
+TEST(Neighborhood, Sum2DTiled) {
+    nd::arrfunc af = make_neighborhood_arrfunc(nd::make_apply_arrfunc(sum<2>), 2);
+    nd::array a;
+
+    a = parse_json("6 * 5 * int",
+        "[[0, 1, 2, 3, 4], [5, 6, 7, 8, 9], [10, 11, 12, 13, 14],"
+        "[15, 16, 17, 18, 19], [20, 21, 22, 23, 24], [25, 26, 27, 28, 29]]");
+
+    // Tiles which split the innermost dimension unevenly, across the boundaries
+    for (int tile_size = 1; tile_size <= 6; ++tile_size) {
+        EXPECT_JSON_EQ_ARR("[[300, 250, 195, 135, 70], [425, 350, 270, 185, 95], [390, 320, 246, 168, 86],"
+            "[330, 270, 207, 141, 72], [245, 200, 153, 104, 53], [135, 110, 84, 57, 29]]",
+            af(a, kwds("shape", parse_json("2 * int", "[5, 5]"), "tile_size", tile_size)));
+
+        EXPECT_JSON_EQ_ARR("[[0, 1, 3, 6, 9], [5, 12, 20, 25, 30], [15, 28, 47, 54, 61],"
+            "[30, 48, 82, 89, 96], [45, 68, 117, 124, 131], [60, 88, 152, 159, 166]]",
+            af(a, kwds("mask", parse_json("3 * 3 * bool", "[[true, false, true], [true, false, true], [true, true, true]]"),
+            "offset", parse_json("2 * int", "[-2, -2]"), "tile_size", tile_size)));
+    }
+}
+
+TEST(Neighborhood, Sum2DThreaded) {
+    nd::arrfunc af = make_neighborhood_arrfunc(nd::make_apply_arrfunc(sum<2>), 2);
+    nd::array a;
+
+    a = parse_json("6 * 5 * int",
+        "[[0, 1, 2, 3, 4], [5, 6, 7, 8, 9], [10, 11, 12, 13, 14],"
+        "[15, 16, 17, 18, 19], [20, 21, 22, 23, 24], [25, 26, 27, 28, 29]]");
+
+    for (int nthreads = 1; nthreads <= 8; ++nthreads) {
+        EXPECT_JSON_EQ_ARR("[[54, 78, 105, 90, 72], [102, 144, 190, 160, 126], [165, 230, 300, 250, 195],"
+            "[240, 330, 425, 350, 270], [222, 304, 390, 320, 246], [189, 258, 330, 270, 207]]",
+            af(a, kwds("shape", parse_json("2 * int", "[5, 5]"), "offset", parse_json("2 * int", "[-2, -2]"),
+            "nthreads", nthreads)));
+
+        EXPECT_JSON_EQ_ARR("[[54, 78, 105, 90, 72], [102, 144, 190, 160, 126], [165, 230, 300, 250, 195],"
+            "[240, 330, 425, 350, 270], [222, 304, 390, 320, 246], [189, 258, 330, 270, 207]]",
+            af(a, kwds("shape", parse_json("2 * int", "[5, 5]"), "offset", parse_json("2 * int", "[-2, -2]"),
+            "nthreads", nthreads, "tile_size", 2)));
+    }
+}
+
+TEST(Neighborhood, SeparableSum2D) {
+    nd::arrfunc af = make_separable_neighborhood_arrfunc(nd::make_apply_arrfunc(sum<1>), 2);
+    nd::array a;
+
+    a = parse_json("4 * 4 * int",
+        "[[0, 1, 2, 3], [4, 5, 6, 7], [8, 9, 10, 11], [12, 13, 14, 15]]");
+
+    EXPECT_JSON_EQ_ARR("[[45, 54, 39, 21], [81, 90, 63, 33], [66, 72, 50, 26], [39, 42, 29, 15]]",
+        af(a, kwds("shape", parse_json("2 * int", "[3, 3]"))));
+
+    EXPECT_JSON_EQ_ARR("[[10, 18, 24, 18], [27, 45, 54, 39], [51, 81, 90, 63], [42, 66, 72, 50]]",
+        af(a, kwds("shape", parse_json("2 * int", "[3, 3]"), "offset", parse_json("2 * int", "[-1, -1]"))));
+
+    a = parse_json("6 * 5 * int",
+        "[[0, 1, 2, 3, 4], [5, 6, 7, 8, 9], [10, 11, 12, 13, 14],"
+        "[15, 16, 17, 18, 19], [20, 21, 22, 23, 24], [25, 26, 27, 28, 29]]");
+
+    EXPECT_JSON_EQ_ARR("[[32, 40, 33, 24, 13], [72, 80, 63, 44, 23], [112, 120, 93, 64, 33],"
+        "[152, 160, 123, 84, 43], [192, 200, 153, 104, 53], [106, 110, 84, 57, 29]]",
+        af(a, kwds("shape", parse_json("2 * int", "[2, 4]"), "nthreads", 3)));
+}
+
+TEST(Neighborhood, SeparableSum3D) {
+    nd::arrfunc af = make_separable_neighborhood_arrfunc(nd::make_apply_arrfunc(sum<1>), 3);
+    nd::array a;
+
+    a = parse_json("4 * 4 * 4 * int",
+        "[[[0, 1, 2, 3], [4, 5, 6, 7], [8, 9, 10, 11], [12, 13, 14, 15]],"
+        "[[16, 17, 18, 19], [20, 21, 22, 23], [24, 25, 26, 27], [28, 29, 30, 31]],"
+        "[[32, 33, 34, 35], [36, 37, 38, 39], [40, 41, 42, 43], [44, 45, 46, 47]],"
+        "[[48, 49, 50, 51], [52, 53, 54, 55], [56, 57, 58, 59], [60, 61, 62, 63]]]");
+
+    EXPECT_JSON_EQ_ARR("[[[567, 594, 405, 207], [675, 702, 477, 243], [486, 504, 342, 174], [261, 270, 183, 93]],"
+        "[[999, 1026, 693, 351], [1107, 1134, 765, 387], [774, 792, 534, 270], [405, 414, 279, 141]],"
+        "[[810, 828, 558, 282], [882, 900, 606, 306], [612, 624, 420, 212], [318, 324, 218, 110]],"
+        "[[477, 486, 327, 165], [513, 522, 351, 177], [354, 360, 242, 122], [183, 186, 125, 63]]]",
+        af(a, kwds("shape", parse_json("3 * int", "[3, 3, 3]"))));
+}
+
 /*
     Todo: Make this 3D test pass.
 
@@ -0,0 +1,182 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/random.hpp>
+#include <dynd/parallel.hpp>
+#include <dynd/func/random_arrfunc.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Random, PhiloxKnownAnswers) {
+    // Known answer vectors from the Random123 distribution
+    uint32_t out[4];
+    uint32_t ctr0[4] = {0, 0, 0, 0}, key0[2] = {0, 0};
+    philox4x32_10(ctr0, key0, out);
+    EXPECT_EQ(0x6627e8d5u, out[0]);
+    EXPECT_EQ(0xe169c58du, out[1]);
+    EXPECT_EQ(0xbc57ac4cu, out[2]);
+    EXPECT_EQ(0x9b00dbd8u, out[3]);
+
+    uint32_t ctr1[4] = {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu};
+    uint32_t key1[2] = {0xffffffffu, 0xffffffffu};
+    philox4x32_10(ctr1, key1, out);
+    EXPECT_EQ(0x408f276du, out[0]);
+    EXPECT_EQ(0x41c83b0eu, out[1]);
+    EXPECT_EQ(0xa20bc7c6u, out[2]);
+    EXPECT_EQ(0x6d5451fdu, out[3]);
+
+    uint32_t ctr2[4] = {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u};
+    uint32_t key2[2] = {0xa4093822u, 0x299f31d0u};
+    philox4x32_10(ctr2, key2, out);
+    EXPECT_EQ(0xd16cfe09u, out[0]);
+    EXPECT_EQ(0x94fdccebu, out[1]);
+    EXPECT_EQ(0x5001e420u, out[2]);
+    EXPECT_EQ(0x24126ea1u, out[3]);
+}
+
+TEST(Random, FillWords) {
+    // Any range of a stream matches the same words from the whole stream
+    vector<uint32_t> all(103), part(50);
+    philox_fill_words(12, 3, 0, all.size(), &all[0]);
+    for (size_t first = 0; first < 8; ++first) {
+        philox_fill_words(12, 3, first + 45, part.size(), &part[0]);
+        for (size_t i = 0; i < part.size(); ++i) {
+            EXPECT_EQ(all[first + 45 + i], part[i]);
+        }
+    }
+    // Other streams and seeds differ
+    philox_fill_words(12, 4, 0, part.size(), &part[0]);
+    EXPECT_NE(all[0], part[0]);
+    philox_fill_words(13, 3, 0, part.size(), &part[0]);
+    EXPECT_NE(all[0], part[0]);
+}
+
+TEST(Random, UniformDeterministic) {
+    nd::arrfunc af = make_uniform_arrfunc(42, 0, -2.0, 3.0);
+    intptr_t n = 300000;
+    nd::array a = nd::empty(n, ndt::make_type<double>());
+    nd::array b = nd::empty(n, ndt::make_type<double>());
+    intptr_t nthreads = parallel::get_num_threads();
+    parallel::set_num_threads(1);
+    af.call_out(a);
+    parallel::set_num_threads(4);
+    af.call_out(b);
+    parallel::set_num_threads(nthreads);
+    EXPECT_EQ(0, memcmp(a.get_readonly_originptr(), b.get_readonly_originptr(),
+                        n * sizeof(double)));
+
+    const double *v = reinterpret_cast<const double *>(a.get_readonly_originptr());
+    double sum = 0;
+    for (intptr_t i = 0; i < n; ++i) {
+        EXPECT_LE(-2.0, v[i]);
+        EXPECT_GT(3.0, v[i]);
+        sum += v[i];
+    }
+    EXPECT_NEAR(0.5, sum / n, 0.02);
+
+    // A strided view gets the same values as a contiguous array
+    nd::array c = nd::empty(4, 3, ndt::make_type<double>());
+    nd::array d = nd::empty(3, 4, ndt::make_type<double>());
+    af.call_out(c);
+    af.call_out(d.permute(2, &std::vector<intptr_t>({1, 0})[0]));
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            EXPECT_EQ(v[i * 3 + j], c(i, j).as<double>());
+            EXPECT_EQ(v[i * 3 + j], d(j, i).as<double>());
+        }
+    }
+
+    // A different stream gives different values
+    make_uniform_arrfunc(42, 1, -2.0, 3.0).call_out(c);
+    EXPECT_NE(v[0], c(0, 0).as<double>());
+}
+
+TEST(Random, Distributions) {
+    intptr_t n = 200000;
+    nd::array a = nd::empty(n, ndt::make_type<double>());
+    const double *v = reinterpret_cast<const double *>(a.get_readonly_originptr());
+
+    make_normal_arrfunc(7, 0, 10.0, 2.0).call_out(a);
+    double sum = 0, sumsq = 0;
+    for (intptr_t i = 0; i < n; ++i) {
+        sum += v[i];
+        sumsq += v[i] * v[i];
+    }
+    double mean = sum / n;
+    EXPECT_NEAR(10.0, mean, 0.05);
+    EXPECT_NEAR(2.0, sqrt(sumsq / n - mean * mean), 0.05);
+
+    make_exponential_arrfunc(7, 1, 4.0).call_out(a);
+    sum = 0;
+    for (intptr_t i = 0; i < n; ++i) {
+        EXPECT_LE(0.0, v[i]);
+        sum += v[i];
+    }
+    EXPECT_NEAR(0.25, sum / n, 0.01);
+
+    nd::array f = nd::empty(n, ndt::make_type<float>());
+    make_normal_arrfunc(7, 2, 0.0, 1.0).call_out(f);
+    const float *fv = reinterpret_cast<const float *>(f.get_readonly_originptr());
+    sum = 0;
+    for (intptr_t i = 0; i < n; ++i) {
+        EXPECT_TRUE(fv[i] == fv[i]);
+        sum += fv[i];
+    }
+    EXPECT_NEAR(0.0, sum / n, 0.02);
+
+    nd::array c = nd::empty(100, ndt::make_type<dynd_complex<float> >());
+    make_uniform_arrfunc(7, 3, 0.0, 1.0).call_out(c);
+    for (intptr_t i = 0; i < 100; ++i) {
+        dynd_complex<float> x = c(i).as<dynd_complex<float> >();
+        EXPECT_LE(0.0f, x.real());
+        EXPECT_GT(1.0f, x.real());
+        EXPECT_LE(0.0f, x.imag());
+        EXPECT_GT(1.0f, x.imag());
+    }
+}
+
+TEST(Random, Randint) {
+    intptr_t n = 60000;
+    nd::array a = nd::empty(n, ndt::make_type<int8_t>());
+    make_randint_arrfunc(1, 0, -3, 3).call_out(a);
+    const int8_t *v = reinterpret_cast<const int8_t *>(a.get_readonly_originptr());
+    intptr_t counts[6] = {0, 0, 0, 0, 0, 0};
+    for (intptr_t i = 0; i < n; ++i) {
+        ASSERT_LE(-3, v[i]);
+        ASSERT_GT(3, v[i]);
+        ++counts[v[i] + 3];
+    }
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_NEAR(n / 6, counts[i], n / 60);
+    }
+
+    nd::array b = nd::empty(10, ndt::make_type<uint64_t>());
+    make_randint_arrfunc(1, 0, 0, numeric_limits<int64_t>::max()).call_out(b);
+
+    // The range has to fit in the type
+    EXPECT_THROW(make_randint_arrfunc(1, 0, 0, 300).call_out(a), type_error);
+    EXPECT_THROW(make_randint_arrfunc(1, 0, -1, 3).call_out(b), type_error);
+    EXPECT_THROW(make_randint_arrfunc(1, 0, 3, 3), invalid_argument);
+    EXPECT_THROW(make_uniform_arrfunc(1, 0, 0, 1).call_out(a), type_error);
+}
+
+TEST(Random, Rand) {
+    nd::array a = nd::rand(10, ndt::make_type<double>());
+    nd::array b = nd::rand(10, ndt::make_type<double>());
+    EXPECT_NE(a(0).as<double>(), b(0).as<double>());
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_LE(0.0, a(i).as<double>());
+        EXPECT_GT(1.0, a(i).as<double>());
+    }
+    EXPECT_THROW(nd::rand(10, ndt::make_type<int32_t>()), runtime_error);
+}
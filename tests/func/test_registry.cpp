@@ -7,8 +7,11 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
+#include <thread>
+#include <vector>
 
 #include "inc_gtest.hpp"
+#include "../dynd_assertions.hpp"
 
 #include <dynd/array.hpp>
 #include <dynd/func/arrfunc_registry.hpp>
@@ -91,3 +94,120 @@ TEST(ArrFuncRegistry, Trig) {
   EXPECT_FLOAT_EQ(powf(1.5f, 2.25f), af(1.5f, 2.25f).as<float>());
   EXPECT_DOUBLE_EQ(pow(1.5, 2.25), af(1.5, 2.25).as<double>());
 }
+
+TEST(ArrFuncRegistry, Comparison) {
+  nd::arrfunc af;
+  int a_arr[6] = {1, 5, -3, 7, 7, 0};
+  int b_arr[6] = {2, 5, -4, 8, 6, 0};
+  nd::array a = a_arr, b = b_arr, c;
+
+  // Contiguous arrays of the same builtin type
+  af = func::get_regfunction("less");
+  c = af(a, b);
+  EXPECT_EQ(ndt::type("6 * bool"), c.get_type());
+  EXPECT_JSON_EQ_ARR("[true, false, false, true, false, false]", c);
+  af = func::get_regfunction("less_equal");
+  EXPECT_JSON_EQ_ARR("[true, true, false, true, false, true]", af(a, b));
+  af = func::get_regfunction("equal");
+  EXPECT_JSON_EQ_ARR("[false, true, false, false, false, true]", af(a, b));
+  af = func::get_regfunction("not_equal");
+  EXPECT_JSON_EQ_ARR("[true, false, true, true, true, false]", af(a, b));
+  af = func::get_regfunction("greater_equal");
+  EXPECT_JSON_EQ_ARR("[false, true, true, false, true, true]", af(a, b));
+  af = func::get_regfunction("greater");
+  EXPECT_JSON_EQ_ARR("[false, false, true, false, true, false]", af(a, b));
+
+  // Broadcasting a scalar on either side
+  EXPECT_JSON_EQ_ARR("[false, false, false, true, true, false]", af(a, 5));
+  EXPECT_JSON_EQ_ARR("[true, false, true, false, false, true]", af(5, a));
+
+  // Non-contiguous strides
+  EXPECT_JSON_EQ_ARR("[false, true, true]",
+                     af(a(irange().by(2)), b(irange().by(2))));
+
+  // Mixed builtin types
+  af = func::get_regfunction("less");
+  EXPECT_JSON_EQ_ARR("[true, false, true, false, false, true]", af(a, 4.5));
+
+  // Non-builtin types
+  const char *s_arr[3] = {"abc", "abd", "ab"};
+  af = func::get_regfunction("equal");
+  EXPECT_JSON_EQ_ARR("[false, true, false]", af(nd::array(s_arr), "abd"));
+}
+
+TEST(ArrFuncRegistry, Handle) {
+  func::regfunction_handle h;
+  EXPECT_TRUE(h.is_null());
+  EXPECT_THROW(func::regfunction_handle("not_a_registered_function"),
+               invalid_argument);
+
+  h = func::regfunction_handle("add");
+  EXPECT_FALSE(h.is_null());
+  EXPECT_EQ("add", h.get_name().str());
+  EXPECT_EQ(8, h(3, 5).as<int>());
+  EXPECT_EQ(func::get_regfunction("add").get(), h.get().get());
+
+  // Registering the name again is seen through existing handles
+  nd::arrfunc add = func::get_regfunction("add");
+  func::set_regfunction("add", func::get_regfunction("subtract"));
+  EXPECT_EQ(-2, h(3, 5).as<int>());
+  func::set_regfunction("add", add);
+  EXPECT_EQ(8, h(3, 5).as<int>());
+  EXPECT_EQ(1u, func::get_regfunctions().count("add"));
+}
+
+TEST(ArrFuncRegistry, ConcurrentLookup) {
+  func::regfunction_handle h("multiply");
+  std::vector<int> failures(4, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.push_back(std::thread([t, &h, &failures]() {
+      for (int i = 0; i < 200; ++i) {
+        if (h(i, t).as<int>() != i * t ||
+            func::get_regfunction("add")(i, t).as<int>() != i + t) {
+          ++failures[t];
+        }
+      }
+    }));
+  }
+  // Registering new names while the readers run
+  for (int i = 0; i < 100; ++i) {
+    stringstream ss;
+    ss << "concurrent_lookup_" << i;
+    func::set_regfunction(ss.str(), func::get_regfunction("negative"));
+  }
+  for (size_t t = 0; t < threads.size(); ++t) {
+    threads[t].join();
+  }
+  for (int t = 0; t < 4; ++t) {
+    EXPECT_EQ(0, failures[t]);
+  }
+  EXPECT_EQ(-3, func::get_regfunction("concurrent_lookup_99")(3).as<int>());
+  EXPECT_EQ(1u, func::get_regfunctions().count("concurrent_lookup_42"));
+
+  for (int i = 0; i < 100; ++i) {
+    stringstream ss;
+    ss << "concurrent_lookup_" << i;
+    func::unregister_regfunction(ss.str());
+  }
+  EXPECT_EQ(0u, func::get_regfunctions().count("concurrent_lookup_42"));
+  EXPECT_THROW(func::get_regfunction("concurrent_lookup_99"),
+               invalid_argument);
+}
+
+TEST(ArrFuncRegistry, Unregister) {
+  func::set_regfunction("unregister_test", func::get_regfunction("negative"));
+  func::regfunction_handle h("unregister_test");
+  EXPECT_EQ(-3, h(3).as<int>());
+  func::unregister_regfunction("unregister_test");
+  EXPECT_THROW(func::get_regfunction("unregister_test"), invalid_argument);
+  EXPECT_THROW(func::regfunction_handle("unregister_test"), invalid_argument);
+  EXPECT_THROW(h(3), invalid_argument);
+  EXPECT_THROW(func::unregister_regfunction("unregister_test"),
+               invalid_argument);
+
+  // Registering the name again revives existing handles
+  func::set_regfunction("unregister_test", func::get_regfunction("add"));
+  EXPECT_EQ(8, h(3, 5).as<int>());
+  func::unregister_regfunction("unregister_test");
+}
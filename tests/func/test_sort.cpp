@@ -0,0 +1,153 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "inc_gtest.hpp"
+#include "../dynd_assertions.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/parallel.hpp>
+#include <dynd/func/sort_arrfunc.hpp>
+#include <dynd/func/arrfunc_registry.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Sort, Builtin) {
+  nd::arrfunc sort = make_sort_arrfunc(), argsort = make_argsort_arrfunc(),
+              unique = make_unique_arrfunc();
+  int a_arr[7] = {5, -2, 7, 5, 0, -2, 100000};
+  nd::array a = a_arr, b;
+
+  b = sort(a);
+  EXPECT_EQ(ndt::type("7 * int32"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[-2, -2, 0, 5, 5, 7, 100000]", b);
+  b = argsort(a);
+  EXPECT_EQ(ndt::type("7 * intptr"), b.get_type());
+  // Equal elements keep their original order
+  EXPECT_JSON_EQ_ARR("[1, 5, 4, 0, 3, 2, 6]", b);
+  b = unique(a);
+  EXPECT_EQ(ndt::type("var * int32"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[-2, 0, 5, 7, 100000]", b);
+
+  // A strided view
+  EXPECT_JSON_EQ_ARR("[0, 5, 7, 100000]", sort(a(irange().by(2))));
+
+  // Floating point puts NaN last, and treats -0.0 as equal to 0.0
+  double f_arr[6] = {1.5, std::numeric_limits<double>::quiet_NaN(), -0.0,
+                     -3.25, 0.0, -std::numeric_limits<double>::infinity()};
+  b = argsort(nd::array(f_arr));
+  EXPECT_JSON_EQ_ARR("[5, 3, 2, 4, 0, 1]", b);
+  float g_arr[4] = {2.f, -1.f, -2.f, 1.f};
+  EXPECT_JSON_EQ_ARR("[-2, -1, 1, 2]", sort(nd::array(g_arr)));
+
+  // Empty input
+  b = sort(nd::empty("0 * int32"));
+  EXPECT_EQ(0, b.get_dim_size());
+  b = unique(nd::empty("0 * int32"));
+  EXPECT_EQ(0, b.get_dim_size());
+}
+
+TEST(Sort, Strings) {
+  nd::arrfunc sort = make_sort_arrfunc(), unique = make_unique_arrfunc();
+  const char *a_arr[8] = {"pear", "apple pie crust", "apple", "",
+                          "apple pie", "pear", "apple pie a la mode",
+                          "\xc3\xa9tude"};
+  nd::array a = a_arr;
+  EXPECT_JSON_EQ_ARR("[\"\", \"apple\", \"apple pie\", \"apple pie a la mode\", "
+                     "\"apple pie crust\", \"pear\", \"pear\", "
+                     "\"\xc3\xa9tude\"]",
+                     sort(a));
+  EXPECT_JSON_EQ_ARR("[\"\", \"apple\", \"apple pie\", \"apple pie a la mode\", "
+                     "\"apple pie crust\", \"pear\", \"\xc3\xa9tude\"]",
+                     unique(a));
+
+  // utf16 goes through the comparison merge sort
+  nd::array b = a.ucast(ndt::make_string(string_encoding_utf_16)).eval();
+  EXPECT_JSON_EQ_ARR("[\"\", \"apple\", \"apple pie\", \"apple pie a la mode\", "
+                     "\"apple pie crust\", \"pear\", \"pear\", "
+                     "\"\xc3\xa9tude\"]",
+                     sort(b));
+}
+
+TEST(Sort, Struct) {
+  nd::arrfunc sort = make_sort_arrfunc(), argsort = make_argsort_arrfunc();
+  nd::array a = parse_json("4 * {x: int32, y: string}",
+                           "[[2, \"b\"], [1, \"z\"], [2, \"a\"], [1, \"z\"]]");
+  EXPECT_JSON_EQ_ARR("[1, 3, 2, 0]", argsort(a));
+  nd::array b = sort(a);
+  EXPECT_EQ(1, b(0, 0).as<int>());
+  EXPECT_EQ("z", b(1, 1).as<string>());
+  EXPECT_EQ("a", b(2, 1).as<string>());
+  EXPECT_EQ("b", b(3, 1).as<string>());
+}
+
+TEST(Sort, LargeParallel) {
+  intptr_t saved_nthreads = parallel::get_num_threads();
+  parallel::set_num_threads(4);
+
+  const intptr_t n = 100000;
+  vector<int64_t> vals(n);
+  vector<string> svals(n);
+  uint64_t state = 12345;
+  for (intptr_t i = 0; i < n; ++i) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    vals[i] = static_cast<int64_t>(state >> 16) % 1000 - 500;
+    svals[i] = "prefix_" + to_string(vals[i] * 7919);
+  }
+  nd::array a = nd::empty(n, ndt::make_type<int64_t>());
+  memcpy(a.get_readwrite_originptr(), &vals[0], n * sizeof(int64_t));
+
+  vector<intptr_t> expected(n);
+  for (intptr_t i = 0; i < n; ++i) {
+    expected[i] = i;
+  }
+  stable_sort(expected.begin(), expected.end(),
+              [&](intptr_t x, intptr_t y) { return vals[x] < vals[y]; });
+  nd::array b = make_argsort_arrfunc()(a);
+  const intptr_t *idx =
+      reinterpret_cast<const intptr_t *>(b.get_readonly_originptr());
+  EXPECT_TRUE(equal(expected.begin(), expected.end(), idx));
+  vector<intptr_t> int_expected = expected;
+
+  // Strings share an eight byte prefix, so the ties need resolving
+  nd::array s = nd::empty(n, ndt::make_string());
+  s.vals() = svals;
+  for (intptr_t i = 0; i < n; ++i) {
+    expected[i] = i;
+  }
+  stable_sort(expected.begin(), expected.end(),
+              [&](intptr_t x, intptr_t y) { return svals[x] < svals[y]; });
+  b = make_argsort_arrfunc()(s);
+  idx = reinterpret_cast<const intptr_t *>(b.get_readonly_originptr());
+  EXPECT_TRUE(equal(expected.begin(), expected.end(), idx));
+
+  // The merge sort path, through a type without radix keys
+  nd::array c = a.ucast(ndt::make_type<dynd_int128>()).eval();
+  b = make_argsort_arrfunc()(c);
+  idx = reinterpret_cast<const intptr_t *>(b.get_readonly_originptr());
+  EXPECT_TRUE(equal(int_expected.begin(), int_expected.end(), idx));
+
+  parallel::set_num_threads(saved_nthreads);
+}
+
+TEST(Sort, Registry) {
+  nd::arrfunc af = func::get_regfunction("sort");
+  nd::array a = parse_json("2 * 3 * int32", "[[3, 1, 2], [0, -1, 5]]");
+  nd::array b = af(a);
+  EXPECT_EQ(ndt::type("2 * 3 * int32"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[[1, 2, 3], [-1, 0, 5]]", b);
+  af = func::get_regfunction("argsort");
+  EXPECT_JSON_EQ_ARR("[[1, 2, 0], [1, 0, 2]]", af(a));
+  af = func::get_regfunction("unique");
+  EXPECT_JSON_EQ_ARR("[-1, 0, 1, 2, 3, 5]", af(parse_json("6 * int32", "[3, 1, 2, 0, -1, 5]")));
+}
@@ -6,6 +6,9 @@
 #include <iostream>
 #include <stdexcept>
 #include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
 #include <inc_gtest.hpp>
 
 #include "dynd_assertions.hpp"
@@ -13,6 +16,9 @@
 
 #include <dynd/special.hpp>
 #include <dynd/func/callable.hpp>
+#include <dynd/func/arrfunc_registry.hpp>
+#include <dynd/kernels/special_kernels.hpp>
+#include <dynd/parallel.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -287,4 +293,145 @@ TEST(Special, AssociatedLegendreP) {
     }
 }
 
+namespace {
+// Evaluates a registry special function over the reference inputs, laid
+// out contiguously so that the batch path is used
+void check_batch_vals(const char *name, const nd::array &vals)
+{
+    intptr_t size = vals.get_dim_size();
+    nd::array x = nd::empty(size, ndt::make_type<double>());
+    x.vals() = vals(irange(), 0);
+    nd::array y = func::get_regfunction(name)(x);
+
+    for (int i = 0; i < size; ++i) {
+        EXPECT_EQ_RELERR(vals(i, 1).as<double>(), y(i).as<double>(),
+                         REL_ERROR_MAX) << name << "(" << x(i).as<double>() << ")";
+    }
+}
+
+// Compares a batch function against the scalar one, NaNs included
+void check_batch_scalar(void (*batch)(double *, const double *, size_t),
+                        double (*scalar)(double), const vector<double> &x)
+{
+    vector<double> y(x.size());
+    batch(&y[0], &x[0], x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        double expected = scalar(x[i]);
+        if (expected != expected) {
+            EXPECT_NE(y[i], y[i]) << "x = " << x[i];
+        } else if (fabs(expected) == numeric_limits<double>::infinity()) {
+            EXPECT_EQ(expected, y[i]) << "x = " << x[i];
+        } else {
+            EXPECT_NEAR(expected, y[i], 1e-14 * max(1.0, fabs(expected)))
+                << "x = " << x[i];
+        }
+    }
+}
+} // anonymous namespace
+
+TEST(Special, BatchArrFuncs) {
+    check_batch_vals("gamma", gamma_vals());
+    check_batch_vals("lgamma", lgamma_vals());
+    check_batch_vals("bessel_j0", bessel_j0_vals());
+    check_batch_vals("bessel_j1", bessel_j1_vals());
+    check_batch_vals("bessel_y0", bessel_y0_vals());
+    check_batch_vals("bessel_y1", bessel_y1_vals());
+    check_batch_vals("sph_bessel_j0", sph_bessel_j0_vals());
+    check_batch_vals("sph_bessel_y0", sph_bessel_y0_vals());
+}
+
+TEST(Special, BatchMatchesScalar) {
+    // Enough elements to be split across threads, over both branches of
+    // the Bessel function approximations
+    std::mt19937 gen(2014);
+    std::uniform_real_distribution<double> dist(-40, 40);
+    vector<double> x(100000);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = dist(gen);
+    }
+    double special[] = {0.0, -0.0, 1e-6, -1e-6, 5.0, -5.0, 1e300,
+                        numeric_limits<double>::infinity(),
+                        -numeric_limits<double>::infinity(),
+                        numeric_limits<double>::quiet_NaN()};
+    x.insert(x.begin() + 1000, special, special + sizeof(special) / sizeof(double));
+
+    intptr_t nthreads = parallel::get_num_threads();
+    parallel::set_num_threads(4);
+    check_batch_scalar(&kernels::special::bessel_j0, &bessel_j0, x);
+    check_batch_scalar(&kernels::special::bessel_j1, &bessel_j1, x);
+    check_batch_scalar(&kernels::special::bessel_y0, &bessel_y0, x);
+    check_batch_scalar(&kernels::special::bessel_y1, &bessel_y1, x);
+    check_batch_scalar(&kernels::special::sph_bessel_j0, &sph_bessel_j0, x);
+    check_batch_scalar(&kernels::special::sph_bessel_y0, &sph_bessel_y0, x);
+    check_batch_scalar(&kernels::special::gamma, &dynd::gamma, x);
+    parallel::set_num_threads(nthreads);
+
+    // In place gives the same results
+    vector<double> y(x), expected(x.size());
+    kernels::special::bessel_y1(&expected[0], &x[0], x.size());
+    kernels::special::bessel_y1(&y[0], &y[0], y.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        if (expected[i] == expected[i]) {
+            EXPECT_EQ(expected[i], y[i]);
+        }
+    }
+}
+
+TEST(Special, BinaryArrFuncs) {
+    nd::array vals = bessel_j_vals();
+    intptr_t size = vals.get_dim_size();
+    nd::array y = func::get_regfunction("bessel_j")(vals(irange(), 0), vals(irange(), 1));
+    for (int i = 0; i < size; ++i) {
+        EXPECT_EQ_RELERR(vals(i, 2).as<double>(), y(i).as<double>(), REL_ERROR_MAX);
+    }
+
+    vals = legendre_p_vals();
+    size = vals.get_dim_size();
+    nd::array l = nd::empty(size, ndt::make_type<int>());
+    l.vals() = vals(irange(), 0);
+    y = func::get_regfunction("legendre_p")(l, vals(irange(), 1));
+    for (int i = 0; i < size; ++i) {
+        EXPECT_EQ_RELERR(vals(i, 2).as<double>(), y(i).as<double>(), REL_ERROR_MAX);
+    }
+}
+
+TEST(Special, AiryArrFuncs) {
+    nd::array vals = airy_vals();
+    intptr_t size = vals.get_dim_size();
+    nd::array x = nd::empty(size, ndt::make_type<double>());
+    x.vals() = vals(irange(), 0);
+
+    nd::array y = func::get_regfunction("airy")(x);
+    nd::array ai = func::get_regfunction("airy_ai")(x);
+    nd::array bi = func::get_regfunction("airy_bi")(x);
+    EXPECT_EQ(ndt::make_fixed_dim(size, ndt::type("2 * 2 * float64")),
+              y.get_type());
+    EXPECT_EQ(ndt::make_fixed_dim(size, ndt::type("2 * float64")),
+              ai.get_type());
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            EXPECT_EQ_RELERR(vals(i, 1, 0, j).as<double>(),
+                             y(i, 0, j).as<double>(), REL_ERROR_MAX);
+            EXPECT_EQ_RELERR(vals(i, 1, 1, j).as<double>(),
+                             y(i, 1, j).as<double>(), REL_ERROR_MAX);
+            EXPECT_EQ_RELERR(vals(i, 1, 0, j).as<double>(),
+                             ai(i, j).as<double>(), REL_ERROR_MAX);
+            EXPECT_EQ_RELERR(vals(i, 1, 1, j).as<double>(),
+                             bi(i, j).as<double>(), REL_ERROR_MAX);
+        }
+    }
+
+    // Strided inputs go through a buffer
+    y = func::get_regfunction("airy")(x(irange().by(2)));
+    EXPECT_EQ((size + 1) / 2, y.get_dim_size());
+    for (int i = 0; i < y.get_dim_size(); ++i) {
+        for (int j = 0; j < 2; ++j) {
+            EXPECT_EQ_RELERR(vals(2 * i, 1, 0, j).as<double>(),
+                             y(i, 0, j).as<double>(), REL_ERROR_MAX);
+            EXPECT_EQ_RELERR(vals(2 * i, 1, 1, j).as<double>(),
+                             y(i, 1, j).as<double>(), REL_ERROR_MAX);
+        }
+    }
+}
+
 #undef REL_ERROR_MAX
@@ -16,6 +16,7 @@
 #include <dynd/types/arrfunc_old_type.hpp>
 #include <dynd/func/lift_reduction_arrfunc.hpp>
 #include <dynd/func/call_callable.hpp>
+#include <dynd/func/lift_arrfunc.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -84,3 +85,30 @@ TEST(ArrFunc, TakeOfArray) {
     EXPECT_EQ(2, c(3, 0).as<int>());
     EXPECT_EQ(3, c(3, 1).as<int>());
 }
+
+TEST(ArrFunc, LiftedMaskedTake) {
+    // Lifting the take over an outer dimension makes many var dim
+    // outputs in one strided kernel call
+    nd::arrfunc take = lift_arrfunc(kernels::make_take_arrfunc());
+    const int n = 500, m = 9;
+    nd::array a = nd::empty(n, m, ndt::make_type<int>());
+    nd::array b = nd::empty(n, m, ndt::make_type<dynd_bool>());
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < m; ++j) {
+            a(i, j).vals() = i * m + j;
+            b(i, j).vals() = (i + j) % (i % 4 + 1) == 0;
+        }
+    }
+    nd::array c = take(a, b);
+    EXPECT_EQ(ndt::type("500 * var * int"), c.get_type());
+    for (int i = 0; i < n; ++i) {
+        intptr_t k = 0;
+        for (int j = 0; j < m; ++j) {
+            if ((i + j) % (i % 4 + 1) == 0) {
+                ASSERT_EQ(i * m + j, c(i, k).as<int>());
+                ++k;
+            }
+        }
+        ASSERT_EQ(k, c(i).get_dim_size());
+    }
+}
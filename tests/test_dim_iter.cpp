@@ -0,0 +1,187 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/dim_iter.hpp>
+#include <dynd/types/byteswap_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/fixedstring_type.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+// Makes a dim_iter over the one-dimensional array ``a``, producing val_tp
+void make_iter(dim_iter *di, const nd::array &a, const ndt::type &val_tp,
+               intptr_t buffer_max_mem, intptr_t queue_depth)
+{
+    const fixed_dim_type_arrmeta *md =
+        reinterpret_cast<const fixed_dim_type_arrmeta *>(a.get_arrmeta());
+    if (queue_depth == 0) {
+        make_buffered_strided_dim_iter(
+            di, val_tp, a.get_dtype(), a.get_arrmeta() + sizeof(fixed_dim_type_arrmeta),
+            a.get_readonly_originptr(), md->dim_size, md->stride,
+            a.get_memblock(), buffer_max_mem);
+    } else {
+        make_async_buffered_strided_dim_iter(
+            di, val_tp, a.get_dtype(), a.get_arrmeta() + sizeof(fixed_dim_type_arrmeta),
+            a.get_readonly_originptr(), md->dim_size, md->stride,
+            a.get_memblock(), buffer_max_mem, queue_depth);
+    }
+}
+
+nd::array make_int32_range(intptr_t size)
+{
+    nd::array a = nd::empty(size, ndt::make_type<int32_t>());
+    int32_t *data = reinterpret_cast<int32_t *>(a.get_readwrite_originptr());
+    for (intptr_t i = 0; i < size; ++i) {
+        data[i] = static_cast<int32_t>(3 * i - 5);
+    }
+    return a;
+}
+} // anonymous namespace
+
+class DimIter : public ::testing::TestWithParam<int> {
+};
+
+TEST_P(DimIter, Convert) {
+    const intptr_t size = 10007;
+    nd::array a = make_int32_range(size);
+    // Small buffers, so there are many chunks. The buffer size counts
+    // elements as they are in memory, 100 int32 values here.
+    dim_iter it;
+    make_iter(&it, a, ndt::make_type<double>(), 400, GetParam());
+    EXPECT_EQ(ndt::make_type<double>(), ndt::type(it.eltype, true));
+    EXPECT_TRUE((it.flags & dim_iter_seekable) != 0);
+    EXPECT_TRUE((it.flags & dim_iter_contiguous) != 0);
+
+    intptr_t i = 0, chunks = 0;
+    while (it.vtable->next(&it)) {
+        for (intptr_t j = 0; j < it.data_elcount; ++j) {
+            ASSERT_EQ(3.0 * (i + j) - 5,
+                      *reinterpret_cast<const double *>(it.data_ptr + j * it.data_stride));
+        }
+        i += it.data_elcount;
+        ++chunks;
+    }
+    EXPECT_EQ(size, i);
+    EXPECT_EQ(101, chunks);
+    EXPECT_EQ(0, it.vtable->next(&it));
+
+    // Seeking in the middle, after the end, and restarting
+    it.vtable->seek(&it, 4321);
+    ASSERT_EQ(100, it.data_elcount);
+    EXPECT_EQ(3.0 * 4321 - 5, *reinterpret_cast<const double *>(it.data_ptr));
+    ASSERT_EQ(1, it.vtable->next(&it));
+    EXPECT_EQ(3.0 * 4421 - 5, *reinterpret_cast<const double *>(it.data_ptr));
+    it.vtable->seek(&it, size);
+    EXPECT_EQ(0, it.data_elcount);
+    it.vtable->seek(&it, 0);
+    ASSERT_EQ(100, it.data_elcount);
+    EXPECT_EQ(-5.0, *reinterpret_cast<const double *>(it.data_ptr));
+    it.destroy();
+
+    // Destroying an iterator part way through
+    make_iter(&it, a, ndt::make_type<double>(), 400, GetParam());
+    ASSERT_EQ(1, it.vtable->next(&it));
+    it.destroy();
+}
+
+TEST_P(DimIter, Byteswap) {
+    const intptr_t size = 5000;
+    nd::array a = make_int32_range(size);
+    // View the native data as foreign-endian
+    nd::array b = a.view_scalars(ndt::make_byteswap<int32_t>());
+    dim_iter it;
+    make_iter(&it, b, ndt::make_type<int32_t>(), 1024, GetParam());
+    intptr_t i = 0;
+    const int32_t *data = reinterpret_cast<const int32_t *>(a.get_readonly_originptr());
+    while (it.vtable->next(&it)) {
+        for (intptr_t j = 0; j < it.data_elcount; ++j, ++i) {
+            int32_t expected = data[i];
+            expected = (int32_t)(((uint32_t)expected >> 24) |
+                                 (((uint32_t)expected >> 8) & 0xff00u) |
+                                 (((uint32_t)expected << 8) & 0xff0000u) |
+                                 ((uint32_t)expected << 24));
+            ASSERT_EQ(expected,
+                      *reinterpret_cast<const int32_t *>(it.data_ptr + j * it.data_stride));
+        }
+    }
+    EXPECT_EQ(size, i);
+}
+
+TEST_P(DimIter, BlockRef) {
+    // The strings produced from a fixedstring live in each buffer's own
+    // memory block, found through el_arrmeta
+    const intptr_t size = 1000;
+    nd::array a = nd::empty(size, ndt::make_fixedstring(8));
+    char *data = a.get_readwrite_originptr();
+    for (intptr_t i = 0; i < size; ++i) {
+        memset(data + 8 * i, 0, 8);
+        sprintf(data + 8 * i, "s%d", (int)i);
+    }
+    dim_iter it;
+    make_iter(&it, a, ndt::make_string(), 1024, GetParam());
+    intptr_t i = 0;
+    while (it.vtable->next(&it)) {
+        ASSERT_TRUE(it.el_arrmeta != NULL);
+        for (intptr_t j = 0; j < it.data_elcount; ++j, ++i) {
+            const string_type_data *d = reinterpret_cast<const string_type_data *>(
+                it.data_ptr + j * it.data_stride);
+            ASSERT_EQ("s" + to_string(i), string(d->begin, d->end));
+        }
+    }
+    EXPECT_EQ(size, i);
+}
+
+TEST_P(DimIter, ConversionError) {
+    const intptr_t size = 1000;
+    nd::array a = nd::empty(size, ndt::make_fixedstring(8));
+    char *data = a.get_readwrite_originptr();
+    memset(data, 0, 8 * size);
+    for (intptr_t i = 0; i < size; ++i) {
+        sprintf(data + 8 * i, "%d", (int)i);
+    }
+    // Element 650 can't convert to an integer
+    strcpy(data + 8 * 650, "bad");
+
+    dim_iter it;
+    make_iter(&it, a, ndt::make_type<int32_t>(), 800, GetParam());
+    intptr_t i = 0;
+    EXPECT_THROW({
+        while (it.vtable->next(&it)) {
+            i += it.data_elcount;
+        }
+    }, invalid_argument);
+    // The chunks before the bad element are all produced
+    EXPECT_EQ(600, i);
+    // Seeking past it recovers
+    it.vtable->seek(&it, 700);
+    ASSERT_EQ(100, it.data_elcount);
+    EXPECT_EQ(700, *reinterpret_cast<const int32_t *>(it.data_ptr));
+}
+
+// 0 is the synchronous iterator, others are async queue depths
+INSTANTIATE_TEST_CASE_P(QueueDepth, DimIter, ::testing::Values(0, 1, 3));
+
+TEST(DimIterAsync, Errors) {
+    nd::array a = make_int32_range(10);
+    dim_iter it;
+    EXPECT_THROW(make_iter(&it, a, ndt::make_type<double>(), 16, -1),
+                 invalid_argument);
+    // A buffer holding everything makes a plain strided iterator
+    make_iter(&it, a, ndt::make_type<double>(), 65536, 2);
+    ASSERT_EQ(1, it.vtable->next(&it));
+    EXPECT_EQ(10, it.data_elcount);
+    EXPECT_EQ(0, it.vtable->next(&it));
+}
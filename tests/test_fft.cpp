@@ -12,6 +12,7 @@
 #include "dynd_assertions.hpp"
 
 #include <dynd/fft.hpp>
+#include <dynd/parallel.hpp>
 #include <dynd/random.hpp>
 
 using namespace std;
@@ -711,8 +712,6 @@ TYPED_TEST_P(RFFT2D, KroneckerDelta) {
     }
 }
 
-#ifdef DYND_FFTW // For now, only test FFTs if we built DYND with FFTW
-
 /** TODO: A few of the single-precision tests fail, even at what should be reasonable relative error.
  *        As all of the double-precision tests are fine, I think this is inherent to FFTW. For now,
  *        I'm commenting out the single-precision tests.
@@ -734,4 +733,134 @@ REGISTER_TYPED_TEST_CASE_P(RFFT2D, Linear, Inverse, Zeros, Ones, KroneckerDelta)
 // INSTANTIATE_TYPED_TEST_CASE_P(Float, RFFT2D, FixedDim2D<float>::Types);
 INSTANTIATE_TYPED_TEST_CASE_P(Double, RFFT2D, FixedDim2D<double>::Types);
 
-#endif // DYND_FFTW
+template <typename T>
+static dynd_complex<T> naive_dft(const nd::array &x, intptr_t k, int sign) {
+    intptr_t n = x.get_dim_size();
+    dynd_complex<double> sum = 0;
+    for (intptr_t j = 0; j < n; ++j) {
+        double theta = sign * 2 * 3.14159265358979323846 * static_cast<double>((j * k) % n) / n;
+        dynd_complex<double> xj = x(j).as<dynd_complex<double> >();
+        sum = sum + xj * dynd_complex<double>(cos(theta), sin(theta));
+    }
+    return dynd_complex<T>(static_cast<T>(sum.real()), static_cast<T>(sum.imag()));
+}
+
+TEST(FFT1D, MatchesNaiveDFT) {
+    // Covers every radix as well as Bluestein lengths
+    intptr_t sizes[] = {1, 2, 3, 5, 6, 7, 11, 30, 49, 97, 120, 250};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        intptr_t n = sizes[i];
+        nd::array x = nd::rand(n, ndt::make_type<dynd_complex<double> >());
+
+        nd::array y = fft(x);
+        nd::array z = ifft(x);
+        for (intptr_t k = 0; k < n; ++k) {
+            EXPECT_EQ_RELERR(naive_dft<double>(x, k, -1), y(k).as<dynd_complex<double> >(), 1E-10);
+            EXPECT_EQ_RELERR(naive_dft<double>(x, k, 1), z(k).as<dynd_complex<double> >(), 1E-10);
+        }
+
+        nd::array xf = nd::empty(n, ndt::make_type<dynd_complex<float> >());
+        xf.vals() = x;
+        nd::array yf = fft(xf);
+        EXPECT_EQ(ndt::make_type<dynd_complex<float> >(), yf.get_dtype());
+        for (intptr_t k = 0; k < n; ++k) {
+            EXPECT_LE(abs(y(k).as<dynd_complex<double> >() - yf(k).as<dynd_complex<double> >()), 1E-5 * n);
+        }
+    }
+}
+
+TEST(FFT1D, RealMatchesComplex) {
+    intptr_t sizes[] = {1, 2, 9, 16, 17, 30, 98};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        intptr_t n = sizes[i];
+        nd::array x = nd::rand(n, ndt::make_type<double>());
+        nd::array xc = nd::empty(n, ndt::make_type<dynd_complex<double> >());
+        xc.vals() = x;
+
+        nd::array y = rfft(x), yc = fft(xc);
+        ASSERT_EQ(n / 2 + 1, y.get_dim_size());
+        for (intptr_t k = 0; k <= n / 2; ++k) {
+            EXPECT_EQ_RELERR(yc(k).as<dynd_complex<double> >(), y(k).as<dynd_complex<double> >(), 1E-10);
+        }
+
+        nd::array z = irfft(y, n);
+        ASSERT_EQ(n, z.get_dim_size());
+        for (intptr_t j = 0; j < n; ++j) {
+            EXPECT_EQ_RELERR(x(j).as<double>(), z(j).as<double>() / n, 1E-10);
+        }
+    }
+}
+
+TEST(FFT1D, TruncateAndPad) {
+    nd::array x = nd::rand(10, ndt::make_type<dynd_complex<double> >());
+
+    // A shorter shape only transforms the leading elements
+    nd::array y = fft(x, 4);
+    nd::array y4 = fft(x(irange(0, 4)).eval());
+    ASSERT_EQ(4, y.get_dim_size());
+    for (intptr_t k = 0; k < 4; ++k) {
+        EXPECT_EQ_RELERR(y4(k).as<dynd_complex<double> >(), y(k).as<dynd_complex<double> >(), 1E-12);
+    }
+
+    // A longer shape pads with zeros
+    y = fft(x, 16);
+    ASSERT_EQ(16, y.get_dim_size());
+    for (intptr_t k = 0; k < 16; ++k) {
+        dynd_complex<double> expected = 0;
+        for (intptr_t j = 0; j < 10; ++j) {
+            double theta = -2 * 3.14159265358979323846 * static_cast<double>((j * k) % 16) / 16;
+            expected = expected + x(j).as<dynd_complex<double> >() * dynd_complex<double>(cos(theta), sin(theta));
+        }
+        EXPECT_EQ_RELERR(expected, y(k).as<dynd_complex<double> >(), 1E-10);
+    }
+}
+
+TEST(FFT3D, BatchedAxes) {
+    nd::array x = nd::rand(6, 7, 10, ndt::make_type<dynd_complex<double> >());
+
+    vector<intptr_t> axes;
+    axes.push_back(1);
+    nd::array y = fft(x, x.get_shape(), axes);
+    for (intptr_t i = 0; i < 6; ++i) {
+        for (intptr_t l = 0; l < 10; ++l) {
+            nd::array row = x(i, irange(), l).eval();
+            for (intptr_t k = 0; k < 7; ++k) {
+                EXPECT_EQ_RELERR(naive_dft<double>(row, k, -1), y(i, k, l).as<dynd_complex<double> >(), 1E-10);
+            }
+        }
+    }
+
+    // Threaded and single-threaded runs agree exactly
+    axes.push_back(0);
+    axes.push_back(2);
+    intptr_t nthreads = parallel::get_num_threads();
+    parallel::set_num_threads(1);
+    nd::array y1 = fft(x, x.get_shape(), axes);
+    parallel::set_num_threads(4);
+    nd::array y4 = fft(x, x.get_shape(), axes);
+    parallel::set_num_threads(nthreads);
+    EXPECT_ARR_EQ(y1, y4);
+
+    nd::array z = ifft(y4, x.get_shape(), axes);
+    for (intptr_t i = 0; i < 6; ++i) {
+        for (intptr_t j = 0; j < 7; ++j) {
+            for (intptr_t l = 0; l < 10; ++l) {
+                EXPECT_EQ_RELERR(x(i, j, l).as<dynd_complex<double> >(),
+                    z(i, j, l).as<dynd_complex<double> >() / 420.0, 1E-10);
+            }
+        }
+    }
+
+    axes.clear();
+    axes.push_back(3);
+    EXPECT_THROW(fft(x, x.get_shape(), axes), invalid_argument);
+    EXPECT_THROW(fft(nd::rand(4, ndt::make_type<int32_t>())), runtime_error);
+
+    // The native engine checks the shape itself when called directly
+    vector<intptr_t> shape(2, 6);
+    axes.clear();
+    axes.push_back(0);
+    EXPECT_THROW(native_fft::fft(x, shape, axes), invalid_argument);
+    EXPECT_THROW(native_fft::rfft(nd::rand(8, ndt::make_type<double>()), shape),
+                 invalid_argument);
+}
@@ -12,6 +12,7 @@
 #include <dynd/types/byteswap_type.hpp>
 #include <dynd/types/convert_type.hpp>
 #include <dynd/types/fixedbytes_type.hpp>
+#include <dynd/kernels/byteswap_kernels.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -78,3 +79,89 @@ TEST(ByteswapDType, CanonicalDType) {
     // The canonical type of a byteswap type is always the non-swapped version
     EXPECT_EQ((ndt::make_type<float>()), (ndt::make_byteswap<float>().get_canonical_type()));
 }
+
+TEST(ByteswapDType, StridedContiguous) {
+    // Enough values to exercise the vectorized path, with an odd tail
+    const int count = 37;
+    int16_t v16[count];
+    int32_t v32[count];
+    int64_t v64[count];
+    uint32_t vc[2 * count];
+    for (int i = 0; i < count; ++i) {
+        v16[i] = (int16_t)(0x0102 + i);
+        v32[i] = 0x01020304 + i;
+        v64[i] = 0x0102030405060708LL + i;
+        vc[2 * i] = 0x01020304 + i;
+        vc[2 * i + 1] = 0x0a0b0c0d + i;
+    }
+    nd::array a16 = nd::empty(count, ndt::make_byteswap<int16_t>());
+    memcpy(a16.get_readwrite_originptr(), v16, sizeof(v16));
+    nd::array a32 = nd::empty(count, ndt::make_byteswap<int32_t>());
+    memcpy(a32.get_readwrite_originptr(), v32, sizeof(v32));
+    nd::array a64 = nd::empty(count, ndt::make_byteswap<int64_t>());
+    memcpy(a64.get_readwrite_originptr(), v64, sizeof(v64));
+    nd::array ac = nd::empty(count, ndt::make_byteswap<dynd_complex<float> >());
+    memcpy(ac.get_readwrite_originptr(), vc, sizeof(vc));
+
+    nd::array b16 = a16.eval(), b32 = a32.eval(), b64 = a64.eval();
+    nd::array bc = ac.eval();
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(byteswap_value((uint16_t)v16[i]),
+                  (uint16_t)b16(i).as<int16_t>());
+        EXPECT_EQ(byteswap_value((uint32_t)v32[i]),
+                  (uint32_t)b32(i).as<int32_t>());
+        EXPECT_EQ(byteswap_value((uint64_t)v64[i]),
+                  (uint64_t)b64(i).as<int64_t>());
+        uint32_t re = byteswap_value(vc[2 * i]);
+        uint32_t im = byteswap_value(vc[2 * i + 1]);
+        float re_f, im_f;
+        memcpy(&re_f, &re, 4);
+        memcpy(&im_f, &im, 4);
+        dynd_complex<float> c = bc(i).as<dynd_complex<float> >();
+        EXPECT_EQ(0, memcmp(&re_f, &c.m_real, 4));
+        EXPECT_EQ(0, memcmp(&im_f, &c.m_imag, 4));
+    }
+
+    // A non-contiguous view takes the strided loop
+    nd::array s32 = a32(irange().by(3)).eval();
+    for (int i = 0; i < count; i += 3) {
+        EXPECT_EQ(byteswap_value((uint32_t)v32[i]),
+                  (uint32_t)s32(i / 3).as<int32_t>());
+    }
+}
+
+TEST(ByteswapDType, FusedConvert) {
+    const int count = 21;
+    int32_t v32[count];
+    for (int i = 0; i < count; ++i) {
+        v32[i] = (int32_t)byteswap_value((uint32_t)(i * 1000 - 7000));
+    }
+    nd::array a = nd::empty(count, ndt::make_byteswap<int32_t>());
+    memcpy(a.get_readwrite_originptr(), v32, sizeof(v32));
+
+    // byteswap[int32] -> float64 in one step
+    nd::array b = a.ucast<double>();
+    EXPECT_EQ(ndt::make_fixed_dim(count, ndt::make_convert(
+                  ndt::make_type<double>(), ndt::make_byteswap<int32_t>())),
+              b.get_type());
+    b = b.eval();
+    EXPECT_EQ(ndt::type("21 * float64"), b.get_type());
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(i * 1000 - 7000, b(i).as<double>());
+    }
+
+    // float64 -> byteswap[int32] in one step
+    nd::array c = nd::empty(count, ndt::make_byteswap<int32_t>());
+    c.vals() = b;
+    EXPECT_EQ(0, memcmp(v32, c.get_readonly_originptr(), sizeof(v32)));
+
+    // Range checking still applies
+    double big[2] = {1e6, -7000.5};
+    nd::array d = nd::empty(2, ndt::make_byteswap<int16_t>());
+    EXPECT_THROW(d.vals() = big, overflow_error);
+    EXPECT_THROW(d(1).vals() = big[1], runtime_error);
+    eval::eval_context ectx;
+    ectx.errmode = assign_error_nocheck;
+    d(1).val_assign(nd::array(big[1]), &ectx);
+    EXPECT_EQ(-7000, d(1).as<int16_t>());
+}
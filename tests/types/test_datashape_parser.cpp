@@ -900,3 +900,62 @@ TEST(DataShapeParser, SpecialCharacterFields){
   }
 
 }
+
+TEST(DataShapeParser, Cache) {
+    clear_datashape_cache();
+    datashape_cache_stats stats = get_datashape_cache_stats();
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(0u, stats.misses);
+    EXPECT_EQ(0u, stats.size);
+    size_t capacity = stats.capacity;
+
+    ndt::type a = ndt::type("3 * {x: int32, y: string}");
+    ndt::type b = ndt::type("3 * {x: int32, y: string}");
+    EXPECT_EQ(a, b);
+    // The second lookup shares the first parse
+    EXPECT_EQ(a.extended(), b.extended());
+    stats = get_datashape_cache_stats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.size);
+
+    // Errors are reported every time, and not cached
+    EXPECT_THROW(ndt::type("3 * {x: int32"), runtime_error);
+    EXPECT_THROW(ndt::type("3 * {x: int32"), runtime_error);
+    EXPECT_EQ(1u, get_datashape_cache_stats().size);
+
+    // Least recently used entries are evicted
+    set_datashape_cache_capacity(2);
+    ndt::type("int16");
+    ndt::type("3 * {x: int32, y: string}");
+    ndt::type("int8");
+    stats = get_datashape_cache_stats();
+    EXPECT_EQ(2u, stats.size);
+    EXPECT_EQ(1u, stats.evictions);
+    ndt::type("3 * {x: int32, y: string}");
+    EXPECT_EQ(stats.hits + 1, get_datashape_cache_stats().hits);
+    ndt::type("int16");
+    EXPECT_EQ(stats.misses + 1, get_datashape_cache_stats().misses);
+
+    // Zero capacity disables the cache
+    set_datashape_cache_capacity(0);
+    EXPECT_EQ(0u, get_datashape_cache_stats().size);
+    EXPECT_EQ(ndt::make_type<int8_t>(), ndt::type("int8"));
+    EXPECT_EQ(0u, get_datashape_cache_stats().size);
+
+    set_datashape_cache_capacity(capacity);
+    clear_datashape_cache();
+}
+
+TEST(DataShapeParser, TypeLiteral) {
+    static const ndt::type_literal point_tp("{x: float64, y: float64}");
+    EXPECT_EQ(string("{x: float64, y: float64}"), point_tp.datashape());
+    const ndt::type &tp = point_tp;
+    EXPECT_EQ(ndt::type("{x: float64, y: float64}"), tp);
+    // Parsed only once
+    EXPECT_EQ(&tp, &point_tp.get());
+    EXPECT_EQ(tp.extended(), point_tp.get().extended());
+
+    static const ndt::type_literal bad_tp("{x: float64");
+    EXPECT_THROW(bad_tp.get(), runtime_error);
+}
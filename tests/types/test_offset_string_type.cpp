@@ -0,0 +1,163 @@
+//
+// Copyright (C) 2011-14 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/func/call_callable.hpp>
+#include <dynd/types/offset_string_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/fixedstring_type.hpp>
+#include <dynd/types/option_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(OffsetStringType, Create) {
+    ndt::type d;
+
+    d = ndt::make_offset_string();
+    EXPECT_EQ(offset_string_type_id, d.get_type_id());
+    EXPECT_EQ(string_kind, d.get_kind());
+    EXPECT_EQ(4u, d.get_data_alignment());
+    EXPECT_EQ(8u, d.get_data_size());
+    EXPECT_EQ(string_encoding_utf_8, d.extended<base_string_type>()->get_encoding());
+    EXPECT_EQ("offset_string", d.str());
+    // Roundtripping through a string
+    EXPECT_EQ(d, ndt::type(d.str()));
+
+    d = ndt::make_offset_string(string_encoding_utf_8, int64_type_id);
+    EXPECT_EQ(8u, d.get_data_alignment());
+    EXPECT_EQ(16u, d.get_data_size());
+    EXPECT_EQ("offset_string[int64]", d.str());
+    EXPECT_EQ(d, ndt::type(d.str()));
+
+    d = ndt::make_offset_string(string_encoding_utf_16, int64_type_id);
+    EXPECT_EQ(string_encoding_utf_16, d.extended<base_string_type>()->get_encoding());
+    EXPECT_EQ("offset_string['utf16', int64]", d.str());
+    EXPECT_EQ(d, ndt::type(d.str()));
+
+    d = ndt::type("offset_string['ascii']");
+    EXPECT_EQ(ndt::make_offset_string(string_encoding_ascii), d);
+
+    EXPECT_NE(ndt::make_offset_string(), ndt::make_string());
+    EXPECT_NE(ndt::make_offset_string(),
+              ndt::make_offset_string(string_encoding_utf_8, int64_type_id));
+    EXPECT_THROW(ndt::make_offset_string(string_encoding_utf_8, int16_type_id),
+                 type_error);
+    EXPECT_THROW(ndt::type("offset_string[float32]"), runtime_error);
+}
+
+TEST(OffsetStringType, ContiguousStorage) {
+    const char *a_arr[4] = {"one", "", "three", "\xe2\x82\xac"};
+    nd::array a = nd::empty(4, ndt::make_offset_string());
+    a.vals() = a_arr;
+
+    EXPECT_EQ("one", a(0).as<string>());
+    EXPECT_EQ("", a(1).as<string>());
+    EXPECT_EQ("three", a(2).as<string>());
+    EXPECT_EQ("\xe2\x82\xac", a(3).as<string>());
+
+    // The characters are packed back to back in a single buffer
+    const offset_string_type_data<int32_t> *d =
+        reinterpret_cast<const offset_string_type_data<int32_t> *>(
+            a.get_readonly_originptr());
+    EXPECT_EQ(0, d[0].begin);
+    EXPECT_EQ(3, d[0].end);
+    EXPECT_EQ(3, d[1].begin);
+    EXPECT_EQ(3, d[1].end);
+    EXPECT_EQ(3, d[2].begin);
+    EXPECT_EQ(8, d[2].end);
+    EXPECT_EQ(8, d[3].begin);
+    EXPECT_EQ(11, d[3].end);
+    const offset_string_type_arrmeta *md =
+        reinterpret_cast<const offset_string_type_arrmeta *>(
+            a.get_arrmeta() + sizeof(fixed_dim_type_arrmeta));
+    EXPECT_EQ(contiguous_pod_memory_block_type, (int)md->blockref->m_type);
+    EXPECT_EQ(0, memcmp(get_contiguous_pod_memory_block_data(md->blockref),
+                        "onethree\xe2\x82\xac", 11));
+}
+
+TEST(OffsetStringType, Conversions) {
+    const char *a_arr[3] = {"testing", "offset", "strings"};
+    nd::array a = a_arr, b, c;
+
+    // string -> offset_string -> string
+    b = a.ucast(ndt::make_offset_string()).eval();
+    EXPECT_EQ(ndt::type("3 * offset_string"), b.get_type());
+    c = b.ucast(ndt::make_string()).eval();
+    EXPECT_EQ(ndt::type("3 * string"), c.get_type());
+    EXPECT_EQ("testing", c(0).as<string>());
+    EXPECT_EQ("offset", c(1).as<string>());
+    EXPECT_EQ("strings", c(2).as<string>());
+
+    // offset_string -> offset_string with a different encoding and width
+    c = b.ucast(ndt::make_offset_string(string_encoding_utf_16, int64_type_id)).eval();
+    EXPECT_EQ("testing", c(0).as<string>());
+    EXPECT_EQ("offset", c(1).as<string>());
+    EXPECT_EQ("strings", c(2).as<string>());
+
+    // offset_string -> fixedstring
+    c = b.ucast(ndt::make_fixedstring(8)).eval();
+    EXPECT_EQ("testing", c(0).as<string>());
+    EXPECT_EQ("strings", c(2).as<string>());
+
+    // Numbers go through the string parsing and printing
+    b = nd::empty(2, ndt::make_offset_string());
+    b.vals() = parse_json("2 * int32", "[12, -345]");
+    EXPECT_EQ("12", b(0).as<string>());
+    EXPECT_EQ("-345", b(1).as<string>());
+    EXPECT_EQ(-345, b(1).as<int>());
+}
+
+TEST(OffsetStringType, Compare) {
+    const char *a_arr[3] = {"abc", "abd", "ab"};
+    nd::array a = nd::array(a_arr).ucast(ndt::make_offset_string()).eval();
+
+    EXPECT_TRUE(a(0) < a(1));
+    EXPECT_FALSE(a(1) < a(0));
+    EXPECT_TRUE(a(2) < a(0));
+    EXPECT_TRUE(a(0) <= a(0));
+    EXPECT_TRUE(a(0) == a(0));
+    EXPECT_TRUE(a(0) != a(1));
+    EXPECT_TRUE(a(1) > a(2));
+    EXPECT_TRUE(a(1) >= a(2));
+
+    // Against other string types
+    EXPECT_TRUE(a(0) == nd::array("abc"));
+    EXPECT_TRUE(a(0) < nd::array("abz"));
+
+    // U+FF5E is less than U+1F600, a surrogate pair in UTF-16
+    const char *b_arr[2] = {"a\xef\xbd\x9e", "a\xf0\x9f\x98\x80"};
+    nd::array b = nd::array(b_arr).ucast(ndt::make_offset_string(
+        string_encoding_utf_16, int32_type_id)).eval();
+    EXPECT_TRUE(b(0) < b(1));
+    EXPECT_FALSE(b(1) < b(0));
+    EXPECT_TRUE(b(1) > b(0));
+}
+
+TEST(OffsetStringType, Option) {
+    nd::array a = nd::empty("3 * ?offset_string");
+    parse_json(a, "[\"x\", null, \"yz\"]");
+    EXPECT_TRUE(nd::is_scalar_avail(a(0)));
+    EXPECT_FALSE(nd::is_scalar_avail(a(1)));
+    EXPECT_TRUE(nd::is_scalar_avail(a(2)));
+    EXPECT_EQ("x", a(0).as<string>());
+    EXPECT_EQ("yz", a(2).as<string>());
+}
+
+TEST(OffsetStringType, StringFunctions) {
+    const char *a_arr[3] = {"apple", "banana", "cherry"};
+    nd::array a = nd::array(a_arr).ucast(ndt::make_offset_string()).eval();
+
+    nd::array c = a.f("find", nd::array("an")).eval();
+    EXPECT_EQ(-1, c(0).as<intptr_t>());
+    EXPECT_EQ(1, c(1).as<intptr_t>());
+    EXPECT_EQ(-1, c(2).as<intptr_t>());
+}
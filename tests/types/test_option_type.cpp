@@ -189,3 +189,33 @@ TEST(OptionType, String) {
   a.vals_at(1) = "NA";
   EXPECT_EQ("NA", a(1).as<string>());
 }
+
+TEST(OptionType, StridedOptionAssign) {
+  // Goes through the strided option to option kernel
+  const intptr_t n = 300;
+  nd::array a = nd::empty(n, ndt::make_option<int32_t>());
+  for (intptr_t i = 0; i < n; ++i) {
+    if (i % 5 == 0 || (i >= 130 && i < 260)) {
+      a.vals_at(i) = "NA";
+    } else {
+      a.vals_at(i) = (int)i;
+    }
+  }
+  nd::array b = nd::empty(n, ndt::make_option<int64_t>());
+  b.vals() = a;
+  for (intptr_t i = 0; i < n; ++i) {
+    bool avail = !(i % 5 == 0 || (i >= 130 && i < 260));
+    EXPECT_EQ(avail, nd::is_scalar_avail(b(i)));
+    if (avail) {
+      EXPECT_EQ(i, b(i).as<int64_t>());
+    }
+  }
+
+  // option[bool] with a stride through the is_avail kernel
+  nd::array c = parse_json("6 * ?bool", "[true, null, false, true, null, null]");
+  nd::array d = nd::empty(3, ndt::make_option<dynd_bool>());
+  d.vals() = c(irange().by(2));
+  EXPECT_TRUE(d(0).as<bool>());
+  EXPECT_FALSE(d(1).as<bool>());
+  EXPECT_FALSE(nd::is_scalar_avail(d(2)));
+}
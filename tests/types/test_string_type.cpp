@@ -549,6 +549,95 @@ TEST(StringType, Find2) {
     EXPECT_EQ(-1, c(5).as<intptr_t>());
 }
 
+TEST(StringType, FindLongPattern) {
+    nd::array a, b, c;
+
+    // Periodic and non-periodic patterns which exercise the
+    // critical factorization and the skipping of the searcher
+    const char *a_arr[5] = {"aaaaaaaaab", "abaabaabaabaab", "xyzxyzxyzw",
+                            "the quick brown fox jumps", "abcabcabd"};
+    const char *b_arr[5] = {"aaab", "abaab", "xyzw", "fox jumps", "abcabd"};
+    a = a_arr;
+    b = b_arr;
+
+    c = a.f("find", b).eval();
+    ASSERT_EQ(ndt::type("5 * intptr"), c.get_type());
+    EXPECT_EQ(6, c(0).as<intptr_t>());
+    EXPECT_EQ(0, c(1).as<intptr_t>());
+    EXPECT_EQ(6, c(2).as<intptr_t>());
+    EXPECT_EQ(16, c(3).as<intptr_t>());
+    EXPECT_EQ(3, c(4).as<intptr_t>());
+
+    c = a.f("find", nd::array("abab")).eval();
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(-1, c(i).as<intptr_t>());
+    }
+}
+
+TEST(StringType, FindUnicode) {
+    nd::array a, b, c;
+
+    // The result is a codepoint index, not a byte offset
+    const char *a_arr[3] = {"\xc3\xa9t\xc3\xa9 \xe2\x82\xac" "5", "\xf0\x9f\x98\x80x\xe2\x82\xac",
+                            "\xe2\x82\xac"};
+    a = a_arr;
+    b = "\xe2\x82\xac";
+
+    c = a.f("find", b).eval();
+    EXPECT_EQ(4, c(0).as<intptr_t>());
+    EXPECT_EQ(2, c(1).as<intptr_t>());
+    EXPECT_EQ(0, c(2).as<intptr_t>());
+
+    // Searching a UTF-16 string for a UTF-8 substring
+    a = nd::array(a_arr).ucast(ndt::make_string(string_encoding_utf_16)).eval();
+    c = a.f("find", b).eval();
+    EXPECT_EQ(4, c(0).as<intptr_t>());
+    EXPECT_EQ(2, c(1).as<intptr_t>());
+    EXPECT_EQ(0, c(2).as<intptr_t>());
+
+    // A substring which ASCII can't represent never matches
+    a = nd::array("cafe").ucast(ndt::make_string(string_encoding_ascii)).eval();
+    EXPECT_EQ(2, a.f("find", nd::array("fe")).as<intptr_t>());
+    EXPECT_EQ(-1, a.f("find", b).as<intptr_t>());
+}
+
+TEST(StringType, StartsEndsWithContains) {
+    nd::array a, c;
+
+    const char *a_arr[5] = {"apple", "application", "pineapple", "", "app"};
+    a = a_arr;
+
+    c = a.f("startswith", nd::array("app")).eval();
+    ASSERT_EQ(ndt::type("5 * bool"), c.get_type());
+    EXPECT_TRUE(c(0).as<bool>());
+    EXPECT_TRUE(c(1).as<bool>());
+    EXPECT_FALSE(c(2).as<bool>());
+    EXPECT_FALSE(c(3).as<bool>());
+    EXPECT_TRUE(c(4).as<bool>());
+
+    c = a.f("endswith", nd::array("apple")).eval();
+    ASSERT_EQ(ndt::type("5 * bool"), c.get_type());
+    EXPECT_TRUE(c(0).as<bool>());
+    EXPECT_FALSE(c(1).as<bool>());
+    EXPECT_TRUE(c(2).as<bool>());
+    EXPECT_FALSE(c(3).as<bool>());
+    EXPECT_FALSE(c(4).as<bool>());
+
+    c = a.f("contains", nd::array("pp")).eval();
+    ASSERT_EQ(ndt::type("5 * bool"), c.get_type());
+    EXPECT_TRUE(c(0).as<bool>());
+    EXPECT_TRUE(c(1).as<bool>());
+    EXPECT_TRUE(c(2).as<bool>());
+    EXPECT_FALSE(c(3).as<bool>());
+    EXPECT_TRUE(c(4).as<bool>());
+
+    // The empty string is contained in everything
+    c = a.f("contains", nd::array("")).eval();
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(c(i).as<bool>());
+    }
+}
+
 template<class T>
 static bool ascii_T_compare(const char *x, const T *y, intptr_t count)
 {
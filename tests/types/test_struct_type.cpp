@@ -21,6 +21,8 @@
 #include <dynd/json_parser.hpp>
 #include <dynd/func/callable.hpp>
 #include <dynd/func/call_callable.hpp>
+#include <dynd/func/arrfunc_registry.hpp>
+#include <dynd/kernels/struct_comparison_kernels.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -535,3 +537,95 @@ TEST(StructType, PackStdVector)
   EXPECT_JSON_EQ_ARR("[0, 1, 2, 3, 4, 5, 6, 7, 8, 9]",
                      a.p("second").f("dereference"));
 }
+
+TEST(StructType, StridedAssign) {
+    // The leading int32 fields copy as one memcpy run, the others
+    // through their own child kernels
+    ndt::type dt = ndt::type("{a : int32, b : int32, s : string, c : float64}");
+    ndt::type dt2 = ndt::type("{a : int32, b : int32, s : string, c : float32}");
+    intptr_t n = 300;
+    nd::array a = nd::empty(n, dt);
+    for (intptr_t i = 0; i < n; ++i) {
+        a(i, 0).vals() = (int)i;
+        a(i, 1).vals() = (int)(-i);
+        stringstream ss;
+        ss << "s" << i;
+        a(i, 2).vals() = ss.str();
+        a(i, 3).vals() = i + 0.5;
+    }
+
+    nd::array b = nd::empty(n, dt2);
+    b.vals() = a;
+    nd::array c = nd::empty(n / 2, dt);
+    c.vals() = a(irange().by(2));
+    for (intptr_t i = 0; i < n; ++i) {
+        stringstream ss;
+        ss << "s" << i;
+        EXPECT_EQ(i, b(i, 0).as<intptr_t>());
+        EXPECT_EQ(-i, b(i, 1).as<intptr_t>());
+        EXPECT_EQ(ss.str(), b(i, 2).as<string>());
+        EXPECT_EQ(i + 0.5f, b(i, 3).as<float>());
+        if (i % 2 == 0) {
+            EXPECT_EQ(i, c(i / 2, 0).as<intptr_t>());
+            EXPECT_EQ(-i, c(i / 2, 1).as<intptr_t>());
+            EXPECT_EQ(ss.str(), c(i / 2, 2).as<string>());
+            EXPECT_EQ(i + 0.5, c(i / 2, 3).as<double>());
+        }
+    }
+}
+
+TEST(StructType, StridedCompareMask) {
+    ndt::type sdt = ndt::type("{a : int32, s : string, c : float64}");
+    intptr_t n = 300;
+    nd::array a = nd::empty(n, sdt), b = nd::empty(n, sdt);
+    // Cycle through ties and differences in each of the fields
+    for (intptr_t i = 0; i < n; ++i) {
+        a(i, 0).vals() = (int)(i % 3);
+        b(i, 0).vals() = (int)((i / 3) % 3);
+        a(i, 1).vals() = (i % 2) ? "x" : "y";
+        b(i, 1).vals() = (i % 5) ? "x" : "y";
+        a(i, 2).vals() = (double)(i % 7);
+        b(i, 2).vals() = (double)(i % 4);
+    }
+
+    comparison_type_t comptypes[3] = {comparison_type_sorting_less,
+                                      comparison_type_equal,
+                                      comparison_type_not_equal};
+    for (int k = 0; k < 3; ++k) {
+        ckernel_builder<kernel_request_host> ckb;
+        const char *elem_arrmeta = a.get_arrmeta() + sizeof(fixed_dim_type_arrmeta);
+        make_comparison_mask_kernel(&ckb, 0, sdt, elem_arrmeta, sdt,
+                                    elem_arrmeta, comptypes[k],
+                                    kernel_request_strided,
+                                    &eval::default_eval_context);
+        expr_strided_t fn = ckb.get()->get_function<expr_strided_t>();
+        vector<char> mask(n);
+        char *src[2] = {const_cast<char *>(a.get_readonly_originptr()),
+                        const_cast<char *>(b.get_readonly_originptr())};
+        intptr_t src_stride[2] = {
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(a.get_arrmeta())->stride,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(b.get_arrmeta())->stride};
+        fn(&mask[0], 1, src, src_stride, n, ckb.get());
+        for (intptr_t i = 0; i < n; ++i) {
+            bool expected;
+            if (comptypes[k] == comparison_type_sorting_less) {
+                expected = a(i).op_sorting_less(b(i));
+            } else if (comptypes[k] == comparison_type_equal) {
+                expected = (a(i) == b(i));
+            } else {
+                expected = (a(i) != b(i));
+            }
+            EXPECT_EQ(expected, mask[i] != 0) << k << " " << i;
+        }
+    }
+
+    // Through the registered comparison arrfuncs
+    nd::array c = func::get_regfunction("equal")(a, a);
+    for (intptr_t i = 0; i < n; ++i) {
+        EXPECT_TRUE(c(i).as<bool>());
+    }
+    EXPECT_THROW(make_struct_comparison_mask_kernel(
+                     NULL, 0, sdt, NULL, NULL, comparison_type_less,
+                     kernel_request_strided, &eval::default_eval_context),
+                 not_comparable_error);
+}
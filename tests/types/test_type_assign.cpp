@@ -11,6 +11,7 @@
 #include "inc_gtest.hpp"
 
 #include "dynd/type.hpp"
+#include "dynd/array.hpp"
 
 using namespace std;
 using namespace dynd;
@@ -828,3 +829,114 @@ TEST(TypeAssign, FixedSizeTests_Complex_Float64) {
 
 }
 
+TEST(TypeAssign, Float16BulkToFloat) {
+    // Every float16 bit pattern, through both the vector and scalar paths
+    vector<uint16_t> h(65536);
+    vector<float> f(h.size());
+    vector<double> d(h.size());
+    for (size_t i = 0; i < h.size(); ++i) {
+        h[i] = (uint16_t)i;
+    }
+    halfbits_to_float_array(&f[0], &h[0], h.size());
+    halfbits_to_double_array(&d[0], &h[0], h.size());
+    for (size_t i = 0; i < h.size(); ++i) {
+        float f1;
+        double d1;
+        halfbits_to_float_array(&f1, &h[i], 1);
+        halfbits_to_double_array(&d1, &h[i], 1);
+        float expected = halfbits_to_float(h[i]);
+        if (DYND_ISNAN(expected)) {
+            EXPECT_TRUE(DYND_ISNAN(f[i]) && DYND_ISNAN(f1) &&
+                        DYND_ISNAN(d[i]) && DYND_ISNAN(d1));
+        } else {
+            EXPECT_EQ(0, memcmp(&expected, &f[i], sizeof(float))) << i;
+            EXPECT_EQ(0, memcmp(&expected, &f1, sizeof(float))) << i;
+            EXPECT_EQ((double)expected, d[i]);
+            EXPECT_EQ((double)expected, d1);
+        }
+    }
+}
+
+TEST(TypeAssign, Float16BulkFromFloat) {
+    // Every float16 value, the midpoints between neighbours (ties round to
+    // even), and values just off the midpoints
+    vector<float> f;
+    vector<double> d;
+    for (uint32_t i = 0; i < 0x7c00u; ++i) {
+        float lo = halfbits_to_float((uint16_t)i);
+        float hi = halfbits_to_float((uint16_t)(i + 1));
+        float mid = (lo + hi) / 2;
+        float vals[4] = {lo, mid, nextafterf(mid, 0.f), nextafterf(mid, 1e10f)};
+        for (int j = 0; j < 4; ++j) {
+            f.push_back(vals[j]);
+            f.push_back(-vals[j]);
+            d.push_back(vals[j]);
+            d.push_back(-vals[j]);
+        }
+        // Rounding at the float32 precision and rounding twice differ here
+        d.push_back((double)mid + 1e-12 * (double)mid);
+    }
+    f.push_back(numeric_limits<float>::infinity());
+    f.push_back(1e-30f);
+    f.push_back(1e30f);
+    d.push_back(-numeric_limits<double>::infinity());
+    d.push_back(1e-300);
+    d.push_back(1e300);
+
+    vector<uint16_t> h(f.size());
+    float_to_halfbits_array(&h[0], &f[0], f.size(), assign_error_nocheck);
+    for (size_t i = 0; i < f.size(); ++i) {
+        uint16_t h1;
+        float_to_halfbits_array(&h1, &f[i], 1, assign_error_nocheck);
+        EXPECT_EQ(float_to_halfbits(f[i], assign_error_nocheck), h[i]) << f[i];
+        EXPECT_EQ(h[i], h1) << f[i];
+    }
+    h.resize(d.size());
+    double_to_halfbits_array(&h[0], &d[0], d.size(), assign_error_nocheck);
+    for (size_t i = 0; i < d.size(); ++i) {
+        EXPECT_EQ(double_to_halfbits(d[i], assign_error_nocheck), h[i]) << d[i];
+    }
+
+    // Quiet NaNs stay NaN
+    float nan = numeric_limits<float>::quiet_NaN();
+    float_to_halfbits_array(&h[0], &nan, 1, assign_error_nocheck);
+    EXPECT_EQ(0x7e00u, h[0]&0x7e00u);
+}
+
+TEST(TypeAssign, Float16BulkErrors) {
+    float f[9] = {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 0.f};
+    uint16_t h[9];
+    float_to_halfbits_array(h, f, 9, assign_error_inexact);
+    EXPECT_EQ(DYND_FLOAT16_ONE, h[0]);
+    f[3] = 1e6f;
+    EXPECT_THROW(float_to_halfbits_array(h, f, 9, assign_error_overflow),
+                 overflow_error);
+    float_to_halfbits_array(h, f, 9, assign_error_nocheck);
+    EXPECT_EQ(DYND_FLOAT16_PINF, h[3]);
+    f[3] = 1e-7f;
+    float_to_halfbits_array(h, f, 9, assign_error_overflow);
+    EXPECT_THROW(float_to_halfbits_array(h, f, 9, assign_error_inexact),
+                 runtime_error);
+    double d[2] = {1.0, -1e10};
+    EXPECT_THROW(double_to_halfbits_array(h, d, 2, assign_error_fractional),
+                 overflow_error);
+
+    // Through the assignment kernels, contiguous and strided
+    nd::array a = nd::empty("10 * float32");
+    for (int i = 0; i < 10; ++i) {
+        a(i).vals() = i * 0.25f;
+    }
+    nd::array b = nd::empty("10 * float16"), c = nd::empty("10 * float64");
+    b.vals() = a;
+    c.vals() = b;
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(i * 0.25, c(i).as<double>());
+    }
+    c = nd::empty("5 * float64");
+    c.vals() = b(irange().by(2));
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(i * 0.5, c(i).as<double>());
+    }
+    a(7).vals() = 1e10f;
+    EXPECT_THROW(b.vals() = a, overflow_error);
+}
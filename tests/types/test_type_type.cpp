@@ -12,6 +12,7 @@
 #include <dynd/types/type_type.hpp>
 #include <dynd/types/cfixed_dim_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
+#include <dynd/types/datashape_parser.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -52,7 +53,8 @@ TEST(DTypeDType, StringCasting) {
 TEST(DTypeDType, ScalarRefCount) {
     nd::array a;
     ndt::type d, d2;
-    d = ndt::type("fixed * 12 * int");
+    // Parse without the datashape cache, so 'd' holds the only reference
+    d = type_from_datashape("fixed * 12 * int");
 
     a = nd::empty(ndt::make_type());
     EXPECT_EQ(1, d.extended()->get_use_count());
@@ -76,7 +78,7 @@ TEST(DTypeDType, ScalarRefCount) {
 TEST(DTypeDType, StridedArrayRefCount) {
     nd::array a;
     ndt::type d;
-    d = ndt::type("fixed * 12 * int");
+    d = type_from_datashape("fixed * 12 * int");
 
     // 1D Strided Array
     a = nd::empty(10, ndt::make_type());
@@ -123,7 +125,7 @@ TEST(DTypeDType, StridedArrayRefCount) {
 TEST(DTypeDType, FixedArrayRefCount) {
     nd::array a;
     ndt::type d;
-    d = ndt::type("fixed * 12 * int");
+    d = type_from_datashape("fixed * 12 * int");
 
     // 1D Fixed Array
     a = nd::empty(ndt::make_cfixed_dim(10, ndt::make_type()));
@@ -169,7 +171,7 @@ TEST(DTypeDType, FixedArrayRefCount) {
 TEST(DTypeDType, VarArrayRefCount) {
     nd::array a;
     ndt::type d;
-    d = ndt::type("fixed * 12 * int");
+    d = type_from_datashape("fixed * 12 * int");
 
     // 1D Var Array
     a = nd::empty(ndt::make_var_dim(ndt::make_type()));
@@ -222,7 +224,7 @@ TEST(DTypeDType, VarArrayRefCount) {
 TEST(DTypeDType, CStructRefCount) {
     nd::array a;
     ndt::type d;
-    d = ndt::type("fixed * 12 * int");
+    d = type_from_datashape("fixed * 12 * int");
 
     // Single CStruct Instance
     a = nd::empty("{dt: type, more: {a: int32, b: type}, other: string}");
@@ -272,7 +274,7 @@ TEST(DTypeDType, CStructRefCount) {
 TEST(DTypeDType, StructRefCount) {
     nd::array a;
     ndt::type d;
-    d = ndt::type("fixed * 12 * int");
+    d = type_from_datashape("fixed * 12 * int");
 
     // Single CStruct Instance
     a = nd::empty("{dt: type, more: {a: int32, b: type}, other: string}")(0 <= irange() < 2);
@@ -6,6 +6,7 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 #include "inc_gtest.hpp"
 #include "dynd_assertions.hpp"
 
@@ -13,6 +14,8 @@
 #include <dynd/types/tuple_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
 #include <dynd/types/cfixed_dim_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/string_type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/json_parser.hpp>
 #include <dynd/func/callable.hpp>
@@ -567,3 +570,72 @@ TEST(VarArrayDType, AssignAfterCreated) {
   a.vals() = vals;
   EXPECT_JSON_EQ_ARR("[1, 3, 5]", a);
 }
+
+TEST(VarDimBuilder, Contiguous) {
+  const intptr_t n = 1000;
+  nd::array a = nd::empty(n, "var * int32");
+  ndt::type vtp = a.get_type().at_single(0);
+  const char *var_meta = a.get_arrmeta() + sizeof(fixed_dim_type_arrmeta);
+  char *data = a.get_readwrite_originptr();
+  intptr_t stride = sizeof(var_dim_type_data);
+
+  vector<intptr_t> counts(n);
+  for (intptr_t i = 0; i < n; ++i) {
+    // Some of the elements are empty
+    counts[i] = i % 7;
+  }
+  {
+    ndt::var_dim_builder builder(vtp, var_meta);
+    builder.append_all(data, stride, n, &counts[0]);
+    EXPECT_THROW(builder.append(data, 1), runtime_error);
+  }
+  for (intptr_t i = 0; i < n; ++i) {
+    var_dim_type_data *d = reinterpret_cast<var_dim_type_data *>(data + i * stride);
+    ASSERT_TRUE(d->begin != NULL);
+    ASSERT_EQ(counts[i], (intptr_t)d->size);
+    for (intptr_t j = 0; j < counts[i]; ++j) {
+      reinterpret_cast<int32_t *>(d->begin)[j] = (int32_t)(i + j);
+    }
+    if (i > 0) {
+      // The elements are back to back in one allocation
+      var_dim_type_data *prev = reinterpret_cast<var_dim_type_data *>(data + (i - 1) * stride);
+      EXPECT_EQ(prev->begin + prev->size * sizeof(int32_t), d->begin);
+    }
+  }
+  EXPECT_EQ(0, a(0).get_dim_size());
+  EXPECT_EQ(3, a(3).get_dim_size());
+  EXPECT_EQ(7, a(5, 2).as<int>());
+  EXPECT_EQ(999 + 4, a(999, 4).as<int>());
+}
+
+TEST(VarDimBuilder, OpenClose) {
+  // Strings need zero-initialized memory, which the builder must
+  // preserve across the space it hands out and takes back
+  const intptr_t n = 50;
+  nd::array a = nd::empty(n, "var * string");
+  ndt::type vtp = a.get_type().at_single(0);
+  const char *var_meta = a.get_arrmeta() + sizeof(fixed_dim_type_arrmeta);
+  char *data = a.get_readwrite_originptr();
+  intptr_t stride = sizeof(var_dim_type_data);
+  {
+    ndt::var_dim_builder builder(vtp, var_meta);
+    for (intptr_t i = 0; i < n; ++i) {
+      char *ptr = builder.open(100);
+      for (intptr_t j = 0; j < i % 3; ++j) {
+        const string_type_data *s =
+            reinterpret_cast<const string_type_data *>(ptr + j * sizeof(string_type_data));
+        ASSERT_TRUE(s->begin == NULL);
+      }
+      builder.close(data + i * stride, i % 3);
+    }
+  }
+  for (intptr_t i = 0; i < n; ++i) {
+    ASSERT_EQ(i % 3, a(i).get_dim_size());
+  }
+  a(7, 0).vals() = "test";
+  EXPECT_EQ("test", a(7, 0).as<string>());
+  EXPECT_EQ("", a(8, 1).as<string>());
+
+  EXPECT_THROW(ndt::var_dim_builder(ndt::type("3 * int32"), var_meta),
+               type_error);
+}